@@ -3,6 +3,7 @@
 #include <functional>
 
 #include "lib/Analysis/Utils.h"
+#include "lib/Dialect/Mgmt/IR/MgmtOps.h"
 #include "lib/Dialect/Secret/IR/SecretOps.h"
 #include "llvm/include/llvm/ADT/TypeSwitch.h"              // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
@@ -26,6 +27,13 @@ LogicalResult MulResultAnalysis::visitOperation(
     propagateIfChanged(lattice, changed);
   };
 
+  if (resetAfterModReduce && isa<mgmt::ModReduceOp, mgmt::BootstrapOp>(op)) {
+    for (auto result : op->getResults()) {
+      propagate(result, MulResultState(false));
+    }
+    return success();
+  }
+
   llvm::TypeSwitch<Operation &>(*op)
       .Case<secret::GenericOp>([&](auto genericOp) {
         Block *body = genericOp.getBody();
@@ -79,6 +79,13 @@ class MulResultAnalysis
   using SparseForwardDataFlowAnalysis::SparseForwardDataFlowAnalysis;
   friend class SecretnessAnalysisDependent<MulResultAnalysis>;
 
+  // If resetAfterModReduce is true, the results of mgmt.modreduce and
+  // mgmt.bootstrap are not mul results, so that the state tells whether the
+  // scale of a value still contains an unrescaled product.
+  MulResultAnalysis(DataFlowSolver &solver, bool resetAfterModReduce)
+      : SparseForwardDataFlowAnalysis(solver),
+        resetAfterModReduce(resetAfterModReduce) {}
+
   void setToEntryState(MulResultLattice *lattice) override {
     propagateIfChanged(lattice, lattice->join(MulResultState()));
   }
@@ -94,6 +101,9 @@ class MulResultAnalysis
   void propagateIfChangedWrapper(AnalysisState *state, ChangeResult changed) {
     propagateIfChanged(state, changed);
   }
+
+ private:
+  bool resetAfterModReduce = false;
 };
 
 }  // namespace heir
@@ -8,24 +8,34 @@
 #include "lib/Dialect/Secret/IR/SecretDialect.h"
 #include "lib/Dialect/Secret/IR/SecretOps.h"
 #include "lib/Dialect/Secret/IR/SecretTypes.h"
+#include "llvm/include/llvm/ADT/STLExtras.h"               // from @llvm-project
 #include "llvm/include/llvm/Support/Casting.h"             // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"     // from @llvm-project
 #include "mlir/include/mlir/IR/Attributes.h"               // from @llvm-project
+#include "mlir/include/mlir/IR/Block.h"                    // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinAttributes.h"        // from @llvm-project
 #include "mlir/include/mlir/IR/OpDefinition.h"             // from @llvm-project
 #include "mlir/include/mlir/IR/Operation.h"                // from @llvm-project
+#include "mlir/include/mlir/IR/Region.h"                   // from @llvm-project
 #include "mlir/include/mlir/IR/Value.h"                    // from @llvm-project
 #include "mlir/include/mlir/IR/ValueRange.h"               // from @llvm-project
 #include "mlir/include/mlir/IR/Visitors.h"                 // from @llvm-project
 #include "mlir/include/mlir/Interfaces/CallInterfaces.h"   // from @llvm-project
+#include "mlir/include/mlir/Interfaces/ControlFlowInterfaces.h"  // from @llvm-project
+#include "mlir/include/mlir/Interfaces/LoopLikeInterface.h"  // from @llvm-project
 #include "mlir/include/mlir/Support/LLVM.h"                // from @llvm-project
 
 namespace mlir {
 namespace heir {
 
-void SecretnessAnalysis::setToEntryState(SecretnessLattice *lattice) {
-  auto operand = lattice->getAnchor();
+namespace {
+
+// The secretness of a value that is not computed from other values: function
+// arguments and block arguments of regions that are not control flow.
+Secretness getEntrySecretness(Value operand) {
   bool secretness = isa<secret::SecretType>(operand.getType());
 
   Operation *operation = nullptr;
@@ -72,12 +82,13 @@ void SecretnessAnalysis::setToEntryState(SecretnessLattice *lattice) {
     }
   }
 
-  propagateIfChanged(lattice, lattice->join(Secretness(secretness)));
+  return Secretness(secretness);
 }
 
-LogicalResult SecretnessAnalysis::visitOperation(
-    Operation *operation, ArrayRef<const SecretnessLattice *> operands,
-    ArrayRef<SecretnessLattice *> results) {
+// The secretness of the results of an operation that is not a region branch,
+// given the secretness of its operands.
+Secretness getResultSecretness(Operation *operation,
+                               ArrayRef<Secretness> operands) {
   auto resultSecretness = Secretness();
   bool isUninitializedOpFound = false;
 
@@ -86,8 +97,7 @@ LogicalResult SecretnessAnalysis::visitOperation(
     resultSecretness.setSecretness(false);
   }
 
-  for (const SecretnessLattice *operand : operands) {
-    const Secretness operandSecretness = operand->getValue();
+  for (const Secretness &operandSecretness : operands) {
     if (!operandSecretness.isInitialized()) {
       // Keep record if operand is uninitialized
       isUninitializedOpFound = true;
@@ -108,6 +118,24 @@ LogicalResult SecretnessAnalysis::visitOperation(
       resultSecretness = Secretness();
     }
   }
+  return resultSecretness;
+}
+
+}  // namespace
+
+void SecretnessAnalysis::setToEntryState(SecretnessLattice *lattice) {
+  propagateIfChanged(lattice,
+                     lattice->join(getEntrySecretness(lattice->getAnchor())));
+}
+
+LogicalResult SecretnessAnalysis::visitOperation(
+    Operation *operation, ArrayRef<const SecretnessLattice *> operands,
+    ArrayRef<SecretnessLattice *> results) {
+  SmallVector<Secretness> operandSecretness;
+  for (const SecretnessLattice *operand : operands) {
+    operandSecretness.push_back(operand->getValue());
+  }
+  auto resultSecretness = getResultSecretness(operation, operandSecretness);
 
   for (SecretnessLattice *result : results) {
     propagateIfChanged(result, result->join(resultSecretness));
@@ -255,5 +283,206 @@ void getSecretOperands(Operation *op,
   }
 }
 
+namespace {
+
+// Overwrites the state of `value` without visiting its users. Returns true if
+// the secretness changed.
+bool writeSecretness(DataFlowSolver *solver, Value value,
+                     Secretness secretness) {
+  auto *lattice = solver->getOrCreateState<SecretnessLattice>(value);
+  if (lattice->getValue() == secretness) return false;
+  // Overwrite rather than join: the value may have been created in place of
+  // an erased one that the solver still holds a (stale) state for.
+  lattice->getValue() = secretness;
+  return true;
+}
+
+Secretness lookupSecretness(Value value, DataFlowSolver *solver) {
+  auto *lattice = solver->lookupState<SecretnessLattice>(value);
+  return lattice ? lattice->getValue() : Secretness();
+}
+
+// Whether every block of every region of `op` ends in a terminator, which is
+// not yet the case while a pattern is still building the op.
+bool hasTerminators(Operation *op) {
+  for (Region &region : op->getRegions()) {
+    for (Block &block : region) {
+      if (block.empty() || !block.back().hasTrait<OpTrait::IsTerminator>())
+        return false;
+    }
+  }
+  return true;
+}
+
+bool setAllToSecretness(ValueRange values, Secretness secretness,
+                        DataFlowSolver *solver) {
+  bool changed = false;
+  for (Value value : values) {
+    changed |= writeSecretness(solver, value, secretness);
+  }
+  return changed;
+}
+
+bool recomputeSecretness(Operation *op, DataFlowSolver *solver);
+
+void recomputeRegions(Operation *op, DataFlowSolver *solver) {
+  for (Region &region : op->getRegions()) {
+    for (Block &block : region) {
+      for (Operation &nested : block) {
+        (void)recomputeSecretness(&nested, solver);
+      }
+    }
+  }
+}
+
+// Recompute the secretness of the values defined by `op`, including the ones
+// defined in its regions. Returns true if the secretness of a result of `op`
+// changed.
+bool recomputeSecretness(Operation *op, DataFlowSolver *solver) {
+  if (op->getNumRegions() == 0 && op->getNumResults() == 0) return false;
+
+  SmallVector<Secretness> operandSecretness;
+  for (Value operand : op->getOperands()) {
+    operandSecretness.push_back(lookupSecretness(operand, solver));
+  }
+
+  if (op->getNumRegions() == 0) {
+    return setAllToSecretness(op->getResults(),
+                              getResultSecretness(op, operandSecretness),
+                              solver);
+  }
+
+  // Regions that are not control flow start from the entry state, like in
+  // SecretnessAnalysis::setToEntryState.
+  if (!isa<RegionBranchOpInterface>(op)) {
+    for (Region &region : op->getRegions()) {
+      if (region.empty()) continue;
+      for (BlockArgument arg : region.front().getArguments()) {
+        writeSecretness(solver, arg, getEntrySecretness(arg));
+      }
+    }
+    recomputeRegions(op, solver);
+    return setAllToSecretness(op->getResults(),
+                              getResultSecretness(op, operandSecretness),
+                              solver);
+  }
+
+  // Loops: iteration arguments join the initial and the yielded values until
+  // they stop changing; the results are the final iteration arguments.
+  if (auto loop = dyn_cast<LoopLikeOpInterface>(op)) {
+    if (auto inductionVars = loop.getLoopInductionVars()) {
+      for (Value inductionVar : *inductionVars) {
+        writeSecretness(solver, inductionVar,
+                             getEntrySecretness(inductionVar));
+      }
+    }
+    auto iterArgs = loop.getRegionIterArgs();
+    for (auto [iterArg, init] : llvm::zip(iterArgs, loop.getInits())) {
+      writeSecretness(solver, iterArg, lookupSecretness(init, solver));
+    }
+    recomputeRegions(op, solver);
+    bool iterArgsChanged = hasTerminators(op);
+    while (iterArgsChanged) {
+      iterArgsChanged = false;
+      for (auto [iterArg, yielded] :
+           llvm::zip(iterArgs, loop.getYieldedValues())) {
+        iterArgsChanged |= writeSecretness(
+            solver, iterArg,
+            Secretness::join(lookupSecretness(iterArg, solver),
+                             lookupSecretness(yielded, solver)));
+      }
+      if (iterArgsChanged) recomputeRegions(op, solver);
+    }
+
+    bool changed = false;
+    if (auto results = loop.getLoopResults()) {
+      for (auto [result, iterArg] : llvm::zip(*results, iterArgs)) {
+        changed |= writeSecretness(solver, result,
+                                        lookupSecretness(iterArg, solver));
+      }
+    }
+    return changed;
+  }
+
+  // Other region branches, e.g. scf.if: each result joins the values yielded
+  // for it by the regions.
+  recomputeRegions(op, solver);
+  SmallVector<Secretness> resultSecretness(op->getNumResults());
+  for (Region &region : op->getRegions()) {
+    for (Block &block : region) {
+      if (block.empty() || !block.back().hasTrait<OpTrait::IsTerminator>())
+        continue;
+      Operation *terminator = &block.back();
+      for (auto [i, yielded] : llvm::enumerate(terminator->getOperands())) {
+        if (i >= resultSecretness.size()) break;
+        resultSecretness[i] = Secretness::join(
+            resultSecretness[i], lookupSecretness(yielded, solver));
+      }
+    }
+  }
+  bool changed = false;
+  for (auto [result, secretness] :
+       llvm::zip(op->getResults(), resultSecretness)) {
+    changed |= writeSecretness(solver, result, secretness);
+  }
+  return changed;
+}
+
+}  // namespace
+
+void updateSecretness(Operation *op, DataFlowSolver *solver) {
+  SmallVector<Operation *> worklist = {op};
+  while (!worklist.empty()) {
+    Operation *current = worklist.pop_back_val();
+    // Terminators have no results, but forward their operands to the results
+    // of region branch ops.
+    if (current->hasTrait<OpTrait::IsTerminator>()) {
+      Operation *parent = current->getParentOp();
+      if (parent && isa<RegionBranchOpInterface>(parent)) {
+        worklist.push_back(parent);
+      }
+      continue;
+    }
+    if (!recomputeSecretness(current, solver)) continue;
+    for (Operation *user : current->getUsers()) {
+      worklist.push_back(user);
+    }
+  }
+}
+
+bool setValueToSecretness(DataFlowSolver *solver, Value value,
+                          Secretness secretness) {
+  if (!writeSecretness(solver, value, secretness)) return false;
+  // propagateIfChanged only enqueues the dependents of a state while the
+  // solver runs, so the users are recomputed here instead.
+  for (Operation *user : value.getUsers()) {
+    updateSecretness(user, solver);
+  }
+  return true;
+}
+
+void eraseSecretness(Operation *op, DataFlowSolver *solver) {
+  op->walk([&](Operation *nested) {
+    for (Value result : nested->getResults()) {
+      solver->eraseState(result);
+    }
+    for (Region &region : nested->getRegions()) {
+      for (Block &block : region) {
+        for (BlockArgument arg : block.getArguments()) {
+          solver->eraseState(arg);
+        }
+      }
+    }
+  });
+}
+
+CachedSecretnessAnalysis::CachedSecretnessAnalysis(Operation *op)
+    : status(failure()) {
+  solver.load<dataflow::DeadCodeAnalysis>();
+  solver.load<dataflow::SparseConstantPropagation>();
+  solver.load<SecretnessAnalysis>();
+  status = solver.initializeAndRun(op);
+}
+
 }  // namespace heir
 }  // namespace mlir
@@ -7,7 +7,9 @@
 #include "llvm/include/llvm/ADT/ArrayRef.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlow/SparseAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Builders.h"                 // from @llvm-project
 #include "mlir/include/mlir/IR/Operation.h"                // from @llvm-project
+#include "mlir/include/mlir/IR/PatternMatch.h"             // from @llvm-project
 #include "mlir/include/mlir/IR/Value.h"                    // from @llvm-project
 #include "mlir/include/mlir/IR/ValueRange.h"               // from @llvm-project
 #include "mlir/include/mlir/Interfaces/CallInterfaces.h"   // from @llvm-project
@@ -234,6 +236,84 @@ void getSecretOperands(Operation *op,
                        SmallVectorImpl<OpOperand *> &secretOperands,
                        DataFlowSolver *solver);
 
+// Overwrite the secretness of a value in the solver and, if it changed, call
+// `updateSecretness` on the users of the value. Returns true if the secretness
+// changed.
+bool setValueToSecretness(DataFlowSolver *solver, Value value,
+                          Secretness secretness);
+
+// Recompute the secretness of the results of `op` from the current secretness
+// of its operands, using the same transfer function as SecretnessAnalysis, and
+// propagate any change to the users of the results. Ops with regions also
+// recompute the values defined in their regions.
+//
+// This is meant for passes that rewrite locally, which can keep a solver up to
+// date this way instead of re-running the analysis to a fixpoint after each
+// rewrite.
+void updateSecretness(Operation *op, DataFlowSolver *solver);
+
+// Drop the secretness of the values defined by `op` and by the operations
+// nested in it, so that the solver does not keep states for erased values.
+void eraseSecretness(Operation *op, DataFlowSolver *solver);
+
+// A rewrite listener that keeps a solver up to date as a pattern driver
+// rewrites: it calls `updateSecretness` on every operation that is inserted or
+// modified, and `eraseSecretness` on every operation that is erased.
+class SecretnessUpdateListener : public RewriterBase::Listener {
+ public:
+  explicit SecretnessUpdateListener(DataFlowSolver *solver) : solver(solver) {}
+
+  void notifyOperationInserted(Operation *op,
+                               OpBuilder::InsertPoint previous) override {
+    updateSecretness(op, solver);
+  }
+
+  void notifyOperationModified(Operation *op) override {
+    updateSecretness(op, solver);
+  }
+
+  // The users of `op` are notified as modified once they use the replacement
+  // values, so only the replacement values need to be up to date here.
+  void notifyOperationReplaced(Operation *op, ValueRange replacement) override {
+    for (Value value : replacement) {
+      if (Operation *definingOp = value.getDefiningOp()) {
+        updateSecretness(definingOp, solver);
+      }
+    }
+  }
+
+  void notifyOperationErased(Operation *op) override {
+    eraseSecretness(op, solver);
+  }
+
+ private:
+  DataFlowSolver *solver;
+};
+
+// SecretnessAnalysis run to a fixpoint on an operation, together with the dead
+// code and constant propagation analyses it depends on.
+//
+// Passes that only need secretness get it from their AnalysisManager with
+// `getAnalysis<CachedSecretnessAnalysis>()` instead of running their own
+// solver, so that consecutive passes share a single run. A pass that rewrites
+// the IR keeps the solver up to date (with a SecretnessUpdateListener, or
+// `updateSecretness` for ops it builds by hand) and then marks the analysis
+// preserved; a pass that cannot, e.g. because it uses the dialect conversion
+// driver, leaves it to be recomputed by the next pass that asks for it.
+class CachedSecretnessAnalysis {
+ public:
+  explicit CachedSecretnessAnalysis(Operation *op);
+
+  DataFlowSolver *getSolver() { return &solver; }
+
+  // Whether the analysis ran successfully when it was created.
+  LogicalResult getStatus() const { return status; }
+
+ private:
+  DataFlowSolver solver;
+  LogicalResult status;
+};
+
 }  // namespace heir
 }  // namespace mlir
 
@@ -1,5 +1,6 @@
 #include "lib/Dialect/Arith/Conversions/ArithToCGGIQuart/ArithToCGGIQuart.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
@@ -48,13 +49,14 @@ static lwe::LWECiphertextType convertArithToCGGIType(IntegerType type,
 }
 
 static std::optional<Type> convertArithToCGGIQuartType(IntegerType type,
+                                                       unsigned limbWidth,
                                                        MLIRContext *ctx) {
   auto lweType = lwe::LWECiphertextType::get(
       ctx, lwe::UnspecifiedBitFieldEncodingAttr::get(ctx, maxIntWidth),
       lwe::LWEParamsAttr());
 
   float width = type.getWidth();
-  float realWidth = maxIntWidth >> 1;
+  float realWidth = limbWidth;
 
   uint8_t nbChunks = ceil(width / realWidth);
 
@@ -64,17 +66,18 @@ static std::optional<Type> convertArithToCGGIQuartType(IntegerType type,
 }
 
 static std::optional<Type> convertArithLikeToCGGIQuartType(ShapedType type,
+                                                           unsigned limbWidth,
                                                            MLIRContext *ctx) {
   if (auto arithType = llvm::dyn_cast<IntegerType>(type.getElementType())) {
     float width = arithType.getWidth();
-    float realWidth = maxIntWidth >> 1;
+    float realWidth = limbWidth;
 
     uint8_t nbChunks = ceil(width / realWidth);
 
     if (width > 64) return std::nullopt;
 
     if (arithType.getIntOrFloatBitWidth() == maxIntWidth)
-      return convertArithToCGGIQuartType(arithType, ctx);
+      return convertArithToCGGIQuartType(arithType, limbWidth, ctx);
 
     auto newShape = to_vector(type.getShape());
     newShape.push_back(nbChunks);
@@ -94,16 +97,16 @@ static std::optional<Type> convertArithLikeToCGGIQuartType(ShapedType type,
 
 class ArithToCGGIQuartTypeConverter : public TypeConverter {
  public:
-  ArithToCGGIQuartTypeConverter(MLIRContext *ctx) {
+  ArithToCGGIQuartTypeConverter(MLIRContext *ctx, unsigned limbWidth) {
     addConversion([](Type type) { return type; });
 
     // Convert Integer types to LWE ciphertext types
-    addConversion([ctx](IntegerType type) -> std::optional<Type> {
-      return convertArithToCGGIQuartType(type, ctx);
+    addConversion([ctx, limbWidth](IntegerType type) -> std::optional<Type> {
+      return convertArithToCGGIQuartType(type, limbWidth, ctx);
     });
 
-    addConversion([ctx](ShapedType type) -> std::optional<Type> {
-      return convertArithLikeToCGGIQuartType(type, ctx);
+    addConversion([ctx, limbWidth](ShapedType type) -> std::optional<Type> {
+      return convertArithLikeToCGGIQuartType(type, limbWidth, ctx);
     });
   }
 };
@@ -206,12 +209,225 @@ static Value constructResultTensor(ConversionPatternRewriter &rewriter,
   return resultVec;
 }
 
-struct ConvertQuartConstantOp
-    : public OpConversionPattern<mlir::arith::ConstantOp> {
-  ConvertQuartConstantOp(mlir::MLIRContext *context)
-      : OpConversionPattern<mlir::arith::ConstantOp>(context) {}
+/// A ciphertext summand of a limb position, with an upper bound on its value.
+struct Term {
+  Value value;
+  uint64_t bound;
+};
 
-  using OpConversionPattern::OpConversionPattern;
+/// Emits the limb arithmetic of the quart lowering. Integers are split into
+/// limbs of `limbWidth` bits, least significant first, and each limb is stored
+/// in a ciphertext of `maxIntWidth` bits. Sums and products of limbs use the
+/// extra bits until their carries are propagated, and every carry costs a
+/// programmable bootstrap (a cggi.cast pair for the low bits and a cggi.sshr
+/// for the high bits).
+class LimbEmitter {
+ public:
+  LimbEmitter(ImplicitLocOpBuilder &b, unsigned limbWidth,
+              unsigned karatsubaThreshold)
+      : b(b),
+        limbWidth(limbWidth),
+        karatsubaThreshold(std::max(karatsubaThreshold, 2u)),
+        elemTy(convertArithToCGGIType(
+            IntegerType::get(b.getContext(), maxIntWidth), b.getContext())),
+        limbTy(convertArithToCGGIType(
+            IntegerType::get(b.getContext(), limbWidth), b.getContext())) {}
+
+  uint64_t getLimbMax() const { return (uint64_t{1} << limbWidth) - 1; }
+
+  /// Returns the limbs of `lhs` * `rhs` mod 2^(n * limbWidth), where `lhs` and
+  /// `rhs` have n limbs each.
+  SmallVector<Value> multiply(ArrayRef<Value> lhs, ArrayRef<Value> rhs) {
+    unsigned n = lhs.size();
+    uint64_t productMax = getLimbMax() * getLimbMax();
+    SmallVector<SmallVector<Term>> columns(n);
+    if (coefficientsFit(n)) {
+      SmallVector<Value> coefficients = shortProduct(lhs, rhs);
+      for (unsigned k = 0; k < n; ++k) {
+        columns[k].push_back({coefficients[k], (k + 1) * productMax});
+      }
+    } else {
+      for (unsigned i = 0; i < n; ++i) {
+        for (unsigned j = 0; i + j < n; ++j) {
+          columns[i + j].push_back({mul(lhs[i], rhs[j]), productMax});
+        }
+      }
+    }
+    return propagateCarries(std::move(columns));
+  }
+
+  /// Sums the terms of each limb position and propagates the carry of each
+  /// position to the next one, returning one limb per position. The carry of
+  /// the last position is dropped.
+  ///
+  /// Carries are only extracted from a partial sum when adding the next term
+  /// could overflow the storage, and are then deferred to the next position
+  /// like any other term (carry-save accumulation).
+  SmallVector<Value> propagateCarries(SmallVector<SmallVector<Term>> columns) {
+    SmallVector<Value> limbs;
+    for (unsigned k = 0; k < columns.size(); ++k) {
+      bool hasNext = k + 1 < columns.size();
+      assert(!columns[k].empty() && "expected a term for every limb");
+      std::optional<Term> sum;
+      for (unsigned t = 0; t < columns[k].size(); ++t) {
+        Term term = columns[k][t];
+        while (sum && sum->bound + term.bound > kStorageMax) {
+          Term &larger = sum->bound >= term.bound ? *sum : term;
+          if (auto carry = splitCarry(larger, hasNext)) {
+            columns[k + 1].push_back(*carry);
+          }
+        }
+        sum = sum ? Term{add(sum->value, term.value), sum->bound + term.bound}
+                  : term;
+      }
+      if (auto carry = splitCarry(*sum, hasNext)) {
+        columns[k + 1].push_back(*carry);
+      }
+      limbs.push_back(sum->value);
+    }
+    return limbs;
+  }
+
+ private:
+  static constexpr uint64_t kStorageMax = (uint64_t{1} << maxIntWidth) - 1;
+
+  Value add(Value lhs, Value rhs) {
+    return b.create<cggi::AddOp>(elemTy, lhs, rhs);
+  }
+  Value sub(Value lhs, Value rhs) {
+    return b.create<cggi::SubOp>(elemTy, lhs, rhs);
+  }
+  Value mul(Value lhs, Value rhs) {
+    return b.create<cggi::MulOp>(elemTy, lhs, rhs);
+  }
+
+  /// Replaces `term` by its low `limbWidth` bits, and returns the remaining
+  /// high bits as a term of the next position if `keepCarry` is set.
+  std::optional<Term> splitCarry(Term &term, bool keepCarry) {
+    if (term.bound <= getLimbMax()) return std::nullopt;
+
+    Term full = term;
+    auto low = b.create<cggi::CastOp>(limbTy, full.value);
+    term = {b.create<cggi::CastOp>(elemTy, low), getLimbMax()};
+    if (!keepCarry) return std::nullopt;
+
+    auto shiftAttr = b.getIntegerAttr(b.getIndexType(), limbWidth);
+    Value carry =
+        b.create<cggi::ScalarShiftRightOp>(elemTy, full.value, shiftAttr);
+    return Term{carry, full.bound >> limbWidth};
+  }
+
+  /// Whether the low n coefficients of the product of two n-limb integers fit
+  /// in the storage together with the carries of the lower positions. Only
+  /// then can they be computed as differences, as Karatsuba's algorithm does,
+  /// since the storage wraps around.
+  bool coefficientsFit(unsigned n) const {
+    uint64_t productMax = getLimbMax() * getLimbMax();
+    uint64_t carry = 0;
+    for (unsigned k = 0; k < n; ++k) {
+      uint64_t sum = (k + 1) * productMax + carry;
+      if (sum > kStorageMax) return false;
+      carry = sum >> limbWidth;
+    }
+    return true;
+  }
+
+  /// Adds `values` to the coefficients of `result` starting at `offset`,
+  /// dropping the ones past its end. Null coefficients are zero.
+  void accumulate(SmallVector<Value> &result, unsigned offset,
+                  ArrayRef<Value> values) {
+    for (auto [i, value] : llvm::enumerate(values)) {
+      if (offset + i >= result.size()) break;
+      Value &coefficient = result[offset + i];
+      coefficient = coefficient ? add(coefficient, value) : value;
+    }
+  }
+
+  /// Returns the 2n - 1 coefficients of the product of the polynomials in
+  /// 2^limbWidth with coefficients `lhs` and `rhs`, which both have n limbs.
+  SmallVector<Value> fullProduct(ArrayRef<Value> lhs, ArrayRef<Value> rhs) {
+    unsigned n = lhs.size();
+    SmallVector<Value> result(2 * n - 1);
+    if (n < karatsubaThreshold) {
+      for (unsigned i = 0; i < n; ++i) {
+        for (unsigned j = 0; j < n; ++j) {
+          accumulate(result, i + j, {mul(lhs[i], rhs[j])});
+        }
+      }
+      return result;
+    }
+
+    // With l = l0 + X^m l1 and r = r0 + X^m r1, l * r is
+    // z0 + X^m ((l0 + l1) * (r0 + r1) - z0 - z2) + X^2m z2,
+    // where z0 = l0 * r0 and z2 = l1 * r1.
+    unsigned m = n / 2;
+    SmallVector<Value> z0 = fullProduct(lhs.take_front(m), rhs.take_front(m));
+    SmallVector<Value> z2 = fullProduct(lhs.drop_front(m), rhs.drop_front(m));
+    SmallVector<Value> lhsSum(lhs.drop_front(m));
+    SmallVector<Value> rhsSum(rhs.drop_front(m));
+    accumulate(lhsSum, 0, lhs.take_front(m));
+    accumulate(rhsSum, 0, rhs.take_front(m));
+    SmallVector<Value> z1 = fullProduct(lhsSum, rhsSum);
+    for (auto [i, value] : llvm::enumerate(z0)) z1[i] = sub(z1[i], value);
+    for (auto [i, value] : llvm::enumerate(z2)) z1[i] = sub(z1[i], value);
+
+    accumulate(result, 0, z0);
+    accumulate(result, m, z1);
+    accumulate(result, 2 * m, z2);
+    return result;
+  }
+
+  /// Returns the low n coefficients of the product of the polynomials in
+  /// 2^limbWidth with coefficients `lhs` and `rhs`, which both have n limbs.
+  SmallVector<Value> shortProduct(ArrayRef<Value> lhs, ArrayRef<Value> rhs) {
+    unsigned n = lhs.size();
+    SmallVector<Value> result(n);
+    if (n < karatsubaThreshold) {
+      for (unsigned i = 0; i < n; ++i) {
+        for (unsigned j = 0; i + j < n; ++j) {
+          accumulate(result, i + j, {mul(lhs[i], rhs[j])});
+        }
+      }
+      return result;
+    }
+
+    // With l = l0 + X^m l1 and r = r0 + X^m r1, the low n coefficients of
+    // l * r are the ones of l0 * r0 + X^m (l0 * r1 + l1 * r0), and only the
+    // low n - m coefficients of the two cross products are needed.
+    unsigned m = (n + 1) / 2;
+    unsigned k = n - m;
+    accumulate(result, 0, fullProduct(lhs.take_front(m), rhs.take_front(m)));
+    accumulate(result, m, shortProduct(lhs.take_front(k), rhs.drop_front(m)));
+    accumulate(result, m, shortProduct(lhs.drop_front(m), rhs.take_front(k)));
+    return result;
+  }
+
+  ImplicitLocOpBuilder &b;
+  unsigned limbWidth;
+  unsigned karatsubaThreshold;
+  Type elemTy;
+  Type limbTy;
+};
+
+/// A conversion pattern of the quart lowering, which knows how integers are
+/// split into limbs.
+template <typename SourceOp>
+struct QuartConversionPattern : public OpConversionPattern<SourceOp> {
+  QuartConversionPattern(const TypeConverter &typeConverter,
+                         MLIRContext *context, unsigned limbWidth,
+                         unsigned karatsubaThreshold)
+      : OpConversionPattern<SourceOp>(typeConverter, context),
+        limbWidth(limbWidth),
+        karatsubaThreshold(karatsubaThreshold) {}
+
+ protected:
+  unsigned limbWidth;
+  unsigned karatsubaThreshold;
+};
+
+struct ConvertQuartConstantOp
+    : public QuartConversionPattern<mlir::arith::ConstantOp> {
+  using QuartConversionPattern::QuartConversionPattern;
 
   LogicalResult matchAndRewrite(
       mlir::arith::ConstantOp op, OpAdaptor adaptor,
@@ -223,7 +439,6 @@ struct ConvertQuartConstantOp
 
     Type oldType = op.getType();
     auto newType = getTypeConverter()->convertType<RankedTensorType>(oldType);
-    auto acutalBitWidth = maxIntWidth >> 1;
 
     if (!newType)
       return rewriter.notifyMatchFailure(
@@ -235,11 +450,12 @@ struct ConvertQuartConstantOp
     SmallVector<Value, 1> newTrivialOps;
 
     if (auto intAttr = dyn_cast<IntegerAttr>(oldValue)) {
+      // The last limb may have fewer bits than the others.
+      APInt value = intAttr.getValue().zext(nbChunks * limbWidth);
       for (uint8_t i = 0; i < nbChunks; i++) {
-        APInt intChunck =
-            intAttr.getValue().extractBits(acutalBitWidth, i * acutalBitWidth);
+        APInt intChunck = value.extractBits(limbWidth, i * limbWidth);
 
-        auto encrypt = createTrivialOpMaxWidth(b, intChunck.getSExtValue());
+        auto encrypt = createTrivialOpMaxWidth(b, intChunck.getZExtValue());
         newTrivialOps.push_back(encrypt);
       }
 
@@ -287,8 +503,8 @@ struct ConvertQuartTruncIOp
 };
 
 template <typename ArithExtOp>
-struct ConvertQuartExt final : OpConversionPattern<ArithExtOp> {
-  using OpConversionPattern<ArithExtOp>::OpConversionPattern;
+struct ConvertQuartExt final : QuartConversionPattern<ArithExtOp> {
+  using QuartConversionPattern<ArithExtOp>::QuartConversionPattern;
 
   // Since each type inside the program is a tensor with 4 elements, we can
   // simply return the input tensor as the result. The generated code will later
@@ -301,11 +517,11 @@ struct ConvertQuartExt final : OpConversionPattern<ArithExtOp> {
 
     auto newResultTy = cast<ShapedType>(
         convertArithToCGGIQuartType(cast<IntegerType>(op.getResult().getType()),
-                                    op.getContext())
+                                    this->limbWidth, op.getContext())
             .value());
     auto newInTy = cast<ShapedType>(
         convertArithToCGGIQuartType(cast<IntegerType>(op.getIn().getType()),
-                                    op.getContext())
+                                    this->limbWidth, op.getContext())
             .value());
 
     auto resultChunks = newResultTy.getShape().back();
@@ -329,8 +545,8 @@ struct ConvertQuartExt final : OpConversionPattern<ArithExtOp> {
   }
 };
 
-struct ConvertQuartAddI final : OpConversionPattern<mlir::arith::AddIOp> {
-  using OpConversionPattern::OpConversionPattern;
+struct ConvertQuartAddI final : QuartConversionPattern<mlir::arith::AddIOp> {
+  using QuartConversionPattern::QuartConversionPattern;
 
   LogicalResult matchAndRewrite(
       mlir::arith::AddIOp op, OpAdaptor adaptor,
@@ -351,40 +567,13 @@ struct ConvertQuartAddI final : OpConversionPattern<mlir::arith::AddIOp> {
 
     assert(splitLhs.size() == splitRhs.size() && "Mismatched tensor sizes");
 
-    // Actual type of the underlying elements; we use half the width.
-    // Create Constant
-    auto shiftAttr =
-        IntegerAttr::get(rewriter.getIndexType(), maxIntWidth >> 1);
-
-    auto elemType = convertArithToCGGIType(
-        IntegerType::get(op->getContext(), maxIntWidth), op->getContext());
-    auto realTy = convertArithToCGGIType(
-        IntegerType::get(op->getContext(), maxIntWidth >> 1), op->getContext());
-
-    SmallVector<Value> carries;
-    SmallVector<Value> outputs;
-
-    for (int i = 0; i < splitLhs.size(); ++i) {
-      auto lowSum = b.create<cggi::AddOp>(elemType, splitLhs[i], splitRhs[i]);
-      auto outputLsb = b.create<cggi::CastOp>(op.getLoc(), realTy, lowSum);
-      auto outputLsbHigh =
-          b.create<cggi::CastOp>(op.getLoc(), elemType, outputLsb);
-
-      // Now all the outputs are 16b elements, wants presentation of 4x8b
-      if (i != splitLhs.size() - 1) {
-        auto carry =
-            b.create<cggi::ScalarShiftRightOp>(elemType, lowSum, shiftAttr);
-        carries.push_back(carry);
-      }
-
-      if (i == 0) {
-        outputs.push_back(outputLsbHigh);
-      } else {
-        auto high =
-            b.create<cggi::AddOp>(elemType, outputLsbHigh, carries[i - 1]);
-        outputs.push_back(high);
-      }
+    LimbEmitter emitter(b, limbWidth, karatsubaThreshold);
+    SmallVector<SmallVector<Term>> columns;
+    for (auto [lhs, rhs] : llvm::zip(splitLhs, splitRhs)) {
+      columns.push_back(
+          {{lhs, emitter.getLimbMax()}, {rhs, emitter.getLimbMax()}});
     }
+    SmallVector<Value> outputs = emitter.propagateCarries(std::move(columns));
 
     Value resultVec = constructResultTensor(rewriter, loc, newTy, outputs);
     rewriter.replaceOp(op, resultVec);
@@ -392,10 +581,11 @@ struct ConvertQuartAddI final : OpConversionPattern<mlir::arith::AddIOp> {
   }
 };
 
-// Implemented using the Karatsuba algorithm
+// Computes the low half of the limb product with Karatsuba's algorithm when
+// possible, see LimbEmitter::multiply.
 // https://en.wikipedia.org/wiki/Karatsuba_algorithm#Algorithm
-struct ConvertQuartMulI final : OpConversionPattern<mlir::arith::MulIOp> {
-  using OpConversionPattern::OpConversionPattern;
+struct ConvertQuartMulI final : QuartConversionPattern<mlir::arith::MulIOp> {
+  using QuartConversionPattern::QuartConversionPattern;
 
   LogicalResult matchAndRewrite(
       mlir::arith::MulIOp op, OpAdaptor adaptor,
@@ -408,92 +598,37 @@ struct ConvertQuartMulI final : OpConversionPattern<mlir::arith::MulIOp> {
     if (!newTy)
       return rewriter.notifyMatchFailure(
           loc, llvm::formatv("unsupported type: {0}", op.getType()));
-    if (newTy.getShape().back() != 4)
-      return rewriter.notifyMatchFailure(
-          loc, llvm::formatv("Mul only support 4 split elements. Shape: {0}",
-                             newTy));
-
-    auto elemTy = convertArithToCGGIType(
-        IntegerType::get(op->getContext(), maxIntWidth), op->getContext());
-    auto realTy = convertArithToCGGIType(
-        IntegerType::get(op->getContext(), maxIntWidth >> 1), op->getContext());
-
-    // Create Constant
-    auto shiftAttr =
-        rewriter.getIntegerAttr(b.getIndexType(), maxIntWidth >> 1);
 
     SmallVector<Value> splitLhs =
         extractLastDimHalves(rewriter, loc, adaptor.getLhs());
     SmallVector<Value> splitRhs =
         extractLastDimHalves(rewriter, loc, adaptor.getRhs());
 
-    // TODO: Implement the real Karatsuba algorithm for 4x4 multiplication.
-    // First part of Karatsuba algorithm
-    auto z00 = b.create<cggi::MulOp>(elemTy, splitLhs[0], splitRhs[0]);
-    auto z02 = b.create<cggi::MulOp>(elemTy, splitLhs[1], splitRhs[1]);
-    auto z01_p1 = b.create<cggi::AddOp>(elemTy, splitLhs[0], splitLhs[1]);
-    auto z01_p2 = b.create<cggi::AddOp>(elemTy, splitRhs[0], splitRhs[1]);
-    auto z01_m = b.create<cggi::MulOp>(elemTy, z01_p1, z01_p2);
-    auto z01_s = b.create<cggi::SubOp>(elemTy, z01_m, z00);
-    auto z01 = b.create<cggi::SubOp>(elemTy, z01_s, z02);
-
-    // Second part I of Karatsuba algorithm
-    auto z1a0 = b.create<cggi::MulOp>(elemTy, splitLhs[0], splitRhs[2]);
-    auto z1a2 = b.create<cggi::MulOp>(elemTy, splitLhs[1], splitRhs[3]);
-    auto z1a1_p1 = b.create<cggi::AddOp>(elemTy, splitLhs[0], splitLhs[1]);
-    auto z1a1_p2 = b.create<cggi::AddOp>(elemTy, splitRhs[2], splitRhs[3]);
-    auto z1a1_m = b.create<cggi::MulOp>(elemTy, z1a1_p1, z1a1_p2);
-    auto z1a1_s = b.create<cggi::SubOp>(elemTy, z1a1_m, z1a0);
-    auto z1a1 = b.create<cggi::SubOp>(elemTy, z1a1_s, z1a2);
-
-    // Second part II of Karatsuba algorithm
-    auto z1b0 = b.create<cggi::MulOp>(elemTy, splitLhs[2], splitRhs[0]);
-    auto z1b2 = b.create<cggi::MulOp>(elemTy, splitLhs[3], splitRhs[1]);
-    auto z1b1_p1 = b.create<cggi::AddOp>(elemTy, splitLhs[2], splitLhs[3]);
-    auto z1b1_p2 = b.create<cggi::AddOp>(elemTy, splitRhs[0], splitRhs[1]);
-    auto z1b1_m = b.create<cggi::MulOp>(elemTy, z1b1_p1, z1b1_p2);
-    auto z1b1_s = b.create<cggi::SubOp>(elemTy, z1b1_m, z1b0);
-    auto z1b1 = b.create<cggi::SubOp>(elemTy, z1b1_s, z1b2);
-
-    auto out2Kara = b.create<cggi::AddOp>(elemTy, z1a0, z1b0);
-    auto out2Carry = b.create<cggi::AddOp>(elemTy, out2Kara, z02);
-    auto out3Carry = b.create<cggi::AddOp>(elemTy, z1a1, z1b1);
-
-    // Output are now all 16b elements, wants presentation of 4x8b
-    auto output0Lsb = b.create<cggi::CastOp>(realTy, z00);
-    auto output0LsbHigh = b.create<cggi::CastOp>(elemTy, output0Lsb);
-    auto output0Msb =
-        b.create<cggi::ScalarShiftRightOp>(elemTy, z00, shiftAttr);
-
-    auto output1Lsb = b.create<cggi::CastOp>(realTy, z01);
-    auto output1LsbHigh = b.create<cggi::CastOp>(elemTy, output1Lsb);
-    auto output1Msb =
-        b.create<cggi::ScalarShiftRightOp>(elemTy, z01, shiftAttr);
-
-    auto output2Lsb = b.create<cggi::CastOp>(realTy, out2Carry);
-    auto output2LsbHigh = b.create<cggi::CastOp>(elemTy, output2Lsb);
-    auto output2Msb =
-        b.create<cggi::ScalarShiftRightOp>(elemTy, out2Carry, shiftAttr);
-
-    auto output3Lsb = b.create<cggi::CastOp>(realTy, out3Carry);
-    auto output3LsbHigh = b.create<cggi::CastOp>(elemTy, output3Lsb);
-
-    auto output1 = b.create<cggi::AddOp>(elemTy, output1LsbHigh, output0Msb);
-    auto output2 = b.create<cggi::AddOp>(elemTy, output2LsbHigh, output1Msb);
-    auto output3 = b.create<cggi::AddOp>(elemTy, output3LsbHigh, output2Msb);
-
-    Value resultVec = constructResultTensor(
-        rewriter, loc, newTy, {output0LsbHigh, output1, output2, output3});
+    assert(splitLhs.size() == splitRhs.size() && "Mismatched tensor sizes");
+
+    LimbEmitter emitter(b, limbWidth, karatsubaThreshold);
+    SmallVector<Value> outputs = emitter.multiply(splitLhs, splitRhs);
+
+    Value resultVec = constructResultTensor(rewriter, loc, newTy, outputs);
     rewriter.replaceOp(op, resultVec);
     return success();
   }
 };
 
 struct ArithToCGGIQuart : public impl::ArithToCGGIQuartBase<ArithToCGGIQuart> {
+  using ArithToCGGIQuartBase::ArithToCGGIQuartBase;
+
   void runOnOperation() override {
     MLIRContext *context = &getContext();
     auto *module = getOperation();
-    ArithToCGGIQuartTypeConverter typeConverter(context);
+
+    if (limbWidth == 0 || limbWidth > maxIntWidth / 2) {
+      module->emitError() << "limb-width must be between 1 and "
+                          << maxIntWidth / 2;
+      return signalPassFailure();
+    }
+
+    ArithToCGGIQuartTypeConverter typeConverter(context, limbWidth);
 
     RewritePatternSet patterns(context);
     ConversionTarget target(*context);
@@ -522,15 +657,17 @@ struct ArithToCGGIQuart : public impl::ArithToCGGIQuartBase<ArithToCGGIQuart> {
           return isa<IndexType>(op.getValue().getType());
         });
 
-    patterns
-        .add<ConvertQuartConstantOp, ConvertQuartExt<mlir::arith::ExtUIOp>,
-             ConvertQuartExt<mlir::arith::ExtSIOp>, ConvertQuartAddI,
-             ConvertQuartMulI, ConvertAny<memref::LoadOp>,
-             ConvertAny<memref::AllocOp>, ConvertAny<memref::DeallocOp>,
-             ConvertAny<memref::StoreOp>, ConvertAny<memref::SubViewOp>,
-             ConvertAny<memref::CopyOp>, ConvertAny<tensor::FromElementsOp>,
-             ConvertAny<tensor::ExtractOp>, ConvertAny<affine::AffineStoreOp>,
-             ConvertAny<affine::AffineLoadOp>>(typeConverter, context);
+    patterns.add<ConvertQuartConstantOp, ConvertQuartExt<mlir::arith::ExtUIOp>,
+                 ConvertQuartExt<mlir::arith::ExtSIOp>, ConvertQuartAddI,
+                 ConvertQuartMulI>(typeConverter, context, limbWidth,
+                                   karatsubaThreshold);
+    patterns.add<ConvertAny<memref::LoadOp>, ConvertAny<memref::AllocOp>,
+                 ConvertAny<memref::DeallocOp>, ConvertAny<memref::StoreOp>,
+                 ConvertAny<memref::SubViewOp>, ConvertAny<memref::CopyOp>,
+                 ConvertAny<tensor::FromElementsOp>,
+                 ConvertAny<tensor::ExtractOp>,
+                 ConvertAny<affine::AffineStoreOp>,
+                 ConvertAny<affine::AffineLoadOp>>(typeConverter, context);
 
     addStructuralConversionPatterns(typeConverter, patterns, target);
 
@@ -542,6 +679,15 @@ struct ArithToCGGIQuart : public impl::ArithToCGGIQuartBase<ArithToCGGIQuart> {
     OpPassManager pipeline("builtin.module");
     pipeline.addPass(createCSEPass());
     (void)runPipeline(pipeline, getOperation());
+
+    module->walk([&](Operation *op) {
+      if (isa<cggi::MulOp>(op)) {
+        ++numMulOps;
+        ++numBootstrapOps;
+      } else if (isa<cggi::CastOp, cggi::ScalarShiftRightOp>(op)) {
+        ++numBootstrapOps;
+      }
+    });
   }
 };
 
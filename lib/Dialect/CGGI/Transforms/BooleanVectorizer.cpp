@@ -7,6 +7,7 @@
 #include "lib/Dialect/CGGI/IR/CGGIAttributes.h"
 #include "lib/Dialect/CGGI/IR/CGGIEnums.h"
 #include "lib/Dialect/CGGI/IR/CGGIOps.h"
+#include "lib/Utils/Graph/CSRGraph.h"
 #include "lib/Utils/Graph/Graph.h"
 #include "llvm/include/llvm/ADT/STLExtras.h"           // from @llvm-project
 #include "llvm/include/llvm/ADT/SmallVector.h"         // from @llvm-project
@@ -211,7 +212,7 @@ bool tryBoolVectorizeBlock(Block *block, MLIRContext &context,
     return false;
   }
 
-  auto result = graph.sortGraphByLevels();
+  auto result = graph::CSRGraph<Operation *>(graph).sortGraphByLevels();
   assert(succeeded(result) &&
          "Only possible failure is a cycle in the SSA graph!");
   auto levels = result.value();
@@ -0,0 +1,18 @@
+#ifndef LIB_DIALECT_JAXITE_TRANSFORMS_PASSES_H_
+#define LIB_DIALECT_JAXITE_TRANSFORMS_PASSES_H_
+
+#include "lib/Dialect/Jaxite/IR/JaxiteDialect.h"
+#include "lib/Dialect/Jaxite/Transforms/PmapLut3.h"
+
+namespace mlir {
+namespace heir {
+namespace jaxite {
+
+#define GEN_PASS_REGISTRATION
+#include "lib/Dialect/Jaxite/Transforms/Passes.h.inc"
+
+}  // namespace jaxite
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_DIALECT_JAXITE_TRANSFORMS_PASSES_H_
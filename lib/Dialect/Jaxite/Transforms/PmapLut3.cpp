@@ -0,0 +1,195 @@
+#include "lib/Dialect/Jaxite/Transforms/PmapLut3.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+
+#include "lib/Dialect/Jaxite/IR/JaxiteOps.h"
+#include "lib/Dialect/Jaxite/IR/JaxiteTypes.h"
+#include "llvm/include/llvm/ADT/DenseMap.h"              // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/SetVector.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"           // from @llvm-project
+#include "llvm/include/llvm/Support/Debug.h"             // from @llvm-project
+#include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
+#include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Block.h"                  // from @llvm-project
+#include "mlir/include/mlir/IR/Builders.h"               // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/Matchers.h"               // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                  // from @llvm-project
+#include "mlir/include/mlir/IR/Visitors.h"               // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"              // from @llvm-project
+#include "mlir/include/mlir/Transforms/RegionUtils.h"    // from @llvm-project
+
+#define DEBUG_TYPE "jaxite-pmap-lut3"
+
+namespace mlir {
+namespace heir {
+namespace jaxite {
+
+#define GEN_PASS_DEF_PMAPLUT3
+#include "lib/Dialect/Jaxite/Transforms/Passes.h.inc"
+
+namespace {
+
+// The jaxite.lut3 ops of one level are grouped by server key set, parameters
+// and ciphertext type, since a jaxite.pmap_lut3 op has a single one of each.
+using GroupKey = std::tuple<Value, Value, Type>;
+
+// A group of jaxite.lut3 ops to be replaced by one jaxite.pmap_lut3 op, which
+// is placed right before the last op of the group.
+struct Bucket {
+  SmallVector<Lut3Op> ops;
+  // The first op in the block that uses a result of `ops`. No op after it can
+  // join the bucket without moving its users.
+  Operation *firstUser = nullptr;
+};
+
+// Returns the jaxite.lut3 ops of `block` by level, each in block order, where
+// an op only depends on ops of lower levels.
+SmallVector<SmallVector<Lut3Op>> levelLut3Ops(Block *block) {
+  // The number of jaxite.lut3 ops on the longest path to a value
+  DenseMap<Value, int> depth;
+  auto getDepth = [&](Value value) { return depth.lookup(value); };
+
+  SmallVector<SmallVector<Lut3Op>> levels;
+  for (Operation &op : block->getOperations()) {
+    int inputDepth = 0;
+    for (Value operand : op.getOperands()) {
+      inputDepth = std::max(inputDepth, getDepth(operand));
+    }
+    if (op.getNumRegions() > 0) {
+      SetVector<Value> captured;
+      getUsedValuesDefinedAbove(op.getRegions(), captured);
+      for (Value value : captured) {
+        inputDepth = std::max(inputDepth, getDepth(value));
+      }
+    }
+
+    int outputDepth = inputDepth;
+    if (auto lut3Op = dyn_cast<Lut3Op>(op)) {
+      if (static_cast<int>(levels.size()) <= inputDepth) {
+        levels.resize(inputDepth + 1);
+      }
+      levels[inputDepth].push_back(lut3Op);
+      outputDepth = inputDepth + 1;
+    }
+    if (outputDepth > 0) {
+      for (Value result : op.getResults()) {
+        depth[result] = outputDepth;
+      }
+    }
+  }
+  return levels;
+}
+
+// Returns the first op of `block` that uses the result of `op`, if any.
+Operation *getFirstUser(Block *block, Lut3Op op) {
+  Operation *firstUser = nullptr;
+  for (Operation *user : op->getUsers()) {
+    Operation *ancestor = block->findAncestorOpInBlock(*user);
+    if (ancestor && (!firstUser || ancestor->isBeforeInBlock(firstUser))) {
+      firstUser = ancestor;
+    }
+  }
+  return firstUser;
+}
+
+// Splits the ops of one level into buckets of at most `parallelism` ops. The
+// ops are not reordered with respect to the rest of the block, so an op only
+// joins a bucket if no result of the bucket is used before it.
+SmallVector<Bucket> bucketLevel(Block *block, ArrayRef<Lut3Op> level,
+                                int parallelism) {
+  SmallVector<Bucket> buckets;
+  DenseMap<GroupKey, int> openBucket;
+  for (Lut3Op op : level) {
+    // The emitter reads the truth tables of jaxite.lut3_args from constants
+    if (!matchPattern(op.getTruthTable(), m_Constant())) continue;
+
+    GroupKey key{op.getServerKeySet(), op.getParams(),
+                 op.getOutput().getType()};
+    auto it = openBucket.find(key);
+    bool canJoin = it != openBucket.end();
+    if (canJoin) {
+      Bucket &bucket = buckets[it->second];
+      bool isFull = parallelism > 0 &&
+                    static_cast<int>(bucket.ops.size()) >= parallelism;
+      canJoin = !isFull &&
+                (!bucket.firstUser || op->isBeforeInBlock(bucket.firstUser));
+    }
+    if (!canJoin) {
+      openBucket[key] = buckets.size();
+      buckets.emplace_back();
+    }
+
+    Bucket &bucket = buckets[openBucket[key]];
+    bucket.ops.push_back(op);
+    Operation *firstUser = getFirstUser(block, op);
+    if (firstUser &&
+        (!bucket.firstUser || firstUser->isBeforeInBlock(bucket.firstUser))) {
+      bucket.firstUser = firstUser;
+    }
+  }
+  return buckets;
+}
+
+void replaceWithPmapLut3(ArrayRef<Lut3Op> ops) {
+  Lut3Op last = ops.back();
+  OpBuilder builder(last);
+
+  SmallVector<Value> lut3Args;
+  for (Lut3Op op : ops) {
+    auto lut3ArgsOp = builder.create<Lut3ArgsOp>(
+        op.getLoc(), op.getA(), op.getB(), op.getC(), op.getTruthTable());
+    lut3Args.push_back(lut3ArgsOp.getResult());
+  }
+  auto fromElementsOp =
+      builder.create<tensor::FromElementsOp>(last.getLoc(), lut3Args);
+
+  auto resultType = RankedTensorType::get(
+      {static_cast<int64_t>(ops.size())}, last.getOutput().getType());
+  auto pmapLut3Op = builder.create<PmapLut3Op>(
+      last.getLoc(), resultType, fromElementsOp.getResult(),
+      last.getServerKeySet(), last.getParams());
+
+  for (auto [index, op] : llvm::enumerate(ops)) {
+    auto extractionIndex = builder.create<arith::ConstantOp>(
+        op.getLoc(), builder.getIndexAttr(index));
+    auto extractOp = builder.create<tensor::ExtractOp>(
+        op.getLoc(), pmapLut3Op.getResult(), extractionIndex.getResult());
+    op.replaceAllUsesWith(extractOp.getResult());
+    op.erase();
+  }
+}
+
+}  // namespace
+
+struct PmapLut3 : impl::PmapLut3Base<PmapLut3> {
+  using PmapLut3Base::PmapLut3Base;
+
+  void runOnOperation() override {
+    SmallVector<Block *> blocks;
+    getOperation()->walk([&](Block *block) { blocks.push_back(block); });
+
+    for (Block *block : blocks) {
+      SmallVector<SmallVector<Lut3Op>> levels = levelLut3Ops(block);
+      LLVM_DEBUG(llvm::dbgs() << "Found " << levels.size()
+                              << " levels of jaxite.lut3 ops\n");
+
+      for (const auto &level : levels) {
+        for (const Bucket &bucket : bucketLevel(block, level, parallelism)) {
+          if (bucket.ops.size() < 2) continue;
+          replaceWithPmapLut3(bucket.ops);
+          ++numPmapLut3Ops;
+          numGroupedLut3Ops += bucket.ops.size();
+        }
+      }
+    }
+  }
+};
+
+}  // namespace jaxite
+}  // namespace heir
+}  // namespace mlir
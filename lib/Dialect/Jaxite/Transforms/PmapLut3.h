@@ -0,0 +1,17 @@
+#ifndef LIB_DIALECT_JAXITE_TRANSFORMS_PMAPLUT3_H_
+#define LIB_DIALECT_JAXITE_TRANSFORMS_PMAPLUT3_H_
+
+#include "mlir/include/mlir/Pass/Pass.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace jaxite {
+
+#define GEN_PASS_DECL_PMAPLUT3
+#include "lib/Dialect/Jaxite/Transforms/Passes.h.inc"
+
+}  // namespace jaxite
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_DIALECT_JAXITE_TRANSFORMS_PMAPLUT3_H_
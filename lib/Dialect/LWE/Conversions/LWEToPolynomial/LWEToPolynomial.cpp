@@ -1,31 +1,50 @@
 #include "lib/Dialect/LWE/Conversions/LWEToPolynomial/LWEToPolynomial.h"
 
+#include <cstdint>
+#include <optional>
+#include <type_traits>
 #include <utility>
 
+#include "lib/Dialect/BGV/IR/BGVOps.h"
+#include "lib/Dialect/CKKS/IR/CKKSOps.h"
 #include "lib/Dialect/LWE/IR/LWEAttributes.h"
 #include "lib/Dialect/LWE/IR/LWEOps.h"
 #include "lib/Dialect/LWE/IR/LWETypes.h"
+#include "lib/Dialect/ModArith/IR/ModArithDialect.h"
 #include "lib/Dialect/ModArith/IR/ModArithOps.h"
 #include "lib/Dialect/ModArith/IR/ModArithTypes.h"
 #include "lib/Dialect/Polynomial/IR/PolynomialAttributes.h"
+#include "lib/Dialect/Polynomial/IR/PolynomialDialect.h"
 #include "lib/Dialect/Polynomial/IR/PolynomialOps.h"
 #include "lib/Dialect/Polynomial/IR/PolynomialTypes.h"
+#include "lib/Dialect/RNS/IR/RNSTypes.h"
+#include "lib/Dialect/Random/IR/RandomDialect.h"
 #include "lib/Dialect/Random/IR/RandomEnums.h"
 #include "lib/Dialect/Random/IR/RandomOps.h"
 #include "lib/Dialect/Random/IR/RandomTypes.h"
+#include "lib/Utils/APIntUtils.h"
 #include "lib/Utils/ConversionUtils.h"
 #include "lib/Utils/Polynomial/Polynomial.h"
+#include "llvm/include/llvm/ADT/APInt.h"                 // from @llvm-project
 #include "llvm/include/llvm/ADT/ArrayRef.h"              // from @llvm-project
+#include "llvm/include/llvm/ADT/MapVector.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/SetVector.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"           // from @llvm-project
 #include "llvm/include/llvm/ADT/TypeSwitch.h"            // from @llvm-project
 #include "llvm/include/llvm/Support/ErrorHandling.h"     // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
+#include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"   // from @llvm-project
 #include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Builders.h"               // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinAttributes.h"      // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinOps.h"             // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinTypes.h"           // from @llvm-project
 #include "mlir/include/mlir/IR/ImplicitLocOpBuilder.h"   // from @llvm-project
 #include "mlir/include/mlir/IR/PatternMatch.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/SymbolTable.h"            // from @llvm-project
 #include "mlir/include/mlir/IR/ValueRange.h"             // from @llvm-project
+#include "mlir/include/mlir/IR/Visitors.h"               // from @llvm-project
 #include "mlir/include/mlir/Support/LLVM.h"              // from @llvm-project
 #include "mlir/include/mlir/Support/LogicalResult.h"     // from @llvm-project
 #include "mlir/include/mlir/Transforms/DialectConversion.h"  // from @llvm-project
@@ -35,6 +54,23 @@ namespace mlir::heir::lwe {
 #define GEN_PASS_DEF_LWETOPOLYNOMIAL
 #include "lib/Dialect/LWE/Conversions/LWEToPolynomial/LWEToPolynomial.h.inc"
 
+// The name of the function argument attribute listing what each key in a
+// tensor of key switching keys switches from.
+static constexpr StringRef kKeySwitchingKeysAttrName = "lwe.key_switching_keys";
+
+// The key id of the relinearization key in `lwe.key_switching_keys`. Rotation
+// keys use their Galois element as id, which is always odd.
+static constexpr int64_t kRelinearizationKeyId = 0;
+
+// Replaces an RNS coefficient type with a single limb by the type of that
+// limb, so that single-modulus RNS rings lower like `mod_arith` rings.
+static polynomial::RingAttr normalizeRing(polynomial::RingAttr ring) {
+  auto rnsType = dyn_cast<rns::RNSType>(ring.getCoefficientType());
+  if (!rnsType || rnsType.getBasisTypes().size() != 1) return ring;
+  return polynomial::RingAttr::get(rnsType.getBasisTypes().front(),
+                                   ring.getPolynomialModulus());
+}
+
 class CiphertextTypeConverter : public TypeConverter {
  public:
   // Convert ciphertext to tensor<#dim x !poly.poly<#rings[#level]>>
@@ -46,25 +82,25 @@ class CiphertextTypeConverter : public TypeConverter {
   CiphertextTypeConverter(MLIRContext *ctx) {
     addConversion([](Type type) { return type; });
     addConversion([ctx](lwe::NewLWECiphertextType type) -> Type {
-      auto ring = type.getCiphertextSpace().getRing();
+      auto ring = normalizeRing(type.getCiphertextSpace().getRing());
       auto polyTy = ::mlir::heir::polynomial::PolynomialType::get(ctx, ring);
 
       return RankedTensorType::get({type.getCiphertextSpace().getSize()},
                                    polyTy);
     });
     addConversion([ctx](lwe::NewLWEPlaintextType type) -> Type {
-      auto ring = type.getPlaintextSpace().getRing();
+      auto ring = normalizeRing(type.getPlaintextSpace().getRing());
       auto polyTy = ::mlir::heir::polynomial::PolynomialType::get(ctx, ring);
       return polyTy;
     });
     addConversion([ctx](lwe::NewLWESecretKeyType type) -> Type {
-      auto ring = type.getRing();
+      auto ring = normalizeRing(type.getRing());
       auto polyTy = ::mlir::heir::polynomial::PolynomialType::get(ctx, ring);
 
       return RankedTensorType::get({2}, polyTy);
     });
     addConversion([ctx](lwe::NewLWEPublicKeyType type) -> Type {
-      auto ring = type.getRing();
+      auto ring = normalizeRing(type.getRing());
       auto polyTy = ::mlir::heir::polynomial::PolynomialType::get(ctx, ring);
 
       return RankedTensorType::get({2}, polyTy);
@@ -467,27 +503,611 @@ struct ConvertRMul : public OpConversionPattern<RMulOp> {
   }
 };
 
+namespace {
+
+int64_t getRingDegree(polynomial::RingAttr ring) {
+  return ring.getPolynomialModulus().getPolynomial().getDegree();
+}
+
+polynomial::PolynomialType getPolynomialType(Value ciphertext) {
+  return cast<polynomial::PolynomialType>(
+      cast<RankedTensorType>(ciphertext.getType()).getElementType());
+}
+
+FailureOr<mod_arith::ModArithType> getModArithCoefficientType(
+    Operation *op, polynomial::PolynomialType polyType) {
+  auto modArithType = dyn_cast<mod_arith::ModArithType>(
+      polyType.getRing().getCoefficientType());
+  if (!modArithType) {
+    // TODO(#1199): support RNS lowering
+    return op->emitOpError()
+           << "requires a single-modulus ciphertext ring, got " << polyType;
+  }
+  return modArithType;
+}
+
+uint64_t getModulus(mod_arith::ModArithType type) {
+  return type.getModulus().getValue().getZExtValue();
+}
+
+// The number of digits of base 2^digitBits needed to represent integers mod
+// the modulus of `type`.
+int64_t getNumDigits(mod_arith::ModArithType type, int64_t digitBits) {
+  int64_t bits = type.getModulus().getValue().getActiveBits();
+  return (bits + digitBits - 1) / digitBits;
+}
+
+// The Galois element 5^offset mod 2N of a rotation by `offset` slots.
+int64_t getGaloisElement(int64_t offset, int64_t degree) {
+  int64_t order = degree / 2;
+  int64_t exponent = ((offset % order) + order) % order;
+  int64_t modulus = 2 * degree;
+  int64_t element = 1;
+  int64_t base = 5 % modulus;
+  for (; exponent > 0; exponent >>= 1) {
+    if (exponent & 1) element = (element * base) % modulus;
+    base = (base * base) % modulus;
+  }
+  return element;
+}
+
+Value extractPolynomial(ImplicitLocOpBuilder &b, Value ciphertext,
+                        int64_t index) {
+  auto indexValue = b.create<arith::ConstantIndexOp>(index);
+  return b.create<tensor::ExtractOp>(ciphertext, ValueRange{indexValue});
+}
+
+Value splat(ImplicitLocOpBuilder &b, RankedTensorType type, uint64_t value) {
+  APInt apValue(type.getElementTypeBitWidth(), value);
+  return b.create<arith::ConstantOp>(
+      type, DenseElementsAttr::get(type, ArrayRef<APInt>(apValue)));
+}
+
+// Returns the coefficients of `poly` as a tensor of integers in [0, q).
+Value toCanonicalIntegers(ImplicitLocOpBuilder &b, Value poly) {
+  auto polyType = cast<polynomial::PolynomialType>(poly.getType());
+  auto modArithType =
+      cast<mod_arith::ModArithType>(polyType.getRing().getCoefficientType());
+  int64_t degree = getRingDegree(polyType.getRing());
+  auto modArithTensorType = RankedTensorType::get({degree}, modArithType);
+  auto intTensorType =
+      RankedTensorType::get({degree}, modArithType.getModulus().getType());
+  auto coeffs = b.create<polynomial::ToTensorOp>(modArithTensorType, poly);
+  auto reduced = b.create<mod_arith::ReduceOp>(modArithTensorType, coeffs);
+  return b.create<mod_arith::ExtractOp>(intTensorType, reduced);
+}
+
+// Returns the polynomial of type `polyType` with coefficients `ints`, which
+// must lie in [0, q) for the modulus q of `polyType`.
+Value fromCanonicalIntegers(ImplicitLocOpBuilder &b, Value ints,
+                            polynomial::PolynomialType polyType) {
+  auto modArithType =
+      cast<mod_arith::ModArithType>(polyType.getRing().getCoefficientType());
+  auto intTensorType = cast<RankedTensorType>(ints.getType());
+  Type storageType = modArithType.getModulus().getType();
+  auto storageTensorType = intTensorType.clone(storageType);
+  unsigned width = intTensorType.getElementTypeBitWidth();
+  unsigned storageWidth = storageType.getIntOrFloatBitWidth();
+  if (storageWidth < width) {
+    ints = b.create<arith::TruncIOp>(storageTensorType, ints);
+  } else if (storageWidth > width) {
+    ints = b.create<arith::ExtUIOp>(storageTensorType, ints);
+  }
+  auto encapsulated = b.create<mod_arith::EncapsulateOp>(
+      storageTensorType.clone(modArithType), ints);
+  return b.create<polynomial::FromTensorOp>(polyType, encapsulated);
+}
+
+// Applies the Galois automorphism X -> X^galoisElement to a polynomial in
+// Z_q[X]/(X^N + 1). Coefficient i moves to i * galoisElement mod 2N, and is
+// negated if that is at least N, so the automorphism is a signed permutation
+// of the coefficients with compile-time indices and signs.
+Value applyAutomorphism(ImplicitLocOpBuilder &b, Value poly,
+                        int64_t galoisElement) {
+  auto polyType = cast<polynomial::PolynomialType>(poly.getType());
+  auto modArithType =
+      cast<mod_arith::ModArithType>(polyType.getRing().getCoefficientType());
+  int64_t degree = getRingDegree(polyType.getRing());
+
+  SmallVector<int64_t> sources(degree);
+  SmallVector<bool> negate(degree);
+  for (int64_t i = 0; i < degree; ++i) {
+    int64_t target = (i * galoisElement) % (2 * degree);
+    negate[target % degree] = target >= degree;
+    sources[target % degree] = i;
+  }
+
+  auto indexTensorType = RankedTensorType::get({degree}, b.getIndexType());
+  auto boolTensorType = RankedTensorType::get({degree}, b.getI1Type());
+  auto modArithTensorType = RankedTensorType::get({degree}, modArithType);
+  Value sourcesTensor = b.create<arith::ConstantOp>(
+      indexTensorType, DenseIntElementsAttr::get(indexTensorType,
+                                                  ArrayRef<int64_t>(sources)));
+  Value negateTensor = b.create<arith::ConstantOp>(
+      boolTensorType, DenseElementsAttr::get(boolTensorType, negate));
+  Value zero = b.create<mod_arith::ConstantOp>(
+      modArithType, IntegerAttr::get(modArithType.getModulus().getType(), 0));
+  Value coeffs = b.create<polynomial::ToTensorOp>(modArithTensorType, poly);
+
+  auto permuted = b.create<tensor::GenerateOp>(
+      modArithTensorType, ValueRange{},
+      [&](OpBuilder &nestedBuilder, Location loc, ValueRange indices) {
+        ImplicitLocOpBuilder nb(loc, nestedBuilder);
+        Value source = nb.create<tensor::ExtractOp>(sourcesTensor, indices);
+        Value coeff = nb.create<tensor::ExtractOp>(coeffs, ValueRange{source});
+        Value isNegated = nb.create<tensor::ExtractOp>(negateTensor, indices);
+        Value negated = nb.create<mod_arith::SubOp>(modArithType, zero, coeff);
+        Value result = nb.create<arith::SelectOp>(isNegated, negated, coeff);
+        nb.create<tensor::YieldOp>(result);
+      });
+  return b.create<polynomial::FromTensorOp>(polyType, permuted);
+}
+
+// Splits `poly` into digit polynomials d_i with coefficients in
+// [0, 2^digitBits), such that poly = sum_i 2^(i * digitBits) * d_i.
+SmallVector<Value> decompose(ImplicitLocOpBuilder &b, Value poly,
+                             int64_t digitBits) {
+  auto polyType = cast<polynomial::PolynomialType>(poly.getType());
+  auto modArithType =
+      cast<mod_arith::ModArithType>(polyType.getRing().getCoefficientType());
+  int64_t numDigits = getNumDigits(modArithType, digitBits);
+  if (numDigits == 1) return {poly};
+
+  Value ints = toCanonicalIntegers(b, poly);
+  auto intTensorType = cast<RankedTensorType>(ints.getType());
+  Value mask = splat(b, intTensorType, (uint64_t{1} << digitBits) - 1);
+  SmallVector<Value> digits;
+  for (int64_t i = 0; i < numDigits; ++i) {
+    Value shifted = ints;
+    if (i > 0) {
+      shifted = b.create<arith::ShRUIOp>(
+          ints, splat(b, intTensorType, i * digitBits));
+    }
+    Value digit = b.create<arith::AndIOp>(shifted, mask);
+    digits.push_back(fromCanonicalIntegers(b, digit, polyType));
+  }
+  return digits;
+}
+
+// Returns the tensor of key switching keys for `ring` in the function
+// containing `op`, and the position of the key with id `keyId` in it.
+FailureOr<std::pair<Value, int64_t>> getKeySwitchingKey(
+    Operation *op, polynomial::RingAttr ring, int64_t keyId) {
+  auto funcOp = op->getParentOfType<func::FuncOp>();
+  for (BlockArgument arg : funcOp.getArguments()) {
+    auto keyIds = funcOp.getArgAttrOfType<DenseI64ArrayAttr>(
+        arg.getArgNumber(), kKeySwitchingKeysAttrName);
+    if (!keyIds || getPolynomialType(arg).getRing() != ring) continue;
+    const auto *it = llvm::find(keyIds.asArrayRef(), keyId);
+    if (it == keyIds.asArrayRef().end()) break;
+    return std::make_pair(
+        Value(arg), static_cast<int64_t>(it - keyIds.asArrayRef().begin()));
+  }
+  return op->emitOpError() << "found no key switching key with id " << keyId
+                           << " for ring " << ring;
+}
+
+// Switches `poly`, which is multiplied by s' in a ciphertext, to the key s.
+// Returns (sum_i d_i * a_i, sum_i d_i * b_i) for the digits d_i of `poly` and
+// the digits (a_i, b_i) of the key switching key from s' to s, which decrypts
+// to approximately poly * s'.
+std::pair<Value, Value> keySwitch(ImplicitLocOpBuilder &b, Value poly,
+                                  Value keys, int64_t keyIndex,
+                                  int64_t digitBits) {
+  Value keyIndexValue = b.create<arith::ConstantIndexOp>(keyIndex);
+  Value index0 = b.create<arith::ConstantIndexOp>(0);
+  Value index1 = b.create<arith::ConstantIndexOp>(1);
+  Value sumA;
+  Value sumB;
+  for (auto [i, digit] : llvm::enumerate(decompose(b, poly, digitBits))) {
+    Value digitIndex = b.create<arith::ConstantIndexOp>(i);
+    Value keyA = b.create<tensor::ExtractOp>(
+        keys, ValueRange{keyIndexValue, digitIndex, index0});
+    Value keyB = b.create<tensor::ExtractOp>(
+        keys, ValueRange{keyIndexValue, digitIndex, index1});
+    Value digitA = b.create<polynomial::MulOp>(digit, keyA);
+    Value digitB = b.create<polynomial::MulOp>(digit, keyB);
+    sumA = sumA ? b.create<polynomial::AddOp>(sumA, digitA) : digitA;
+    sumB = sumB ? b.create<polynomial::AddOp>(sumB, digitB) : digitB;
+  }
+  return {sumA, sumB};
+}
+
+// Switches the coefficients of `poly` from modulus q to the modulus q' of
+// `outputType` by computing round(x * q' / q), which requires p = q / q' to
+// be an integer.
+//
+// If `plaintextModulus` is set, the rounding error delta is instead chosen to
+// be congruent to x mod p and to 0 mod t, so that (x - delta) / p preserves
+// the message up to the factor p^-1 mod t, as required for BGV. With
+// r = x mod p, k = -r * p^-1 mod t and delta = r + p * k, this is
+// floor(x / p) - k.
+Value switchModulus(ImplicitLocOpBuilder &b, Value poly,
+                    polynomial::PolynomialType outputType, uint64_t p,
+                    uint64_t outputModulus,
+                    std::optional<std::pair<uint64_t, uint64_t>>
+                        plaintextModulusAndInverse) {
+  Value ints = toCanonicalIntegers(b, poly);
+  auto intTensorType = cast<RankedTensorType>(ints.getType());
+  auto constant = [&](uint64_t value) {
+    return splat(b, intTensorType, value);
+  };
+
+  Value quotient = b.create<arith::DivUIOp>(ints, constant(p));
+  Value remainder = b.create<arith::RemUIOp>(ints, constant(p));
+  Value result;
+  if (!plaintextModulusAndInverse.has_value()) {
+    Value roundUp = b.create<arith::CmpIOp>(arith::CmpIPredicate::uge,
+                                            remainder, constant(p - p / 2));
+    Value carry = b.create<arith::ExtUIOp>(intTensorType, roundUp);
+    result = b.create<arith::AddIOp>(quotient, carry);
+  } else {
+    auto [t, pInverse] = plaintextModulusAndInverse.value();
+    Value remainderModT = b.create<arith::RemUIOp>(remainder, constant(t));
+    Value negRemainder = b.create<arith::RemUIOp>(
+        b.create<arith::SubIOp>(constant(t), remainderModT), constant(t));
+    Value k = b.create<arith::RemUIOp>(
+        b.create<arith::MulIOp>(negRemainder, constant(pInverse)), constant(t));
+    Value kModOutput = b.create<arith::RemUIOp>(k, constant(outputModulus));
+    result = b.create<arith::SubIOp>(
+        b.create<arith::AddIOp>(quotient, constant(outputModulus)), kModOutput);
+  }
+  result = b.create<arith::RemUIOp>(result, constant(outputModulus));
+  return fromCanonicalIntegers(b, result, outputType);
+}
+
+// Returns the moduli q and q' of the input and output polynomial types of a
+// modulus switch, checking that q' divides q.
+FailureOr<std::pair<uint64_t, uint64_t>> getSwitchModuli(
+    Operation *op, polynomial::PolynomialType inputType,
+    polynomial::PolynomialType outputType) {
+  auto inputModArithType = getModArithCoefficientType(op, inputType);
+  auto outputModArithType = getModArithCoefficientType(op, outputType);
+  if (failed(inputModArithType) || failed(outputModArithType)) {
+    return failure();
+  }
+  uint64_t modulus = getModulus(inputModArithType.value());
+  uint64_t outputModulus = getModulus(outputModArithType.value());
+  if (modulus % outputModulus != 0) {
+    return op->emitOpError()
+           << "expected the output modulus " << outputModulus
+           << " to divide the input modulus " << modulus;
+  }
+  return std::make_pair(modulus, outputModulus);
+}
+
+}  // namespace
+
+template <typename RelinOp>
+struct ConvertRelinearize : public OpConversionPattern<RelinOp> {
+  ConvertRelinearize(const TypeConverter &typeConverter,
+                     mlir::MLIRContext *context, int64_t digitBits)
+      : OpConversionPattern<RelinOp>(typeConverter, context),
+        digitBits(digitBits) {}
+
+  LogicalResult matchAndRewrite(
+      RelinOp op, typename RelinOp::Adaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    if (!llvm::equal(adaptor.getFromBasis(), ArrayRef<int>{0, 1, 2}) ||
+        !llvm::equal(adaptor.getToBasis(), ArrayRef<int>{0, 1})) {
+      return op.emitOpError()
+             << "only supports relinearizing from basis [0, 1, 2] to [0, 1]";
+    }
+
+    Value input = adaptor.getInput();
+    auto polyType = getPolynomialType(input);
+    if (failed(getModArithCoefficientType(op, polyType))) return failure();
+    auto key = getKeySwitchingKey(op, polyType.getRing(),
+                                  kRelinearizationKeyId);
+    if (failed(key)) return failure();
+
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    // The input decrypts as c0 * s^2 + c1 * s + c2, see ConvertRMul.
+    Value c0 = extractPolynomial(b, input, 0);
+    Value c1 = extractPolynomial(b, input, 1);
+    Value c2 = extractPolynomial(b, input, 2);
+    auto [switchedA, switchedB] =
+        keySwitch(b, c0, key->first, key->second, digitBits);
+    Value output0 = b.create<polynomial::AddOp>(c1, switchedA);
+    Value output1 = b.create<polynomial::AddOp>(c2, switchedB);
+    rewriter.replaceOp(op, b.create<tensor::FromElementsOp>(
+                               ArrayRef<Value>({output0, output1})));
+    return success();
+  }
+
+ private:
+  int64_t digitBits;
+};
+
+template <typename RotateOp>
+struct ConvertRotate : public OpConversionPattern<RotateOp> {
+  ConvertRotate(const TypeConverter &typeConverter, mlir::MLIRContext *context,
+                int64_t digitBits)
+      : OpConversionPattern<RotateOp>(typeConverter, context),
+        digitBits(digitBits) {}
+
+  LogicalResult matchAndRewrite(
+      RotateOp op, typename RotateOp::Adaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    Value input = adaptor.getInput();
+    auto polyType = getPolynomialType(input);
+    if (failed(getModArithCoefficientType(op, polyType))) return failure();
+    int64_t galoisElement = getGaloisElement(op.getOffsetAttr().getInt(),
+                                             getRingDegree(polyType.getRing()));
+    auto key = getKeySwitchingKey(op, polyType.getRing(), galoisElement);
+    if (failed(key)) return failure();
+
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    // The automorphism of (c0, c1) decrypts under s(X^g), so switch the
+    // component multiplied by the key back to s.
+    Value c0 = applyAutomorphism(b, extractPolynomial(b, input, 0),
+                                 galoisElement);
+    Value c1 = applyAutomorphism(b, extractPolynomial(b, input, 1),
+                                 galoisElement);
+    auto [switchedA, switchedB] =
+        keySwitch(b, c0, key->first, key->second, digitBits);
+    Value output1 = b.create<polynomial::AddOp>(c1, switchedB);
+    rewriter.replaceOp(op, b.create<tensor::FromElementsOp>(
+                               ArrayRef<Value>({switchedA, output1})));
+    return success();
+  }
+
+ private:
+  int64_t digitBits;
+};
+
+// Lowers bgv.modulus_switch and ckks.rescale. Only BGV needs the rounding
+// error to be divisible by the plaintext modulus.
+template <typename ModulusSwitchOp>
+struct ConvertModulusSwitch : public OpConversionPattern<ModulusSwitchOp> {
+  using OpConversionPattern<ModulusSwitchOp>::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      ModulusSwitchOp op, typename ModulusSwitchOp::Adaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    Value input = adaptor.getInput();
+    auto outputType = dyn_cast_or_null<RankedTensorType>(
+        this->getTypeConverter()->convertType(op.getOutput().getType()));
+    if (!outputType) return failure();
+    auto outputPolyType =
+        cast<polynomial::PolynomialType>(outputType.getElementType());
+    auto moduli =
+        getSwitchModuli(op, getPolynomialType(input), outputPolyType);
+    if (failed(moduli)) return failure();
+    auto [modulus, outputModulus] = moduli.value();
+    uint64_t p = modulus / outputModulus;
+
+    std::optional<std::pair<uint64_t, uint64_t>> plaintextModulusAndInverse;
+    if constexpr (std::is_same_v<ModulusSwitchOp, bgv::ModulusSwitchOp>) {
+      auto plaintextModArithType = dyn_cast<mod_arith::ModArithType>(
+          op.getInput()
+              .getType()
+              .getPlaintextSpace()
+              .getRing()
+              .getCoefficientType());
+      if (!plaintextModArithType) {
+        return op.emitOpError() << "expected a mod_arith plaintext ring";
+      }
+      uint64_t t = getModulus(plaintextModArithType);
+      APInt pInverse =
+          multiplicativeInverse(APInt(128, p % t), APInt(128, t));
+      if (pInverse.isZero()) {
+        return op.emitOpError()
+               << "expected the dropped modulus " << p
+               << " to be invertible mod the plaintext modulus " << t;
+      }
+      // The correction is computed in the storage type of the input.
+      auto inputModArithType = cast<mod_arith::ModArithType>(
+          getPolynomialType(input).getRing().getCoefficientType());
+      unsigned storageWidth =
+          inputModArithType.getModulus().getType().getIntOrFloatBitWidth();
+      if (2 * plaintextModArithType.getModulus().getValue().getActiveBits() >
+          storageWidth) {
+        return op.emitOpError() << "plaintext modulus " << t
+                                << " is too large for the ciphertext ring";
+      }
+      plaintextModulusAndInverse = std::make_pair(t, pInverse.getZExtValue());
+    }
+
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    int64_t size = outputType.getDimSize(0);
+    SmallVector<Value> outputs;
+    for (int64_t i = 0; i < size; ++i) {
+      outputs.push_back(switchModulus(b, extractPolynomial(b, input, i),
+                                      outputPolyType, p, outputModulus,
+                                      plaintextModulusAndInverse));
+    }
+    rewriter.replaceOp(op, b.create<tensor::FromElementsOp>(outputs));
+    return success();
+  }
+};
+
+// Lowers bgv.level_reduce and ckks.level_reduce by reducing the coefficients
+// mod the smaller modulus, which is exact because it divides the larger one.
+template <typename LevelReduceOp>
+struct ConvertLevelReduce : public OpConversionPattern<LevelReduceOp> {
+  using OpConversionPattern<LevelReduceOp>::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      LevelReduceOp op, typename LevelReduceOp::Adaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    Value input = adaptor.getInput();
+    auto outputType = dyn_cast_or_null<RankedTensorType>(
+        this->getTypeConverter()->convertType(op.getOutput().getType()));
+    if (!outputType) return failure();
+    auto outputPolyType =
+        cast<polynomial::PolynomialType>(outputType.getElementType());
+    auto moduli =
+        getSwitchModuli(op, getPolynomialType(input), outputPolyType);
+    if (failed(moduli)) return failure();
+    uint64_t outputModulus = moduli.value().second;
+
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    int64_t size = outputType.getDimSize(0);
+    SmallVector<Value> outputs;
+    for (int64_t i = 0; i < size; ++i) {
+      Value ints = toCanonicalIntegers(b, extractPolynomial(b, input, i));
+      Value reduced = b.create<arith::RemUIOp>(
+          ints, splat(b, cast<RankedTensorType>(ints.getType()),
+                      outputModulus));
+      outputs.push_back(fromCanonicalIntegers(b, reduced, outputPolyType));
+    }
+    rewriter.replaceOp(op, b.create<tensor::FromElementsOp>(outputs));
+    return success();
+  }
+};
+
+// Adds a trailing argument with the key switching keys needed by each function
+// that relinearizes or rotates, one per ciphertext ring. See the pass
+// description for the layout of the keys.
+LogicalResult addKeySwitchingKeyArgs(Operation *module, int64_t digitBits) {
+  MLIRContext *context = module->getContext();
+  WalkResult result = module->walk([&](func::FuncOp funcOp) {
+    if (funcOp.isDeclaration()) return WalkResult::advance();
+
+    llvm::MapVector<polynomial::RingAttr, llvm::SetVector<int64_t>> keyIds;
+    auto addKey = [&](Value input, std::optional<int64_t> offset) {
+      auto ring = normalizeRing(cast<lwe::NewLWECiphertextType>(input.getType())
+                                    .getCiphertextSpace()
+                                    .getRing());
+      keyIds[ring].insert(
+          offset.has_value()
+              ? getGaloisElement(offset.value(), getRingDegree(ring))
+              : kRelinearizationKeyId);
+    };
+    funcOp.walk([&](Operation *op) {
+      llvm::TypeSwitch<Operation *>(op)
+          .Case<bgv::RelinearizeOp, ckks::RelinearizeOp>(
+              [&](auto relinOp) { addKey(relinOp.getInput(), std::nullopt); })
+          .Case<bgv::RotateColumnsOp, ckks::RotateOp>([&](auto rotateOp) {
+            addKey(rotateOp.getInput(), rotateOp.getOffsetAttr().getInt());
+          });
+    });
+
+    for (auto &[ring, ids] : keyIds) {
+      auto modArithType =
+          dyn_cast<mod_arith::ModArithType>(ring.getCoefficientType());
+      if (!modArithType) {
+        // TODO(#1199): support RNS lowering
+        funcOp.emitOpError()
+            << "key switching requires a single-modulus ciphertext ring, got "
+            << ring;
+        return WalkResult::interrupt();
+      }
+      auto keysType = RankedTensorType::get(
+          {static_cast<int64_t>(ids.size()),
+           getNumDigits(modArithType, digitBits), 2},
+          polynomial::PolynomialType::get(context, ring));
+      Builder builder(context);
+      auto argAttrs = builder.getDictionaryAttr(builder.getNamedAttr(
+          kKeySwitchingKeysAttrName,
+          builder.getDenseI64ArrayAttr(ids.getArrayRef())));
+      funcOp.insertArgument(funcOp.getNumArguments(), keysType, argAttrs,
+                            funcOp.getLoc());
+    }
+    return WalkResult::advance();
+  });
+  if (result.wasInterrupted()) return failure();
+
+  // The key arguments are not threaded through calls.
+  result = module->walk([&](func::CallOp callOp) {
+    auto callee = SymbolTable::lookupNearestSymbolFrom<func::FuncOp>(
+        callOp, callOp.getCalleeAttr());
+    if (!callee) return WalkResult::advance();
+    for (unsigned i = 0; i < callee.getNumArguments(); ++i) {
+      if (callee.getArgAttr(i, kKeySwitchingKeysAttrName)) {
+        callOp.emitOpError()
+            << "calls to functions that use key switching keys are not "
+               "supported";
+        return WalkResult::interrupt();
+      }
+    }
+    return WalkResult::advance();
+  });
+  return failure(result.wasInterrupted());
+}
+
+// Returns true if `type` is an LWE type over an RNS ring with several limbs.
+bool hasMultiLimbRing(Type type) {
+  auto isMultiLimb = [](polynomial::RingAttr ring) {
+    auto rnsType = dyn_cast<rns::RNSType>(ring.getCoefficientType());
+    return rnsType && rnsType.getBasisTypes().size() > 1;
+  };
+  return llvm::TypeSwitch<Type, bool>(type)
+      .Case<lwe::NewLWECiphertextType>([&](auto type) {
+        return isMultiLimb(type.getCiphertextSpace().getRing());
+      })
+      .Case<lwe::NewLWEPlaintextType>([&](auto type) {
+        return isMultiLimb(type.getPlaintextSpace().getRing());
+      })
+      .Case<lwe::NewLWESecretKeyType, lwe::NewLWEPublicKeyType>(
+          [&](auto type) { return isMultiLimb(type.getRing()); })
+      .Default([](Type) { return false; });
+}
+
 struct LWEToPolynomial : public impl::LWEToPolynomialBase<LWEToPolynomial> {
   void runOnOperation() override {
-    // TODO(#1199): Remove this emitError once the pass is fixed.
-    getOperation()->emitError(
-        "LWEToPolynomial conversion pass is broken. See #1199.");
-    return;
-
     MLIRContext *context = &getContext();
     auto *module = getOperation();
+
+    // TODO(#1199): Remove these errors once RNS rings with several limbs
+    // lower, and `lwe.rlwe_encrypt` is migrated to the new LWE types.
+    WalkResult unsupported = module->walk([&](Operation *op) {
+      bool hasMultiLimbType =
+          llvm::any_of(op->getResultTypes(), hasMultiLimbRing);
+      if (auto funcOp = dyn_cast<func::FuncOp>(op)) {
+        hasMultiLimbType |=
+            llvm::any_of(funcOp.getArgumentTypes(), hasMultiLimbRing);
+      }
+      if (hasMultiLimbType) {
+        op->emitOpError()
+            << "requires single-modulus ciphertext rings, but uses an RNS "
+               "ring with several limbs. See #1199.";
+        return WalkResult::interrupt();
+      }
+      if (isa<RLWEEncryptOp>(op)) {
+        module->emitError(
+            "LWEToPolynomial conversion pass is broken. See #1199.");
+        return WalkResult::interrupt();
+      }
+      return WalkResult::advance();
+    });
+    if (unsupported.wasInterrupted()) {
+      return signalPassFailure();
+    }
+
+    if (failed(addKeySwitchingKeyArgs(module, keySwitchingDigitBits))) {
+      return signalPassFailure();
+    }
+
     CiphertextTypeConverter typeConverter(context);
 
     ConversionTarget target(*context);
     target.addLegalOp<ModuleOp>();
+    target.addLegalDialect<arith::ArithDialect, mod_arith::ModArithDialect,
+                           polynomial::PolynomialDialect, random::RandomDialect,
+                           tensor::TensorDialect>();
 
     RewritePatternSet patterns(context);
 
     patterns.add<ConvertRLWEDecrypt, ConvertRLWEEncrypt, ConvertRAdd,
-                 ConvertRSub, ConvertRNegate, ConvertRMul>(typeConverter,
-                                                           context);
+                 ConvertRSub, ConvertRNegate, ConvertRMul,
+                 ConvertModulusSwitch<bgv::ModulusSwitchOp>,
+                 ConvertModulusSwitch<ckks::RescaleOp>,
+                 ConvertLevelReduce<bgv::LevelReduceOp>,
+                 ConvertLevelReduce<ckks::LevelReduceOp>>(typeConverter,
+                                                          context);
+    patterns.add<ConvertRelinearize<bgv::RelinearizeOp>,
+                 ConvertRelinearize<ckks::RelinearizeOp>,
+                 ConvertRotate<bgv::RotateColumnsOp>,
+                 ConvertRotate<ckks::RotateOp>>(typeConverter, context,
+                                                keySwitchingDigitBits);
     target.addIllegalOp<RLWEDecryptOp, RLWEEncryptOp, RAddOp, RSubOp, RNegateOp,
                         RMulOp>();
+    target.addIllegalOp<bgv::RelinearizeOp, bgv::RotateColumnsOp,
+                        bgv::ModulusSwitchOp, bgv::LevelReduceOp,
+                        ckks::RelinearizeOp, ckks::RotateOp, ckks::RescaleOp,
+                        ckks::LevelReduceOp>();
 
     addStructuralConversionPatterns(typeConverter, patterns, target);
 
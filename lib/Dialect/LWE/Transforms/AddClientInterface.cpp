@@ -1,6 +1,7 @@
 #include "lib/Dialect/LWE/Transforms/AddClientInterface.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include "lib/Dialect/BGV/IR/BGVAttributes.h"
@@ -8,22 +9,29 @@
 #include "lib/Dialect/CKKS/IR/CKKSAttributes.h"
 #include "lib/Dialect/CKKS/IR/CKKSDialect.h"
 #include "lib/Dialect/LWE/IR/LWEAttributes.h"
+#include "lib/Dialect/LWE/IR/LWEDialect.h"
 #include "lib/Dialect/LWE/IR/LWEOps.h"
 #include "lib/Dialect/LWE/IR/LWETypes.h"
 #include "lib/Dialect/ModuleAttributes.h"
 #include "lib/Dialect/Polynomial/IR/PolynomialAttributes.h"
-#include "llvm/include/llvm/Support/raw_ostream.h"      // from @llvm-project
-#include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
-#include "mlir/include/mlir/IR/Block.h"                 // from @llvm-project
-#include "mlir/include/mlir/IR/BuiltinOps.h"            // from @llvm-project
-#include "mlir/include/mlir/IR/BuiltinTypes.h"          // from @llvm-project
-#include "mlir/include/mlir/IR/ImplicitLocOpBuilder.h"  // from @llvm-project
-#include "mlir/include/mlir/IR/TypeUtilities.h"         // from @llvm-project
-#include "mlir/include/mlir/IR/Types.h"                 // from @llvm-project
-#include "mlir/include/mlir/IR/Value.h"                 // from @llvm-project
-#include "mlir/include/mlir/IR/Visitors.h"              // from @llvm-project
-#include "mlir/include/mlir/Support/LLVM.h"             // from @llvm-project
-#include "mlir/include/mlir/Support/LogicalResult.h"    // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"        // from @llvm-project
+#include "llvm/include/llvm/Support/raw_ostream.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Affine/IR/AffineOps.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"   // from @llvm-project
+#include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Block.h"                  // from @llvm-project
+#include "mlir/include/mlir/IR/Builders.h"               // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinAttributes.h"      // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinOps.h"             // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/ImplicitLocOpBuilder.h"   // from @llvm-project
+#include "mlir/include/mlir/IR/OpDefinition.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/TypeUtilities.h"          // from @llvm-project
+#include "mlir/include/mlir/IR/Types.h"                  // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                  // from @llvm-project
+#include "mlir/include/mlir/IR/Visitors.h"               // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"              // from @llvm-project
+#include "mlir/include/mlir/Support/LogicalResult.h"     // from @llvm-project
 
 namespace mlir {
 namespace heir {
@@ -76,11 +84,126 @@ FailureOr<mlir::heir::polynomial::RingAttr> getDecRingFromFuncOp(
   return ring;
 }
 
+/// Returns the type of the cleartext encrypted into `type`, which is either a
+/// ciphertext, or a 1D tensor of ciphertexts whose cleartexts are stacked
+/// along a new leading dimension.
+Type getCleartextType(Type type) {
+  if (auto ctTy = dyn_cast<lwe::NewLWECiphertextType>(type)) {
+    return ctTy.getApplicationData().getMessageType();
+  }
+  auto tensorTy = cast<RankedTensorType>(type);
+  auto ctTy = cast<lwe::NewLWECiphertextType>(tensorTy.getElementType());
+  Type messageTy = ctTy.getApplicationData().getMessageType();
+  SmallVector<int64_t> shape(tensorTy.getShape());
+  if (auto messageTensorTy = dyn_cast<RankedTensorType>(messageTy)) {
+    llvm::append_range(shape, messageTensorTy.getShape());
+    messageTy = messageTensorTy.getElementType();
+  }
+  return RankedTensorType::get(shape, messageTy);
+}
+
+/// Whether `type` is a 1D tensor of ciphertexts.
+bool isCiphertextTensor(Type type) {
+  auto tensorTy = dyn_cast<RankedTensorType>(type);
+  return tensorTy && tensorTy.getRank() == 1 &&
+         isa<lwe::NewLWECiphertextType>(tensorTy.getElementType());
+}
+
+Value encodeAndEncrypt(ImplicitLocOpBuilder &builder, Value cleartext,
+                       Value encryptionKey, lwe::NewLWECiphertextType ctTy) {
+  auto plaintextTy = lwe::NewLWEPlaintextType::get(
+      builder.getContext(), ctTy.getApplicationData(), ctTy.getPlaintextSpace());
+  auto encoded = builder.create<lwe::RLWEEncodeOp>(
+      plaintextTy, cleartext, ctTy.getPlaintextSpace().getEncoding(),
+      ctTy.getPlaintextSpace().getRing());
+  return builder.create<lwe::RLWEEncryptOp>(ctTy, encoded.getResult(),
+                                            encryptionKey);
+}
+
+Value decryptAndDecode(ImplicitLocOpBuilder &builder, Value ciphertext,
+                       Value secretKey, Type cleartextTy) {
+  auto ctTy = cast<lwe::NewLWECiphertextType>(ciphertext.getType());
+  auto plaintextTy = lwe::NewLWEPlaintextType::get(
+      builder.getContext(), ctTy.getApplicationData(), ctTy.getPlaintextSpace());
+  auto decrypted =
+      builder.create<lwe::RLWEDecryptOp>(plaintextTy, ciphertext, secretKey);
+  // FIXME: if the input is a scalar type, we must add a tensor.extract op.
+  // The decode op's tablegen should also support having tensor types as
+  // outputs if it doesn't already.
+  return builder.create<lwe::RLWEDecodeOp>(
+      cleartextTy, decrypted.getResult(), ctTy.getPlaintextSpace().getEncoding(),
+      ctTy.getPlaintextSpace().getRing());
+}
+
+/// Builds a loop over the `size` elements of a 1D tensor that inserts the
+/// value computed by `bodyFn` for each index into `init`, a tensor whose
+/// leading dimension has `size` elements. The iterations are independent, so
+/// unless `clientThreads` is 1, the loop is annotated to run in parallel with
+/// that many threads.
+Value buildClientLoop(
+    ImplicitLocOpBuilder &builder, Value init, int64_t size,
+    int64_t clientThreads,
+    function_ref<Value(ImplicitLocOpBuilder &, Value)> bodyFn) {
+  auto forOp = builder.create<affine::AffineForOp>(
+      0, size, 1, ValueRange{init},
+      [&](OpBuilder &b, Location loc, Value iv, ValueRange iterArgs) {
+        ImplicitLocOpBuilder nested(loc, b);
+        Value element = bodyFn(nested, iv);
+        Value acc = iterArgs[0];
+        auto accTy = cast<RankedTensorType>(acc.getType());
+        Value inserted;
+        if (accTy.getRank() == 1) {
+          inserted = nested.create<tensor::InsertOp>(element, acc, iv);
+        } else {
+          SmallVector<OpFoldResult> offsets(accTy.getRank(),
+                                            nested.getIndexAttr(0));
+          offsets[0] = iv;
+          SmallVector<OpFoldResult> sizes = {nested.getIndexAttr(1)};
+          for (int64_t dim : accTy.getShape().drop_front()) {
+            sizes.push_back(nested.getIndexAttr(dim));
+          }
+          SmallVector<OpFoldResult> strides(accTy.getRank(),
+                                            nested.getIndexAttr(1));
+          inserted = nested.create<tensor::InsertSliceOp>(element, acc, offsets,
+                                                          sizes, strides);
+        }
+        nested.create<affine::AffineYieldOp>(inserted);
+      });
+  if (clientThreads != 1) {
+    forOp->setAttr(LWEDialect::kClientThreadsAttrName,
+                   builder.getI64IntegerAttr(clientThreads));
+  }
+  return forOp.getResult(0);
+}
+
+/// Extracts the cleartext of the ciphertext at `index` from the stacked
+/// cleartexts of a tensor of ciphertexts.
+Value extractCleartext(ImplicitLocOpBuilder &builder, Value cleartexts,
+                       Value index, Type cleartextTy) {
+  auto cleartextsTy = cast<RankedTensorType>(cleartexts.getType());
+  if (cleartextsTy.getRank() == 1) {
+    return builder.create<tensor::ExtractOp>(cleartexts, index);
+  }
+  SmallVector<OpFoldResult> offsets(cleartextsTy.getRank(),
+                                    builder.getIndexAttr(0));
+  offsets[0] = index;
+  SmallVector<OpFoldResult> sizes = {builder.getIndexAttr(1)};
+  for (int64_t dim : cleartextsTy.getShape().drop_front()) {
+    sizes.push_back(builder.getIndexAttr(dim));
+  }
+  SmallVector<OpFoldResult> strides(cleartextsTy.getRank(),
+                                    builder.getIndexAttr(1));
+  return builder.create<tensor::ExtractSliceOp>(
+      cast<RankedTensorType>(cleartextTy), cleartexts, offsets, sizes,
+      strides);
+}
+
 /// Generates an encryption func for one or more types.
 LogicalResult generateEncryptionFunc(
     func::FuncOp op, const std::string &encFuncName, TypeRange encFuncArgTypes,
     TypeRange encFuncResultTypes, bool usePublicKey,
-    mlir::heir::polynomial::RingAttr ring, ImplicitLocOpBuilder &builder) {
+    mlir::heir::polynomial::RingAttr ring, int64_t clientThreads,
+    ImplicitLocOpBuilder &builder) {
   // The enryption function converts each plaintext operand to its encrypted
   // form. We also have to add a public/secret key arg, and we put it at the
   // end to maintain zippability of the non-key args.
@@ -108,16 +231,27 @@ LogicalResult generateEncryptionFunc(
 
     // If the output is encrypted, we need to encode and encrypt
     if (auto resultCtTy = dyn_cast<lwe::NewLWECiphertextType>(resultTy)) {
-      auto plaintextTy = lwe::NewLWEPlaintextType::get(
-          op.getContext(), resultCtTy.getApplicationData(),
-          resultCtTy.getPlaintextSpace());
-      auto encoded = builder.create<lwe::RLWEEncodeOp>(
-          plaintextTy, encFuncOp.getArgument(i),
-          resultCtTy.getPlaintextSpace().getEncoding(),
-          resultCtTy.getPlaintextSpace().getRing());
-      auto encrypted = builder.create<lwe::RLWEEncryptOp>(
-          resultCtTy, encoded.getResult(), secretKey);
-      encValuesToReturn.push_back(encrypted.getResult());
+      encValuesToReturn.push_back(encodeAndEncrypt(
+          builder, encFuncOp.getArgument(i), secretKey, resultCtTy));
+      continue;
+    }
+
+    // For a tensor of ciphertexts, encode and encrypt each one of them.
+    if (isCiphertextTensor(resultTy)) {
+      auto resultTensorTy = cast<RankedTensorType>(resultTy);
+      auto ctTy =
+          cast<lwe::NewLWECiphertextType>(resultTensorTy.getElementType());
+      Type cleartextTy = ctTy.getApplicationData().getMessageType();
+      Value cleartexts = encFuncOp.getArgument(i);
+      Value init = builder.create<tensor::EmptyOp>(resultTensorTy.getShape(),
+                                                   ctTy);
+      encValuesToReturn.push_back(buildClientLoop(
+          builder, init, resultTensorTy.getDimSize(0), clientThreads,
+          [&](ImplicitLocOpBuilder &b, Value index) {
+            Value cleartext =
+                extractCleartext(b, cleartexts, index, cleartextTy);
+            return encodeAndEncrypt(b, cleartext, secretKey, ctTy);
+          }));
       continue;
     }
 
@@ -135,6 +269,7 @@ LogicalResult generateDecryptionFunc(func::FuncOp op,
                                      TypeRange decFuncArgTypes,
                                      TypeRange decFuncResultTypes,
                                      mlir::heir::polynomial::RingAttr ring,
+                                     int64_t clientThreads,
                                      ImplicitLocOpBuilder &builder) {
   Type decryptionKeyType = lwe::NewLWESecretKeyType::get(
       op.getContext(), KeyAttr::get(op.getContext(), 0), ring);
@@ -157,20 +292,27 @@ LogicalResult generateDecryptionFunc(func::FuncOp op,
     auto resultTy = decFuncResultTypes[i];
 
     // If the input is ciphertext, we need to decode and decrypt
-    if (auto argCtTy = dyn_cast<lwe::NewLWECiphertextType>(argTy)) {
-      auto plaintextTy = lwe::NewLWEPlaintextType::get(
-          op.getContext(), argCtTy.getApplicationData(),
-          argCtTy.getPlaintextSpace());
-      auto decrypted = builder.create<lwe::RLWEDecryptOp>(
-          plaintextTy, decFuncOp.getArgument(i), secretKey);
-      auto decoded = builder.create<lwe::RLWEDecodeOp>(
-          resultTy, decrypted.getResult(),
-          argCtTy.getPlaintextSpace().getEncoding(),
-          argCtTy.getPlaintextSpace().getRing());
-      // FIXME: if the input is a scalar type, we must add a tensor.extract op.
-      // The decode op's tablegen should also support having tensor types as
-      // outputs if it doesn't already.
-      decValuesToReturn.push_back(decoded.getResult());
+    if (isa<lwe::NewLWECiphertextType>(argTy)) {
+      decValuesToReturn.push_back(decryptAndDecode(
+          builder, decFuncOp.getArgument(i), secretKey, resultTy));
+      continue;
+    }
+
+    // For a tensor of ciphertexts, decrypt and decode each one of them.
+    if (isCiphertextTensor(argTy)) {
+      auto argTensorTy = cast<RankedTensorType>(argTy);
+      auto ctTy = cast<lwe::NewLWECiphertextType>(argTensorTy.getElementType());
+      Type cleartextTy = ctTy.getApplicationData().getMessageType();
+      Value ciphertexts = decFuncOp.getArgument(i);
+      auto resultTensorTy = cast<RankedTensorType>(resultTy);
+      Value init = builder.create<tensor::EmptyOp>(
+          resultTensorTy.getShape(), resultTensorTy.getElementType());
+      decValuesToReturn.push_back(buildClientLoop(
+          builder, init, argTensorTy.getDimSize(0), clientThreads,
+          [&](ImplicitLocOpBuilder &b, Value index) {
+            Value ciphertext = b.create<tensor::ExtractOp>(ciphertexts, index);
+            return decryptAndDecode(b, ciphertext, secretKey, cleartextTy);
+          }));
       continue;
     }
 
@@ -182,9 +324,33 @@ LogicalResult generateDecryptionFunc(func::FuncOp op,
   return success();
 }
 
+/// Annotates a client interface func with the names of the helpers that
+/// serialize and deserialize the ciphertext it encrypts or decrypts.
+void annotateSerialization(ModuleOp module, StringRef clientFuncName,
+                           StringRef funcName, StringRef valueName,
+                           bool trimLevels) {
+  auto clientFuncOp = module.lookupSymbol<func::FuncOp>(clientFuncName);
+  Builder builder(module.getContext());
+  SmallVector<NamedAttribute> attrs;
+  attrs.push_back(builder.getNamedAttr(
+      "serialize",
+      builder.getStringAttr(funcName + "__serialize__" + valueName)));
+  attrs.push_back(builder.getNamedAttr(
+      "deserialize",
+      builder.getStringAttr(funcName + "__deserialize__" + valueName)));
+  if (trimLevels) {
+    attrs.push_back(
+        builder.getNamedAttr("trim_levels", builder.getUnitAttr()));
+  }
+  clientFuncOp->setAttr(LWEDialect::kClientSerializationAttrName,
+                        builder.getDictionaryAttr(attrs));
+}
+
 /// Adds the client interface for a single func. This should only be used on the
 /// "entry" func for the IR being compiled, but there may be multiple.
-LogicalResult convertFunc(func::FuncOp op, bool usePublicKey) {
+LogicalResult convertFunc(func::FuncOp op, bool usePublicKey,
+                          bool serialization, bool trimLevels,
+                          int64_t clientThreads) {
   auto module = op->getParentOfType<ModuleOp>();
   auto ringEncResult = getEncRingFromFuncOp(op);
   auto ringDecResult = getDecRingFromFuncOp(op);
@@ -201,15 +367,21 @@ LogicalResult convertFunc(func::FuncOp op, bool usePublicKey) {
   // when encrypting multiple inputs which requires out-params.
   for (auto val : op.getArguments()) {
     auto argTy = val.getType();
-    if (auto argCtTy = dyn_cast<lwe::NewLWECiphertextType>(argTy)) {
+    if (isa<lwe::NewLWECiphertextType>(argTy) || isCiphertextTensor(argTy)) {
       std::string encFuncName("");
       llvm::raw_string_ostream encNameOs(encFuncName);
       encNameOs << op.getSymName() << "__encrypt__arg" << val.getArgNumber();
-      if (failed(generateEncryptionFunc(
-              op, encFuncName, {argCtTy.getApplicationData().getMessageType()},
-              {argCtTy}, usePublicKey, ringEnc, builder))) {
+      if (failed(generateEncryptionFunc(op, encFuncName,
+                                        {getCleartextType(argTy)}, {argTy},
+                                        usePublicKey, ringEnc, clientThreads,
+                                        builder))) {
         return failure();
       }
+      if (serialization) {
+        annotateSerialization(module, encFuncName, op.getSymName(),
+                              "arg" + std::to_string(val.getArgNumber()),
+                              /*trimLevels=*/false);
+      }
       // insertion point is inside func, move back out
       builder.setInsertionPointToEnd(module.getBody());
     }
@@ -218,16 +390,20 @@ LogicalResult convertFunc(func::FuncOp op, bool usePublicKey) {
   ArrayRef<Type> returnTypes = op.getFunctionType().getResults();
   for (size_t i = 0; i < returnTypes.size(); ++i) {
     auto returnTy = returnTypes[i];
-    if (auto returnCtTy = dyn_cast<lwe::NewLWECiphertextType>(returnTy)) {
+    if (isa<lwe::NewLWECiphertextType>(returnTy) ||
+        isCiphertextTensor(returnTy)) {
       std::string decFuncName("");
       llvm::raw_string_ostream encNameOs(decFuncName);
       encNameOs << op.getSymName() << "__decrypt__result" << i;
-      if (failed(generateDecryptionFunc(
-              op, decFuncName, {returnCtTy},
-              {returnCtTy.getApplicationData().getMessageType()}, ringDec,
-              builder))) {
+      if (failed(generateDecryptionFunc(op, decFuncName, {returnTy},
+                                        {getCleartextType(returnTy)}, ringDec,
+                                        clientThreads, builder))) {
         return failure();
       }
+      if (serialization) {
+        annotateSerialization(module, decFuncName, op.getSymName(),
+                              "result" + std::to_string(i), trimLevels);
+      }
       // insertion point is inside func, move back out
       builder.setInsertionPointToEnd(module.getBody());
     }
@@ -275,7 +451,8 @@ struct AddClientInterface : impl::AddClientInterfaceBase<AddClientInterface> {
             op->emitWarning("Skipping client interface for external func");
             return WalkResult::advance();
           }
-          if (failed(convertFunc(op, getUsePublicKey()))) {
+          if (failed(convertFunc(op, getUsePublicKey(), serialization,
+                                 trimLevels, clientThreads))) {
             op->emitError("Failed to add client interface for func");
             return WalkResult::interrupt();
           }
@@ -42,6 +42,25 @@ LogicalResult RLWENewEncryptorOp::verify() {
   return success();
 }
 
+template <typename WeightedSumOp>
+LogicalResult verifyWeightedSumOp(WeightedSumOp op) {
+  if (op.getCiphertexts().empty()) {
+    return op.emitOpError("expected at least one ciphertext");
+  }
+  if (op.getCiphertexts().size() != op.getPlaintexts().size()) {
+    return op.emitOpError("expected as many plaintexts as ciphertexts");
+  }
+  return success();
+}
+
+LogicalResult BGVWeightedSumNewOp::verify() {
+  return verifyWeightedSumOp(*this);
+}
+
+LogicalResult CKKSWeightedSumNewOp::verify() {
+  return verifyWeightedSumOp(*this);
+}
+
 }  // namespace lattigo
 }  // namespace heir
 }  // namespace mlir
@@ -0,0 +1,166 @@
+#include "lib/Dialect/Lattigo/Transforms/FuseWeightedSum.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "lib/Dialect/Lattigo/IR/LattigoOps.h"
+#include "lib/Dialect/Lattigo/IR/LattigoTypes.h"
+#include "llvm/include/llvm/ADT/SmallVector.h"        // from @llvm-project
+#include "mlir/include/mlir/IR/MLIRContext.h"         // from @llvm-project
+#include "mlir/include/mlir/IR/PatternMatch.h"        // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"               // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"           // from @llvm-project
+#include "mlir/include/mlir/Support/LogicalResult.h"  // from @llvm-project
+#include "mlir/include/mlir/Transforms/GreedyPatternRewriteDriver.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace lattigo {
+
+#define GEN_PASS_DEF_FUSEWEIGHTEDSUM
+#include "lib/Dialect/Lattigo/Transforms/Passes.h.inc"
+
+// Rewrites the tree of adds rooted at an add whose addends include products
+// of a ciphertext and an encoded plaintext into a weighted sum.
+template <typename AddNewOp, typename MulNewOp, typename RescaleNewOp,
+          typename EncodeOp, typename WeightedSumNewOp>
+struct FuseAddTree : public OpRewritePattern<AddNewOp> {
+  FuseAddTree(MLIRContext *context, int64_t &numFusedSums,
+              int64_t &numFusedTerms)
+      : OpRewritePattern<AddNewOp>(context),
+        numFusedSums(numFusedSums),
+        numFusedTerms(numFusedTerms) {}
+
+  // A product of a ciphertext and a plaintext encoded at `scale`, possibly
+  // followed by a rescale.
+  struct WeightedTerm {
+    MulNewOp mulOp;
+    RescaleNewOp rescaleOp;
+    uint64_t scale;
+  };
+
+  static bool isCiphertextAdd(AddNewOp op) {
+    return isa<RLWECiphertextType>(op.getRhs().getType());
+  }
+
+  static FailureOr<WeightedTerm> getWeightedTerm(Value value) {
+    WeightedTerm term;
+    if (auto rescaleOp = value.getDefiningOp<RescaleNewOp>()) {
+      if (!rescaleOp->hasOneUse()) return failure();
+      term.rescaleOp = rescaleOp;
+      value = rescaleOp.getInput();
+    }
+    auto mulOp = value.getDefiningOp<MulNewOp>();
+    if (!mulOp || !mulOp->hasOneUse() ||
+        !isa<RLWEPlaintextType>(mulOp.getRhs().getType())) {
+      return failure();
+    }
+    // The scale of a plaintext is only known from the op that encoded it.
+    auto encodeOp = mulOp.getRhs().template getDefiningOp<EncodeOp>();
+    if (!encodeOp) return failure();
+    term.mulOp = mulOp;
+    term.scale = encodeOp.getScale();
+    return term;
+  }
+
+  // Collects the operands of the tree of single-use adds of two ciphertexts
+  // rooted at `value`.
+  static void collectAddends(Value value, bool isRoot,
+                             SmallVector<Value> &addends) {
+    auto addOp = value.getDefiningOp<AddNewOp>();
+    if (!addOp || !isCiphertextAdd(addOp) ||
+        (!isRoot && !addOp->hasOneUse())) {
+      addends.push_back(value);
+      return;
+    }
+    collectAddends(addOp.getLhs(), /*isRoot=*/false, addends);
+    collectAddends(addOp.getRhs(), /*isRoot=*/false, addends);
+  }
+
+  LogicalResult matchAndRewrite(AddNewOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!isCiphertextAdd(op)) return failure();
+    // Only rewrite from the root of a tree of adds.
+    if (op->hasOneUse()) {
+      auto userOp = dyn_cast<AddNewOp>(*op->getUsers().begin());
+      if (userOp && isCiphertextAdd(userOp)) return failure();
+    }
+
+    SmallVector<Value> addends;
+    collectAddends(op.getResult(), /*isRoot=*/true, addends);
+
+    // Lattigo types do not carry the level and scale of a ciphertext, which
+    // the adds of the tree already require to match. The terms are fused if
+    // their plaintexts are encoded at the same scale, so that MulThenAdd
+    // accumulates the products without rescaling them, and if they are all
+    // (or none of them) rescaled, so that they can share one rescale.
+    SmallVector<WeightedTerm> terms;
+    SmallVector<Value> otherAddends;
+    for (Value addend : addends) {
+      auto term = getWeightedTerm(addend);
+      if (succeeded(term) &&
+          (terms.empty() ||
+           (term->scale == terms.front().scale &&
+            static_cast<bool>(term->rescaleOp) ==
+                static_cast<bool>(terms.front().rescaleOp)))) {
+        terms.push_back(term.value());
+        continue;
+      }
+      otherAddends.push_back(addend);
+    }
+    if (terms.size() < 2) {
+      return rewriter.notifyMatchFailure(op, "fewer than two weighted terms");
+    }
+
+    Value evaluator = op.getEvaluator();
+    SmallVector<Value> ciphertexts;
+    SmallVector<Value> plaintexts;
+    for (const WeightedTerm &term : terms) {
+      ciphertexts.push_back(term.mulOp.getLhs());
+      plaintexts.push_back(term.mulOp.getRhs());
+    }
+    Type ciphertextType = op.getType();
+    Value result = rewriter.create<WeightedSumNewOp>(
+        op.getLoc(), ciphertextType, evaluator, ciphertexts, plaintexts);
+    if (terms.front().rescaleOp) {
+      result = rewriter.create<RescaleNewOp>(op.getLoc(), ciphertextType,
+                                             evaluator, result);
+    }
+    for (Value addend : otherAddends) {
+      result = rewriter.create<AddNewOp>(op.getLoc(), ciphertextType,
+                                         evaluator, result, addend);
+    }
+
+    numFusedSums += 1;
+    numFusedTerms += terms.size();
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+
+ private:
+  int64_t &numFusedSums;
+  int64_t &numFusedTerms;
+};
+
+struct FuseWeightedSum : impl::FuseWeightedSumBase<FuseWeightedSum> {
+  using FuseWeightedSumBase::FuseWeightedSumBase;
+
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    int64_t fusedSums = 0;
+    int64_t fusedTerms = 0;
+    RewritePatternSet patterns(context);
+    patterns.add<FuseAddTree<BGVAddNewOp, BGVMulNewOp, BGVRescaleNewOp,
+                             BGVEncodeOp, BGVWeightedSumNewOp>,
+                 FuseAddTree<CKKSAddNewOp, CKKSMulNewOp, CKKSRescaleNewOp,
+                             CKKSEncodeOp, CKKSWeightedSumNewOp>>(
+        context, fusedSums, fusedTerms);
+    (void)applyPatternsGreedily(getOperation(), std::move(patterns));
+    numFusedSums += fusedSums;
+    numFusedTerms += fusedTerms;
+  }
+};
+
+}  // namespace lattigo
+}  // namespace heir
+}  // namespace mlir
@@ -12,8 +12,6 @@
 #include "llvm/include/llvm/ADT/APInt.h"              // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"          // from @llvm-project
 #include "llvm/include/llvm/Support/LogicalResult.h"  // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Affine/IR/AffineOps.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
@@ -485,14 +483,12 @@ struct LinalgToTensorExt
     auto *module = getOperation();
     ConversionTarget target(*context);
 
-    DataFlowSolver solver;
-    solver.load<dataflow::DeadCodeAnalysis>();
-    solver.load<dataflow::SparseConstantPropagation>();
-    solver.load<SecretnessAnalysis>();
+    // The dialect conversion driver does not notify a listener, so the
+    // analysis is not preserved.
+    auto &secretness = getAnalysis<CachedSecretnessAnalysis>();
+    DataFlowSolver *solver = secretness.getSolver();
 
-    auto result = solver.initializeAndRun(module);
-
-    if (failed(result)) {
+    if (failed(secretness.getStatus())) {
       getOperation()->emitOpError() << "Failed to run the analysis.\n";
       signalPassFailure();
       return;
@@ -505,9 +501,9 @@ struct LinalgToTensorExt
     RewritePatternSet patterns(context);
 
     patterns.add<SecretGenericOpLinalgMatmulConversion>(
-        replicatedTypeConverter, &solver, context, tilingSize);
+        replicatedTypeConverter, solver, context, tilingSize);
     target.addDynamicallyLegalOp<secret::GenericOp>([&](secret::GenericOp op) {
-      return !isSquatPackableMatmul(op, &solver);
+      return !isSquatPackableMatmul(op, solver);
     });
 
     addStructuralConversionPatterns(replicatedTypeConverter, patterns, target);
@@ -520,7 +516,7 @@ struct LinalgToTensorExt
         if (auto secretTy = dyn_cast<secret::SecretType>(value.getType())) {
           for (auto use : value.getUsers()) {
             if (auto genericOp = dyn_cast<secret::GenericOp>(use)) {
-              if (isSquatPackableMatmul(genericOp, &solver)) {
+              if (isSquatPackableMatmul(genericOp, solver)) {
                 valueUsedInMatmul = true;
                 break;
               }
@@ -539,7 +535,7 @@ struct LinalgToTensorExt
         if (auto secretTy = dyn_cast<secret::SecretType>(value.getType())) {
           if (auto genericOp =
                   dyn_cast_or_null<secret::GenericOp>(value.getDefiningOp())) {
-            if (isSquatPackableMatmul(genericOp, &solver)) {
+            if (isSquatPackableMatmul(genericOp, solver)) {
               return failure();
             }
           }
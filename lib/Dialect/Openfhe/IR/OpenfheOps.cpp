@@ -9,6 +9,7 @@
 #include "mlir/include/mlir/IR/Location.h"            // from @llvm-project
 #include "mlir/include/mlir/IR/MLIRContext.h"         // from @llvm-project
 #include "mlir/include/mlir/IR/Types.h"               // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"               // from @llvm-project
 #include "mlir/include/mlir/Support/LLVM.h"           // from @llvm-project
 #include "mlir/include/mlir/Support/LogicalResult.h"  // from @llvm-project
 
@@ -38,6 +39,22 @@ LogicalResult MakeCKKSPackedPlaintextOp::verify() {
   return success();
 }
 
+LogicalResult LinearWSumOp::verify() {
+  if (getCiphertexts().empty()) {
+    return emitOpError("expected at least one ciphertext.");
+  }
+  if (getCiphertexts().size() != getWeights().size()) {
+    return emitOpError("expected as many weights as ciphertexts.");
+  }
+  Type ciphertextType = getCiphertexts().front().getType();
+  for (Value ciphertext : getCiphertexts()) {
+    if (ciphertext.getType() != ciphertextType) {
+      return emitOpError("expected all ciphertexts to have the same type.");
+    }
+  }
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // Op type inference.
 //===----------------------------------------------------------------------===//
@@ -80,6 +80,7 @@ bool hasBootstrapOp(func::FuncOp op) {
 LogicalResult generateGenFunc(func::FuncOp op, const std::string &genFuncName,
                               int64_t mulDepth, bool hasBootstrapOp,
                               bool insecure, bool encryptionTechniqueExtended,
+                              int64_t numLargeDigits,
                               ImplicitLocOpBuilder &builder) {
   Type openfheContextType =
       openfhe::CryptoContextType::get(builder.getContext());
@@ -121,7 +122,7 @@ LogicalResult generateGenFunc(func::FuncOp op, const std::string &genFuncName,
   Type openfheParamsType = openfhe::CCParamsType::get(builder.getContext());
   Value ccParams = builder.create<openfhe::GenParamsOp>(
       openfheParamsType, mulDepth, plainMod, insecure, evalAddCount,
-      keySwitchCount, encryptionTechniqueExtended);
+      keySwitchCount, encryptionTechniqueExtended, numLargeDigits);
   Value cryptoContext = builder.create<openfhe::GenContextOp>(
       openfheContextType, ccParams,
       BoolAttr::get(builder.getContext(), hasBootstrapOp));
@@ -134,7 +135,8 @@ LogicalResult generateGenFunc(func::FuncOp op, const std::string &genFuncName,
 LogicalResult generateConfigFunc(
     func::FuncOp op, const std::string &configFuncName, bool hasRelinOp,
     SmallVector<int64_t> rotIndices, bool hasBootstrapOp, int levelBudgetEncode,
-    int levelBudgetDecode, ImplicitLocOpBuilder &builder) {
+    int levelBudgetDecode, const std::string &keyCacheDir,
+    ImplicitLocOpBuilder &builder) {
   Type openfheContextType =
       openfhe::CryptoContextType::get(builder.getContext());
   Type privateKeyType = openfhe::PrivateKeyType::get(builder.getContext());
@@ -170,13 +172,85 @@ LogicalResult generateConfigFunc(
                          levelBudgetDecode));
     builder.create<openfhe::GenBootstrapKeyOp>(cryptoContext, privateKey);
   }
+  if (!keyCacheDir.empty()) {
+    builder.create<openfhe::SaveCryptoContextOp>(cryptoContext, keyCacheDir);
+  }
 
   builder.create<func::ReturnOp>(cryptoContext);
   return success();
 }
 
+// function that loads the crypto context and evaluation keys saved by the
+// configuration function
+LogicalResult generateLoadFunc(const std::string &loadFuncName,
+                               bool hasBootstrapOp, int levelBudgetEncode,
+                               int levelBudgetDecode,
+                               const std::string &keyCacheDir,
+                               ImplicitLocOpBuilder &builder) {
+  Type openfheContextType =
+      openfhe::CryptoContextType::get(builder.getContext());
+  FunctionType loadFuncType =
+      FunctionType::get(builder.getContext(), {}, {openfheContextType});
+  auto loadFuncOp = builder.create<func::FuncOp>(loadFuncName, loadFuncType);
+  builder.setInsertionPointToEnd(loadFuncOp.addEntryBlock());
+
+  Value cryptoContext = builder.create<openfhe::LoadCryptoContextOp>(
+      openfheContextType, keyCacheDir);
+  // The bootstrapping keys are serialized with the other evaluation keys, but
+  // the precomputations of the bootstrapping setup are not.
+  if (hasBootstrapOp) {
+    builder.create<openfhe::SetupBootstrapOp>(
+        cryptoContext,
+        IntegerAttr::get(IndexType::get(builder.getContext()),
+                         levelBudgetEncode),
+        IntegerAttr::get(IndexType::get(builder.getContext()),
+                         levelBudgetDecode));
+  }
+
+  builder.create<func::ReturnOp>(cryptoContext);
+  return success();
+}
+
+// function that saves the key pair generated by the client next to the
+// crypto context
+LogicalResult generateSaveKeyPairFunc(const std::string &saveFuncName,
+                                      const std::string &keyCacheDir,
+                                      ImplicitLocOpBuilder &builder) {
+  Type publicKeyType = openfhe::PublicKeyType::get(builder.getContext());
+  Type privateKeyType = openfhe::PrivateKeyType::get(builder.getContext());
+  FunctionType saveFuncType = FunctionType::get(
+      builder.getContext(), {publicKeyType, privateKeyType}, {});
+  auto saveFuncOp = builder.create<func::FuncOp>(saveFuncName, saveFuncType);
+  builder.setInsertionPointToEnd(saveFuncOp.addEntryBlock());
+
+  builder.create<openfhe::SaveKeyOp>(saveFuncOp.getArgument(0), keyCacheDir);
+  builder.create<openfhe::SaveKeyOp>(saveFuncOp.getArgument(1), keyCacheDir);
+  builder.create<func::ReturnOp>();
+  return success();
+}
+
+// function that loads a key saved by the function above, once the crypto
+// context is loaded
+LogicalResult generateLoadKeyFunc(const std::string &loadFuncName,
+                                  Type keyType, const std::string &keyCacheDir,
+                                  ImplicitLocOpBuilder &builder) {
+  Type openfheContextType =
+      openfhe::CryptoContextType::get(builder.getContext());
+  FunctionType loadFuncType =
+      FunctionType::get(builder.getContext(), {openfheContextType}, {keyType});
+  auto loadFuncOp = builder.create<func::FuncOp>(loadFuncName, loadFuncType);
+  builder.setInsertionPointToEnd(loadFuncOp.addEntryBlock());
+
+  Value key = builder.create<openfhe::LoadKeyOp>(
+      keyType, loadFuncOp.getArgument(0), keyCacheDir);
+  builder.create<func::ReturnOp>(key);
+  return success();
+}
+
 LogicalResult convertFunc(func::FuncOp op, int levelBudgetEncode,
-                          int levelBudgetDecode, bool insecure) {
+                          int levelBudgetDecode, bool insecure,
+                          const std::string &keyCacheDir,
+                          bool minimizeRuntime) {
   auto module = op->getParentOfType<ModuleOp>();
   std::string genFuncName("");
   llvm::raw_string_ostream genNameOs(genFuncName);
@@ -189,10 +263,22 @@ LogicalResult convertFunc(func::FuncOp op, int levelBudgetEncode,
   ImplicitLocOpBuilder builder =
       ImplicitLocOpBuilder::atBlockEnd(module.getLoc(), module.getBody());
 
+  // With minimize-runtime, the generated parameters fix the number of special
+  // primes of HYBRID key switching, from which OpenFHE recovers
+  // dnum = ceil(|Q| / |P|). Otherwise OpenFHE keeps its default.
+  auto getNumLargeDigits = [&](ArrayRef<int64_t> q,
+                               ArrayRef<int64_t> p) -> int64_t {
+    if (!minimizeRuntime || p.empty()) return 0;
+    return (q.size() + p.size() - 1) / p.size();
+  };
+
   bool encryptionTechniqueExtended = false;
+  int64_t numLargeDigits = 0;
   // remove bgv.schemeParam attribute if present
   if (auto schemeParamAttr = module->getAttrOfType<bgv::SchemeParamAttr>(
           bgv::BGVDialect::kSchemeParamAttrName)) {
+    numLargeDigits = getNumLargeDigits(schemeParamAttr.getQ().asArrayRef(),
+                                       schemeParamAttr.getP().asArrayRef());
     if (moduleIsBGV(module) && schemeParamAttr.getEncryptionTechnique() ==
                                    bgv::BGVEncryptionTechnique::extended) {
       module->emitError(
@@ -207,6 +293,8 @@ LogicalResult convertFunc(func::FuncOp op, int levelBudgetEncode,
   // remove ckks.schemeParam attribute if present
   if (auto schemeParamAttr = module->getAttrOfType<ckks::SchemeParamAttr>(
           ckks::CKKSDialect::kSchemeParamAttrName)) {
+    numLargeDigits = getNumLargeDigits(schemeParamAttr.getQ().asArrayRef(),
+                                       schemeParamAttr.getP().asArrayRef());
     module->removeAttr(ckks::CKKSDialect::kSchemeParamAttrName);
   }
 
@@ -231,9 +319,12 @@ LogicalResult convertFunc(func::FuncOp op, int levelBudgetEncode,
   int bootstrapDepth = levelBudgetEncode + 14 + levelBudgetDecode;
   if (hasBootstrapOpResult) {
     mulDepth += bootstrapDepth;
+    // the scheme parameters do not model the bootstrapping levels
+    numLargeDigits = 0;
   }
   if (failed(generateGenFunc(op, genFuncName, mulDepth, hasBootstrapOpResult,
-                             insecure, encryptionTechniqueExtended, builder))) {
+                             insecure, encryptionTechniqueExtended,
+                             numLargeDigits, builder))) {
     return failure();
   }
 
@@ -244,9 +335,46 @@ LogicalResult convertFunc(func::FuncOp op, int levelBudgetEncode,
   if (failed(generateConfigFunc(op, configFuncName, hasRelinOpResult,
                                 rotIndices, hasBootstrapOpResult,
                                 levelBudgetEncode, levelBudgetDecode,
-                                builder))) {
+                                keyCacheDir, builder))) {
     return failure();
   }
+
+  if (!keyCacheDir.empty()) {
+    std::string loadFuncName("");
+    llvm::raw_string_ostream loadNameOs(loadFuncName);
+    loadNameOs << op.getSymName() << "__load_crypto_context";
+
+    builder.setInsertionPointToEnd(module.getBody());
+    if (failed(generateLoadFunc(loadFuncName, hasBootstrapOpResult,
+                                levelBudgetEncode, levelBudgetDecode,
+                                keyCacheDir, builder))) {
+      return failure();
+    }
+
+    // The key pair is generated by the caller, between the generation and the
+    // configuration of the crypto context, so it is saved by a helper of its
+    // own.
+    std::string symName = op.getSymName().str();
+    builder.setInsertionPointToEnd(module.getBody());
+    if (failed(generateSaveKeyPairFunc(symName + "__save_key_pair",
+                                       keyCacheDir, builder))) {
+      return failure();
+    }
+    builder.setInsertionPointToEnd(module.getBody());
+    if (failed(generateLoadKeyFunc(
+            symName + "__load_public_key",
+            openfhe::PublicKeyType::get(builder.getContext()), keyCacheDir,
+            builder))) {
+      return failure();
+    }
+    builder.setInsertionPointToEnd(module.getBody());
+    if (failed(generateLoadKeyFunc(
+            symName + "__load_private_key",
+            openfhe::PrivateKeyType::get(builder.getContext()), keyCacheDir,
+            builder))) {
+      return failure();
+    }
+  }
   return success();
 }
 
@@ -258,7 +386,8 @@ struct ConfigureCryptoContext
     auto funcOp =
         detectEntryFunction(cast<ModuleOp>(getOperation()), entryFunction);
     if (funcOp && failed(convertFunc(funcOp, levelBudgetEncode,
-                                     levelBudgetDecode, insecure))) {
+                                     levelBudgetDecode, insecure, keyCacheDir,
+                                     minimizeRuntime))) {
       funcOp->emitError("Failed to configure the crypto context for func");
       signalPassFailure();
     }
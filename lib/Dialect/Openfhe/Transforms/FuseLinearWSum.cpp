@@ -0,0 +1,201 @@
+#include "lib/Dialect/Openfhe/Transforms/FuseLinearWSum.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "lib/Dialect/ModuleAttributes.h"
+#include "lib/Dialect/Openfhe/IR/OpenfheOps.h"
+#include "llvm/include/llvm/ADT/SmallVector.h"           // from @llvm-project
+#include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
+#include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinAttributes.h"      // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/Matchers.h"               // from @llvm-project
+#include "mlir/include/mlir/IR/OpDefinition.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/PatternMatch.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/Types.h"                  // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                  // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"              // from @llvm-project
+#include "mlir/include/mlir/Support/LogicalResult.h"     // from @llvm-project
+#include "mlir/include/mlir/Transforms/GreedyPatternRewriteDriver.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace openfhe {
+
+#define GEN_PASS_DEF_FUSELINEARWSUM
+#include "lib/Dialect/Openfhe/Transforms/Passes.h.inc"
+
+namespace {
+
+// Returns the scalar that `plaintext` repeats in all of its slots, either as
+// a constant attribute or as the value of a tensor.splat.
+FailureOr<OpFoldResult> getSplatWeight(Value plaintext) {
+  auto makeOp = plaintext.getDefiningOp<MakeCKKSPackedPlaintextOp>();
+  if (!makeOp) return failure();
+
+  Value value = makeOp.getValue();
+  if (auto extOp = value.getDefiningOp<arith::ExtFOp>()) {
+    value = extOp.getIn();
+  }
+  if (auto splatOp = value.getDefiningOp<tensor::SplatOp>()) {
+    if (!isa<FloatType>(splatOp.getInput().getType())) return failure();
+    return OpFoldResult(splatOp.getInput());
+  }
+  DenseElementsAttr denseAttr;
+  if (matchPattern(value, m_Constant(&denseAttr)) && denseAttr.isSplat()) {
+    return OpFoldResult(denseAttr.getSplatValue<Attribute>());
+  }
+  return failure();
+}
+
+// A product of a ciphertext and a plaintext with the same scalar in all
+// slots, possibly followed by a mod_reduce.
+struct WeightedTerm {
+  MulPlainOp mulOp;
+  ModReduceOp modReduceOp;
+  OpFoldResult weight;
+};
+
+FailureOr<WeightedTerm> getWeightedTerm(Value value) {
+  WeightedTerm term;
+  if (auto modReduceOp = value.getDefiningOp<ModReduceOp>()) {
+    if (!modReduceOp->hasOneUse()) return failure();
+    term.modReduceOp = modReduceOp;
+    value = modReduceOp.getCiphertext();
+  }
+  auto mulOp = value.getDefiningOp<MulPlainOp>();
+  if (!mulOp || !mulOp->hasOneUse()) return failure();
+  auto weight = getSplatWeight(mulOp.getPlaintext());
+  if (failed(weight)) return failure();
+  term.mulOp = mulOp;
+  term.weight = weight.value();
+  return term;
+}
+
+// Collects the operands of the tree of single-use adds rooted at `value`.
+void collectAddends(Value value, bool isRoot, SmallVector<Value> &addends) {
+  auto addOp = value.getDefiningOp<AddOp>();
+  if (!addOp || (!isRoot && !addOp->hasOneUse())) {
+    addends.push_back(value);
+    return;
+  }
+  collectAddends(addOp.getLhs(), /*isRoot=*/false, addends);
+  collectAddends(addOp.getRhs(), /*isRoot=*/false, addends);
+}
+
+Value materializeWeight(PatternRewriter &rewriter, Location loc,
+                        OpFoldResult weight) {
+  Type f64Type = rewriter.getF64Type();
+  if (auto attr = dyn_cast<Attribute>(weight)) {
+    double doubleValue =
+        isa<FloatAttr>(attr)
+            ? cast<FloatAttr>(attr).getValueAsDouble()
+            : static_cast<double>(cast<IntegerAttr>(attr).getInt());
+    return rewriter.create<arith::ConstantOp>(
+        loc, rewriter.getF64FloatAttr(doubleValue));
+  }
+  auto value = cast<Value>(weight);
+  if (value.getType() == f64Type) return value;
+  return rewriter.create<arith::ExtFOp>(loc, f64Type, value);
+}
+
+}  // namespace
+
+// Rewrites the tree of adds rooted at an add whose addends include
+// `ct_i * pt_i`, where each pt_i is a constant or splat, into a linear_wsum.
+struct FuseAddTree : public OpRewritePattern<AddOp> {
+  FuseAddTree(MLIRContext *context, int64_t &numFusedSums,
+              int64_t &numFusedTerms)
+      : OpRewritePattern<AddOp>(context),
+        numFusedSums(numFusedSums),
+        numFusedTerms(numFusedTerms) {}
+
+  LogicalResult matchAndRewrite(AddOp op,
+                                PatternRewriter &rewriter) const override {
+    // Only rewrite from the root of a tree of adds.
+    if (op->hasOneUse() && isa<AddOp>(*op->getUsers().begin())) {
+      return failure();
+    }
+
+    SmallVector<Value> addends;
+    collectAddends(op.getResult(), /*isRoot=*/true, addends);
+
+    // The terms are fused if their products have the same type and are all
+    // (or none of them) mod reduced, so that they can share one rescale.
+    SmallVector<WeightedTerm> terms;
+    SmallVector<Value> otherAddends;
+    for (Value addend : addends) {
+      auto term = getWeightedTerm(addend);
+      if (succeeded(term) &&
+          (terms.empty() ||
+           (term->mulOp.getCiphertext().getType() ==
+                terms.front().mulOp.getCiphertext().getType() &&
+            term->mulOp.getType() == terms.front().mulOp.getType() &&
+            static_cast<bool>(term->modReduceOp) ==
+                static_cast<bool>(terms.front().modReduceOp)))) {
+        terms.push_back(term.value());
+        continue;
+      }
+      otherAddends.push_back(addend);
+    }
+    if (terms.size() < 2) {
+      return rewriter.notifyMatchFailure(op, "fewer than two weighted terms");
+    }
+    ModReduceOp modReduceOp = terms.front().modReduceOp;
+    Type sumType = modReduceOp ? modReduceOp.getType()
+                               : terms.front().mulOp.getType();
+    if (otherAddends.empty() && sumType != op.getType()) {
+      return rewriter.notifyMatchFailure(op, "fused sum has a different type");
+    }
+
+    Value cryptoContext = op.getCryptoContext();
+    SmallVector<Value> ciphertexts;
+    SmallVector<Value> weights;
+    for (const WeightedTerm &term : terms) {
+      ciphertexts.push_back(term.mulOp.getCiphertext());
+      weights.push_back(materializeWeight(rewriter, op.getLoc(), term.weight));
+    }
+    Value result = rewriter.create<LinearWSumOp>(
+        op.getLoc(), terms.front().mulOp.getType(), cryptoContext, ciphertexts,
+        weights);
+    if (modReduceOp) {
+      result = rewriter.create<ModReduceOp>(op.getLoc(), sumType,
+                                            cryptoContext, result);
+    }
+    for (Value addend : otherAddends) {
+      result = rewriter.create<AddOp>(op.getLoc(), op.getType(), cryptoContext,
+                                      result, addend);
+    }
+
+    numFusedSums += 1;
+    numFusedTerms += terms.size();
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+
+ private:
+  int64_t &numFusedSums;
+  int64_t &numFusedTerms;
+};
+
+struct FuseLinearWSum : impl::FuseLinearWSumBase<FuseLinearWSum> {
+  using FuseLinearWSumBase::FuseLinearWSumBase;
+
+  void runOnOperation() override {
+    // EvalLinearWSum is only implemented for CKKS.
+    if (!moduleIsCKKS(getOperation())) return;
+
+    int64_t fusedSums = 0;
+    int64_t fusedTerms = 0;
+    RewritePatternSet patterns(&getContext());
+    patterns.add<FuseAddTree>(&getContext(), fusedSums, fusedTerms);
+    (void)applyPatternsGreedily(getOperation(), std::move(patterns));
+    numFusedSums += fusedSums;
+    numFusedTerms += fusedTerms;
+  }
+};
+
+}  // namespace openfhe
+}  // namespace heir
+}  // namespace mlir
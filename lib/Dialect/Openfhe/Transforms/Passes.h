@@ -4,6 +4,7 @@
 #include "lib/Dialect/Openfhe/IR/OpenfheDialect.h"
 #include "lib/Dialect/Openfhe/Transforms/ConfigureCryptoContext.h"
 #include "lib/Dialect/Openfhe/Transforms/CountAddAndKeySwitch.h"
+#include "lib/Dialect/Openfhe/Transforms/FuseLinearWSum.h"
 
 namespace mlir {
 namespace heir {
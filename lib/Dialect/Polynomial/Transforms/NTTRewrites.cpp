@@ -3,6 +3,7 @@
 #include <utility>
 
 #include "lib/Dialect/Polynomial/IR/PolynomialOps.h"
+#include "lib/Utils/APIntUtils.h"
 #include "mlir/include/mlir/IR/MLIRContext.h"   // from @llvm-project
 #include "mlir/include/mlir/IR/PatternMatch.h"  // from @llvm-project
 #include "mlir/include/mlir/Transforms/GreedyPatternRewriteDriver.h"  // from @llvm-project
@@ -23,8 +24,7 @@ struct PolyMulToNTT : impl::PolyMulToNTTBase<PolyMulToNTT> {
   void runOnOperation() override {
     MLIRContext *context = &getContext();
     RewritePatternSet patterns(context);
-    // TODO(#1095): migrate to mod arith type
-    // patterns.add<rewrites::NTTRewritePolyMul>(patterns.getContext());
+    patterns.add<rewrites::NTTRewritePolyMul>(patterns.getContext());
     // TODO (#1221): Investigate whether folding (default: on) can be skipped
     // here.
     (void)applyPatternsGreedily(getOperation(), std::move(patterns));
@@ -0,0 +1,325 @@
+#include "lib/Dialect/Polynomial/Transforms/OptimizeNTTPlacement.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "lib/Dialect/ModArith/IR/ModArithOps.h"
+#include "lib/Dialect/ModArith/IR/ModArithTypes.h"
+#include "lib/Dialect/Polynomial/IR/PolynomialAttributes.h"
+#include "lib/Dialect/Polynomial/IR/PolynomialOps.h"
+#include "lib/Dialect/Polynomial/IR/PolynomialTypes.h"
+#include "lib/Utils/APIntUtils.h"
+#include "llvm/include/llvm/ADT/APInt.h"                 // from @llvm-project
+#include "llvm/include/llvm/ADT/DenseMap.h"              // from @llvm-project
+#include "llvm/include/llvm/ADT/DenseSet.h"              // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"           // from @llvm-project
+#include "llvm/include/llvm/ADT/TypeSwitch.h"            // from @llvm-project
+#include "llvm/include/llvm/Support/Debug.h"             // from @llvm-project
+#include "llvm/include/llvm/Support/MathExtras.h"        // from @llvm-project
+#include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Block.h"                  // from @llvm-project
+#include "mlir/include/mlir/IR/Builders.h"               // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                  // from @llvm-project
+#include "mlir/include/mlir/IR/Visitors.h"               // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"              // from @llvm-project
+
+#define DEBUG_TYPE "optimize-ntt-placement"
+
+namespace mlir {
+namespace heir {
+namespace polynomial {
+
+#define GEN_PASS_DEF_OPTIMIZENTTPLACEMENT
+#include "lib/Dialect/Polynomial/Transforms/Passes.h.inc"
+
+namespace {
+
+// Returns the type of the evaluation form of a value of type `type`, or a
+// null type if its ring does not support the NTT.
+RankedTensorType getEvaluationType(Type type) {
+  auto polyType = dyn_cast<PolynomialType>(type);
+  if (!polyType) return nullptr;
+  RingAttr ring = polyType.getRing();
+  auto coefficientType =
+      dyn_cast<mod_arith::ModArithType>(ring.getCoefficientType());
+  if (!coefficientType) return nullptr;
+  unsigned degree = ring.getPolynomialModulus().getPolynomial().getDegree();
+  if (!llvm::isPowerOf2_32(degree)) return nullptr;
+  // The negacyclic NTT needs a prime q with a primitive 2n-th root of unity.
+  APInt modulus = coefficientType.getModulus().getValue();
+  if (modulus.urem(2 * degree) != 1 || !isPrime(modulus)) return nullptr;
+  return RankedTensorType::get({static_cast<int64_t>(degree)},
+                               ring.getCoefficientType(), ring);
+}
+
+// Whether `op` can be computed pointwise on evaluation forms.
+bool isSupported(Operation *op) {
+  return isa<MulOp, AddOp, SubOp, MulScalarOp>(op) &&
+         getEvaluationType(op->getResult(0).getType());
+}
+
+// Whether `op` can be computed in either form.
+bool isLinear(Operation *op) {
+  return isa<AddOp, SubOp, MulScalarOp>(op) && isSupported(op);
+}
+
+// Transforms are only matched when they use the default primitive root, like
+// the ones created by this pass.
+bool isDefaultNTT(Operation *op) {
+  if (auto nttOp = dyn_cast<NTTOp>(op)) return !nttOp.getRoot().has_value();
+  if (auto inttOp = dyn_cast<INTTOp>(op)) return !inttOp.getRoot().has_value();
+  return false;
+}
+
+// The representations in which the users of the values of a block consume
+// them, computed backwards over the block.
+struct Demands {
+  // Values with a user that only accepts the coefficient form: an op that is
+  // not supported, or an op of another block.
+  DenseSet<Value> requiresCoefficient;
+  // Values with a user that only accepts the evaluation form: a
+  // polynomial.mul or a polynomial.ntt.
+  DenseSet<Value> requiresEvaluation;
+  // Values that are eventually consumed in coefficient (resp. evaluation)
+  // form, directly or through linear ops.
+  DenseSet<Value> wantsCoefficient;
+  DenseSet<Value> wantsEvaluation;
+};
+
+Demands computeDemands(Block *block) {
+  Demands demands;
+  for (Operation &op : llvm::reverse(block->getOperations())) {
+    for (Value result : op.getResults()) {
+      for (Operation *user : result.getUsers()) {
+        if (user->getBlock() != block) {
+          demands.requiresCoefficient.insert(result);
+          demands.wantsCoefficient.insert(result);
+        } else if (isa<MulOp>(user) && isSupported(user)) {
+          demands.requiresEvaluation.insert(result);
+          demands.wantsEvaluation.insert(result);
+        } else if (isa<NTTOp>(user) && isDefaultNTT(user)) {
+          demands.requiresEvaluation.insert(result);
+          demands.wantsEvaluation.insert(result);
+        } else if (isLinear(user)) {
+          // Users come later in the block, so their demands are known.
+          Value userResult = user->getResult(0);
+          if (demands.wantsCoefficient.contains(userResult))
+            demands.wantsCoefficient.insert(result);
+          if (demands.wantsEvaluation.contains(userResult))
+            demands.wantsEvaluation.insert(result);
+        } else {
+          demands.requiresCoefficient.insert(result);
+          demands.wantsCoefficient.insert(result);
+        }
+      }
+    }
+  }
+  return demands;
+}
+
+class NTTPlacement {
+ public:
+  explicit NTTPlacement(DenseMap<Value, Value> &evaluationForms)
+      : evaluationForms(evaluationForms) {}
+
+  void run(Block *block) {
+    demands = computeDemands(block);
+    nttCache.clear();
+    for (Operation &op : llvm::make_early_inc_range(block->getOperations())) {
+      if (auto inttOp = dyn_cast<INTTOp>(op)) {
+        if (isDefaultNTT(inttOp))
+          evaluationForms[inttOp.getOutput()] = inttOp.getInput();
+      } else if (auto nttOp = dyn_cast<NTTOp>(op)) {
+        if (isDefaultNTT(nttOp)) visitNTT(nttOp);
+      } else if (isa<MulOp>(op) && isSupported(&op)) {
+        computeInEvaluationForm(&op);
+      } else if (isLinear(&op) && prefersEvaluationForm(&op)) {
+        computeInEvaluationForm(&op);
+      }
+    }
+  }
+
+ private:
+  // Returns the evaluation form of `value`, converting it right before `op`
+  // if needed.
+  Value getEvaluationForm(Value value, Operation *op) {
+    if (Value form = evaluationForms.lookup(value)) return form;
+    if (Value form = nttCache.lookup(value)) return form;
+    OpBuilder builder(op);
+    auto nttOp = builder.create<NTTOp>(
+        op->getLoc(), getEvaluationType(value.getType()), value, nullptr);
+    nttCache[value] = nttOp.getOutput();
+    return nttOp.getOutput();
+  }
+
+  void visitNTT(NTTOp nttOp) {
+    Value input = nttOp.getInput();
+    Value form = evaluationForms.lookup(input);
+    if (!form) form = nttCache.lookup(input);
+    if (form && form.getType() == nttOp.getOutput().getType()) {
+      nttOp.replaceAllUsesWith(form);
+      nttOp.erase();
+      return;
+    }
+    nttCache[input] = nttOp.getOutput();
+  }
+
+  // Compares the number of transforms needed to compute the linear op `op` in
+  // each form, preferring to stay in the form of its operands on a tie.
+  bool prefersEvaluationForm(Operation *op) {
+    int evaluationCost = 0;
+    int coefficientCost = 0;
+    bool anyInEvaluationForm = false;
+    for (Value operand : op->getOperands()) {
+      if (!isa<PolynomialType>(operand.getType())) continue;
+      if (evaluationForms.contains(operand)) {
+        anyInEvaluationForm = true;
+        // Values computed in evaluation form are only converted back when
+        // some user requires it.
+        if (!demands.requiresCoefficient.contains(operand)) ++coefficientCost;
+      } else if (!nttCache.contains(operand) &&
+                 !demands.requiresEvaluation.contains(operand)) {
+        ++evaluationCost;
+      }
+    }
+    Value result = op->getResult(0);
+    if (demands.wantsCoefficient.contains(result)) ++evaluationCost;
+    if (demands.wantsEvaluation.contains(result)) ++coefficientCost;
+
+    LLVM_DEBUG(llvm::dbgs() << "Cost of " << op->getName()
+                            << " in evaluation form: " << evaluationCost
+                            << ", in coefficient form: " << coefficientCost
+                            << "\n");
+    if (evaluationCost != coefficientCost)
+      return evaluationCost < coefficientCost;
+    return anyInEvaluationForm;
+  }
+
+  // Replaces `op` with its pointwise equivalent on evaluation forms, followed
+  // by a polynomial.intt that is removed at the end if no user requires the
+  // coefficient form.
+  void computeInEvaluationForm(Operation *op) {
+    OpBuilder builder(op);
+    Location loc = op->getLoc();
+    RankedTensorType evaluationType =
+        getEvaluationType(op->getResult(0).getType());
+    Value form =
+        llvm::TypeSwitch<Operation *, Value>(op)
+            .Case<MulOp>([&](MulOp mulOp) {
+              return builder
+                  .create<mod_arith::MulOp>(
+                      loc, getEvaluationForm(mulOp.getLhs(), op),
+                      getEvaluationForm(mulOp.getRhs(), op))
+                  .getResult();
+            })
+            .Case<AddOp>([&](AddOp addOp) {
+              return builder
+                  .create<mod_arith::AddOp>(
+                      loc, getEvaluationForm(addOp.getLhs(), op),
+                      getEvaluationForm(addOp.getRhs(), op))
+                  .getResult();
+            })
+            .Case<SubOp>([&](SubOp subOp) {
+              return builder
+                  .create<mod_arith::SubOp>(
+                      loc, getEvaluationForm(subOp.getLhs(), op),
+                      getEvaluationForm(subOp.getRhs(), op))
+                  .getResult();
+            })
+            .Case<MulScalarOp>([&](MulScalarOp mulScalarOp) {
+              // The NTT is linear, so scaling the coefficients scales the
+              // evaluations.
+              Value polynomial =
+                  getEvaluationForm(mulScalarOp.getPolynomial(), op);
+              auto splatOp = builder.create<tensor::SplatOp>(
+                  loc, mulScalarOp.getScalar(), evaluationType);
+              return builder
+                  .create<mod_arith::MulOp>(loc, polynomial,
+                                            splatOp.getResult())
+                  .getResult();
+            });
+
+    Value result = op->getResult(0);
+    auto inttOp = builder.create<INTTOp>(loc, result.getType(), form, nullptr);
+    evaluationForms[inttOp.getOutput()] = form;
+    if (demands.requiresCoefficient.contains(result))
+      demands.requiresCoefficient.insert(inttOp.getOutput());
+    if (demands.requiresEvaluation.contains(result))
+      demands.requiresEvaluation.insert(inttOp.getOutput());
+    result.replaceAllUsesWith(inttOp.getOutput());
+    op->erase();
+  }
+
+  // Evaluation forms of values computed by a polynomial.intt, which dominate
+  // every use of these values.
+  DenseMap<Value, Value> &evaluationForms;
+  // Evaluation forms created in the current block, which may not dominate
+  // uses outside of it.
+  DenseMap<Value, Value> nttCache;
+  Demands demands;
+};
+
+// Returns the number of ntt and intt ops under `op`.
+std::pair<int64_t, int64_t> countTransforms(Operation *op) {
+  int64_t numNTT = 0;
+  int64_t numINTT = 0;
+  op->walk([&](Operation *nested) {
+    if (isa<NTTOp>(nested)) ++numNTT;
+    if (isa<INTTOp>(nested)) ++numINTT;
+  });
+  return {numNTT, numINTT};
+}
+
+}  // namespace
+
+struct OptimizeNTTPlacement
+    : impl::OptimizeNTTPlacementBase<OptimizeNTTPlacement> {
+  using OptimizeNTTPlacementBase::OptimizeNTTPlacementBase;
+
+  void runOnOperation() override {
+    auto [numNTTBefore, numINTTBefore] = countTransforms(getOperation());
+    int64_t numMuls = 0;
+    getOperation()->walk([&](MulOp mulOp) {
+      if (isSupported(mulOp)) ++numMuls;
+    });
+
+    // Blocks are visited before the blocks nested in them, so that nested
+    // uses see the evaluation forms of the values defined above.
+    SmallVector<Block *> blocks;
+    getOperation()->walk<WalkOrder::PreOrder>(
+        [&](Block *block) { blocks.push_back(block); });
+
+    DenseMap<Value, Value> evaluationForms;
+    NTTPlacement placement(evaluationForms);
+    for (Block *block : blocks) {
+      placement.run(block);
+    }
+
+    // Remove the transforms whose results ended up unused.
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      getOperation()->walk([&](Operation *op) {
+        if (isa<NTTOp, INTTOp>(op) && op->use_empty()) {
+          op->erase();
+          changed = true;
+        }
+      });
+    }
+
+    auto [numNTTAfter, numINTTAfter] = countTransforms(getOperation());
+    numNTTOps = numNTTAfter;
+    numINTTOps = numINTTAfter;
+    int64_t roundTrips = numNTTBefore + numINTTBefore + 3 * numMuls;
+    if (roundTrips > numNTTAfter + numINTTAfter) {
+      numTransformsRemoved = roundTrips - numNTTAfter - numINTTAfter;
+    }
+  }
+};
+
+}  // namespace polynomial
+}  // namespace heir
+}  // namespace mlir
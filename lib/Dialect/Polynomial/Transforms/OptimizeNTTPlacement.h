@@ -0,0 +1,19 @@
+#ifndef LIB_DIALECT_POLYNOMIAL_TRANSFORMS_OPTIMIZENTTPLACEMENT_H_
+#define LIB_DIALECT_POLYNOMIAL_TRANSFORMS_OPTIMIZENTTPLACEMENT_H_
+
+#include "lib/Dialect/ModArith/IR/ModArithDialect.h"
+#include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/Pass/Pass.h"                 // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace polynomial {
+
+#define GEN_PASS_DECL_OPTIMIZENTTPLACEMENT
+#include "lib/Dialect/Polynomial/Transforms/Passes.h.inc"
+
+}  // namespace polynomial
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_DIALECT_POLYNOMIAL_TRANSFORMS_OPTIMIZENTTPLACEMENT_H_
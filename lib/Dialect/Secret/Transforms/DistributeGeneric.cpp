@@ -16,8 +16,6 @@
 #include "llvm/include/llvm/ADT/SmallVector.h"  // from @llvm-project
 #include "llvm/include/llvm/Support/Casting.h"  // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"    // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"     // from @llvm-project
 #include "mlir/include/mlir/IR/Attributes.h"               // from @llvm-project
@@ -703,14 +701,12 @@ struct DistributeGeneric
       }
     });
 
-    DataFlowSolver solver;
-    solver.load<dataflow::DeadCodeAnalysis>();
-    solver.load<dataflow::SparseConstantPropagation>();
-    solver.load<SecretnessAnalysis>();
+    // SplitGeneric re-runs the solver on the generics it creates, and the
+    // other patterns are not tracked, so the analysis is not preserved.
+    auto &secretness = getAnalysis<CachedSecretnessAnalysis>();
+    DataFlowSolver *solver = secretness.getSolver();
 
-    auto result = solver.initializeAndRun(getOperation());
-
-    if (failed(result)) {
+    if (failed(secretness.getStatus())) {
       getOperation()->emitOpError() << "Failed to run the analysis.\n";
       signalPassFailure();
       return;
@@ -721,7 +717,7 @@ struct DistributeGeneric
     // move dialect attrs from secret generic op arg to func arg
     moveDialectAttrsToFuncArgument(getOperation());
 
-    patterns.add<SplitGeneric>(context, opsToDistribute, &solver);
+    patterns.add<SplitGeneric>(context, opsToDistribute, solver);
     // These patterns are shared with canonicalization
     patterns.add<FoldSecretSeparators, CollapseSecretlessGeneric,
                  RemoveUnusedGenericArgs, RemoveNonSecretGenericArgs>(context);
@@ -6,8 +6,6 @@
 #include "lib/Dialect/TensorExt/IR/TensorExtOps.h"
 #include "llvm/include/llvm/Support/ErrorHandling.h"  // from @llvm-project
 #include "llvm/include/llvm/Support/LogicalResult.h"  // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"      // from @llvm-project
 #include "mlir/include/mlir/Dialect/Tosa/IR/TosaOps.h"     // from @llvm-project
@@ -115,14 +113,10 @@ struct TosaToSecretArith
     MLIRContext *context = &getContext();
     auto *module = getOperation();
 
-    DataFlowSolver solver;
-    solver.load<dataflow::DeadCodeAnalysis>();
-    solver.load<dataflow::SparseConstantPropagation>();
-    solver.load<SecretnessAnalysis>();
+    auto &secretness = getAnalysis<CachedSecretnessAnalysis>();
+    DataFlowSolver *solver = secretness.getSolver();
 
-    auto result = solver.initializeAndRun(module);
-
-    if (failed(result)) {
+    if (failed(secretness.getStatus())) {
       getOperation()->emitOpError() << "Failed to run the analysis.\n";
       signalPassFailure();
       return;
@@ -130,14 +124,18 @@ struct TosaToSecretArith
 
     RewritePatternSet patterns(context);
 
-    patterns.add<ConvertTosaSigmoid>(&solver, context);
+    patterns.add<ConvertTosaSigmoid>(solver, context);
 
     // Run pattern matching and conversion
+    SecretnessUpdateListener listener(solver);
+    GreedyRewriteConfig config;
+    config.listener = &listener;
     // TODO (#1221): Investigate whether folding (default: on) can be skipped
     // here.
-    if (failed(applyPatternsGreedily(module, std::move(patterns)))) {
+    if (failed(applyPatternsGreedily(module, std::move(patterns), config))) {
       return signalPassFailure();
     }
+    markAnalysesPreserved<CachedSecretnessAnalysis>();
   }
 };
 
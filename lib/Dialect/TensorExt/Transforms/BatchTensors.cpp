@@ -0,0 +1,347 @@
+#include "lib/Dialect/TensorExt/Transforms/BatchTensors.h"
+
+#include <cstdint>
+#include <optional>
+
+#include "lib/Dialect/Secret/IR/SecretOps.h"
+#include "lib/Dialect/Secret/IR/SecretTypes.h"
+#include "lib/Dialect/TensorExt/IR/TensorExtAttributes.h"
+#include "lib/Dialect/TensorExt/IR/TensorExtOps.h"
+#include "llvm/include/llvm/ADT/DenseSet.h"              // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"           // from @llvm-project
+#include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
+#include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"   // from @llvm-project
+#include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Utils/StaticValueUtils.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/AffineExpr.h"            // from @llvm-project
+#include "mlir/include/mlir/IR/AffineMap.h"             // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinAttributes.h"     // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"          // from @llvm-project
+#include "mlir/include/mlir/IR/Diagnostics.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/ImplicitLocOpBuilder.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Matchers.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/OpDefinition.h"          // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                 // from @llvm-project
+#include "mlir/include/mlir/IR/Visitors.h"              // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"             // from @llvm-project
+#include "mlir/include/mlir/Support/LogicalResult.h"    // from @llvm-project
+
+#define DEBUG_NAME "batch-tensors"
+
+namespace mlir {
+namespace heir {
+namespace tensor_ext {
+
+#define GEN_PASS_DEF_BATCHTENSORS
+#include "lib/Dialect/TensorExt/Transforms/Passes.h.inc"
+
+namespace {
+
+// Rewrites a single function so that every secret 1-D tensor of size N holds
+// `batchSize` interleaved inputs, with element i of input b in slot
+// i * batchSize + b. Secret scalars are represented by a batched tensor whose
+// first `batchSize` slots hold the scalar of each input.
+class FunctionBatcher {
+ public:
+  FunctionBatcher(func::FuncOp funcOp, int64_t batchSize)
+      : funcOp(funcOp), batchSize(batchSize) {}
+
+  LogicalResult batch() {
+    if (failed(findTensorSize())) return failure();
+    if (!tensorSize.has_value()) return success();
+
+    if (failed(batchArguments())) return failure();
+    for (Operation &op :
+         llvm::make_early_inc_range(funcOp.getBody().front())) {
+      if (failed(batchTopLevelOp(&op))) return failure();
+    }
+    batchResults();
+    return success();
+  }
+
+ private:
+  // Finds the common size N of the secret tensors in the function, if any.
+  LogicalResult findTensorSize() {
+    auto result = funcOp.walk([&](Operation *op) {
+      SmallVector<Value> values(op->getOperands());
+      for (Region &region : op->getRegions()) {
+        for (Block &block : region) {
+          llvm::append_range(values, block.getArguments());
+        }
+      }
+      for (Value value : values) {
+        auto secretType = dyn_cast<secret::SecretType>(value.getType());
+        if (!secretType) continue;
+        auto tensorType = dyn_cast<RankedTensorType>(secretType.getValueType());
+        if (!tensorType) continue;
+        if (tensorType.getRank() != 1 || !tensorType.hasStaticShape()) {
+          op->emitError() << "expected secret tensors to be statically shaped "
+                             "and one-dimensional, but found "
+                          << secretType;
+          return WalkResult::interrupt();
+        }
+        if (tensorSize.has_value() && *tensorSize != tensorType.getDimSize(0)) {
+          op->emitError() << "expected all secret tensors to have size "
+                          << *tensorSize << ", but found " << secretType;
+          return WalkResult::interrupt();
+        }
+        tensorSize = tensorType.getDimSize(0);
+      }
+      return WalkResult::advance();
+    });
+    return failure(result.wasInterrupted());
+  }
+
+  // Returns the batched type of a plaintext type: tensor<N x T> and T both map
+  // to tensor<(N * batchSize) x T>.
+  FailureOr<RankedTensorType> getBatchedType(Operation *op, Type type) {
+    Type elementType = type;
+    if (auto tensorType = dyn_cast<RankedTensorType>(type)) {
+      if (tensorType.getRank() != 1 ||
+          tensorType.getDimSize(0) != *tensorSize) {
+        return op->emitError() << "cannot batch " << type
+                               << ", expected a tensor of size " << *tensorSize;
+      }
+      elementType = tensorType.getElementType();
+    } else if (!elementType.isIntOrFloat()) {
+      return op->emitError() << "cannot batch values of type " << type;
+    }
+    return RankedTensorType::get({*tensorSize * batchSize}, elementType);
+  }
+
+  // Describes the batched type of a secret value of type `type` and its
+  // layout.
+  tensor_ext::OriginalTypeAttr getOriginalTypeAttr(secret::SecretType type) {
+    MLIRContext *ctx = funcOp.getContext();
+    Type valueType = type.getValueType();
+    if (auto tensorType = dyn_cast<RankedTensorType>(valueType)) {
+      // Input d0, element d1 lives in slot d1 * batchSize + d0.
+      AffineExpr slot =
+          getAffineDimExpr(1, ctx) * batchSize + getAffineDimExpr(0, ctx);
+      auto layout = AffineMap::get(2, 0, slot);
+      auto batchedType = RankedTensorType::get(
+          {batchSize, tensorType.getDimSize(0)}, tensorType.getElementType());
+      return tensor_ext::OriginalTypeAttr::get(
+          ctx, secret::SecretType::get(batchedType), layout);
+    }
+    auto batchedType = RankedTensorType::get({batchSize}, valueType);
+    return tensor_ext::OriginalTypeAttr::get(
+        ctx, secret::SecretType::get(batchedType),
+        AffineMap::getMultiDimIdentityMap(1, ctx));
+  }
+
+  LogicalResult batchArguments() {
+    for (BlockArgument arg : funcOp.getArguments()) {
+      auto secretType = dyn_cast<secret::SecretType>(arg.getType());
+      if (!secretType) continue;
+      if (!isa<RankedTensorType>(secretType.getValueType())) {
+        return funcOp.emitError()
+               << "cannot batch secret scalar argument " << arg.getArgNumber();
+      }
+      auto batchedType = getBatchedType(funcOp, secretType.getValueType());
+      if (failed(batchedType)) return failure();
+      arg.setType(secret::SecretType::get(batchedType.value()));
+      funcOp.setArgAttr(arg.getArgNumber(),
+                        TensorExtDialect::kOriginalTypeAttrName,
+                        getOriginalTypeAttr(secretType));
+      batched.insert(arg);
+    }
+    return success();
+  }
+
+  void batchResults() {
+    SmallVector<Type> oldResultTypes(funcOp.getResultTypes());
+    Block &body = funcOp.getBody().front();
+    Operation *returnOp = body.getTerminator();
+    for (OpOperand &operand : returnOp->getOpOperands()) {
+      if (!isBatched(operand.get())) continue;
+      auto oldType =
+          cast<secret::SecretType>(oldResultTypes[operand.getOperandNumber()]);
+      funcOp.setResultAttr(operand.getOperandNumber(),
+                           TensorExtDialect::kOriginalTypeAttrName,
+                           getOriginalTypeAttr(oldType));
+    }
+    funcOp.setFunctionType(FunctionType::get(funcOp.getContext(),
+                                             body.getArgumentTypes(),
+                                             returnOp->getOperandTypes()));
+  }
+
+  LogicalResult batchTopLevelOp(Operation *op) {
+    bool hasBatchedOperand = llvm::any_of(
+        op->getOperands(), [&](Value value) { return isBatched(value); });
+    if (!hasBatchedOperand || isa<func::ReturnOp>(op)) return success();
+
+    auto genericOp = dyn_cast<secret::GenericOp>(op);
+    if (!genericOp) {
+      return op->emitError() << "cannot batch an operation on secret values "
+                                "outside of a secret.generic";
+    }
+
+    Block *body = genericOp.getBody();
+    for (OpOperand &operand : genericOp->getOpOperands()) {
+      if (!isBatched(operand.get())) continue;
+      BlockArgument arg = body->getArgument(operand.getOperandNumber());
+      arg.setType(
+          cast<secret::SecretType>(operand.get().getType()).getValueType());
+      batched.insert(arg);
+    }
+
+    for (Operation &bodyOp : llvm::make_early_inc_range(*body)) {
+      if (failed(batchBodyOp(&bodyOp))) return failure();
+    }
+
+    for (OpOperand &operand : genericOp.getYieldOp()->getOpOperands()) {
+      if (!isBatched(operand.get())) continue;
+      OpResult result = genericOp->getResult(operand.getOperandNumber());
+      result.setType(secret::SecretType::get(operand.get().getType()));
+      batched.insert(result);
+    }
+    return success();
+  }
+
+  LogicalResult batchBodyOp(Operation *op) {
+    bool hasBatchedOperand = llvm::any_of(
+        op->getOperands(), [&](Value value) { return isBatched(value); });
+    if (!hasBatchedOperand || isa<secret::YieldOp>(op)) return success();
+
+    if (auto rotateOp = dyn_cast<tensor_ext::RotateOp>(op)) {
+      return batchRotate(rotateOp);
+    }
+    if (auto extractOp = dyn_cast<tensor::ExtractOp>(op)) {
+      return batchExtract(extractOp);
+    }
+    if (op->hasTrait<OpTrait::Elementwise>() && op->getNumRegions() == 0) {
+      return batchElementwise(op);
+    }
+    return op->emitError() << "cannot batch this operation on secret values";
+  }
+
+  // A rotation by k within each input is a rotation by k * batchSize.
+  LogicalResult batchRotate(tensor_ext::RotateOp op) {
+    ImplicitLocOpBuilder b(op.getLoc(), op);
+    Value shift = op.getShift();
+    Value newShift;
+    if (std::optional<int64_t> constantShift = getConstantIntValue(shift)) {
+      newShift = b.create<arith::ConstantOp>(
+          b.getIntegerAttr(shift.getType(), *constantShift * batchSize));
+    } else {
+      newShift = b.create<arith::MulIOp>(
+          shift, b.create<arith::ConstantOp>(
+                     b.getIntegerAttr(shift.getType(), batchSize)));
+    }
+    op->setOperand(1, newShift);
+    op.getOutput().setType(op.getTensor().getType());
+    batched.insert(op.getOutput());
+    return success();
+  }
+
+  // Extracting element c of each input rotates it into the first batchSize
+  // slots.
+  LogicalResult batchExtract(tensor::ExtractOp op) {
+    std::optional<int64_t> index = getConstantIntValue(op.getIndices()[0]);
+    if (!index.has_value()) {
+      return op.emitError() << "cannot batch an extraction at a non-constant "
+                               "index";
+    }
+
+    Value replacement = op.getTensor();
+    if (*index != 0) {
+      ImplicitLocOpBuilder b(op.getLoc(), op);
+      replacement = b.create<tensor_ext::RotateOp>(
+          replacement,
+          b.create<arith::ConstantOp>(b.getIndexAttr(*index * batchSize)));
+    }
+    op.getResult().replaceAllUsesWith(replacement);
+    op.erase();
+    batched.insert(replacement);
+    return success();
+  }
+
+  LogicalResult batchElementwise(Operation *op) {
+    for (OpOperand &operand : op->getOpOperands()) {
+      if (isBatched(operand.get())) continue;
+      FailureOr<Value> batchedOperand = batchPlaintext(op, operand.get());
+      if (failed(batchedOperand)) return failure();
+      operand.set(batchedOperand.value());
+    }
+    for (OpResult result : op->getResults()) {
+      auto batchedType = getBatchedType(op, result.getType());
+      if (failed(batchedType)) return failure();
+      result.setType(batchedType.value());
+      batched.insert(result);
+    }
+    return success();
+  }
+
+  // Returns a batched copy of a plaintext operand of `op`: scalars are
+  // splatted and constant tensors have each element repeated batchSize
+  // times.
+  FailureOr<Value> batchPlaintext(Operation *op, Value value) {
+    auto batchedType = getBatchedType(op, value.getType());
+    if (failed(batchedType)) return failure();
+
+    ImplicitLocOpBuilder b(op->getLoc(), op);
+    if (!isa<RankedTensorType>(value.getType())) {
+      return b.create<tensor::SplatOp>(value, batchedType.value()).getResult();
+    }
+
+    DenseElementsAttr attr;
+    if (!matchPattern(value, m_Constant(&attr))) {
+      return op->emitError() << "cannot batch a plaintext tensor operand that "
+                                "is not a constant";
+    }
+    if (attr.isSplat()) {
+      return b
+          .create<arith::ConstantOp>(DenseElementsAttr::get(
+              batchedType.value(), attr.getSplatValue<Attribute>()))
+          .getResult();
+    }
+    SmallVector<Attribute> values;
+    values.reserve(batchedType->getNumElements());
+    for (Attribute element : attr.getValues<Attribute>()) {
+      values.append(batchSize, element);
+    }
+    return b
+        .create<arith::ConstantOp>(
+            DenseElementsAttr::get(batchedType.value(), values))
+        .getResult();
+  }
+
+  bool isBatched(Value value) const { return batched.contains(value); }
+
+  func::FuncOp funcOp;
+  int64_t batchSize;
+  // The common size of the secret tensors before batching.
+  std::optional<int64_t> tensorSize;
+  // The values whose types have been batched.
+  DenseSet<Value> batched;
+};
+
+}  // namespace
+
+struct BatchTensors : impl::BatchTensorsBase<BatchTensors> {
+  using BatchTensorsBase::BatchTensorsBase;
+
+  void runOnOperation() override {
+    if (batchSize < 1) {
+      getOperation()->emitError() << "expected a positive batch size";
+      signalPassFailure();
+      return;
+    }
+    if (batchSize == 1) return;
+
+    auto result = getOperation()->walk([&](func::FuncOp funcOp) {
+      if (funcOp.isDeclaration()) return WalkResult::advance();
+      if (failed(FunctionBatcher(funcOp, batchSize).batch())) {
+        return WalkResult::interrupt();
+      }
+      return WalkResult::advance();
+    });
+    if (result.wasInterrupted()) signalPassFailure();
+  }
+};
+
+}  // namespace tensor_ext
+}  // namespace heir
+}  // namespace mlir
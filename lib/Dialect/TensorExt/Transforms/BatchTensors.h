@@ -0,0 +1,18 @@
+#ifndef LIB_DIALECT_TENSOREXT_TRANSFORMS_BATCHTENSORS_H_
+#define LIB_DIALECT_TENSOREXT_TRANSFORMS_BATCHTENSORS_H_
+
+#include "lib/Dialect/TensorExt/IR/TensorExtDialect.h"
+#include "mlir/include/mlir/Pass/Pass.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace tensor_ext {
+
+#define GEN_PASS_DECL_BATCHTENSORS
+#include "lib/Dialect/TensorExt/Transforms/Passes.h.inc"
+
+}  // namespace tensor_ext
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_DIALECT_TENSOREXT_TRANSFORMS_BATCHTENSORS_H_
@@ -1,18 +1,28 @@
 #include "lib/Dialect/TensorExt/Transforms/ImplementShiftNetwork.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <optional>
-#include <unordered_map>
+#include <string>
+#include <system_error>
 #include <utility>
+#include <vector>
 
 #include "lib/Dialect/TensorExt/IR/TensorExtOps.h"
 #include "lib/Utils/ADT/FrozenVector.h"
 #include "lib/Utils/AffineMapUtils.h"
-#include "lib/Utils/Graph/Graph.h"
+#include "lib/Utils/Graph/DenseGraphColoring.h"
 #include "llvm/include/llvm/ADT/STLExtras.h"           // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallString.h"         // from @llvm-project
 #include "llvm/include/llvm/ADT/SmallVectorExtras.h"   // from @llvm-project
+#include "llvm/include/llvm/ADT/StringExtras.h"        // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"           // from @llvm-project
+#include "llvm/include/llvm/Support/FileSystem.h"      // from @llvm-project
+#include "llvm/include/llvm/Support/MemoryBuffer.h"    // from @llvm-project
+#include "llvm/include/llvm/Support/Path.h"            // from @llvm-project
+#include "llvm/include/llvm/Support/raw_ostream.h"     // from @llvm-project
+#include "llvm/include/llvm/Support/xxhash.h"          // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"  // from @llvm-project
 #include "mlir/include/mlir/IR/AffineMap.h"            // from @llvm-project
 #include "mlir/include/mlir/IR/Attributes.h"           // from @llvm-project
@@ -148,13 +158,109 @@ class ShiftStrategy {
   SmallVector<ShiftRound> rounds;
 };
 
+// Stores computed shift networks as files in a directory, so that compiles
+// that produce the same layouts can reuse them. Each file records the
+// ciphertext size, the permutation, and the rotation group of each index, and
+// is named after a hash of the first two. Unreadable or mismatched files are
+// treated as cache misses.
+class ShiftNetworkDiskCache {
+ public:
+  explicit ShiftNetworkDiskCache(StringRef cacheDir) : cacheDir(cacheDir) {}
+
+  std::optional<SmallVector<RotationGroup>> load(
+      const Permutation &permutation, int64_t ciphertextSize) const {
+    auto buffer =
+        llvm::MemoryBuffer::getFile(getPath(permutation, ciphertextSize));
+    if (!buffer) return std::nullopt;
+
+    SmallVector<StringRef> lines;
+    (*buffer)->getBuffer().split(lines, '\n', /*MaxSplit=*/-1,
+                                 /*KeepEmpty=*/false);
+    if (lines.size() != 3 || lines[0] != getHeader(ciphertextSize) ||
+        lines[1] != join(permutation)) {
+      return std::nullopt;
+    }
+
+    SmallVector<StringRef> groupIds;
+    lines[2].split(groupIds, ' ');
+    if (groupIds.size() != permutation.size()) return std::nullopt;
+    SmallVector<RotationGroup> groups;
+    for (auto [index, groupId] : llvm::enumerate(groupIds)) {
+      unsigned group;
+      if (groupId.getAsInteger(10, group) || group >= permutation.size()) {
+        return std::nullopt;
+      }
+      if (group >= groups.size()) groups.resize(group + 1);
+      groups[group].insert(index);
+    }
+    auto isEmpty = [](const RotationGroup &group) { return group.empty(); };
+    if (llvm::any_of(groups, isEmpty)) return std::nullopt;
+    return groups;
+  }
+
+  void store(const Permutation &permutation, int64_t ciphertextSize,
+             ArrayRef<RotationGroup> groups) const {
+    SmallVector<int64_t> groupIds(permutation.size(), 0);
+    for (auto [group, indices] : llvm::enumerate(groups)) {
+      for (int64_t index : indices) groupIds[index] = group;
+    }
+
+    // Write to a unique file first and rename it into place, so that
+    // concurrent compiles never observe a partially written entry.
+    if (llvm::sys::fs::create_directories(cacheDir)) return;
+    std::string path = getPath(permutation, ciphertextSize);
+    int fd;
+    SmallString<128> tempPath;
+    if (llvm::sys::fs::createUniqueFile(path + ".tmp-%%%%%%", fd, tempPath)) {
+      return;
+    }
+    {
+      llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+      os << getHeader(ciphertextSize) << "\n"
+         << join(permutation) << "\n"
+         << join(groupIds) << "\n";
+    }
+    if (llvm::sys::fs::rename(tempPath, path)) {
+      llvm::sys::fs::remove(tempPath);
+    }
+  }
+
+ private:
+  static std::string getHeader(int64_t ciphertextSize) {
+    return "heir-shift-network-v1 " + std::to_string(ciphertextSize);
+  }
+
+  static std::string join(ArrayRef<int64_t> values) {
+    return llvm::join(
+        llvm::map_range(values, [](int64_t v) { return std::to_string(v); }),
+        " ");
+  }
+
+  std::string getPath(const Permutation &permutation,
+                      int64_t ciphertextSize) const {
+    ArrayRef<int64_t> values = permutation;
+    uint64_t hash = llvm::xxh3_64bits(
+        ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(values.data()),
+                          values.size() * sizeof(int64_t)));
+    std::string filename = std::to_string(ciphertextSize) + "-" +
+                           llvm::utohexstr(hash, /*LowerCase=*/true) + ".txt";
+    SmallString<128> path(cacheDir);
+    llvm::sys::path::append(path, filename);
+    return path.str().str();
+  }
+
+  std::string cacheDir;
+};
+
 // Cf. https://www.jeremykun.com/2024/09/02/shift-networks/
 // and https://link.springer.com/chapter/10.1007/978-3-031-17140-6_20
 // for an explanation of the algorithm.
 class VosVosErkinShiftNetworks {
  public:
-  VosVosErkinShiftNetworks(int64_t ciphertextSize)
-      : ciphertextSize(ciphertextSize) {}
+  VosVosErkinShiftNetworks(int64_t ciphertextSize, StringRef cacheDir = "")
+      : ciphertextSize(ciphertextSize) {
+    if (!cacheDir.empty()) diskCache.emplace(cacheDir);
+  }
 
   // Computes a partition of the slot indices of a ciphertext into
   // RotationGroups that are compatible with respect to the target permutation.
@@ -163,11 +269,20 @@ class VosVosErkinShiftNetworks {
   //
   // The returned ArrayRef is owned by this VosVosErkinShiftNetworks instance.
   // The resulting set of rotation groups are is cached, and the cache is used
-  // on further calls to avoid recomputing the shift network.
+  // on further calls to avoid recomputing the shift network. If a cache
+  // directory was given, the result is also looked up in and saved to it.
   ArrayRef<RotationGroup> computeShiftNetwork(const Permutation &permutation) {
     if (rotationGroups.count(permutation)) {
+      ++numCacheHits;
       return rotationGroups[permutation];
     }
+    if (diskCache) {
+      if (auto cached = diskCache->load(permutation, ciphertextSize)) {
+        ++numCacheHits;
+        rotationGroups[permutation] = std::move(*cached);
+        return rotationGroups[permutation];
+      }
+    }
 
     ShiftStrategy strategy;
     RotationGroup allIndices;
@@ -178,40 +293,46 @@ class VosVosErkinShiftNetworks {
 
     // Create a graph whose vertices are the input indices to permute, and
     // whose edges are conflicts: an edge being present means the two indices
-    // cannot participate in the same rotation group.
-    graph::UndirectedGraph<int64_t> conflictGraph;
-    for (int64_t i = 0; i < ciphertextSize; i++) {
-      conflictGraph.addVertex(i);
-    }
+    // cannot participate in the same rotation group. Two indices conflict when
+    // they land in the same slot in some round, so the indices are bucketed by
+    // slot rather than compared pairwise. The largest bucket is a clique,
+    // which bounds the number of groups from below.
+    graph::DenseUndirectedGraph conflictGraph(ciphertextSize);
+    int maxBucketSize = 1;
+    std::vector<SmallVector<int64_t>> buckets(ciphertextSize);
     for (const ShiftRound &round : strategy.getRounds()) {
+      for (SmallVector<int64_t> &bucket : buckets) bucket.clear();
       for (int64_t i = 0; i < ciphertextSize; i++) {
-        for (int64_t j = i + 1; j < ciphertextSize; j++) {
-          if (round.positions[i] == round.positions[j]) {
-            conflictGraph.addEdge(i, j);
+        buckets[round.positions[i]].push_back(i);
+      }
+      for (const SmallVector<int64_t> &bucket : buckets) {
+        maxBucketSize = std::max<int>(maxBucketSize, bucket.size());
+        for (size_t i = 0; i < bucket.size(); i++) {
+          for (size_t j = i + 1; j < bucket.size(); j++) {
+            conflictGraph.addEdge(bucket[i], bucket[j]);
           }
         }
       }
     }
+    conflictGraph.finalize();
 
     LLVM_DEBUG({
       llvm::dbgs() << "Conflict graph:\n";
-      for (int64_t vertex : conflictGraph.getVertices()) {
+      for (int64_t vertex = 0; vertex < ciphertextSize; ++vertex) {
         llvm::dbgs() << "  " << vertex << ": ";
-        for (int64_t neighbor : conflictGraph.edgesIncidentTo(vertex)) {
+        for (int64_t neighbor : conflictGraph.neighbors(vertex)) {
           llvm::dbgs() << neighbor << " ";
         }
         llvm::dbgs() << "\n";
       }
     });
 
-    graph::GreedyGraphColoring<int64_t> colorer;
-    std::unordered_map<int64_t, int> coloring = colorer.color(conflictGraph);
+    graph::DenseGraphColoring colorer;
+    std::vector<int> coloring = colorer.color(conflictGraph, maxBucketSize);
 
     SmallVector<RotationGroup> resultRotationGroups;
     resultRotationGroups.reserve(64);
-    for (const auto &entry : coloring) {
-      int64_t index = entry.first;
-      int64_t color = entry.second;
+    for (auto [index, color] : llvm::enumerate(coloring)) {
       if (color >= resultRotationGroups.size()) {
         resultRotationGroups.resize(color + 1);
       }
@@ -232,14 +353,23 @@ class VosVosErkinShiftNetworks {
       }
     });
 
+    if (diskCache) {
+      diskCache->store(permutation, ciphertextSize, resultRotationGroups);
+    }
     rotationGroups[permutation] = resultRotationGroups;
     return rotationGroups[permutation];
   }
 
   int64_t getCiphertextSize() const { return ciphertextSize; }
 
+  // The number of calls to computeShiftNetwork that were served from the
+  // in-memory or on-disk cache.
+  int64_t getNumCacheHits() const { return numCacheHits; }
+
  private:
   int64_t ciphertextSize;
+  int64_t numCacheHits = 0;
+  std::optional<ShiftNetworkDiskCache> diskCache;
   DenseMap<Permutation, llvm::SmallVector<RotationGroup>> rotationGroups;
 };
 
@@ -260,9 +390,16 @@ Value createMask(TypedValue<RankedTensorType> tensor,
   return constant.getResult();
 }
 
+// Counts of the generated ops, reported as pass statistics.
+struct ShiftNetworkCounts {
+  int64_t numRotationGroups = 0;
+  int64_t numRotations = 0;
+};
+
 Value rotateGroup(TypedValue<RankedTensorType> tensor,
                   const RotationGroup &group, int64_t ciphertextSize,
-                  const Permutation &permutation, IRRewriter &rewriter) {
+                  const Permutation &permutation, IRRewriter &rewriter,
+                  ShiftNetworkCounts &counts) {
   std::optional<Value> result = std::nullopt;
 
   // Re-run the shift strategy on a single rotation group, and use the
@@ -286,6 +423,7 @@ Value rotateGroup(TypedValue<RankedTensorType> tensor,
         tensor.getLoc(), maskOp.getResult(),
         rewriter.create<arith::ConstantIntOp>(tensor.getLoc(), rotationAmount,
                                               rewriter.getI32Type()));
+    ++counts.numRotations;
 
     if (result.has_value()) {
       result = rewriter.create<arith::AddIOp>(tensor.getLoc(), result.value(),
@@ -300,7 +438,8 @@ Value rotateGroup(TypedValue<RankedTensorType> tensor,
 
 LogicalResult convertPermuteOp(PermuteOp op,
                                VosVosErkinShiftNetworks &shiftNetworks,
-                               int64_t ciphertextSize) {
+                               int64_t ciphertextSize,
+                               ShiftNetworkCounts &counts) {
   LLVM_DEBUG(llvm::dbgs() << "Converting layout op: " << op << "\n");
   IRRewriter rewriter(op.getContext());
   RankedTensorType tensorTy = op.getInput().getType();
@@ -352,6 +491,7 @@ LogicalResult convertPermuteOp(PermuteOp op,
       shiftNetworks.computeShiftNetwork(permKey);
   assert(!rotationGroup.empty() &&
          "Shift network must have at least one group");
+  counts.numRotationGroups += rotationGroup.size();
 
   // Process each rotation group separately with a full set of power-of-two
   // shifts. Then sum the results together.
@@ -361,8 +501,8 @@ LogicalResult convertPermuteOp(PermuteOp op,
   for (const RotationGroup &group : rotationGroup) {
     LLVM_DEBUG(llvm::dbgs()
                << "Implementing rotations for group " << groupIndex++ << "\n");
-    Value perGroupResult =
-        rotateGroup(op.getInput(), group, ciphertextSize, permKey, rewriter);
+    Value perGroupResult = rotateGroup(op.getInput(), group, ciphertextSize,
+                                       permKey, rewriter, counts);
     if (result.has_value())
       result =
           rewriter.create<arith::AddIOp>(op.getLoc(), *result, perGroupResult);
@@ -382,13 +522,20 @@ struct ImplementShiftNetwork
     MLIRContext *context = &getContext();
     RewritePatternSet patterns(context);
 
-    VosVosErkinShiftNetworks shiftNetworks{ciphertextSize};
+    VosVosErkinShiftNetworks shiftNetworks{ciphertextSize, cacheDir};
+    ShiftNetworkCounts counts;
 
     getOperation()->walk([&](PermuteOp op) {
-      if (failed(convertPermuteOp(op, shiftNetworks, ciphertextSize))) {
+      ++numPermuteOps;
+      if (failed(
+              convertPermuteOp(op, shiftNetworks, ciphertextSize, counts))) {
         signalPassFailure();
       }
     });
+
+    numRotationGroups += counts.numRotationGroups;
+    numRotations += counts.numRotations;
+    numCacheHits += shiftNetworks.getNumCacheHits();
   }
 };
 
@@ -33,6 +33,21 @@ SchemeParam SchemeParam::getConcreteSchemeParam(
       plaintextModulus, encryptionTechniqueExtended);
 }
 
+std::vector<SchemeParam> SchemeParam::getConcreteSchemeParamCandidates(
+    const std::vector<double> &logqi, int64_t plaintextModulus, int slotNumber,
+    bool usePublicKey, bool encryptionTechniqueExtended,
+    const RLWEOpCounts &opCounts) {
+  std::vector<SchemeParam> candidates;
+  // Use only half of the BGV slot number to make 1-dim vector.
+  for (const auto &param :
+       RLWESchemeParam::getConcreteRLWESchemeParamCandidates(
+           logqi, 2 * slotNumber, usePublicKey, opCounts, plaintextModulus)) {
+    candidates.emplace_back(param, plaintextModulus,
+                            encryptionTechniqueExtended);
+  }
+  return candidates;
+}
+
 SchemeParam SchemeParam::getSchemeParamFromAttr(SchemeParamAttr attr) {
   auto logN = attr.getLogN();
   auto ringDim = pow(2, logN);
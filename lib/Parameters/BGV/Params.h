@@ -47,6 +47,13 @@ class SchemeParam : public RLWESchemeParam {
                                             int slotNumber, bool usePublicKey,
                                             bool encryptionTechniqueExtended);
 
+  // One concrete parameter per number of special primes, cheapest first for
+  // `opCounts`, c.f. RLWESchemeParam::getConcreteRLWESchemeParamCandidates.
+  static std::vector<SchemeParam> getConcreteSchemeParamCandidates(
+      const std::vector<double> &logqi, int64_t plaintextModulus,
+      int slotNumber, bool usePublicKey, bool encryptionTechniqueExtended,
+      const RLWEOpCounts &opCounts);
+
   static SchemeParam getSchemeParamFromAttr(SchemeParamAttr attr);
 };
 
@@ -21,6 +21,19 @@ SchemeParam SchemeParam::getConcreteSchemeParam(std::vector<double> logqi,
                      logDefaultScale);
 }
 
+std::vector<SchemeParam> SchemeParam::getConcreteSchemeParamCandidates(
+    const std::vector<double> &logqi, int logDefaultScale, int slotNumber,
+    bool usePublicKey, const RLWEOpCounts &opCounts) {
+  std::vector<SchemeParam> candidates;
+  // CKKS slot number = ringDim / 2
+  for (const auto &param :
+       RLWESchemeParam::getConcreteRLWESchemeParamCandidates(
+           logqi, 2 * slotNumber, usePublicKey, opCounts)) {
+    candidates.emplace_back(param, logDefaultScale);
+  }
+  return candidates;
+}
+
 SchemeParam SchemeParam::getSchemeParamFromAttr(SchemeParamAttr attr) {
   auto logN = attr.getLogN();
   auto ringDim = pow(2, logN);
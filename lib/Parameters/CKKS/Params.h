@@ -30,6 +30,12 @@ class SchemeParam : public RLWESchemeParam {
                                             int logDefaultScale, int slotNumber,
                                             bool usePublicKey);
 
+  // One concrete parameter per number of special primes, cheapest first for
+  // `opCounts`, c.f. RLWESchemeParam::getConcreteRLWESchemeParamCandidates.
+  static std::vector<SchemeParam> getConcreteSchemeParamCandidates(
+      const std::vector<double> &logqi, int logDefaultScale, int slotNumber,
+      bool usePublicKey, const RLWEOpCounts &opCounts);
+
   static SchemeParam getSchemeParamFromAttr(SchemeParamAttr attr);
 };
 
@@ -6,13 +6,24 @@
 #include <cstdint>
 #include <iomanip>
 #include <ios>
+#include <map>
+#include <mutex>
 #include <numeric>
+#include <optional>
 #include <sstream>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "lib/Parameters/RLWESecurityParams.h"
-#include "llvm/include/llvm/Support/raw_ostream.h"  // from @llvm-project
-#include "src/core/include/openfhecore.h"           // from @openfhe
+#include "llvm/include/llvm/ADT/ArrayRef.h"          // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallString.h"       // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"       // from @llvm-project
+#include "llvm/include/llvm/ADT/StringRef.h"         // from @llvm-project
+#include "llvm/include/llvm/Support/FileSystem.h"    // from @llvm-project
+#include "llvm/include/llvm/Support/MemoryBuffer.h"  // from @llvm-project
+#include "llvm/include/llvm/Support/raw_ostream.h"   // from @llvm-project
+#include "src/core/include/openfhecore.h"            // from @openfhe
 
 namespace mlir {
 namespace heir {
@@ -43,36 +54,156 @@ RLWESchemeParam RLWESchemeParam::getConservativeRLWESchemeParam(
   return RLWESchemeParam(ringDim, level, logqi, dnum, logpi, usePublicKey);
 }
 
+namespace {
+
+// The primes congruent to 1 modulo `modulus`, in increasing order from the
+// first prime of a given bit size, as found by OpenFHE FirstPrime/NextPrime.
+struct PrimeChain {
+  std::vector<int64_t> primes;
+  // Set when OpenFHE failed to find a further prime.
+  bool exhausted = false;
+};
+
+class PrimeTable {
+ public:
+  // Returns the `index`-th prime of `bits` bits congruent to 1 modulo
+  // `modulus`, or std::nullopt if there is no such prime.
+  std::optional<int64_t> get(int bits, int64_t modulus, size_t index) {
+    std::lock_guard<std::mutex> lock(mutex);
+    PrimeChain &chain = chains[{bits, modulus}];
+    while (chain.primes.size() <= index && !chain.exhausted) {
+      // openfhe FirstPrime/NextPrime will throw exception if it fails to find
+      // a prime
+      try {
+        lbcrypto::NativeInteger prime =
+            chain.primes.empty()
+                ? lbcrypto::FirstPrime<lbcrypto::NativeInteger>(bits, modulus)
+                : lbcrypto::NextPrime(
+                      lbcrypto::NativeInteger(chain.primes.back()), modulus);
+        chain.primes.push_back(prime.ConvertToInt());
+      } catch (...) {
+        chain.exhausted = true;
+      }
+      dirty = true;
+    }
+    if (index < chain.primes.size()) return chain.primes[index];
+    return std::nullopt;
+  }
+
+  // Each line of the file is "<bits> <modulus> <prime>...". Entries whose
+  // primes are not increasing primes congruent to 1 modulo `modulus` are
+  // rejected.
+  bool load(const std::string &path) {
+    auto buffer = llvm::MemoryBuffer::getFile(path);
+    if (!buffer) return true;
+
+    llvm::SmallVector<llvm::StringRef> lines;
+    (*buffer)->getBuffer().split(lines, '\n', /*MaxSplit=*/-1,
+                                 /*KeepEmpty=*/false);
+    if (lines.empty() || lines[0] != kHeader) return false;
+
+    std::map<std::pair<int, int64_t>, PrimeChain> loaded;
+    for (llvm::StringRef line : llvm::ArrayRef(lines).drop_front()) {
+      llvm::SmallVector<llvm::StringRef> fields;
+      line.split(fields, ' ', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+      int bits;
+      int64_t modulus;
+      if (fields.size() < 2 || fields[0].getAsInteger(10, bits) ||
+          fields[1].getAsInteger(10, modulus) || modulus <= 0) {
+        return false;
+      }
+      PrimeChain chain;
+      for (llvm::StringRef field : llvm::ArrayRef(fields).drop_front(2)) {
+        int64_t prime;
+        if (field.getAsInteger(10, prime) || prime % modulus != 1 ||
+            (!chain.primes.empty() && prime <= chain.primes.back()) ||
+            !lbcrypto::MillerRabinPrimalityTest(
+                lbcrypto::NativeInteger(prime))) {
+          return false;
+        }
+        chain.primes.push_back(prime);
+      }
+      // A recorded entry without primes means that FirstPrime failed.
+      chain.exhausted = chain.primes.empty();
+      loaded[{bits, modulus}] = std::move(chain);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &[key, chain] : loaded) {
+      PrimeChain &existing = chains[key];
+      if (chain.primes.size() > existing.primes.size()) {
+        existing = std::move(chain);
+      }
+    }
+    return true;
+  }
+
+  bool save(const std::string &path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!dirty) return true;
+
+    // Write to a unique file first and rename it into place, so that
+    // concurrent compiles never observe a partially written table.
+    int fd;
+    llvm::SmallString<128> tempPath;
+    if (llvm::sys::fs::createUniqueFile(path + ".tmp-%%%%%%", fd, tempPath)) {
+      return false;
+    }
+    {
+      llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+      os << kHeader << "\n";
+      for (const auto &[key, chain] : chains) {
+        os << key.first << " " << key.second;
+        for (int64_t prime : chain.primes) os << " " << prime;
+        os << "\n";
+      }
+    }
+    if (llvm::sys::fs::rename(tempPath, path)) {
+      llvm::sys::fs::remove(tempPath);
+      return false;
+    }
+    dirty = false;
+    return true;
+  }
+
+ private:
+  static constexpr llvm::StringLiteral kHeader = "heir-prime-table-v1";
+
+  std::mutex mutex;
+  std::map<std::pair<int, int64_t>, PrimeChain> chains;
+  bool dirty = false;
+};
+
+PrimeTable &getPrimeTable() {
+  static PrimeTable table;
+  return table;
+}
+
+}  // namespace
+
+bool loadPrimeTable(const std::string &path) {
+  return getPrimeTable().load(path);
+}
+
+bool savePrimeTable(const std::string &path) {
+  return getPrimeTable().save(path);
+}
+
+// Returns the smallest prime of `qi` bits that is 1 modulo 2 * ringDim and
+// not in `existingPrimes`, moving to more bits if there is none.
 int64_t findPrime(int qi, int ringDim,
                   const std::vector<int64_t> &existingPrimes) {
   while (qi < 80) {
-    try {
-      // openfhe FirstPrime will throw exception if it fails to find a prime
-      bool redo = false;
-      int64_t dupPrime;
-      do {
-        int64_t prime;
-        if (!redo) {
-          // first time, use first prime
-          auto res =
-              lbcrypto::FirstPrime<lbcrypto::NativeInteger>(qi, 2 * ringDim);
-          prime = res.ConvertToInt();
-        } else {
-          // start from the duplicated prime
-          auto res = lbcrypto::NextPrime(lbcrypto::NativeInteger(dupPrime),
-                                         2 * ringDim);
-          prime = res.ConvertToInt();
-        }
-        if (std::find(existingPrimes.begin(), existingPrimes.end(), prime) ==
-            existingPrimes.end()) {
-          return prime;
-        }
-        dupPrime = prime;
-        redo = true;
-      } while (redo);
-    } catch (...) {
-      qi += 1;
+    for (size_t index = 0;; ++index) {
+      std::optional<int64_t> prime =
+          getPrimeTable().get(qi, 2 * ringDim, index);
+      if (!prime.has_value()) break;
+      if (std::find(existingPrimes.begin(), existingPrimes.end(), *prime) ==
+          existingPrimes.end()) {
+        return *prime;
+      }
     }
+    qi += 1;
   }
   assert(false && "failed to generate good qi");
   return 0;
@@ -80,9 +211,11 @@ int64_t findPrime(int qi, int ringDim,
 
 RLWESchemeParam RLWESchemeParam::getConcreteRLWESchemeParam(
     std::vector<double> logqi, int slotNumber, bool usePublicKey,
-    int64_t plaintextModulus) {
+    int64_t plaintextModulus, int dnum) {
   auto level = logqi.size() - 1;
-  auto dnum = computeDnum(level);
+  if (dnum <= 0) {
+    dnum = computeDnum(level);
+  }
 
   // sanitize qi
   for (auto &qi : logqi) {
@@ -150,6 +283,98 @@ RLWESchemeParam RLWESchemeParam::getConcreteRLWESchemeParam(
                          usePublicKey);
 }
 
+std::vector<RLWESchemeParam>
+RLWESchemeParam::getConcreteRLWESchemeParamCandidates(
+    const std::vector<double> &logqi, int slotNumber, bool usePublicKey,
+    const RLWEOpCounts &opCounts, int64_t plaintextModulus) {
+  int numQ = logqi.size();
+  int defaultDnum = computeDnum(numQ - 1);
+
+  // dnum only matters through the number of special primes
+  // ceil(numQ / dnum). Use the smallest dnum for each number of special
+  // primes, since that is what is recovered from the prime count, and keep
+  // the default dnum first so that it wins ties.
+  std::vector<int> dnums = {defaultDnum};
+  std::vector<int> numPs = {(numQ + defaultDnum - 1) / defaultDnum};
+  for (int dnum = 1; dnum <= numQ; ++dnum) {
+    int numP = (numQ + dnum - 1) / dnum;
+    if (std::find(numPs.begin(), numPs.end(), numP) != numPs.end()) continue;
+    dnums.push_back((numQ + numP - 1) / numP);
+    numPs.push_back(numP);
+  }
+
+  std::vector<std::pair<double, RLWESchemeParam>> candidates;
+  for (int dnum : dnums) {
+    auto param = getConcreteRLWESchemeParam(logqi, slotNumber, usePublicKey,
+                                            plaintextModulus, dnum);
+    candidates.emplace_back(opCounts.estimateCost(param), param);
+  }
+  std::stable_sort(
+      candidates.begin(), candidates.end(),
+      [](const auto &a, const auto &b) { return a.first < b.first; });
+
+  std::vector<RLWESchemeParam> result;
+  for (auto &[cost, param] : candidates) {
+    result.push_back(std::move(param));
+  }
+  return result;
+}
+
+// The cost of each operation counts the modular multiplications on one
+// ciphertext with `limbs` RNS limbs, where an NTT on one limb takes
+// N log N / 2 multiplications. Key switching follows the HYBRID technique:
+// the ciphertext is split into ceil(limbs / alpha) digits, each digit is
+// raised to the basis QP, multiplied with the key switching key and the
+// result is brought back to Q.
+double RLWEOpCounts::estimateCost(const RLWESchemeParam &param) const {
+  double ringDim = param.getRingDim();
+  double ntt = ringDim * log2(ringDim) / 2;
+  double alpha = param.getLogpi().size();
+
+  auto keySwitchCost = [&](double limbs) {
+    double digits = ceil(limbs / alpha);
+    double extendedLimbs = limbs + alpha;
+    // INTT of Q, base conversion to the other limbs, NTT of each digit
+    double modUp = limbs * ntt + limbs * extendedLimbs * ringDim +
+                   digits * extendedLimbs * ntt;
+    double innerProduct = 2 * digits * extendedLimbs * ringDim;
+    // INTT of P, base conversion to Q, NTT and subtraction on both parts
+    double modDown =
+        2 * (alpha * ntt + alpha * limbs * ringDim + limbs * ntt + limbs);
+    return modUp + innerProduct + modDown;
+  };
+
+  double total = 0;
+  for (const auto &[key, count] : counts) {
+    auto [kind, level] = key;
+    double limbs = level + 1;
+    double cost = 0;
+    switch (kind) {
+      case RLWEOpKind::Add:
+      case RLWEOpKind::MulPlain:
+        cost = 2 * limbs * ringDim;
+        break;
+      case RLWEOpKind::Mul:
+        cost = 4 * limbs * ringDim;
+        break;
+      case RLWEOpKind::Relinearize:
+        cost = keySwitchCost(limbs);
+        break;
+      case RLWEOpKind::Rotate:
+        // the automorphism on both polynomials, then key switching
+        cost = 2 * limbs * ringDim + keySwitchCost(limbs);
+        break;
+      case RLWEOpKind::ModReduce:
+        // INTT of the last limb, NTT into the other limbs, and scaling, for
+        // both polynomials
+        cost = 2 * (ntt + (limbs - 1) * (ntt + ringDim));
+        break;
+    }
+    total += count * cost;
+  }
+  return total;
+}
+
 void RLWESchemeParam::print(llvm::raw_ostream &os) const {
   auto doubleToString = [](double d) {
     std::stringstream stream;
@@ -2,6 +2,9 @@
 #define LIB_PARAMETERS_RLWEPARAMS_H_
 
 #include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "llvm/include/llvm/Support/raw_ostream.h"  // from @llvm-project
@@ -9,6 +12,8 @@
 namespace mlir {
 namespace heir {
 
+class RLWEOpCounts;
+
 // Parameter for BGV scheme at ModuleOp level
 class RLWESchemeParam {
  public:
@@ -92,11 +97,66 @@ class RLWESchemeParam {
 
   // plaintext modulus for BGV
   // for CKKS this field is not used
+  // dnum = 0 selects the number of digits from the level
   static RLWESchemeParam getConcreteRLWESchemeParam(
       std::vector<double> logqi, int minRingDim, bool usePublicKey,
-      int64_t plaintextModulus = 0);
+      int64_t plaintextModulus = 0, int dnum = 0);
+
+  // Returns one concrete parameter for each distinct number of special
+  // primes, sorted by the estimated runtime of `opCounts`, cheapest first.
+  // The ring dimension of each candidate is the smallest secure one.
+  static std::vector<RLWESchemeParam> getConcreteRLWESchemeParamCandidates(
+      const std::vector<double> &logqi, int minRingDim, bool usePublicKey,
+      const RLWEOpCounts &opCounts, int64_t plaintextModulus = 0);
+};
+
+// The homomorphic operations distinguished by the runtime cost model.
+enum class RLWEOpKind {
+  // addition, subtraction and other linear operations
+  Add,
+  // multiplication by a plaintext
+  MulPlain,
+  // ciphertext-ciphertext multiplication, without relinearization
+  Mul,
+  Relinearize,
+  Rotate,
+  ModReduce,
+};
+
+// Number of homomorphic operations at each level of a program, used to
+// compare scheme parameters by the runtime they would give.
+class RLWEOpCounts {
+ public:
+  void add(RLWEOpKind kind, int level, int64_t count = 1) {
+    counts[{kind, level}] += count;
+  }
+
+  int64_t get(RLWEOpKind kind, int level) const {
+    auto it = counts.find({kind, level});
+    return it == counts.end() ? 0 : it->second;
+  }
+
+  // Estimates the runtime of the counted operations under `param`, in units
+  // of word-sized modular multiplications. Key switching is modeled as the
+  // HYBRID technique with `param.getLogpi().size()` special primes.
+  double estimateCost(const RLWESchemeParam &param) const;
+
+ private:
+  std::map<std::pair<RLWEOpKind, int>, int64_t> counts;
 };
 
+// Primes found during parameter generation are memoized in a table shared by
+// all compilations in the process. The table can be persisted to a file so
+// that later compilations skip the prime search.
+//
+// Loads the primes recorded in `path` into the table. A missing file is not
+// an error; returns false if the file cannot be parsed.
+bool loadPrimeTable(const std::string &path);
+
+// Writes the table to `path` if it changed since it was last loaded or saved.
+// Returns false if the file cannot be written.
+bool savePrimeTable(const std::string &path);
+
 // Parameter for each RLWE ciphertext SSA value.
 class RLWELocalParam {
  public:
@@ -13,9 +13,11 @@
 #include "lib/Dialect/LWE/Transforms/AddDebugPort.h"
 #include "lib/Dialect/Lattigo/Transforms/AllocToInplace.h"
 #include "lib/Dialect/Lattigo/Transforms/ConfigureCryptoContext.h"
+#include "lib/Dialect/Lattigo/Transforms/FuseWeightedSum.h"
 #include "lib/Dialect/LinAlg/Conversions/LinalgToTensorExt/LinalgToTensorExt.h"
 #include "lib/Dialect/Openfhe/Transforms/ConfigureCryptoContext.h"
 #include "lib/Dialect/Openfhe/Transforms/CountAddAndKeySwitch.h"
+#include "lib/Dialect/Openfhe/Transforms/FuseLinearWSum.h"
 #include "lib/Dialect/Secret/Conversions/SecretToBGV/SecretToBGV.h"
 #include "lib/Dialect/Secret/Conversions/SecretToCKKS/SecretToCKKS.h"
 #include "lib/Dialect/Secret/Transforms/AddDebugPort.h"
@@ -24,11 +26,13 @@
 #include "lib/Dialect/Secret/Transforms/ImportExecutionResult.h"
 #include "lib/Dialect/Secret/Transforms/MergeAdjacentGenerics.h"
 #include "lib/Dialect/TensorExt/Conversions/TensorExtToTensor/TensorExtToTensor.h"
+#include "lib/Dialect/TensorExt/Transforms/BatchTensors.h"
 #include "lib/Dialect/TensorExt/Transforms/CollapseInsertionChains.h"
 #include "lib/Dialect/TensorExt/Transforms/InsertRotate.h"
 #include "lib/Dialect/TensorExt/Transforms/RotateAndReduce.h"
 #include "lib/Pipelines/PipelineRegistration.h"
 #include "lib/Transforms/ApplyFolders/ApplyFolders.h"
+#include "lib/Transforms/DropLevelsEarly/DropLevelsEarly.h"
 #include "lib/Transforms/FullLoopUnroll/FullLoopUnroll.h"
 #include "lib/Transforms/GenerateParam/GenerateParam.h"
 #include "lib/Transforms/LinalgCanonicalizations/LinalgCanonicalizations.h"
@@ -94,7 +98,10 @@ void heirSIMDVectorizerPipelineBuilder(OpPassManager &manager,
 void mlirToSecretArithmeticPipelineBuilder(
     OpPassManager &pm, const MlirToRLWEPipelineOptions &options) {
   pm.addPass(createWrapGeneric());
-  convertToDataObliviousPipelineBuilder(pm);
+  // Only the linear strategy for accesses at a secret index lowers to RLWE
+  // schemes, which the simd cost model makes `auto` pick.
+  convertToDataObliviousPipelineBuilder(pm, /*accessStrategy=*/"auto",
+                                        /*accessCostModel=*/"simd");
   pm.addPass(createCanonicalizerPass());
   pm.addPass(createCSEPass());
 
@@ -167,6 +174,15 @@ void mlirToRLWEPipeline(OpPassManager &pm,
                         const RLWEScheme scheme) {
   mlirToSecretArithmeticPipelineBuilder(pm, options);
 
+  // Interleave independent inputs across the slots of each ciphertext.
+  if (options.batchSize > 1) {
+    auto batchTensorsOptions = tensor_ext::BatchTensorsOptions{};
+    batchTensorsOptions.batchSize = options.batchSize;
+    pm.addPass(tensor_ext::createBatchTensors(batchTensorsOptions));
+    pm.addPass(createCanonicalizerPass());
+    pm.addPass(createCSEPass());
+  }
+
   // Only for debugging purpose.
   // Note that optimization-relinearization below won't preserve the attribute
   // in relin op.
@@ -210,6 +226,11 @@ void mlirToRLWEPipeline(OpPassManager &pm,
   // Optimize relinearization at mgmt dialect level
   pm.addPass(createOptimizeRelinearization());
 
+  // Move modulus switches up through level-preserving ops
+  if (scheme == RLWEScheme::bgvScheme && options.dropLevelsEarly) {
+    pm.addPass(createDropLevelsEarly());
+  }
+
   // IR is stable now, compute scheme param
   switch (scheme) {
     case RLWEScheme::bgvScheme: {
@@ -222,6 +243,7 @@ void mlirToRLWEPipeline(OpPassManager &pm,
       generateParamOptions.usePublicKey = options.usePublicKey;
       generateParamOptions.encryptionTechniqueExtended =
           options.encryptionTechniqueExtended;
+      generateParamOptions.primeTable = options.primeTable;
       pm.addPass(createGenerateParamBGV(generateParamOptions));
 
       auto validateNoiseOptions = ValidateNoiseOptions{};
@@ -241,6 +263,7 @@ void mlirToRLWEPipeline(OpPassManager &pm,
       generateParamOptions.usePublicKey = options.usePublicKey;
       generateParamOptions.encryptionTechniqueExtended =
           options.encryptionTechniqueExtended;
+      generateParamOptions.primeTable = options.primeTable;
       pm.addPass(createGenerateParamBFV(generateParamOptions));
 
       auto validateNoiseOptions = ValidateNoiseOptions{};
@@ -255,6 +278,7 @@ void mlirToRLWEPipeline(OpPassManager &pm,
       generateParamOptions.scalingModBits = options.scalingModBits;
       generateParamOptions.slotNumber = options.ciphertextDegree;
       generateParamOptions.usePublicKey = options.usePublicKey;
+      generateParamOptions.primeTable = options.primeTable;
       pm.addPass(createGenerateParamCKKS(generateParamOptions));
       break;
     }
@@ -326,6 +350,10 @@ BackendPipelineBuilder toOpenFhePipelineBuilder() {
     pm.addPass(createCanonicalizerPass());
     pm.addPass(createCSEPass());
 
+    // Fuse plaintext-weighted sums (CKKS only)
+    pm.addPass(openfhe::createFuseLinearWSum());
+    pm.addPass(createCanonicalizerPass());
+
     // TODO (#1145): OpenFHE context configuration should NOT do its own
     // analysis but instead use information put into the IR by previous passes
     auto configureCryptoContextOptions =
@@ -353,6 +381,9 @@ BackendPipelineBuilder toLattigoPipelineBuilder() {
     // Convert LWE (and scheme-specific BGV ops) to Lattigo
     pm.addPass(lwe::createLWEToLattigo());
 
+    // Fuse plaintext-weighted sums
+    pm.addPass(lattigo::createFuseWeightedSum());
+
     // Convert Alloc Ops to Inplace Ops
     pm.addPass(lattigo::createAllocToInplace());
 
@@ -34,6 +34,12 @@ struct MlirToRLWEPipelineOptions : public SimdVectorizerOptions {
                      "equivalently, the number of messages that can be packed "
                      "into a single ciphertext."),
       llvm::cl::init(1024)};
+  PassOptions::Option<int> batchSize{
+      *this, "batch-size",
+      llvm::cl::desc("The number of independent inputs evaluated at once by "
+                     "interleaving them across the slots of each ciphertext, "
+                     "c.f. --batch-tensors (default to 1)"),
+      llvm::cl::init(1)};
   PassOptions::Option<bool> usePublicKey{
       *this, "use-public-key",
       llvm::cl::desc("If true, use public key encryption (default to true)"),
@@ -48,6 +54,12 @@ struct MlirToRLWEPipelineOptions : public SimdVectorizerOptions {
       llvm::cl::desc("Modulus switching right before the first multiplication "
                      "(default to false)"),
       llvm::cl::init(false)};
+  PassOptions::Option<bool> dropLevelsEarly{
+      *this, "drop-levels-early",
+      llvm::cl::desc("For BGV, switch ciphertext moduli as early as the "
+                     "estimated cost allows, c.f. --drop-levels-early "
+                     "(default to false)"),
+      llvm::cl::init(false)};
   PassOptions::Option<int64_t> plaintextModulus{
       *this, "plaintext-modulus",
       llvm::cl::desc("Plaintext modulus for BGV scheme (default to 65537)"),
@@ -74,6 +86,12 @@ struct MlirToRLWEPipelineOptions : public SimdVectorizerOptions {
       *this, "bfv-mod-bits",
       llvm::cl::desc("The number of bits for all moduli for B/FV"),
       llvm::cl::init(60)};
+  PassOptions::Option<std::string> primeTable{
+      *this, "prime-table",
+      llvm::cl::desc("File in which the primes generated for the scheme "
+                     "parameters are memoized across compilations (c.f. "
+                     "--generate-param-bgv)"),
+      llvm::cl::init("")};
   PassOptions::Option<std::string> plaintextExecutionResultFileName{
       *this, "plaintext-execution-result-file-name",
       llvm::cl::desc("File name to import execution result from (c.f. --secret-"
@@ -91,7 +91,8 @@ void tosaToCGGIPipelineBuilder(OpPassManager &pm,
   // Booleanize and Yosys Optimize
   pm.addPass(createYosysOptimizer(
       yosysFilesPath, abcPath, options.abcFast, options.unrollFactor,
-      /*useSubmodules=*/true, abcBooleanGates ? Mode::Boolean : Mode::LUT));
+      /*useSubmodules=*/true, abcBooleanGates ? Mode::Boolean : Mode::LUT,
+      /*printStats=*/false, options.lutMapping, options.maxDepth));
 
   // Cleanup
   pm.addPass(mlir::createCSEPass());
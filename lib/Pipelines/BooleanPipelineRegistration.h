@@ -3,6 +3,7 @@
 
 #include <string>
 
+#include "lib/Transforms/YosysOptimizer/YosysOptimizer.h"
 #include "llvm/include/llvm/Support/CommandLine.h"  // from @llvm-project
 #include "mlir/include/mlir/Pass/PassManager.h"     // from @llvm-project
 #include "mlir/include/mlir/Pass/PassOptions.h"     // from @llvm-project
@@ -21,6 +22,22 @@ struct TosaToBooleanTfheOptions
       llvm::cl::desc("Unroll loops by a given factor before optimizing. A "
                      "value of zero (default) prevents unrolling."),
       llvm::cl::init(0)};
+
+  PassOptions::Option<LutMapping> lutMapping{
+      *this, "lut-mapping",
+      llvm::cl::desc("The objective of the mapping to lookup tables, c.f. "
+                     "--yosys-optimizer (default to area)"),
+      llvm::cl::init(LutMapping::Area),
+      llvm::cl::values(
+          clEnumValN(LutMapping::Area, "area", "minimize the number of LUTs"),
+          clEnumValN(LutMapping::Depth, "depth",
+                     "minimize the number of sequential LUT levels"))};
+
+  PassOptions::Option<int> maxDepth{
+      *this, "max-depth",
+      llvm::cl::desc("With lut-mapping=depth, the target number of LUT levels "
+                     "(default to 0, i.e., the minimum depth)"),
+      llvm::cl::init(0)};
 };
 
 struct TosaToBooleanJaxiteOptions : public TosaToBooleanTfheOptions {
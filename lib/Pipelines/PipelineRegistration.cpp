@@ -1,9 +1,12 @@
 #include "lib/Pipelines/PipelineRegistration.h"
 
+#include <string>
+
 #include "lib/Dialect/ModArith/Conversions/ModArithToArith/ModArithToArith.h"
 #include "lib/Dialect/Polynomial/Conversions/PolynomialToModArith/PolynomialToModArith.h"
 #include "lib/Transforms/ConvertIfToSelect/ConvertIfToSelect.h"
 #include "lib/Transforms/ConvertSecretExtractToStaticExtract/ConvertSecretExtractToStaticExtract.h"
+#include "lib/Transforms/ConvertSecretForToMaskedTensor/ConvertSecretForToMaskedTensor.h"
 #include "lib/Transforms/ConvertSecretForToStaticFor/ConvertSecretForToStaticFor.h"
 #include "lib/Transforms/ConvertSecretInsertToStaticInsert/ConvertSecretInsertToStaticInsert.h"
 #include "lib/Transforms/ConvertSecretWhileToStaticFor/ConvertSecretWhileToStaticFor.h"
@@ -177,13 +180,24 @@ void basicMLIRToLLVMPipelineBuilder(OpPassManager &manager) {
   manager.addPass(createSymbolDCEPass());
 }
 
-void convertToDataObliviousPipelineBuilder(OpPassManager &manager) {
+void convertToDataObliviousPipelineBuilder(OpPassManager &manager,
+                                           const std::string &accessStrategy,
+                                           const std::string &accessCostModel) {
   // Access Transformation
-  manager.addPass(createConvertSecretExtractToStaticExtract());
-  manager.addPass(createConvertSecretInsertToStaticInsert());
+  auto extractOptions = ConvertSecretExtractToStaticExtractOptions{};
+  extractOptions.strategy = accessStrategy;
+  extractOptions.costModel = accessCostModel;
+  manager.addPass(createConvertSecretExtractToStaticExtract(extractOptions));
+  auto insertOptions = ConvertSecretInsertToStaticInsertOptions{};
+  insertOptions.strategy = accessStrategy;
+  insertOptions.costModel = accessCostModel;
+  manager.addPass(createConvertSecretInsertToStaticInsert(insertOptions));
 
   // Loop Transformation
   manager.addPass(createConvertSecretWhileToStaticFor());
+  // Reductions and maps become masked tensor ops, and the remaining loops get
+  // static bounds.
+  manager.addPass(createConvertSecretForToMaskedTensor());
   manager.addPass(createConvertSecretForToStaticFor());
 
   // If Transformation
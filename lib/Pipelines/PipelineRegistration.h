@@ -1,9 +1,12 @@
 #ifndef LIB_PIPELINES_PIPELINEREGISTRATION_H_
 #define LIB_PIPELINES_PIPELINEREGISTRATION_H_
 
-#include "mlir/include/mlir/Pass/PassManager.h"   // from @llvm-project
-#include "mlir/include/mlir/Pass/PassOptions.h"   // from @llvm-project
-#include "mlir/include/mlir/Pass/PassRegistry.h"  // from @llvm-project
+#include <string>
+
+#include "llvm/include/llvm/Support/CommandLine.h"  // from @llvm-project
+#include "mlir/include/mlir/Pass/PassManager.h"     // from @llvm-project
+#include "mlir/include/mlir/Pass/PassOptions.h"     // from @llvm-project
+#include "mlir/include/mlir/Pass/PassRegistry.h"    // from @llvm-project
 
 namespace mlir::heir {
 
@@ -23,7 +26,24 @@ void polynomialToLLVMPipelineBuilder(OpPassManager &manager);
 
 void basicMLIRToLLVMPipelineBuilder(OpPassManager &manager);
 
-void convertToDataObliviousPipelineBuilder(OpPassManager &manager);
+struct DataObliviousOptions
+    : public PassPipelineOptions<DataObliviousOptions> {
+  PassOptions::Option<std::string> accessStrategy{
+      *this, "access-strategy",
+      llvm::cl::desc("How to access tensors at a secret index: linear, "
+                     "mux-tree, mask-reduce or auto."),
+      llvm::cl::init("linear")};
+  PassOptions::Option<std::string> accessCostModel{
+      *this, "access-cost-model",
+      llvm::cl::desc("Cost model of the target scheme for accesses at a "
+                     "secret index: simd or boolean. Defaults to the scheme "
+                     "annotated on the module."),
+      llvm::cl::init("")};
+};
+
+void convertToDataObliviousPipelineBuilder(OpPassManager &manager,
+                                           const std::string &accessStrategy,
+                                           const std::string &accessCostModel);
 
 }  // namespace mlir::heir
 
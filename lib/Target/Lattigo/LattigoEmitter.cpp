@@ -1,5 +1,7 @@
 #include "lib/Target/Lattigo/LattigoEmitter.h"
 
+#include <algorithm>
+#include <set>
 #include <string>
 #include <string_view>
 
@@ -12,6 +14,10 @@
 #include "lib/Dialect/RNS/IR/RNSDialect.h"
 #include "lib/Target/Lattigo/LattigoTemplates.h"
 #include "lib/Utils/TargetUtils.h"
+#include "llvm/include/llvm/ADT/ArrayRef.h"              // from @llvm-project
+#include "llvm/include/llvm/ADT/DenseMap.h"              // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"           // from @llvm-project
 #include "llvm/include/llvm/ADT/TypeSwitch.h"            // from @llvm-project
 #include "llvm/include/llvm/Support/CommandLine.h"       // from @llvm-project
 #include "llvm/include/llvm/Support/FormatVariadic.h"    // from @llvm-project
@@ -21,6 +27,7 @@
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"   // from @llvm-project
 #include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
 #include "mlir/include/mlir/IR/Attributes.h"             // from @llvm-project
+#include "mlir/include/mlir/IR/Block.h"                  // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinAttributes.h"      // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinOps.h"             // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinTypeInterfaces.h"  // from @llvm-project
@@ -39,14 +46,21 @@ namespace heir {
 namespace lattigo {
 
 LogicalResult translateToLattigo(Operation *op, llvm::raw_ostream &os,
-                                 const std::string &packageName) {
+                                 const std::string &packageName,
+                                 bool profileOps, bool parallel) {
   SelectVariableNames variableNames(op);
-  LattigoEmitter emitter(os, &variableNames, packageName);
+  LattigoEmitter emitter(os, &variableNames, packageName, profileOps,
+                         parallel);
   LogicalResult result = emitter.translate(*op);
   return result;
 }
 
 LogicalResult LattigoEmitter::translate(Operation &op) {
+  std::string profileTimer;
+  if (profileOps && isHomomorphicOp(op)) {
+    profileTimer = emitProfileStart(op);
+  }
+
   LogicalResult status =
       llvm::TypeSwitch<Operation &, LogicalResult>(op)
           // Builtin ops
@@ -69,14 +83,16 @@ LogicalResult LattigoEmitter::translate(Operation &op) {
               // BGV
               BGVNewParametersFromLiteralOp, BGVNewEncoderOp, BGVNewEvaluatorOp,
               BGVNewPlaintextOp, BGVEncodeOp, BGVDecodeOp, BGVAddNewOp,
-              BGVSubNewOp, BGVMulNewOp, BGVAddOp, BGVSubOp, BGVMulOp,
+              BGVSubNewOp, BGVMulNewOp, BGVWeightedSumNewOp, BGVAddOp,
+              BGVSubOp, BGVMulOp,
               BGVRelinearizeOp, BGVRescaleOp, BGVRotateColumnsOp,
               BGVRotateRowsOp, BGVRelinearizeNewOp, BGVRescaleNewOp,
               BGVRotateColumnsNewOp, BGVRotateRowsNewOp,
               // CKKS
               CKKSNewParametersFromLiteralOp, CKKSNewEncoderOp,
               CKKSNewEvaluatorOp, CKKSNewPlaintextOp, CKKSEncodeOp,
-              CKKSDecodeOp, CKKSAddNewOp, CKKSSubNewOp, CKKSMulNewOp, CKKSAddOp,
+              CKKSDecodeOp, CKKSAddNewOp, CKKSSubNewOp, CKKSMulNewOp,
+              CKKSWeightedSumNewOp, CKKSAddOp,
               CKKSSubOp, CKKSMulOp, CKKSRelinearizeOp, CKKSRescaleOp,
               CKKSRotateOp, CKKSRelinearizeNewOp, CKKSRescaleNewOp,
               CKKSRotateNewOp>([&](auto op) { return printOperation(op); })
@@ -88,20 +104,246 @@ LogicalResult LattigoEmitter::translate(Operation &op) {
     return emitError(op.getLoc(),
                      llvm::formatv("Failed to translate op {0}", op.getName()));
   }
+
+  if (!profileTimer.empty()) {
+    emitProfileStop(profileTimer);
+  }
+  return success();
+}
+
+bool LattigoEmitter::isHomomorphicOp(Operation &op) {
+  return isa<RLWELevelReduceNewOp, RLWELevelReduceOp,
+             // BGV
+             BGVAddNewOp, BGVSubNewOp, BGVMulNewOp, BGVWeightedSumNewOp,
+             BGVAddOp, BGVSubOp,
+             BGVMulOp, BGVRelinearizeOp, BGVRescaleOp, BGVRotateColumnsOp,
+             BGVRotateRowsOp, BGVRelinearizeNewOp, BGVRescaleNewOp,
+             BGVRotateColumnsNewOp, BGVRotateRowsNewOp,
+             // CKKS
+             CKKSAddNewOp, CKKSSubNewOp, CKKSMulNewOp, CKKSWeightedSumNewOp,
+             CKKSAddOp, CKKSSubOp,
+             CKKSMulOp, CKKSRelinearizeOp, CKKSRescaleOp, CKKSRotateOp,
+             CKKSRelinearizeNewOp, CKKSRescaleNewOp, CKKSRotateNewOp>(op);
+}
+
+std::string LattigoEmitter::emitProfileStart(Operation &op) {
+  // The level and ring dimension are read from the first ciphertext operand
+  // before the op runs, as inplace ops may overwrite it.
+  Value ciphertext;
+  for (Value operand : op.getOperands()) {
+    if (isa<RLWECiphertextType>(operand.getType())) {
+      ciphertext = operand;
+      break;
+    }
+  }
+  auto funcOp = op.getParentOfType<func::FuncOp>();
+  std::string timerName = getProfileTimerName();
+  std::string ciphertextName = getName(ciphertext);
+  os << timerName << " := heirProfileStart(\""
+     << (funcOp ? funcOp.getName() : "unknown") << "\", \"" << op.getName()
+     << "\", \"" << locationToSourceString(op.getLoc()) << "\", "
+     << ciphertextName << ".Level(), " << ciphertextName
+     << ".Value[0].N())\n";
+  return timerName;
+}
+
+void LattigoEmitter::emitProfileStop(const std::string &timerName) {
+  os << "heirProfileStop(" << timerName << ")\n";
+}
+
+LogicalResult LattigoEmitter::printBlock(Block &block) {
+  if (!parallel) {
+    for (Operation &op : block.getOperations()) {
+      if (failed(translate(op))) {
+        return failure();
+      }
+    }
+    return success();
+  }
+
+  // Runs of consecutive homomorphic ops are scheduled together, all other ops
+  // are printed in order.
+  SmallVector<Operation *> run;
+  for (Operation &op : block.getOperations()) {
+    if (isHomomorphicOp(op)) {
+      run.push_back(&op);
+      continue;
+    }
+    if (failed(printParallelOps(run)) || failed(translate(op))) {
+      return failure();
+    }
+    run.clear();
+  }
+  return printParallelOps(run);
+}
+
+LogicalResult LattigoEmitter::printParallelOps(ArrayRef<Operation *> ops) {
+  // Level the ops such that the ops of one level can run concurrently. Besides
+  // SSA dependencies, the buffers reused by lattigo-alloc-to-inplace must not
+  // be written by an op while another op of the same level reads or writes
+  // them, so dependencies are tracked on the storage values.
+  DenseMap<Value, int> lastWriteLevel;
+  DenseMap<Value, int> lastReadLevel;
+  auto lookup = [](const DenseMap<Value, int> &levels, Value storage) {
+    auto it = levels.find(storage);
+    return it == levels.end() ? -1 : it->second;
+  };
+
+  SmallVector<SmallVector<Operation *>> levels;
+  for (Operation *op : ops) {
+    SmallVector<Value> reads;
+    for (Value operand : op->getOperands()) {
+      if (isa<RLWECiphertextType, RLWEPlaintextType>(operand.getType())) {
+        reads.push_back(getStorageValue(operand));
+      }
+    }
+    SmallVector<Value> writes;
+    for (Value result : op->getResults()) {
+      writes.push_back(getStorageValue(result));
+    }
+
+    int level = 0;
+    for (Value storage : reads) {
+      level = std::max(level, lookup(lastWriteLevel, storage) + 1);
+    }
+    for (Value storage : writes) {
+      level = std::max(level, lookup(lastWriteLevel, storage) + 1);
+      level = std::max(level, lookup(lastReadLevel, storage) + 1);
+    }
+
+    for (Value storage : reads) {
+      lastReadLevel[storage] = std::max(lookup(lastReadLevel, storage), level);
+    }
+    for (Value storage : writes) {
+      lastWriteLevel[storage] = level;
+      lastReadLevel[storage] = level;
+    }
+
+    if (static_cast<int>(levels.size()) <= level) {
+      levels.resize(level + 1);
+    }
+    levels[level].push_back(op);
+  }
+
+  for (const auto &level : levels) {
+    if (level.size() == 1) {
+      if (failed(translate(*level.front()))) {
+        return failure();
+      }
+      continue;
+    }
+    if (failed(printParallelGroup(level))) {
+      return failure();
+    }
+  }
+  return success();
+}
+
+LogicalResult LattigoEmitter::printParallelGroup(ArrayRef<Operation *> ops) {
+  // Results of non-inplace ops are assigned inside the goroutines, so they
+  // are declared beforehand.
+  for (Operation *op : ops) {
+    for (Value result : op->getResults()) {
+      if (result.use_empty() || getStorageValue(result) != result) {
+        continue;
+      }
+      auto type = convertType(result.getType());
+      if (failed(type)) {
+        return op->emitError("unsupported result type");
+      }
+      os << "var " << getName(result) << " " << type.value() << "\n";
+    }
+  }
+
+  // Evaluators are not safe for concurrent use, so each worker gets a
+  // shallow copy sharing the evaluation keys.
+  std::string numWorkers = "runtime.GOMAXPROCS(0)";
+  for (Operation *op : ops) {
+    for (Value operand : op->getOperands()) {
+      if (!isa<BGVEvaluatorType, CKKSEvaluatorType>(operand.getType())) {
+        continue;
+      }
+      auto it = evaluatorWorkers.find(operand);
+      if (it == evaluatorWorkers.end()) {
+        std::string workersName = getName(operand) + "Workers";
+        os << workersName << " := heirShallowCopies(" << getName(operand)
+           << ")\n";
+        it = evaluatorWorkers.insert({operand, workersName}).first;
+      }
+      numWorkers = "len(" + it->second + ")";
+    }
+  }
+
+  os << "heirParallel(" << numWorkers << ", " << ops.size()
+     << ", func(worker, task int) {\n";
+  os.indent();
+  os << "switch task {\n";
+  inParallelGroup = true;
+  for (auto [index, op] : llvm::enumerate(ops)) {
+    os << "case " << index << ":\n";
+    os.indent();
+    for (auto &[evaluator, workersName] : evaluatorWorkers) {
+      nameOverrides[evaluator] = workersName + "[worker]";
+    }
+    LogicalResult result = translate(*op);
+    nameOverrides.clear();
+    os.unindent();
+    if (failed(result)) {
+      inParallelGroup = false;
+      return failure();
+    }
+  }
+  inParallelGroup = false;
+  os << "}\n";
+  os.unindent();
+  os << "})\n";
   return success();
 }
 
+void LattigoEmitter::printErrDeclaration(std::string_view errName) {
+  if (inParallelGroup) {
+    os << "var " << errName << " error\n";
+  }
+}
+
 LogicalResult LattigoEmitter::printOperation(ModuleOp moduleOp) {
   os << "package " << packageName << "\n";
 
+  std::string_view moduleImports;
   if (moduleIsBGVOrBFV(moduleOp)) {
-    os << kModulePreludeBGVTemplate;
+    moduleImports = kModuleImportsBGVTemplate;
   } else if (moduleIsCKKS(moduleOp)) {
-    os << kModulePreludeCKKSTemplate;
+    moduleImports = kModuleImportsCKKSTemplate;
   } else {
     return moduleOp.emitError("Unknown scheme");
   }
 
+  // Go rejects imports after other top-level declarations, so the packages
+  // used by the optional preludes are merged into a single import block.
+  std::set<std::string_view> stdImports;
+  if (profileOps) {
+    stdImports.insert({"fmt", "io", "sort", "sync", "time"});
+  }
+  if (parallel) {
+    stdImports.insert({"runtime", "sync", "sync/atomic"});
+  }
+
+  os << "\nimport (\n";
+  for (std::string_view stdImport : stdImports) {
+    os << "    \"" << stdImport << "\"\n";
+  }
+  if (!stdImports.empty()) {
+    os << "\n";
+  }
+  os << moduleImports << ")\n";
+
+  if (profileOps) {
+    os << kProfilePreludeTemplate;
+  }
+  if (parallel) {
+    os << kParallelPreludeTemplate;
+  }
+
   for (Operation &op : moduleOp) {
     if (failed(translate(op))) {
       return failure();
@@ -147,11 +389,10 @@ LogicalResult LattigoEmitter::printOperation(func::FuncOp funcOp) {
   os.indent();
 
   // body
+  evaluatorWorkers.clear();
   for (Block &block : funcOp.getBlocks()) {
-    for (Operation &op : block.getOperations()) {
-      if (failed(translate(op))) {
-        return failure();
-      }
+    if (failed(printBlock(block))) {
+      return failure();
     }
   }
 
@@ -340,8 +581,8 @@ LogicalResult LattigoEmitter::printOperation(RLWEDecryptOp op) {
 LogicalResult LattigoEmitter::printOperation(RLWELevelReduceNewOp op) {
   // there is no LevelReduceNew method in Lattigo, manually create new
   // ciphertext
-  os << getName(op.getOutput()) << " := " << getName(op.getInput())
-     << ".CopyNew()\n";
+  os << getName(op.getOutput()) << getAssignOperator()
+     << getName(op.getInput()) << ".CopyNew()\n";
   os << getName(op.getOutput()) << ".Resize(" << getName(op.getOutput())
      << ".Degree(), " << getName(op.getOutput()) << ".Level()-"
      << op.getLevelToDrop() << ")\n";
@@ -463,6 +704,11 @@ LogicalResult LattigoEmitter::printOperation(BGVMulNewOp op) {
                             {op.getLhs(), op.getRhs()}, "MulNew", true);
 }
 
+LogicalResult LattigoEmitter::printOperation(BGVWeightedSumNewOp op) {
+  return printWeightedSum(op.getOutput(), op.getEvaluator(),
+                          op.getCiphertexts(), op.getPlaintexts());
+}
+
 LogicalResult LattigoEmitter::printOperation(BGVAddOp op) {
   return printEvalInplaceMethod(op.getEvaluator(),
                                 {op.getLhs(), op.getRhs(), op.getInplace()},
@@ -488,16 +734,17 @@ LogicalResult LattigoEmitter::printOperation(BGVRelinearizeNewOp op) {
 
 LogicalResult LattigoEmitter::printOperation(BGVRescaleNewOp op) {
   // there is no RescaleNew method in Lattigo, manually create new ciphertext
-  os << getName(op.getOutput()) << " := " << getName(op.getInput())
-     << ".CopyNew()\n";
+  os << getName(op.getOutput()) << getAssignOperator()
+     << getName(op.getInput()) << ".CopyNew()\n";
   return printEvalInplaceMethod(
       op.getEvaluator(), {op.getInput(), op.getOutput()}, "Rescale", true);
 }
 
 LogicalResult LattigoEmitter::printOperation(BGVRotateColumnsNewOp op) {
   auto errName = getErrName();
-  os << getName(op.getOutput()) << ", " << errName
-     << " := " << getName(op.getEvaluator()) << ".RotateColumnsNew(";
+  printErrDeclaration(errName);
+  os << getName(op.getOutput()) << ", " << errName << getAssignOperator()
+     << getName(op.getEvaluator()) << ".RotateColumnsNew(";
   os << getName(op.getInput()) << ", ";
   os << op.getOffset().getInt() << ")\n";
   printErrPanic(errName);
@@ -674,6 +921,11 @@ LogicalResult LattigoEmitter::printOperation(CKKSMulNewOp op) {
                             {op.getLhs(), op.getRhs()}, "MulNew", true);
 }
 
+LogicalResult LattigoEmitter::printOperation(CKKSWeightedSumNewOp op) {
+  return printWeightedSum(op.getOutput(), op.getEvaluator(),
+                          op.getCiphertexts(), op.getPlaintexts());
+}
+
 LogicalResult LattigoEmitter::printOperation(CKKSAddOp op) {
   return printEvalInplaceMethod(op.getEvaluator(),
                                 {op.getLhs(), op.getRhs(), op.getInplace()},
@@ -699,16 +951,17 @@ LogicalResult LattigoEmitter::printOperation(CKKSRelinearizeNewOp op) {
 
 LogicalResult LattigoEmitter::printOperation(CKKSRescaleNewOp op) {
   // there is no RescaleNew method in Lattigo, manually create new ciphertext
-  os << getName(op.getOutput()) << " := " << getName(op.getInput())
-     << ".CopyNew()\n";
+  os << getName(op.getOutput()) << getAssignOperator()
+     << getName(op.getInput()) << ".CopyNew()\n";
   return printEvalInplaceMethod(
       op.getEvaluator(), {op.getInput(), op.getOutput()}, "Rescale", true);
 }
 
 LogicalResult LattigoEmitter::printOperation(CKKSRotateNewOp op) {
   auto errName = getErrName();
-  os << getName(op.getOutput()) << ", " << errName
-     << " := " << getName(op.getEvaluator()) << ".RotateNew(";
+  printErrDeclaration(errName);
+  os << getName(op.getOutput()) << ", " << errName << getAssignOperator()
+     << getName(op.getEvaluator()) << ".RotateNew(";
   os << getName(op.getInput()) << ", ";
   os << op.getOffset().getInt() << ")\n";
   printErrPanic(errName);
@@ -803,17 +1056,40 @@ LogicalResult LattigoEmitter::printEvalInplaceMethod(
   return success();
 }
 
+LogicalResult LattigoEmitter::printWeightedSum(::mlir::Value result,
+                                               ::mlir::Value evaluator,
+                                               ::mlir::ValueRange ciphertexts,
+                                               ::mlir::ValueRange plaintexts) {
+  // The products are accumulated in the result without rescaling them.
+  if (failed(printEvalNewMethod(result, evaluator,
+                                {ciphertexts.front(), plaintexts.front()},
+                                "MulNew", true))) {
+    return failure();
+  }
+  for (auto [ciphertext, plaintext] :
+       llvm::zip(ciphertexts.drop_front(), plaintexts.drop_front())) {
+    if (failed(printEvalInplaceMethod(
+            evaluator, {ciphertext, plaintext, result}, "MulThenAdd", true))) {
+      return failure();
+    }
+  }
+  return success();
+}
+
 LogicalResult LattigoEmitter::printEvalNewMethod(::mlir::ValueRange results,
                                                  ::mlir::Value evaluator,
                                                  ::mlir::ValueRange operands,
                                                  std::string_view op,
                                                  bool err) {
   std::string errName = getErrName();
+  if (err) {
+    printErrDeclaration(errName);
+  }
   os << getCommaSeparatedNames(results);
   if (err) {
     os << ", " << errName;
   }
-  os << " := " << getName(evaluator) << "." << op << "(";
+  os << getAssignOperator() << getName(evaluator) << "." << op << "(";
   os << getCommaSeparatedNames(operands);
   os << ")\n";
   if (err) {
@@ -901,14 +1177,33 @@ LogicalResult LattigoEmitter::emitType(Type type) {
 
 LattigoEmitter::LattigoEmitter(raw_ostream &os,
                                SelectVariableNames *variableNames,
-                               const std::string &packageName)
-    : os(os), variableNames(variableNames), packageName(packageName) {}
+                               const std::string &packageName, bool profileOps,
+                               bool parallel)
+    : os(os),
+      variableNames(variableNames),
+      packageName(packageName),
+      profileOps(profileOps),
+      parallel(parallel) {}
 
 struct TranslateOptions {
   llvm::cl::opt<std::string> packageName{
       "package-name",
       llvm::cl::desc("The name to use for the package declaration in the "
                      "generated golang file.")};
+  llvm::cl::opt<bool> profileOps{
+      "lattigo-profile-ops",
+      llvm::cl::desc(
+          "Wrap each homomorphic op in a timer recording the op name, level, "
+          "ring dimension and source location, and emit HeirProfile functions "
+          "reporting a per-op latency table and folded stacks"),
+      llvm::cl::init(false)};
+  llvm::cl::opt<bool> parallel{
+      "lattigo-parallel",
+      llvm::cl::desc(
+          "Evaluate independent homomorphic ops concurrently in goroutines, "
+          "each with a shallow copy of the evaluator, using up to GOMAXPROCS "
+          "workers"),
+      llvm::cl::init(false)};
 };
 static llvm::ManagedStatic<TranslateOptions> translateOptions;
 
@@ -922,7 +1217,9 @@ void registerToLattigoTranslation() {
       "emit-lattigo",
       "translate the lattigo dialect to GO code against the Lattigo API",
       [](Operation *op, llvm::raw_ostream &output) {
-        return translateToLattigo(op, output, translateOptions->packageName);
+        return translateToLattigo(op, output, translateOptions->packageName,
+                                  translateOptions->profileOps,
+                                  translateOptions->parallel);
       },
       [](DialectRegistry &registry) {
         registry.insert<rns::RNSDialect, arith::ArithDialect, func::FuncDialect,
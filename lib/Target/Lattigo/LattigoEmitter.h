@@ -8,10 +8,13 @@
 #include "lib/Dialect/Lattigo/IR/LattigoOps.h"
 #include "lib/Utils/Tablegen/InplaceOpInterface.h"
 #include "lib/Utils/TargetUtils.h"
+#include "llvm/include/llvm/ADT/ArrayRef.h"              // from @llvm-project
+#include "llvm/include/llvm/ADT/DenseMap.h"              // from @llvm-project
 #include "llvm/include/llvm/Support/raw_ostream.h"       // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"   // from @llvm-project
 #include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Block.h"                  // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinOps.h"             // from @llvm-project
 #include "mlir/include/mlir/IR/Operation.h"              // from @llvm-project
 #include "mlir/include/mlir/IR/TypeRange.h"              // from @llvm-project
@@ -31,12 +34,15 @@ void registerTranslateOptions();
 /// Translates the given operation to Lattigo
 ::mlir::LogicalResult translateToLattigo(::mlir::Operation *op,
                                          llvm::raw_ostream &os,
-                                         const std::string &packageName);
+                                         const std::string &packageName,
+                                         bool profileOps = false,
+                                         bool parallel = false);
 
 class LattigoEmitter {
  public:
   LattigoEmitter(raw_ostream &os, SelectVariableNames *variableNames,
-                 const std::string &packageName);
+                 const std::string &packageName, bool profileOps = false,
+                 bool parallel = false);
 
   LogicalResult translate(::mlir::Operation &operation);
 
@@ -50,6 +56,23 @@ class LattigoEmitter {
 
   const std::string &packageName;
 
+  /// Whether to wrap each homomorphic op in a heirProfile timer.
+  bool profileOps;
+
+  /// Whether to evaluate independent homomorphic ops in goroutines.
+  bool parallel;
+
+  /// Whether the ops being printed belong to a parallel group, whose results
+  /// are declared before the group.
+  bool inParallelGroup = false;
+
+  /// Names to use instead of the selected variable names, e.g. the per-worker
+  /// evaluator inside a parallel group.
+  ::llvm::DenseMap<::mlir::Value, std::string> nameOverrides;
+
+  /// The per-worker copies of each evaluator in the current function.
+  ::llvm::DenseMap<::mlir::Value, std::string> evaluatorWorkers;
+
   // Functions for printing individual ops
   LogicalResult printOperation(::mlir::ModuleOp op);
   LogicalResult printOperation(::mlir::func::FuncOp op);
@@ -81,6 +104,7 @@ class LattigoEmitter {
   LogicalResult printOperation(BGVAddNewOp op);
   LogicalResult printOperation(BGVSubNewOp op);
   LogicalResult printOperation(BGVMulNewOp op);
+  LogicalResult printOperation(BGVWeightedSumNewOp op);
   LogicalResult printOperation(BGVRelinearizeNewOp op);
   LogicalResult printOperation(BGVRescaleNewOp op);
   LogicalResult printOperation(BGVRotateColumnsNewOp op);
@@ -102,6 +126,7 @@ class LattigoEmitter {
   LogicalResult printOperation(CKKSAddNewOp op);
   LogicalResult printOperation(CKKSSubNewOp op);
   LogicalResult printOperation(CKKSMulNewOp op);
+  LogicalResult printOperation(CKKSWeightedSumNewOp op);
   LogicalResult printOperation(CKKSRelinearizeNewOp op);
   LogicalResult printOperation(CKKSRescaleNewOp op);
   LogicalResult printOperation(CKKSRotateNewOp op);
@@ -136,6 +161,24 @@ class LattigoEmitter {
                               op, err);
   }
 
+  // Prints a MulNew of the first ciphertext and plaintext, followed by a
+  // MulThenAdd of each other pair into the result.
+  LogicalResult printWeightedSum(::mlir::Value result, ::mlir::Value evaluator,
+                                 ::mlir::ValueRange ciphertexts,
+                                 ::mlir::ValueRange plaintexts);
+
+  // Parallel evaluation
+  LogicalResult printBlock(::mlir::Block &block);
+  LogicalResult printParallelOps(::llvm::ArrayRef<::mlir::Operation *> ops);
+  LogicalResult printParallelGroup(::llvm::ArrayRef<::mlir::Operation *> ops);
+  std::string getAssignOperator() { return inParallelGroup ? " = " : " := "; }
+  void printErrDeclaration(std::string_view errName);
+
+  // Per-op profiling hooks
+  bool isHomomorphicOp(::mlir::Operation &op);
+  std::string emitProfileStart(::mlir::Operation &op);
+  void emitProfileStop(const std::string &timerName);
+
   // Canonicalize Debug Port
   bool isDebugPort(::llvm::StringRef debugPortName);
   ::llvm::StringRef canonicalizeDebugPort(::llvm::StringRef debugPortName);
@@ -158,6 +201,9 @@ class LattigoEmitter {
     if (value == Value()) {
       return "nil";
     }
+    if (auto it = nameOverrides.find(value); it != nameOverrides.end()) {
+      return it->second;
+    }
     // when the value has no uses, we can not assign it a name
     // otherwise GO would complain "declared and not used"
     if (value.use_empty()) {
@@ -171,6 +217,11 @@ class LattigoEmitter {
     return "err" + std::to_string(errCount++);
   }
 
+  std::string getProfileTimerName() {
+    static int profileTimerCount = 0;
+    return "profileTimer" + std::to_string(profileTimerCount++);
+  }
+
   std::string getDebugAttrMapName() {
     static int debugAttrMapCount = 0;
     return "debugAttrMap" + std::to_string(debugAttrMapCount++);
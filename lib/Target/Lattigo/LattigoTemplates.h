@@ -7,19 +7,151 @@ namespace mlir {
 namespace heir {
 namespace lattigo {
 
+// Lattigo packages imported by every module. The emitter merges these with
+// the standard library packages needed by the optional preludes below into a
+// single import block, as Go requires all imports to precede declarations.
 // clang-format off
-constexpr std::string_view kModulePreludeBGVTemplate = R"go(
-import (
-    "github.com/tuneinsight/lattigo/v6/core/rlwe"
+constexpr std::string_view kModuleImportsBGVTemplate = R"go(    "github.com/tuneinsight/lattigo/v6/core/rlwe"
     "github.com/tuneinsight/lattigo/v6/schemes/bgv"
-)
 )go";
 
-constexpr std::string_view kModulePreludeCKKSTemplate = R"go(
-import (
-    "github.com/tuneinsight/lattigo/v6/core/rlwe"
+constexpr std::string_view kModuleImportsCKKSTemplate = R"go(    "github.com/tuneinsight/lattigo/v6/core/rlwe"
     "github.com/tuneinsight/lattigo/v6/schemes/ckks"
+)go";
+// clang-format on
+
+// Per-op profiler emitted with --lattigo-profile-ops. Timings are aggregated
+// by function, op, source location, level and ring dimension. Requires the
+// "fmt", "io", "sort", "sync" and "time" packages.
+// clang-format off
+constexpr std::string_view kProfilePreludeTemplate = R"go(
+type heirProfileKey struct {
+    fn      string
+    op      string
+    loc     string
+    level   int
+    ringDim int
+}
+
+type heirProfileTimer struct {
+    key   heirProfileKey
+    start time.Time
+}
+
+type heirProfileStats struct {
+    count      int64
+    totalNanos int64
+    maxNanos   int64
+}
+
+var (
+    heirProfileMu         sync.Mutex
+    heirProfileStatsByKey = map[heirProfileKey]*heirProfileStats{}
 )
+
+func heirProfileStart(fn, op, loc string, level, ringDim int) heirProfileTimer {
+    return heirProfileTimer{heirProfileKey{fn, op, loc, level, ringDim}, time.Now()}
+}
+
+func heirProfileStop(timer heirProfileTimer) {
+    nanos := time.Since(timer.start).Nanoseconds()
+    heirProfileMu.Lock()
+    defer heirProfileMu.Unlock()
+    stats, ok := heirProfileStatsByKey[timer.key]
+    if !ok {
+        stats = &heirProfileStats{}
+        heirProfileStatsByKey[timer.key] = stats
+    }
+    stats.count++
+    stats.totalNanos += nanos
+    if nanos > stats.maxNanos {
+        stats.maxNanos = nanos
+    }
+}
+
+func heirProfileSortedKeys() ([]heirProfileKey, map[heirProfileKey]heirProfileStats) {
+    heirProfileMu.Lock()
+    defer heirProfileMu.Unlock()
+    keys := make([]heirProfileKey, 0, len(heirProfileStatsByKey))
+    snapshot := make(map[heirProfileKey]heirProfileStats, len(heirProfileStatsByKey))
+    for key, stats := range heirProfileStatsByKey {
+        keys = append(keys, key)
+        snapshot[key] = *stats
+    }
+    sort.SliceStable(keys, func(i, j int) bool {
+        return snapshot[keys[i]].totalNanos > snapshot[keys[j]].totalNanos
+    })
+    return keys, snapshot
+}
+
+// HeirProfileWriteTable writes a tab-separated table of per-op latencies.
+func HeirProfileWriteTable(w io.Writer) {
+    keys, snapshot := heirProfileSortedKeys()
+    fmt.Fprintln(w, "function\top\tlocation\tlevel\tring_dim\tcount\ttotal_us\tmean_us\tmax_us")
+    for _, key := range keys {
+        stats := snapshot[key]
+        fmt.Fprintf(w, "%s\t%s\t%s\t%d\t%d\t%d\t%.3f\t%.3f\t%.3f\n",
+            key.fn, key.op, key.loc, key.level, key.ringDim, stats.count,
+            float64(stats.totalNanos)/1e3,
+            float64(stats.totalNanos)/1e3/float64(stats.count),
+            float64(stats.maxNanos)/1e3)
+    }
+}
+
+// HeirProfileWriteFolded writes the per-op latencies in the folded-stack
+// format consumed by flamegraph.pl and speedscope, in nanoseconds.
+func HeirProfileWriteFolded(w io.Writer) {
+    keys, snapshot := heirProfileSortedKeys()
+    for _, key := range keys {
+        fmt.Fprintf(w, "%s;%s[L%d,N%d];%s %d\n", key.fn, key.op, key.level,
+            key.ringDim, key.loc, snapshot[key].totalNanos)
+    }
+}
+
+// HeirProfileReset discards all recorded timings.
+func HeirProfileReset() {
+    heirProfileMu.Lock()
+    defer heirProfileMu.Unlock()
+    heirProfileStatsByKey = map[heirProfileKey]*heirProfileStats{}
+}
+)go";
+// clang-format on
+
+// Helpers for --lattigo-parallel. Each group of independent ops is run by
+// heirParallel on up to numWorkers goroutines, where worker i uses the i-th
+// shallow copy of the evaluator. Requires the "runtime", "sync" and
+// "sync/atomic" packages.
+// clang-format off
+constexpr std::string_view kParallelPreludeTemplate = R"go(
+func heirShallowCopies[T interface{ ShallowCopy() T }](evaluator T) []T {
+    copies := make([]T, runtime.GOMAXPROCS(0))
+    for i := range copies {
+        copies[i] = evaluator.ShallowCopy()
+    }
+    return copies
+}
+
+func heirParallel(numWorkers, numTasks int, task func(worker, task int)) {
+    if numWorkers > numTasks {
+        numWorkers = numTasks
+    }
+    var next atomic.Int64
+    var wg sync.WaitGroup
+    wg.Add(numWorkers)
+    for worker := 0; worker < numWorkers; worker++ {
+        go func(worker int) {
+            defer wg.Done()
+            for {
+                i := int(next.Add(1) - 1)
+                if i >= numTasks {
+                    return
+                }
+                task(worker, i)
+            }
+        }(worker)
+    }
+    wg.Wait()
+}
 )go";
 // clang-format on
 
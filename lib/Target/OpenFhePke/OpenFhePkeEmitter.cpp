@@ -8,6 +8,7 @@
 #include <functional>
 #include <ios>
 #include <iterator>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -18,10 +19,13 @@
 #include "include/cereal/archives/portable_binary.hpp"  // from @cereal
 #include "lib/Analysis/SelectVariableNames/SelectVariableNames.h"
 #include "lib/Dialect/LWE/IR/LWEAttributes.h"
+#include "lib/Dialect/LWE/IR/LWEDialect.h"
 #include "lib/Dialect/LWE/IR/LWEOps.h"
 #include "lib/Dialect/ModuleAttributes.h"
 #include "lib/Dialect/Openfhe/IR/OpenfheOps.h"
 #include "lib/Target/OpenFhePke/OpenFheUtils.h"
+#include "lib/Utils/Graph/CSRGraph.h"
+#include "lib/Utils/Graph/Graph.h"
 #include "lib/Utils/TargetUtils.h"
 #include "llvm/include/llvm/ADT/STLExtras.h"           // from @llvm-project
 #include "llvm/include/llvm/ADT/SmallVector.h"         // from @llvm-project
@@ -228,18 +232,43 @@ FailureOr<std::string> getWeightType(Type type) {
   return result;
 }
 
+// A rough relative cost of each homomorphic op, used to balance parallel
+// sections. Ops that key switch dominate, so they are weighted most heavily.
+int64_t getOpCost(Operation *op) {
+  return llvm::TypeSwitch<Operation *, int64_t>(op)
+      .Case<AddOp, AddPlainOp, SubOp, SubPlainOp, NegateOp, LevelReduceOp>(
+          [](auto op) { return 1; })
+      .Case<MulPlainOp, MulConstOp, ModReduceOp>([](auto op) { return 3; })
+      .Case<LinearWSumOp>(
+          [](auto op) { return 3 * op.getCiphertexts().size(); })
+      .Case<MulNoRelinOp>([](auto op) { return 4; })
+      .Case<RelinOp, RotOp, AutomorphOp, KeySwitchOp>(
+          [](auto op) { return 16; })
+      .Case<MulOp, SquareOp>([](auto op) { return 20; })
+      .Case<BootstrapOp>([](auto op) { return 1000; })
+      .Default([](Operation *op) { return 1; });
+}
+
 }  // namespace
 
 LogicalResult translateToOpenFhePke(Operation *op, llvm::raw_ostream &os,
                                     const OpenfheImportType &importType,
-                                    const std::string &weightsFile) {
+                                    const std::string &weightsFile,
+                                    bool profileOps,
+                                    unsigned parallelSections) {
   SelectVariableNames variableNames(op);
-  OpenFhePkeEmitter emitter(os, &variableNames, importType, weightsFile);
+  OpenFhePkeEmitter emitter(os, &variableNames, importType, weightsFile,
+                            profileOps, parallelSections);
   LogicalResult result = emitter.translate(*op);
   return result;
 }
 
 LogicalResult OpenFhePkeEmitter::translate(Operation &op) {
+  std::string profileTimer;
+  if (profileOps_ && isProfiledOp(op)) {
+    profileTimer = emitProfileStart(op);
+  }
+
   LogicalResult status =
       llvm::TypeSwitch<Operation &, LogicalResult>(op)
           // Builtin ops
@@ -254,19 +283,22 @@ LogicalResult OpenFhePkeEmitter::translate(Operation &op) {
           .Case<arith::ConstantOp, arith::ExtSIOp, arith::IndexCastOp,
                 arith::ExtFOp>([&](auto op) { return printOperation(op); })
           // Tensor ops
-          .Case<tensor::EmptyOp, tensor::InsertOp, tensor::ExtractOp,
-                tensor::ExtractSliceOp, tensor::SplatOp>(
+          .Case<tensor::EmptyOp, tensor::InsertOp, tensor::InsertSliceOp,
+                tensor::ExtractOp, tensor::ExtractSliceOp, tensor::SplatOp>(
               [&](auto op) { return printOperation(op); })
           // LWE ops
           .Case<lwe::RLWEDecodeOp, lwe::ReinterpretApplicationDataOp>(
               [&](auto op) { return printOperation(op); })
           // OpenFHE ops
           .Case<AddOp, AddPlainOp, SubOp, SubPlainOp, MulNoRelinOp, MulOp,
-                MulPlainOp, SquareOp, NegateOp, MulConstOp, RelinOp,
-                ModReduceOp, LevelReduceOp, RotOp, AutomorphOp, KeySwitchOp,
-                EncryptOp, DecryptOp, GenParamsOp, GenContextOp, GenMulKeyOp,
-                GenRotKeyOp, GenBootstrapKeyOp, MakePackedPlaintextOp,
-                MakeCKKSPackedPlaintextOp, SetupBootstrapOp, BootstrapOp>(
+                MulPlainOp, SquareOp, NegateOp, MulConstOp, LinearWSumOp,
+                RelinOp, ModReduceOp, LevelReduceOp, RotOp, AutomorphOp,
+                KeySwitchOp, EncryptOp, DecryptOp, GenParamsOp, GenContextOp,
+                GenMulKeyOp, GenRotKeyOp, GenBootstrapKeyOp,
+                MakePackedPlaintextOp,
+                MakeCKKSPackedPlaintextOp, SetupBootstrapOp, BootstrapOp,
+                SaveCryptoContextOp, LoadCryptoContextOp, SaveKeyOp,
+                LoadKeyOp>(
               [&](auto op) { return printOperation(op); })
           .Default([&](Operation &) {
             return emitError(op.getLoc(), "unable to find printer for op");
@@ -276,9 +308,41 @@ LogicalResult OpenFhePkeEmitter::translate(Operation &op) {
     return emitError(op.getLoc(),
                      llvm::formatv("Failed to translate op {0}", op.getName()));
   }
+
+  if (!profileTimer.empty()) {
+    emitProfileStop(profileTimer);
+  }
   return success();
 }
 
+bool OpenFhePkeEmitter::isProfiledOp(Operation &op) {
+  return isa<AddOp, AddPlainOp, SubOp, SubPlainOp, MulNoRelinOp, MulOp,
+             MulPlainOp, SquareOp, NegateOp, MulConstOp, LinearWSumOp, RelinOp,
+             ModReduceOp, LevelReduceOp, RotOp, AutomorphOp, KeySwitchOp,
+             BootstrapOp>(op);
+}
+
+std::string OpenFhePkeEmitter::emitProfileStart(Operation &op) {
+  // All profiled ops take the crypto context first and a ciphertext second.
+  // The level is read at runtime, before the op runs, since OpenFHE may pick
+  // a different modulus chain than the one recorded in the IR types.
+  auto funcOp = op.getParentOfType<func::FuncOp>();
+  std::string cc = variableNames->getNameForValue(op.getOperand(0));
+  std::string ciphertext = variableNames->getNameForValue(op.getOperand(1));
+  std::string timerName = getProfileTimerName();
+  os << llvm::formatv(
+      "auto {0} = heir_profile::Start(\"{1}\", \"{2}\", \"{3}\", "
+      "{4}->GetLevel(), {5}->GetRingDimension());\n",
+      timerName, funcOp ? funcOp.getName() : "unknown",
+      op.getName().getStringRef(),
+      locationToSourceString(op.getLoc()), ciphertext, cc);
+  return timerName;
+}
+
+void OpenFhePkeEmitter::emitProfileStop(const std::string &timerName) {
+  os << "heir_profile::Stop(" << timerName << ");\n";
+}
+
 LogicalResult OpenFhePkeEmitter::printOperation(ModuleOp moduleOp) {
   OpenfheScheme scheme;
   if (moduleIsBGV(moduleOp)) {
@@ -296,6 +360,28 @@ LogicalResult OpenFhePkeEmitter::printOperation(ModuleOp moduleOp) {
   if (!weightsFile_.empty()) {
     os << getWeightsPrelude() << "\n";
   }
+  if (profileOps_) {
+    os << getProfilePrelude() << "\n";
+  }
+  bool usesKeyCache =
+      moduleOp
+          .walk([](Operation *op) {
+            return isa<SaveCryptoContextOp, LoadCryptoContextOp, SaveKeyOp,
+                       LoadKeyOp>(op)
+                       ? WalkResult::interrupt()
+                       : WalkResult::advance();
+          })
+          .wasInterrupted();
+  if (usesKeyCache) {
+    os << getKeyCachePrelude(scheme, importType_) << "\n";
+  }
+  bool usesSerialization = llvm::any_of(
+      moduleOp.getOps<func::FuncOp>(), [](func::FuncOp funcOp) {
+        return getSerializationHelpers(funcOp).has_value();
+      });
+  if (usesSerialization) {
+    os << getWirePrelude() << "\n";
+  }
   for (Operation &op : moduleOp) {
     if (failed(translate(op))) {
       return failure();
@@ -393,6 +479,12 @@ LogicalResult OpenFhePkeEmitter::printOperation(func::FuncOp funcOp) {
   }
 
   for (Block &block : funcOp.getBlocks()) {
+    if (parallelSections_ > 0) {
+      if (failed(translateBlockInParallel(block))) {
+        return failure();
+      }
+      continue;
+    }
     for (Operation &op : block.getOperations()) {
       if (failed(translate(op))) {
         return failure();
@@ -400,6 +492,183 @@ LogicalResult OpenFhePkeEmitter::printOperation(func::FuncOp funcOp) {
     }
   }
 
+  os.unindent();
+  os << "}\n";
+  return printSerializationHelpers(funcOp);
+}
+
+LogicalResult OpenFhePkeEmitter::printSerializationHelpers(
+    func::FuncOp funcOp) {
+  std::optional<SerializationHelpers> helpers =
+      getSerializationHelpers(funcOp);
+  if (!helpers.has_value()) {
+    return success();
+  }
+  auto signatures =
+      getSerializationHelperSignatures(helpers.value(), funcOp.getLoc());
+  if (failed(signatures)) {
+    return emitError(funcOp.getLoc(),
+                     llvm::formatv("Failed to emit type {0}",
+                                   helpers->ciphertextType));
+  }
+  auto ciphertextType = convertType(helpers->ciphertextType, funcOp.getLoc());
+
+  os << signatures->first << " {\n";
+  os.indent();
+  os << "return heir_wire::Write(cc, ciphertext, os, /*trimLevels=*/"
+     << (helpers->trimLevels ? "true" : "false") << ");\n";
+  os.unindent();
+  os << "}\n";
+
+  os << signatures->second << " {\n";
+  os.indent();
+  os << "return heir_wire::Read<" << ciphertextType.value() << ">(cc, is);\n";
+  os.unindent();
+  os << "}\n";
+  return success();
+}
+
+bool OpenFhePkeEmitter::isReorderableOp(Operation &op) {
+  // Ops that neither read nor write state shared with other emitted ops, so
+  // they may be emitted in any order consistent with their SSA dependencies.
+  // Notably tensor.insert is excluded, since it is emitted as an in-place
+  // update of its destination.
+  return isProfiledOp(op) ||
+         isa<arith::ConstantOp, tensor::ExtractOp,
+             lwe::ReinterpretApplicationDataOp>(op);
+}
+
+LogicalResult OpenFhePkeEmitter::translateBlockInParallel(Block &block) {
+  // Split the block into maximal runs of reorderable ops, separated by ops
+  // that must stay in program order.
+  SmallVector<Operation *> segment;
+  for (Operation &op : block.getOperations()) {
+    if (isReorderableOp(op)) {
+      segment.push_back(&op);
+      continue;
+    }
+    if (failed(translateSegmentInParallel(segment))) {
+      return failure();
+    }
+    segment.clear();
+    if (failed(translate(op))) {
+      return failure();
+    }
+  }
+  return translateSegmentInParallel(segment);
+}
+
+LogicalResult OpenFhePkeEmitter::translateSegmentInParallel(
+    ArrayRef<Operation *> segment) {
+  if (segment.empty()) {
+    return success();
+  }
+
+  graph::Graph<Operation *> graph;
+  for (Operation *op : segment) {
+    graph.addVertex(op);
+  }
+  for (Operation *op : segment) {
+    for (Value operand : op->getOperands()) {
+      // Edges from ops outside the segment are ignored by addEdge.
+      if (Operation *definingOp = operand.getDefiningOp()) {
+        graph.addEdge(definingOp, op);
+      }
+    }
+  }
+
+  // Schedule each op as soon as its operands are available, so that
+  // independent key switching ops land in the same level.
+  graph::CSRGraph<Operation *> frozenGraph(graph);
+  auto result = frozenGraph.computeLevels();
+  assert(succeeded(result) &&
+         "Only possible failure is a cycle in the SSA graph!");
+  DenseMap<Operation *, int> opLevels;
+  int maxLevel = 0;
+  for (auto [id, level] : llvm::enumerate(result.value())) {
+    opLevels[frozenGraph.getVertex(id)] = level;
+    maxLevel = std::max(maxLevel, static_cast<int>(level));
+  }
+  // Ops within a level stay in program order to keep the output deterministic.
+  SmallVector<SmallVector<Operation *>> levels(maxLevel + 1);
+  for (Operation *op : segment) {
+    levels[opLevels[op]].push_back(op);
+  }
+
+  for (auto &level : levels) {
+    // Cheap ops such as additions are not worth the cost of a task.
+    SmallVector<Operation *> parallelOps;
+    for (Operation *op : level) {
+      if (isProfiledOp(*op) && getOpCost(op) > 1) {
+        parallelOps.push_back(op);
+      }
+    }
+    if (parallelOps.size() < 2) {
+      parallelOps.clear();
+    }
+
+    // Ops in the same level are independent, so the cheap ones can be emitted
+    // ahead of the parallel region.
+    for (Operation *op : level) {
+      if (!llvm::is_contained(parallelOps, op) && failed(translate(*op))) {
+        return failure();
+      }
+    }
+    if (!parallelOps.empty() && failed(emitParallelSections(parallelOps))) {
+      return failure();
+    }
+  }
+  return success();
+}
+
+LogicalResult OpenFhePkeEmitter::emitParallelSections(
+    ArrayRef<Operation *> ops) {
+  // Longest-processing-time-first assignment of ops to sections, so that the
+  // expensive key switching ops are spread across threads.
+  SmallVector<Operation *> byCost(ops.begin(), ops.end());
+  llvm::stable_sort(byCost, [](Operation *lhs, Operation *rhs) {
+    return getOpCost(lhs) > getOpCost(rhs);
+  });
+  size_t numSections = std::min<size_t>(parallelSections_, ops.size());
+  SmallVector<SmallVector<Operation *>> sections(numSections);
+  SmallVector<int64_t> sectionCosts(numSections, 0);
+  for (Operation *op : byCost) {
+    auto *cheapest = llvm::min_element(sectionCosts);
+    auto index = std::distance(sectionCosts.begin(), cheapest);
+    sections[index].push_back(op);
+    *cheapest += getOpCost(op);
+  }
+
+  // Results are declared ahead of the parallel region so they remain in scope
+  // after it, and assigned inside their section.
+  for (Operation *op : ops) {
+    for (Value result : op->getResults()) {
+      if (failed(emitType(result.getType(), op->getLoc()))) {
+        return failure();
+      }
+      os << " " << variableNames->getNameForValue(result) << ";\n";
+      mutableValues.insert(result);
+    }
+  }
+
+  os << "#pragma omp parallel sections\n";
+  os << "{\n";
+  os.indent();
+  for (auto &section : sections) {
+    llvm::sort(section, [](Operation *lhs, Operation *rhs) {
+      return lhs->isBeforeInBlock(rhs);
+    });
+    os << "#pragma omp section\n";
+    os << "{\n";
+    os.indent();
+    for (Operation *op : section) {
+      if (failed(translate(*op))) {
+        return failure();
+      }
+    }
+    os.unindent();
+    os << "}\n";
+  }
   os.unindent();
   os << "}\n";
   return success();
@@ -457,6 +726,10 @@ LogicalResult OpenFhePkeEmitter::printOperation(func::CallOp op) {
 }
 
 LogicalResult OpenFhePkeEmitter::printOperation(func::ReturnOp op) {
+  if (op.getNumOperands() == 0) {
+    os << "return;\n";
+    return success();
+  }
   if (op.getNumOperands() != 1) {
     return emitError(op.getLoc(), "Only one return value supported");
   }
@@ -496,6 +769,16 @@ LogicalResult OpenFhePkeEmitter::printOperation(affine::AffineForOp op) {
     mutableValues.insert(op.getYieldedValues()[i]);
   }
 
+  // The client interface marks the loops encrypting or decrypting the
+  // elements of a tensor, whose iterations are independent.
+  if (auto threadsAttr = op->getAttrOfType<IntegerAttr>(
+          lwe::LWEDialect::kClientThreadsAttrName)) {
+    os << "#pragma omp parallel for";
+    if (threadsAttr.getInt() > 0) {
+      os << " num_threads(" << threadsAttr.getInt() << ")";
+    }
+    os << "\n";
+  }
   os << llvm::formatv("for (auto {0} = {1}; {0} < {2}; ++{0}) {{\n",
                       variableNames->getNameForValue(op.getInductionVar()),
                       op.getConstantLowerBound(), op.getConstantUpperBound());
@@ -601,6 +884,27 @@ LogicalResult OpenFhePkeEmitter::printOperation(MulConstOp op) {
                          {op.getCiphertext(), op.getConstant()}, "EvalMult");
 }
 
+LogicalResult OpenFhePkeEmitter::printOperation(LinearWSumOp op) {
+  // EvalLinearWSum takes its ciphertexts by non-const reference, so they are
+  // gathered in named vectors first.
+  // std::vector<CiphertextT> v_cts = {ct0, ct1};
+  // std::vector<double> v_weights = {w0, w1};
+  // const auto& v = cc->EvalLinearWSum(v_cts, v_weights);
+  std::string resultName = variableNames->getNameForValue(op.getResult());
+  auto getName = [&](Value value) {
+    return variableNames->getNameForValue(value);
+  };
+  os << "std::vector<CiphertextT> " << resultName << "_cts = {"
+     << commaSeparatedValues(op.getCiphertexts(), getName) << "};\n";
+  os << "std::vector<double> " << resultName << "_weights = {"
+     << commaSeparatedValues(op.getWeights(), getName) << "};\n";
+  emitAutoAssignPrefix(op.getResult());
+  os << variableNames->getNameForValue(op.getCryptoContext())
+     << "->EvalLinearWSum(" << resultName << "_cts, " << resultName
+     << "_weights);\n";
+  return success();
+}
+
 LogicalResult OpenFhePkeEmitter::printOperation(NegateOp op) {
   return printEvalMethod(op.getResult(), op.getCryptoContext(),
                          {op.getCiphertext()}, "EvalNegate");
@@ -799,25 +1103,15 @@ LogicalResult OpenFhePkeEmitter::printOperation(arith::IndexCastOp op) {
 }
 
 LogicalResult OpenFhePkeEmitter::printOperation(tensor::EmptyOp op) {
-  // std::vector<std::vector<CiphertextT>> result(dim0,
-  // std::vector<CiphertextT>(dim1)); initStr = (dim1) initStr = (dim0,
-  // std::vector<CiphertextT>{initStr})
+  // Tensors are flattened into a single vector, which tensor ops index in
+  // row-major order.
+  // std::vector<CiphertextT> result(dim0 * dim1);
   RankedTensorType resultTy = op.getResult().getType();
-  auto elementTy = convertType(resultTy.getElementType(), op.getLoc());
-  if (failed(elementTy)) {
-    return failure();
-  }
   if (failed(emitType(resultTy, op->getLoc()))) {
     return failure();
   }
-  os << " " << variableNames->getNameForValue(op.getResult());
-  std::string initStr = llvm::formatv("({0})", resultTy.getShape().back());
-  for (auto dim :
-       llvm::reverse(op.getResult().getType().getShape().drop_back(1))) {
-    initStr = llvm::formatv("({0}, std::vector<{1}>{2})", dim,
-                            elementTy.value(), initStr);
-  }
-  os << initStr << ";\n";
+  os << " " << variableNames->getNameForValue(op.getResult()) << "("
+     << resultTy.getNumElements() << ");\n";
   return success();
 }
 
@@ -864,14 +1158,48 @@ LogicalResult OpenFhePkeEmitter::printOperation(tensor::ExtractSliceOp op) {
     return failure();
   }
 
-  auto flattenStart = llvm::formatv(
+  // The row starts at offset * rowSize in the flattened input.
+  int64_t rowSize = op.getSourceType().getShape()[1];
+  std::string flattenStart = llvm::formatv(
       "{0} * {1}", variableNames->getNameForValue(op.getDynamicOffset(0)),
-      op.getSourceType().getShape()[0]);
-  auto flattenEnd = llvm::formatv("{0} + {1}", flattenStart,
-                                  op.getResultType().getNumElements());
+      rowSize);
   os << "std::vector<" << elementType.value() << "> " << resultVarName
      << "(std::begin(" << inputVarName << ") + " << flattenStart
-     << ", std::end(" << inputVarName << ") + " << flattenEnd << ");\n";
+     << ", std::begin(" << inputVarName << ") + " << flattenStart << " + "
+     << rowSize << ");\n";
+  return success();
+}
+
+LogicalResult OpenFhePkeEmitter::printOperation(tensor::InsertSliceOp op) {
+  if (!llvm::all_of(op.getStaticStrides(),
+                    [](int64_t size) { return size == 1; })) {
+    return op.emitError() << "expected stride 1";
+  }
+  // Only handle the case of inserting a single row into a 2-D tensor.
+  // Offsets are expected to be [%val, 0] and sizes [1, rowSize]
+  RankedTensorType destType = op.getDestType();
+  if (destType.getRank() != 2 || op.getMixedOffsets().size() != 2 ||
+      op.getStaticOffsets()[1] != 0 || op.getStaticSizes()[0] != 1 ||
+      op.getStaticSizes()[1] != destType.getShape()[1]) {
+    return op.emitError() << "only support inserting one row into a 2D tensor";
+  }
+
+  // As for tensor.insert, copy into the destination vector and map the result
+  // value to the destination value.
+  // std::copy(std::begin(source), std::end(source),
+  //           std::begin(dest) + offset * rowSize);
+  std::string destVarName = variableNames->getNameForValue(op.getDest());
+  std::string offset =
+      ShapedType::isDynamic(op.getStaticOffsets()[0])
+          ? variableNames->getNameForValue(op.getDynamicOffset(0))
+          : std::to_string(op.getStaticOffsets()[0]);
+  os << "std::copy(std::begin("
+     << variableNames->getNameForValue(op.getSource()) << "), std::end("
+     << variableNames->getNameForValue(op.getSource()) << "), std::begin("
+     << destVarName << ") + " << offset << " * " << destType.getShape()[1]
+     << ");\n";
+
+  variableNames->mapValueNameToValue(op.getResult(), op.getDest());
   return success();
 }
 
@@ -1072,6 +1400,7 @@ LogicalResult OpenFhePkeEmitter::printOperation(GenParamsOp op) {
   int64_t plainMod = op.getPlainModAttr().getValue().getSExtValue();
   int64_t evalAddCount = op.getEvalAddCountAttr().getValue().getSExtValue();
   int64_t keySwitchCount = op.getKeySwitchCountAttr().getValue().getSExtValue();
+  int64_t numLargeDigits = op.getNumLargeDigits();
 
   os << "CCParamsT " << paramsName << ";\n";
   os << paramsName << ".SetMultiplicativeDepth(" << mulDepth << ");\n";
@@ -1091,6 +1420,9 @@ LogicalResult OpenFhePkeEmitter::printOperation(GenParamsOp op) {
   // B/FV defaults to BV, to match HEIR parameter generation we need to
   // set it to HYBRID. Other schemes defaults to HYBRID.
   os << paramsName << ".SetKeySwitchTechnique(HYBRID);\n";
+  if (numLargeDigits != 0) {
+    os << paramsName << ".SetNumLargeDigits(" << numLargeDigits << ");\n";
+  }
   // For B/FV, OpenFHE supports EXTENDED encryption technique.
   if (op.getEncryptionTechniqueExtended()) {
     os << paramsName << ".SetEncryptionTechnique(EXTENDED);\n";
@@ -1155,6 +1487,50 @@ LogicalResult OpenFhePkeEmitter::printOperation(SetupBootstrapOp op) {
   return success();
 }
 
+LogicalResult OpenFhePkeEmitter::printOperation(SaveCryptoContextOp op) {
+  auto contextName = variableNames->getNameForValue(op.getCryptoContext());
+  os << "heir_keys::SaveCryptoContext(" << contextName << ", \"";
+  os.write_escaped(op.getDirectory());
+  os << "\");\n";
+  return success();
+}
+
+LogicalResult OpenFhePkeEmitter::printOperation(LoadCryptoContextOp op) {
+  auto contextName = variableNames->getNameForValue(op.getResult());
+  os << "CryptoContextT " << contextName
+     << " = heir_keys::LoadCryptoContext(\"";
+  os.write_escaped(op.getDirectory());
+  os << "\");\n";
+  return success();
+}
+
+// The name of the constant of the key cache prelude holding the file name of
+// a key of type `keyType`.
+static std::string getKeyFileConstant(Type keyType) {
+  return isa<PublicKeyType>(keyType) ? "heir_keys::kPublicKeyFile"
+                                     : "heir_keys::kPrivateKeyFile";
+}
+
+LogicalResult OpenFhePkeEmitter::printOperation(SaveKeyOp op) {
+  auto keyName = variableNames->getNameForValue(op.getKey());
+  os << "heir_keys::SaveKey(" << keyName << ", \"";
+  os.write_escaped(op.getDirectory());
+  os << "\", " << getKeyFileConstant(op.getKey().getType()) << ");\n";
+  return success();
+}
+
+LogicalResult OpenFhePkeEmitter::printOperation(LoadKeyOp op) {
+  auto keyType = convertType(op.getKey().getType(), op.getLoc());
+  if (failed(keyType)) {
+    return emitError(op.getLoc(), "Failed to emit key type");
+  }
+  os << keyType.value() << " " << variableNames->getNameForValue(op.getKey())
+     << " = heir_keys::LoadKey<" << keyType.value() << ">(\"";
+  os.write_escaped(op.getDirectory());
+  os << "\", " << getKeyFileConstant(op.getKey().getType()) << ");\n";
+  return success();
+}
+
 LogicalResult OpenFhePkeEmitter::emitType(Type type, Location loc,
                                           bool constant) {
   auto result = convertType(type, loc, constant);
@@ -1168,8 +1544,11 @@ LogicalResult OpenFhePkeEmitter::emitType(Type type, Location loc,
 OpenFhePkeEmitter::OpenFhePkeEmitter(raw_ostream &os,
                                      SelectVariableNames *variableNames,
                                      const OpenfheImportType &importType,
-                                     const std::string &weightsFile)
+                                     const std::string &weightsFile,
+                                     bool profileOps, unsigned parallelSections)
     : importType_(importType),
+      profileOps_(profileOps),
+      parallelSections_(parallelSections),
       os(os),
       variableNames(variableNames),
       weightsFile_(weightsFile) {}
@@ -38,7 +38,9 @@ namespace openfhe {
 ::mlir::LogicalResult translateToOpenFhePke(::mlir::Operation *op,
                                             llvm::raw_ostream &os,
                                             const OpenfheImportType &importType,
-                                            const std::string &weightsFile);
+                                            const std::string &weightsFile,
+                                            bool profileOps = false,
+                                            unsigned parallelSections = 0);
 
 // A map from the SSA value name of a 1-D dense element constants to its value.
 // Note that multidimensional shapes are handled as flattened 1-D vectors.
@@ -61,13 +63,21 @@ class OpenFhePkeEmitter {
  public:
   OpenFhePkeEmitter(raw_ostream &os, SelectVariableNames *variableNames,
                     const OpenfheImportType &importType,
-                    const std::string &weightsFile);
+                    const std::string &weightsFile, bool profileOps = false,
+                    unsigned parallelSections = 0);
 
   LogicalResult translate(::mlir::Operation &operation);
 
  private:
   OpenfheImportType importType_;
 
+  /// Whether to wrap each homomorphic op in a heir_profile timer.
+  bool profileOps_;
+
+  /// If nonzero, independent homomorphic ops are emitted in OpenMP parallel
+  /// sections, using at most this many sections per parallel region.
+  unsigned parallelSections_;
+
   /// Output stream to emit to.
   raw_indented_ostream os;
 
@@ -94,6 +104,7 @@ class OpenFhePkeEmitter {
   LogicalResult printOperation(::mlir::tensor::EmptyOp op);
   LogicalResult printOperation(::mlir::tensor::ExtractOp op);
   LogicalResult printOperation(::mlir::tensor::ExtractSliceOp op);
+  LogicalResult printOperation(::mlir::tensor::InsertSliceOp op);
   LogicalResult printOperation(::mlir::tensor::InsertOp op);
   LogicalResult printOperation(::mlir::tensor::SplatOp op);
   LogicalResult printOperation(::mlir::func::FuncOp op);
@@ -115,21 +126,36 @@ class OpenFhePkeEmitter {
   LogicalResult printOperation(GenBootstrapKeyOp op);
   LogicalResult printOperation(KeySwitchOp op);
   LogicalResult printOperation(LevelReduceOp op);
+  LogicalResult printOperation(LoadCryptoContextOp op);
+  LogicalResult printOperation(LoadKeyOp op);
   LogicalResult printOperation(MakePackedPlaintextOp op);
   LogicalResult printOperation(MakeCKKSPackedPlaintextOp op);
   LogicalResult printOperation(ModReduceOp op);
   LogicalResult printOperation(MulConstOp op);
+  LogicalResult printOperation(LinearWSumOp op);
   LogicalResult printOperation(MulNoRelinOp op);
   LogicalResult printOperation(MulOp op);
   LogicalResult printOperation(MulPlainOp op);
   LogicalResult printOperation(NegateOp op);
   LogicalResult printOperation(RelinOp op);
   LogicalResult printOperation(RotOp op);
+  LogicalResult printOperation(SaveCryptoContextOp op);
+  LogicalResult printOperation(SaveKeyOp op);
   LogicalResult printOperation(SetupBootstrapOp op);
   LogicalResult printOperation(SquareOp op);
   LogicalResult printOperation(SubOp op);
   LogicalResult printOperation(SubPlainOp op);
 
+  // Serialization helpers of client interface functions
+  LogicalResult printSerializationHelpers(::mlir::func::FuncOp funcOp);
+
+  // Task-parallel emission of straight-line code
+  bool isReorderableOp(::mlir::Operation &op);
+  LogicalResult translateBlockInParallel(::mlir::Block &block);
+  LogicalResult translateSegmentInParallel(
+      ::llvm::ArrayRef<::mlir::Operation *> segment);
+  LogicalResult emitParallelSections(::llvm::ArrayRef<::mlir::Operation *> ops);
+
   // Helpers for above
   LogicalResult printEvalMethod(::mlir::Value result,
                                 ::mlir::Value cryptoContext,
@@ -144,6 +170,16 @@ class OpenFhePkeEmitter {
   bool isDebugPort(::llvm::StringRef debugPortName);
   ::llvm::StringRef canonicalizeDebugPort(::llvm::StringRef debugPortName);
 
+  // Per-op profiling hooks. Returns true if the op is timed when profiling.
+  bool isProfiledOp(::mlir::Operation &op);
+  std::string emitProfileStart(::mlir::Operation &op);
+  void emitProfileStop(const std::string &timerName);
+
+  std::string getProfileTimerName() {
+    static int profileTimerCount = 0;
+    return "profileTimer" + std::to_string(profileTimerCount++);
+  }
+
   std::string getDebugAttrMapName() {
     static int debugAttrMapCount = 0;
     return "debugAttrMap" + std::to_string(debugAttrMapCount++);
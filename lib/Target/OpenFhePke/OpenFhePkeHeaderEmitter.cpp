@@ -1,9 +1,12 @@
 #include "lib/Target/OpenFhePke/OpenFhePkeHeaderEmitter.h"
 
+#include <optional>
+
 #include "lib/Analysis/SelectVariableNames/SelectVariableNames.h"
 #include "lib/Dialect/ModuleAttributes.h"
 #include "lib/Target/OpenFhePke/OpenFheUtils.h"
 #include "lib/Utils/TargetUtils.h"
+#include "llvm/include/llvm/ADT/STLExtras.h"           // from @llvm-project
 #include "llvm/include/llvm/ADT/TypeSwitch.h"           // from @llvm-project
 #include "llvm/include/llvm/Support/FormatVariadic.h"   // from @llvm-project
 #include "llvm/include/llvm/Support/raw_ostream.h"      // from @llvm-project
@@ -22,9 +25,10 @@ namespace heir {
 namespace openfhe {
 
 LogicalResult translateToOpenFhePkeHeader(Operation *op, llvm::raw_ostream &os,
-                                          OpenfheImportType importType) {
+                                          OpenfheImportType importType,
+                                          bool profileOps) {
   SelectVariableNames variableNames(op);
-  OpenFhePkeHeaderEmitter emitter(os, &variableNames, importType);
+  OpenFhePkeHeaderEmitter emitter(os, &variableNames, importType, profileOps);
   return emitter.translate(*op);
 }
 
@@ -57,6 +61,14 @@ LogicalResult OpenFhePkeHeaderEmitter::printOperation(ModuleOp moduleOp) {
   }
 
   os << getModulePrelude(scheme, importType_) << "\n";
+  if (profileOps_) {
+    os << getProfileDeclarations() << "\n";
+  }
+  if (llvm::any_of(moduleOp.getOps<func::FuncOp>(), [](func::FuncOp funcOp) {
+        return getSerializationHelpers(funcOp).has_value();
+      })) {
+    os << getWireDeclarations() << "\n";
+  }
   for (Operation &op : moduleOp) {
     if (failed(translate(op))) {
       return failure();
@@ -68,16 +80,20 @@ LogicalResult OpenFhePkeHeaderEmitter::printOperation(ModuleOp moduleOp) {
 LogicalResult OpenFhePkeHeaderEmitter::printOperation(func::FuncOp funcOp) {
   // If keeping this consistent alongside OpenFheEmitter gets annoying,
   // extract to a shared function in a base class.
-  if (funcOp.getNumResults() != 1) {
+  if (funcOp.getNumResults() > 1) {
     return funcOp.emitOpError() << "Only functions with a single return type "
                                    "are supported, but this function has "
                                 << funcOp.getNumResults();
     return failure();
   }
 
-  Type result = funcOp.getResultTypes()[0];
-  if (failed(emitType(result, funcOp->getLoc()))) {
-    return funcOp.emitOpError() << "Failed to emit type " << result;
+  if (funcOp.getNumResults() == 1) {
+    Type result = funcOp.getResultTypes()[0];
+    if (failed(emitType(result, funcOp->getLoc()))) {
+      return funcOp.emitOpError() << "Failed to emit type " << result;
+    }
+  } else {
+    os << "void";
   }
 
   os << " " << funcOp.getName() << "(";
@@ -94,6 +110,18 @@ LogicalResult OpenFhePkeHeaderEmitter::printOperation(func::FuncOp funcOp) {
   });
   os << ");\n";
 
+  if (std::optional<SerializationHelpers> helpers =
+          getSerializationHelpers(funcOp)) {
+    auto signatures =
+        getSerializationHelperSignatures(helpers.value(), funcOp.getLoc());
+    if (failed(signatures)) {
+      return funcOp.emitOpError()
+             << "Failed to emit type " << helpers->ciphertextType;
+    }
+    os << signatures->first << ";\n";
+    os << signatures->second << ";\n";
+  }
+
   return success();
 }
 
@@ -108,8 +136,11 @@ LogicalResult OpenFhePkeHeaderEmitter::emitType(Type type, Location loc) {
 
 OpenFhePkeHeaderEmitter::OpenFhePkeHeaderEmitter(
     raw_ostream &os, SelectVariableNames *variableNames,
-    OpenfheImportType importType)
-    : importType_(importType), os(os), variableNames(variableNames) {}
+    OpenfheImportType importType, bool profileOps)
+    : importType_(importType),
+      profileOps_(profileOps),
+      os(os),
+      variableNames(variableNames) {}
 
 }  // namespace openfhe
 }  // namespace heir
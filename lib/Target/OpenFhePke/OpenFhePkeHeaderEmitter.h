@@ -21,20 +21,25 @@ namespace openfhe {
 /// Translates the given operation to OpenFhePke.
 ::mlir::LogicalResult translateToOpenFhePkeHeader(::mlir::Operation *op,
                                                   llvm::raw_ostream &os,
-                                                  OpenfheImportType importType);
+                                                  OpenfheImportType importType,
+                                                  bool profileOps = false);
 
 /// For each function in the mlir module, emits a function header declaration
 /// along with any necessary includes.
 class OpenFhePkeHeaderEmitter {
  public:
   OpenFhePkeHeaderEmitter(raw_ostream &os, SelectVariableNames *variableNames,
-                          OpenfheImportType importType);
+                          OpenfheImportType importType,
+                          bool profileOps = false);
 
   LogicalResult translate(::mlir::Operation &operation);
 
  private:
   OpenfheImportType importType_;
 
+  /// Whether to declare the heir_profile reporting functions.
+  bool profileOps_;
+
   /// Output stream to emit to.
   raw_indented_ostream os;
 
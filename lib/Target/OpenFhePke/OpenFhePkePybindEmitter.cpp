@@ -2,13 +2,20 @@
 
 #include <string>
 
+#include "lib/Dialect/LWE/IR/LWETypes.h"
+#include "lib/Dialect/Openfhe/IR/OpenfheTypes.h"
 #include "lib/Target/OpenFhePke/OpenFhePkeTemplates.h"
+#include "lib/Target/OpenFhePke/OpenFheUtils.h"
+#include "llvm/include/llvm/ADT/STLExtras.h"            // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"          // from @llvm-project
+#include "llvm/include/llvm/ADT/StringExtras.h"         // from @llvm-project
 #include "llvm/include/llvm/ADT/TypeSwitch.h"           // from @llvm-project
 #include "llvm/include/llvm/Support/FormatVariadic.h"   // from @llvm-project
 #include "llvm/include/llvm/Support/raw_ostream.h"      // from @llvm-project
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinAttributes.h"     // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinOps.h"            // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"          // from @llvm-project
 #include "mlir/include/mlir/IR/Value.h"                 // from @llvm-project
 #include "mlir/include/mlir/IR/Visitors.h"              // from @llvm-project
 #include "mlir/include/mlir/Support/LLVM.h"             // from @llvm-project
@@ -61,7 +68,74 @@ LogicalResult OpenFhePkePybindEmitter::printOperation(ModuleOp moduleOp) {
 }
 
 LogicalResult OpenFhePkePybindEmitter::printOperation(func::FuncOp funcOp) {
+  SmallVector<std::string> argTypes;
+  for (Value arg : funcOp.getArguments()) {
+    auto argType = convertType(arg.getType(), funcOp->getLoc());
+    if (failed(argType)) {
+      return funcOp.emitOpError() << "Failed to emit type " << arg.getType();
+    }
+    argTypes.push_back(argType.value());
+  }
+  auto getArgName = [](unsigned i) { return "v" + std::to_string(i); };
+
+  // Overloads are tried in order, so NumPy arrays are matched before the
+  // element-by-element conversion to std::vector. Only tensors of numbers
+  // have a NumPy dtype; tensors of ciphertexts are passed as lists.
+  bool hasArrayArg = false;
+  std::string params, conversions, callArgs;
+  for (auto [i, arg] : llvm::enumerate(funcOp.getArguments())) {
+    std::string name = getArgName(i);
+    std::string callArg = name;
+    auto tensorType = dyn_cast<RankedTensorType>(arg.getType());
+    if (tensorType && tensorType.getRank() == 1 &&
+        isa<IntegerType, FloatType>(tensorType.getElementType())) {
+      std::string elementType =
+          convertType(tensorType.getElementType(), funcOp->getLoc()).value();
+      hasArrayArg = true;
+      params += "const py::array_t<" + elementType +
+                ", py::array::c_style | py::array::forcecast>& " + name;
+      callArg = name + "Vector";
+      conversions += "  " + argTypes[i] + " " + callArg +
+                     " = heir_vector_from_array(" + name + ");\n";
+    } else {
+      params += argTypes[i] + " " + name;
+    }
+    if (i + 1 < funcOp.getNumArguments()) {
+      params += ", ";
+    }
+    callArgs += (i == 0 ? "" : ", ") + callArg;
+  }
+  if (hasArrayArg) {
+    os << llvm::formatv(kPybindArrayFunctionTemplate.data(), funcOp.getName(),
+                        params, conversions, callArgs);
+  }
+
   os << llvm::formatv(kPybindFunctionTemplate.data(), funcOp.getName()) << "\n";
+
+  // Functions of a crypto context and ciphertexts get a batch variant, which
+  // takes a list for each ciphertext argument.
+  bool takesContext = funcOp.getNumArguments() > 0 &&
+                      isa<CryptoContextType>(funcOp.getArgumentTypes()[0]);
+  if (!takesContext ||
+      llvm::none_of(funcOp.getArgumentTypes(),
+                    llvm::IsaPred<lwe::NewLWECiphertextType>)) {
+    return success();
+  }
+  SmallVector<std::string> batchParams, sizes, batchCallArgs;
+  for (auto [i, argType] : llvm::enumerate(funcOp.getArgumentTypes())) {
+    std::string name = getArgName(i);
+    if (isa<lwe::NewLWECiphertextType>(argType)) {
+      batchParams.push_back("const std::vector<" + argTypes[i] + ">& " + name);
+      sizes.push_back(name + ".size()");
+      batchCallArgs.push_back(name + "[i]");
+    } else {
+      batchParams.push_back(argTypes[i] + " " + name);
+      batchCallArgs.push_back(name);
+    }
+  }
+  os << llvm::formatv(kPybindBatchFunctionTemplate.data(), funcOp.getName(),
+                      llvm::join(batchParams, ", "), llvm::join(sizes, ", "),
+                      llvm::join(batchCallArgs, ", "));
   return success();
 }
 
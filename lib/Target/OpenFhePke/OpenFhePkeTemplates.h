@@ -64,10 +64,535 @@ Weights GetWeightModule(const std::string& filename) {
 )cpp";
 // clang-format on
 
+// Declarations for the per-op profiler emitted with --openfhe-profile-ops,
+// shared by the generated header and source files.
+// clang-format off
+constexpr std::string_view kProfileDeclarations = R"cpp(
+#include <ostream>
+
+namespace heir_profile {
+// Print a tab-separated table of per-op latencies, aggregated by function,
+// op, source location, level and ring dimension.
+void PrintTable(std::ostream& os);
+// Write the recorded op latencies in the folded-stack format consumed by
+// flamegraph.pl and speedscope, with durations in nanoseconds.
+void WriteFoldedStacks(std::ostream& os);
+// Discard all recorded events.
+void Reset();
+}  // namespace heir_profile
+)cpp";
+// clang-format on
+
+// clang-format off
+constexpr std::string_view kProfilePreludeTemplate = R"cpp(
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace heir_profile {
+
+struct Timer {
+  const char* func;
+  const char* op;
+  const char* loc;
+  uint32_t level;
+  uint32_t ringDim;
+  std::chrono::steady_clock::time_point start;
+};
+
+struct Event {
+  const char* func;
+  const char* op;
+  const char* loc;
+  uint32_t level;
+  uint32_t ringDim;
+  int64_t nanos;
+};
+
+inline std::mutex& EventsMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+inline std::vector<Event>& Events() {
+  static std::vector<Event> events;
+  return events;
+}
+
+inline Timer Start(const char* func, const char* op, const char* loc,
+                   uint32_t level, uint32_t ringDim) {
+  return Timer{func, op, loc, level, ringDim, std::chrono::steady_clock::now()};
+}
+
+inline void Stop(const Timer& timer) {
+  auto end = std::chrono::steady_clock::now();
+  int64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      end - timer.start).count();
+  std::lock_guard<std::mutex> lock(EventsMutex());
+  Events().push_back(Event{timer.func, timer.op, timer.loc, timer.level,
+                           timer.ringDim, nanos});
+}
+
+struct Stats {
+  int64_t count = 0;
+  int64_t totalNanos = 0;
+  int64_t maxNanos = 0;
+};
+
+using StatsKey = std::tuple<std::string, std::string, std::string, uint32_t,
+                            uint32_t>;
+
+inline std::vector<std::pair<StatsKey, Stats>> AggregateEvents() {
+  std::map<StatsKey, Stats> stats;
+  {
+    std::lock_guard<std::mutex> lock(EventsMutex());
+    for (const Event& event : Events()) {
+      Stats& entry = stats[StatsKey{event.func, event.op, event.loc,
+                                    event.level, event.ringDim}];
+      entry.count += 1;
+      entry.totalNanos += event.nanos;
+      entry.maxNanos = std::max(entry.maxNanos, event.nanos);
+    }
+  }
+  std::vector<std::pair<StatsKey, Stats>> sorted(stats.begin(), stats.end());
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.second.totalNanos > b.second.totalNanos;
+                   });
+  return sorted;
+}
+
+void PrintTable(std::ostream& os) {
+  os << "function\top\tlocation\tlevel\tring_dim\tcount\ttotal_us\tmean_us"
+        "\tmax_us\n";
+  for (const auto& [key, entry] : AggregateEvents()) {
+    os << std::get<0>(key) << "\t" << std::get<1>(key) << "\t"
+       << std::get<2>(key) << "\t" << std::get<3>(key) << "\t"
+       << std::get<4>(key) << "\t" << entry.count << "\t"
+       << entry.totalNanos / 1000.0 << "\t"
+       << entry.totalNanos / 1000.0 / entry.count << "\t"
+       << entry.maxNanos / 1000.0 << "\n";
+  }
+}
+
+void WriteFoldedStacks(std::ostream& os) {
+  for (const auto& [key, entry] : AggregateEvents()) {
+    os << std::get<0>(key) << ";" << std::get<1>(key) << "[L"
+       << std::get<3>(key) << ",N" << std::get<4>(key) << "];"
+       << std::get<2>(key) << " " << entry.totalNanos << "\n";
+  }
+}
+
+void Reset() {
+  std::lock_guard<std::mutex> lock(EventsMutex());
+  Events().clear();
+}
+
+// Dump the profile at exit when HEIR_PROFILE_TABLE or HEIR_PROFILE_FOLDED
+// name an output file, so existing binaries can be profiled without changes.
+struct ExitDumper {
+  ExitDumper() {
+    // Construct the function-local statics first so they outlive this object.
+    EventsMutex();
+    Events();
+  }
+  ~ExitDumper() {
+    if (const char* path = std::getenv("HEIR_PROFILE_TABLE")) {
+      std::ofstream file(path);
+      PrintTable(file);
+    }
+    if (const char* path = std::getenv("HEIR_PROFILE_FOLDED")) {
+      std::ofstream file(path);
+      WriteFoldedStacks(file);
+    }
+  }
+};
+static ExitDumper exitDumper;
+
+}  // namespace heir_profile
+)cpp";
+// clang-format on
+
+// Helpers to save and load a crypto context with its evaluation keys, used by
+// openfhe.save_crypto_context and openfhe.load_crypto_context, and the key
+// pair, used by openfhe.save_key and openfhe.load_key. The
+// serialization headers of OpenFHE are included separately, as their paths
+// depend on the scheme and the import type.
+// clang-format off
+constexpr std::string_view kKeyCachePrelude = R"cpp(
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace heir_keys {
+
+constexpr const char* kCryptoContextFile = "/cryptocontext.bin";
+constexpr const char* kEvalMultKeyFile = "/key_eval_mult.bin";
+constexpr const char* kEvalAutomorphismKeyFile = "/key_eval_automorphism.bin";
+constexpr const char* kPublicKeyFile = "/key_public.bin";
+constexpr const char* kPrivateKeyFile = "/key_private.bin";
+constexpr size_t kStreamBufferSize = 1 << 22;
+
+// A file stream with a large buffer, as the keys are read and written
+// sequentially.
+template <typename Stream>
+struct BufferedFile {
+  std::unique_ptr<char[]> buffer{new char[kStreamBufferSize]};
+  Stream stream;
+
+  BufferedFile(const std::string& path, std::ios::openmode mode) {
+    stream.rdbuf()->pubsetbuf(buffer.get(), kStreamBufferSize);
+    stream.open(path, mode | std::ios::binary);
+    if (!stream.is_open()) {
+      throw std::runtime_error("Unable to open " + path);
+    }
+  }
+};
+
+inline void Check(bool ok, const std::string& path) {
+  if (!ok) {
+    throw std::runtime_error("Unable to serialize or deserialize " + path);
+  }
+}
+
+inline void SaveCryptoContext(const CryptoContextT& cc,
+                              const std::string& dir) {
+  {
+    BufferedFile<std::ofstream> file(dir + kCryptoContextFile, std::ios::out);
+    Serial::Serialize(cc, file.stream, SerType::BINARY);
+    Check(file.stream.good(), dir + kCryptoContextFile);
+  }
+  {
+    BufferedFile<std::ofstream> file(dir + kEvalMultKeyFile, std::ios::out);
+    Check(cc->SerializeEvalMultKey(file.stream, SerType::BINARY),
+          dir + kEvalMultKeyFile);
+  }
+  {
+    BufferedFile<std::ofstream> file(dir + kEvalAutomorphismKeyFile,
+                                     std::ios::out);
+    Check(cc->SerializeEvalAutomorphismKey(file.stream, SerType::BINARY),
+          dir + kEvalAutomorphismKeyFile);
+  }
+}
+
+inline CryptoContextT LoadCryptoContext(const std::string& dir) {
+  CryptoContextT cc;
+  {
+    BufferedFile<std::ifstream> file(dir + kCryptoContextFile, std::ios::in);
+    Serial::Deserialize(cc, file.stream, SerType::BINARY);
+    Check(cc != nullptr, dir + kCryptoContextFile);
+  }
+  {
+    BufferedFile<std::ifstream> file(dir + kEvalMultKeyFile, std::ios::in);
+    Check(cc->DeserializeEvalMultKey(file.stream, SerType::BINARY),
+          dir + kEvalMultKeyFile);
+  }
+  {
+    BufferedFile<std::ifstream> file(dir + kEvalAutomorphismKeyFile,
+                                     std::ios::in);
+    Check(cc->DeserializeEvalAutomorphismKey(file.stream, SerType::BINARY),
+          dir + kEvalAutomorphismKeyFile);
+  }
+  return cc;
+}
+
+template <typename KeyT>
+inline void SaveKey(const KeyT& key, const std::string& dir,
+                    const char* fileName) {
+  BufferedFile<std::ofstream> file(dir + fileName, std::ios::out);
+  Serial::Serialize(key, file.stream, SerType::BINARY);
+  Check(file.stream.good(), dir + fileName);
+}
+
+// The crypto context of the key must be loaded first, e.g., by
+// LoadCryptoContext.
+template <typename KeyT>
+inline KeyT LoadKey(const std::string& dir, const char* fileName) {
+  KeyT key;
+  BufferedFile<std::ifstream> file(dir + fileName, std::ios::in);
+  Serial::Deserialize(key, file.stream, SerType::BINARY);
+  Check(key != nullptr, dir + fileName);
+  return key;
+}
+
+}  // namespace heir_keys
+)cpp";
+// clang-format on
+
+// Includes needed by the declarations of the helpers that serialize the
+// ciphertexts of client interface functions.
+// clang-format off
+constexpr std::string_view kWireDeclarations = R"cpp(
+#include <cstddef>
+#include <istream>
+#include <ostream>
+)cpp";
+// clang-format on
+
+// A compact wire format for ciphertexts: a small header with the metadata of
+// the ciphertext, followed by the coefficients of each RNS limb of each
+// polynomial, packed to ceil(log2 q_i) bits for the modulus q_i of the limb.
+// Limbs are written and read one at a time, so that a ciphertext is never
+// copied into a single buffer. Vectors of ciphertexts are prefixed by their
+// size. The reader checks the header and the coefficients against the crypto
+// context, and throws on a stream that does not match it.
+// clang-format off
+constexpr std::string_view kWirePrelude = R"cpp(
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace heir_wire {
+
+constexpr uint32_t kMagic = 0x52494548;  // "HEIR"
+constexpr uint32_t kVersion = 2;
+// OpenFHE key tags are hex digests, well below this size.
+constexpr uint32_t kMaxKeyTagSize = 1024;
+
+template <typename T>
+size_t Put(std::ostream& os, const T& value) {
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  return sizeof(T);
+}
+
+template <typename T>
+T Get(std::istream& is) {
+  T value;
+  is.read(reinterpret_cast<char*>(&value), sizeof(T));
+  if (!is) {
+    throw std::runtime_error("Truncated ciphertext stream");
+  }
+  return value;
+}
+
+// Writes the low `bits` bits of each value as a little-endian bit stream, and
+// returns the number of bytes written.
+inline size_t PutPacked(std::ostream& os, const std::vector<uint64_t>& values,
+                        uint32_t bits, std::vector<uint8_t>& packed) {
+  packed.assign((values.size() * bits + 7) / 8, 0);
+  size_t pos = 0;
+  for (uint64_t value : values) {
+    for (uint32_t b = 0; b < bits;) {
+      uint32_t offset = pos % 8;
+      uint32_t take = std::min(bits - b, 8 - offset);
+      uint64_t chunk = (value >> b) & ((uint64_t{1} << take) - 1);
+      packed[pos / 8] |= static_cast<uint8_t>(chunk << offset);
+      b += take;
+      pos += take;
+    }
+  }
+  os.write(reinterpret_cast<const char*>(packed.data()), packed.size());
+  return packed.size();
+}
+
+// Reads `values.size()` values written by PutPacked with the same `bits`.
+inline void GetPacked(std::istream& is, std::vector<uint64_t>& values,
+                      uint32_t bits, std::vector<uint8_t>& packed) {
+  packed.resize((values.size() * bits + 7) / 8);
+  is.read(reinterpret_cast<char*>(packed.data()), packed.size());
+  if (!is) {
+    throw std::runtime_error("Truncated ciphertext stream");
+  }
+  size_t pos = 0;
+  for (uint64_t& value : values) {
+    value = 0;
+    for (uint32_t b = 0; b < bits;) {
+      uint32_t offset = pos % 8;
+      uint32_t take = std::min(bits - b, 8 - offset);
+      uint64_t chunk = (packed[pos / 8] >> offset) & ((1u << take) - 1);
+      value |= chunk << b;
+      b += take;
+      pos += take;
+    }
+  }
+}
+
+// Writes `ct` to `os` and returns the number of bytes written. With
+// `trimLevels`, only the first RNS limb is kept, which suffices to decrypt.
+inline size_t Write(const CryptoContextT& cc, CiphertextT ct, std::ostream& os,
+                    bool trimLevels) {
+  if (trimLevels && ct->GetElements()[0].GetNumOfElements() > 1) {
+    ct = cc->Compress(ct, 1);
+  }
+  const std::vector<DCRTPoly>& elements = ct->GetElements();
+  const std::string& keyTag = ct->GetKeyTag();
+  uint32_t numLimbs = elements[0].GetNumOfElements();
+  uint32_t ringDim = elements[0].GetRingDimension();
+
+  size_t bytes = 0;
+  bytes += Put<uint32_t>(os, kMagic);
+  bytes += Put<uint32_t>(os, kVersion);
+  bytes += Put<uint32_t>(os, elements.size());
+  bytes += Put<uint32_t>(os, numLimbs);
+  bytes += Put<uint32_t>(os, ringDim);
+  bytes += Put<uint32_t>(os, elements[0].GetFormat());
+  bytes += Put<uint32_t>(os, ct->GetLevel());
+  bytes += Put<uint32_t>(os, ct->GetNoiseScaleDeg());
+  bytes += Put<double>(os, ct->GetScalingFactor());
+  bytes += Put<uint32_t>(os, ct->GetSlots());
+  bytes += Put<uint32_t>(os, ct->GetEncodingType());
+  bytes += Put<uint32_t>(os, keyTag.size());
+  os.write(keyTag.data(), keyTag.size());
+  bytes += keyTag.size();
+
+  std::vector<uint64_t> buffer(ringDim);
+  std::vector<uint8_t> packed;
+  for (const DCRTPoly& element : elements) {
+    for (uint32_t i = 0; i < numLimbs; ++i) {
+      const NativePoly& limb = element.GetElementAtIndex(i);
+      const auto& values = limb.GetValues();
+      for (uint32_t j = 0; j < ringDim; ++j) {
+        buffer[j] = values[j].ConvertToInt();
+      }
+      bytes += PutPacked(os, buffer, limb.GetModulus().GetMSB(), packed);
+    }
+  }
+  if (!os) {
+    throw std::runtime_error("Unable to write ciphertext stream");
+  }
+  return bytes;
+}
+
+inline size_t Write(const CryptoContextT& cc,
+                    const std::vector<CiphertextT>& cts, std::ostream& os,
+                    bool trimLevels) {
+  size_t bytes = Put<uint64_t>(os, cts.size());
+  for (const CiphertextT& ct : cts) {
+    bytes += Write(cc, ct, os, trimLevels);
+  }
+  return bytes;
+}
+
+inline MutableCiphertextT ReadCiphertext(const CryptoContextT& cc,
+                                         std::istream& is) {
+  if (Get<uint32_t>(is) != kMagic || Get<uint32_t>(is) != kVersion) {
+    throw std::runtime_error("Not a ciphertext stream");
+  }
+  uint32_t numElements = Get<uint32_t>(is);
+  uint32_t numLimbs = Get<uint32_t>(is);
+  uint32_t ringDim = Get<uint32_t>(is);
+  uint32_t formatValue = Get<uint32_t>(is);
+  uint32_t level = Get<uint32_t>(is);
+  uint32_t noiseScaleDeg = Get<uint32_t>(is);
+  double scalingFactor = Get<double>(is);
+  uint32_t slots = Get<uint32_t>(is);
+  auto encodingType = static_cast<PlaintextEncodings>(Get<uint32_t>(is));
+  uint32_t keyTagSize = Get<uint32_t>(is);
+  if (keyTagSize > kMaxKeyTagSize) {
+    throw std::runtime_error("Ciphertext key tag is too long");
+  }
+  std::string keyTag(keyTagSize, '\0');
+  is.read(keyTag.data(), keyTag.size());
+  if (!is) {
+    throw std::runtime_error("Truncated ciphertext stream");
+  }
+
+  // A ciphertext of degree d has d + 1 elements, and the crypto context only
+  // decrypts up to the degree of its relinearization keys.
+  auto params = cc->GetElementParams();
+  uint32_t maxLimbs = params->GetParams().size();
+  auto cryptoParams = std::dynamic_pointer_cast<CryptoParametersRLWE<DCRTPoly>>(
+      cc->GetCryptoParameters());
+  uint32_t maxElements = cryptoParams->GetMaxRelinSkDeg() + 1;
+  if (ringDim != params->GetRingDimension() || numLimbs == 0 ||
+      numLimbs > maxLimbs || numElements == 0 || numElements > maxElements ||
+      (formatValue != Format::EVALUATION &&
+       formatValue != Format::COEFFICIENT)) {
+    throw std::runtime_error("Ciphertext does not match the crypto context");
+  }
+  auto format = static_cast<Format>(formatValue);
+
+  std::vector<DCRTPoly> elements;
+  std::vector<uint64_t> buffer(ringDim);
+  std::vector<uint8_t> packed;
+  for (uint32_t e = 0; e < numElements; ++e) {
+    DCRTPoly element(params, format, true);
+    element.DropLastElements(maxLimbs - numLimbs);
+    for (uint32_t i = 0; i < numLimbs; ++i) {
+      NativePoly limb = element.GetElementAtIndex(i);
+      const NativeInteger& modulus = limb.GetModulus();
+      GetPacked(is, buffer, modulus.GetMSB(), packed);
+      NativeVector values(ringDim, modulus);
+      for (uint32_t j = 0; j < ringDim; ++j) {
+        if (NativeInteger(buffer[j]) >= modulus) {
+          throw std::runtime_error("Ciphertext coefficient exceeds modulus");
+        }
+        values[j] = NativeInteger(buffer[j]);
+      }
+      limb.SetValues(std::move(values), format);
+      element.SetElementAtIndex(i, std::move(limb));
+    }
+    elements.push_back(std::move(element));
+  }
+
+  auto ct = std::make_shared<CiphertextImpl<DCRTPoly>>(cc, keyTag, encodingType);
+  ct->SetElements(std::move(elements));
+  ct->SetLevel(level);
+  ct->SetNoiseScaleDeg(noiseScaleDeg);
+  ct->SetScalingFactor(scalingFactor);
+  ct->SetSlots(slots);
+  return ct;
+}
+
+template <typename T>
+struct Reader {
+  static T Read(const CryptoContextT& cc, std::istream& is) {
+    return ReadCiphertext(cc, is);
+  }
+};
+
+template <typename T>
+struct Reader<std::vector<T>> {
+  static std::vector<T> Read(const CryptoContextT& cc, std::istream& is) {
+    // The size is not trusted for an allocation: a truncated stream throws
+    // when the next element is read.
+    uint64_t size = Get<uint64_t>(is);
+    std::vector<T> result;
+    for (uint64_t i = 0; i < size; ++i) {
+      result.push_back(Reader<T>::Read(cc, is));
+    }
+    return result;
+  }
+};
+
+template <typename T>
+T Read(const CryptoContextT& cc, std::istream& is) {
+  return Reader<T>::Read(cc, is);
+}
+
+}  // namespace heir_wire
+)cpp";
+// clang-format on
+
 // clang-format off
 constexpr std::string_view kPybindImports = R"cpp(
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <initializer_list>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 )cpp";
 // clang-format on
 
@@ -92,6 +617,57 @@ void bind_common(py::module &m)
         .def(py::init<>())
         .def("KeyGen", &CryptoContextImpl<DCRTPoly>::KeyGen);
 }
+
+// Copies a NumPy array into the std::vector argument of a generated function
+// in one pass over its buffer.
+template <typename T>
+std::vector<T> heir_vector_from_array(
+    const py::array_t<T, py::array::c_style | py::array::forcecast> &array) {
+  if (array.ndim() != 1) {
+    throw std::invalid_argument("expected a 1D array");
+  }
+  return std::vector<T>(array.data(), array.data() + array.size());
+}
+
+// Returns the common length of the lists passed to a batch function.
+size_t heir_batch_size(std::initializer_list<size_t> sizes) {
+  size_t size = *sizes.begin();
+  for (size_t other : sizes) {
+    if (other != size) {
+      throw std::invalid_argument("batch arguments must have the same length");
+    }
+  }
+  return size;
+}
+
+// Evaluates func(0), ..., func(size - 1) concurrently, on up to one thread
+// per core, and rethrows the first exception raised by any of them.
+template <typename Func>
+auto heir_batch(size_t size, Func func) -> std::vector<decltype(func(0))> {
+  std::vector<decltype(func(0))> results(size);
+  std::atomic<size_t> next{0};
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  auto worker = [&]() {
+    for (size_t i = next++; i < size; i = next++) {
+      try {
+        results[i] = func(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error) error = std::current_exception();
+      }
+    }
+  };
+
+  size_t numThreads = std::min<size_t>(
+      size, std::max<size_t>(1, std::thread::hardware_concurrency()));
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < numThreads; ++i) threads.emplace_back(worker);
+  worker();
+  for (std::thread &thread : threads) thread.join();
+  if (error) std::rethrow_exception(error);
+  return results;
+}
 )cpp";
 // clang-format on
 
@@ -102,7 +678,34 @@ PYBIND11_MODULE({0}, m) {{
 )cpp";
 // clang-format on
 
-constexpr std::string_view kPybindFunctionTemplate = "m.def(\"{0}\", &{0});";
+// The GIL is released while a generated function runs, after its arguments
+// are converted, so that Python threads can evaluate concurrently.
+constexpr std::string_view kPybindFunctionTemplate =
+    "m.def(\"{0}\", &{0}, py::call_guard<py::gil_scoped_release>());";
+
+// An overload of a function taking tensors that accepts NumPy arrays for
+// them. {1} are the parameters, {2} the conversions of the arrays and {3} the
+// arguments of the call.
+// clang-format off
+constexpr std::string_view kPybindArrayFunctionTemplate = R"cpp(
+m.def("{0}", []({1}) {{
+{2}  py::gil_scoped_release release;
+  return {0}({3});
+});
+)cpp";
+// clang-format on
+
+// A variant of a function taking lists of ciphertexts and evaluating the
+// function on their elements concurrently. {1} are the parameters, {2} the
+// sizes of the lists and {3} the arguments of the call for element i.
+// clang-format off
+constexpr std::string_view kPybindBatchFunctionTemplate = R"cpp(
+m.def("{0}__batch", []({1}) {{
+  size_t size = heir_batch_size({{{2}});
+  return heir_batch(size, [&](size_t i) {{ return {0}({3}); });
+}, py::call_guard<py::gil_scoped_release>());
+)cpp";
+// clang-format on
 
 }  // namespace openfhe
 }  // namespace heir
@@ -46,6 +46,20 @@ struct TranslateOptions {
   llvm::cl::opt<std::string> weightsFile{
       "weights-file",
       llvm::cl::desc("Emit all dense elements attributes to this binary file")};
+  llvm::cl::opt<bool> profileOps{
+      "openfhe-profile-ops",
+      llvm::cl::desc(
+          "Wrap each homomorphic op in a timer recording the op name, level, "
+          "ring dimension and source location, and emit heir_profile "
+          "functions reporting a per-op latency table and folded stacks"),
+      llvm::cl::init(false)};
+  llvm::cl::opt<unsigned> parallelSections{
+      "openfhe-parallel-sections",
+      llvm::cl::desc(
+          "If nonzero, emit independent homomorphic ops in OpenMP parallel "
+          "sections, balancing the estimated op cost across at most this "
+          "many sections (typically the number of threads)"),
+      llvm::cl::init(0)};
 };
 static llvm::ManagedStatic<TranslateOptions> options;
 
@@ -73,7 +87,9 @@ void registerToOpenFhePkeTranslation() {
       "translate the openfhe dialect to C++ code against the OpenFHE pke API",
       [](Operation *op, llvm::raw_ostream &output) {
         return translateToOpenFhePke(op, output, options->openfheImportType,
-                                     options->weightsFile);
+                                     options->weightsFile,
+                                     options->profileOps,
+                                     options->parallelSections);
       },
       [](DialectRegistry &registry) {
         registry.insert<arith::ArithDialect, func::FuncDialect,
@@ -92,7 +108,8 @@ void registerToOpenFhePkeHeaderTranslation() {
       "--emit-openfhe-pke",
       [](Operation *op, llvm::raw_ostream &output) {
         return translateToOpenFhePkeHeader(op, output,
-                                           options->openfheImportType);
+                                           options->openfheImportType,
+                                           options->profileOps);
       },
       [](DialectRegistry &registry) {
         registry.insert<
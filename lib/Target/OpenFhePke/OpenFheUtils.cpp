@@ -1,14 +1,19 @@
 #include "lib/Target/OpenFhePke/OpenFheUtils.h"
 
+#include <optional>
 #include <string>
+#include <utility>
 
+#include "lib/Dialect/LWE/IR/LWEDialect.h"
 #include "lib/Dialect/LWE/IR/LWETypes.h"
 #include "lib/Dialect/Openfhe/IR/OpenfheTypes.h"
 #include "lib/Target/OpenFhePke/OpenFhePkeTemplates.h"
+#include "llvm/include/llvm/ADT/STLExtras.h"             // from @llvm-project
 #include "llvm/include/llvm/ADT/TypeSwitch.h"            // from @llvm-project
 #include "llvm/include/llvm/Support/FormatVariadic.h"    // from @llvm-project
 #include "llvm/include/llvm/Support/raw_ostream.h"       // from @llvm-project
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"   // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinAttributes.h"      // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinTypeInterfaces.h"  // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinTypes.h"           // from @llvm-project
 #include "mlir/include/mlir/IR/Diagnostics.h"            // from @llvm-project
@@ -39,6 +44,78 @@ std::string getModulePrelude(OpenfheScheme scheme,
 
 std::string getWeightsPrelude() { return std::string(kWeightsPreludeTemplate); }
 
+std::string getProfilePrelude() { return std::string(kProfilePreludeTemplate); }
+
+std::string getKeyCachePrelude(OpenfheScheme scheme,
+                               OpenfheImportType importType) {
+  std::string prefix = importType == OpenfheImportType::SOURCE_RELATIVE
+                           ? "src/pke/include/"
+                           : "openfhe/pke/";
+  std::string schemeDir = scheme == OpenfheScheme::CKKS
+                              ? "ckksrns"
+                              : (scheme == OpenfheScheme::BGV ? "bgvrns"
+                                                              : "bfvrns");
+  std::string includes;
+  llvm::raw_string_ostream os(includes);
+  os << "\n";
+  for (const std::string &header :
+       {std::string("ciphertext-ser.h"), std::string("cryptocontext-ser.h"),
+        std::string("key/key-ser.h"),
+        "scheme/" + schemeDir + "/" + schemeDir + "-ser.h"}) {
+    os << "#include \"" << prefix << header << "\"  // from @openfhe\n";
+  }
+  return includes + std::string(kKeyCachePrelude);
+}
+
+std::string getProfileDeclarations() {
+  return std::string(kProfileDeclarations);
+}
+
+std::string getWirePrelude() { return std::string(kWirePrelude); }
+
+std::string getWireDeclarations() { return std::string(kWireDeclarations); }
+
+std::optional<SerializationHelpers> getSerializationHelpers(
+    func::FuncOp funcOp) {
+  auto attr = funcOp->getAttrOfType<DictionaryAttr>(
+      lwe::LWEDialect::kClientSerializationAttrName);
+  if (!attr) return std::nullopt;
+  auto serializeName = attr.getAs<StringAttr>("serialize");
+  auto deserializeName = attr.getAs<StringAttr>("deserialize");
+  if (!serializeName || !deserializeName) return std::nullopt;
+
+  // Encryption functions return the ciphertext, while decryption functions
+  // take it as an argument.
+  SmallVector<Type> types(funcOp.getResultTypes());
+  llvm::append_range(types, funcOp.getArgumentTypes());
+  Type ciphertextType;
+  for (Type type : types) {
+    if (isa<lwe::NewLWECiphertextType>(getElementTypeOrSelf(type))) {
+      ciphertextType = type;
+      break;
+    }
+  }
+  if (!ciphertextType) return std::nullopt;
+
+  return SerializationHelpers{serializeName.str(), deserializeName.str(),
+                              ciphertextType,
+                              attr.contains("trim_levels")};
+}
+
+FailureOr<std::pair<std::string, std::string>>
+getSerializationHelperSignatures(const SerializationHelpers &helpers,
+                                 Location loc) {
+  auto ciphertextType = convertType(helpers.ciphertextType, loc);
+  if (failed(ciphertextType)) return failure();
+  std::string serialize = llvm::formatv(
+      "size_t {0}(CryptoContextT cc, const {1}& ciphertext, std::ostream& os)",
+      helpers.serializeName, ciphertextType.value());
+  std::string deserialize =
+      llvm::formatv("{0} {1}(CryptoContextT cc, std::istream& is)",
+                    ciphertextType.value(), helpers.deserializeName);
+  return std::make_pair(serialize, deserialize);
+}
+
 FailureOr<std::string> convertType(Type type, Location loc, bool constant) {
   // Right now we only support non-const ciphertext types that may be modified
   // in a loop body.
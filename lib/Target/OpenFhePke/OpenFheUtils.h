@@ -1,12 +1,15 @@
 #ifndef LIB_TARGET_OPENFHEPKE_OPENFHEUTILS_H_
 #define LIB_TARGET_OPENFHEPKE_OPENFHEUTILS_H_
 
+#include <optional>
 #include <string>
+#include <utility>
 
-#include "mlir/include/mlir/IR/Location.h"            // from @llvm-project
-#include "mlir/include/mlir/IR/Types.h"               // from @llvm-project
-#include "mlir/include/mlir/IR/Value.h"               // from @llvm-project
-#include "mlir/include/mlir/Support/LogicalResult.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Location.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/Types.h"                 // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                 // from @llvm-project
+#include "mlir/include/mlir/Support/LogicalResult.h"    // from @llvm-project
 
 namespace mlir {
 namespace heir {
@@ -36,6 +39,41 @@ std::string getModulePrelude(OpenfheScheme scheme,
 
 std::string getWeightsPrelude();
 
+std::string getProfilePrelude();
+
+// The serialization headers of OpenFHE for `scheme` and the helpers to save
+// and load a crypto context with its evaluation keys.
+std::string getKeyCachePrelude(OpenfheScheme scheme,
+                               OpenfheImportType importType);
+
+std::string getProfileDeclarations();
+
+std::string getWirePrelude();
+
+std::string getWireDeclarations();
+
+// The helpers that serialize and deserialize the ciphertext encrypted or
+// decrypted by a client interface function, as requested by
+// --lwe-add-client-interface=serialization=true.
+struct SerializationHelpers {
+  std::string serializeName;
+  std::string deserializeName;
+  // The result of an encryption function or the argument of a decryption
+  // function.
+  ::mlir::Type ciphertextType;
+  bool trimLevels;
+};
+
+/// Returns the serialization helpers requested for `funcOp`, if any.
+std::optional<SerializationHelpers> getSerializationHelpers(
+    ::mlir::func::FuncOp funcOp);
+
+/// Returns the signatures of the serialize and deserialize helpers, without a
+/// trailing semicolon or body.
+::mlir::FailureOr<std::pair<std::string, std::string>>
+getSerializationHelperSignatures(const SerializationHelpers &helpers,
+                                 ::mlir::Location loc);
+
 /// Convert a type to a string, using a const specifier if constant is true.
 ::mlir::FailureOr<std::string> convertType(::mlir::Type type,
                                            ::mlir::Location loc,
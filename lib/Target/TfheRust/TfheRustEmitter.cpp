@@ -16,6 +16,7 @@
 #include "lib/Dialect/TfheRust/IR/TfheRustTypes.h"
 #include "lib/Target/TfheRust/TfheRustTemplates.h"
 #include "lib/Target/TfheRust/Utils.h"
+#include "lib/Utils/Graph/CSRGraph.h"
 #include "lib/Utils/Graph/Graph.h"
 #include "lib/Utils/TargetUtils.h"
 #include "llvm/include/llvm/ADT/STLExtras.h"           // from @llvm-project
@@ -172,7 +173,8 @@ LogicalResult TfheRustEmitter::emitBlock(::mlir::Operation *op) {
   // Compute a graph of the levelled operations.
   auto [graph, nextOp] = getGraph(op);
   if (!graph.empty()) {
-    auto sortedGraph = graph.sortGraphByLevels();
+    auto sortedGraph =
+        graph::CSRGraph<Operation *>(graph).sortGraphByLevels();
     if (failed(sortedGraph)) {
       llvm_unreachable("Only possible failure is a cycle in the SSA graph!");
     }
@@ -1,5 +1,6 @@
 #include "lib/Target/TfheRustHL/TfheRustHLEmitter.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <functional>
@@ -15,8 +16,11 @@
 #include "lib/Target/TfheRust/Utils.h"
 #include "lib/Target/TfheRustHL/TfheRustHLTemplates.h"
 #include "lib/Utils/TargetUtils.h"
+#include "llvm/include/llvm/ADT/DenseMap.h"            // from @llvm-project
 #include "llvm/include/llvm/ADT/STLExtras.h"           // from @llvm-project
+#include "llvm/include/llvm/ADT/SetVector.h"           // from @llvm-project
 #include "llvm/include/llvm/ADT/TypeSwitch.h"          // from @llvm-project
+#include "llvm/include/llvm/Support/CommandLine.h"     // from @llvm-project
 #include "llvm/include/llvm/Support/FormatVariadic.h"  // from @llvm-project
 #include "llvm/include/llvm/Support/raw_ostream.h"     // from @llvm-project
 #include "mlir/include/mlir/Dialect/Affine/Analysis/AffineAnalysis.h"  // from @llvm-project
@@ -56,17 +60,50 @@ FailureOr<int> getRustIntegerType(int width) {
   return failure();
 }
 
+// Returns true for the ops on ciphertexts that are expensive enough to be
+// evaluated concurrently.
+bool isLevelledOp(Operation *op) {
+  return isa<AddOp, SubOp, MulOp, ScalarRightShiftOp, CastOp>(op);
+}
+
+// Returns true for the cheap ops that may be printed ahead of a run of
+// levelled ops, as long as they do not use its results.
+bool isHoistableOp(Operation *op) {
+  return isa<arith::ConstantOp, CreateTrivialOp, affine::AffineLoadOp,
+             memref::LoadOp, tensor::ExtractOp>(op);
+}
+
+// Returns the pattern binding the results of a rayon::join tree over `ops`,
+// as printed by TfheRustHLEmitter::printJoin.
+std::string getJoinPattern(ArrayRef<Operation *> ops,
+                           SelectVariableNames *variableNames) {
+  if (ops.size() == 1) {
+    return variableNames->getNameForValue(ops.front()->getResult(0));
+  }
+  size_t mid = ops.size() / 2;
+  return "(" + getJoinPattern(ops.take_front(mid), variableNames) + ", " +
+         getJoinPattern(ops.drop_front(mid), variableNames) + ")";
+}
+
 }  // namespace
 
 // Global Variable
 // Here the input size of the function arguments is stored
 int16_t DefaultTfheRustHLBitWidth = 32;
 
+static bool parallelHL;
+
+static llvm::cl::opt<bool, true> parallelHLFlag(
+    "tfhe-rust-hl-parallel",
+    llvm::cl::desc("Evaluate independent ops concurrently with rayon::join, "
+                   "taking the server key as a function argument"),
+    llvm::cl::location(parallelHL), llvm::cl::init(false));
+
 void registerToTfheRustHLTranslation() {
   TranslateFromMLIRRegistration reg(
       "emit-tfhe-rust-hl", "translate the tfhe-rs dialect to HL Rust code",
       [](Operation *op, llvm::raw_ostream &output) {
-        return translateToTfheRustHL(op, output);
+        return translateToTfheRustHL(op, output, parallelHL);
       },
       [](DialectRegistry &registry) {
         registry.insert<func::FuncDialect, tfhe_rust::TfheRustDialect,
@@ -75,9 +112,10 @@ void registerToTfheRustHLTranslation() {
       });
 }
 
-LogicalResult translateToTfheRustHL(Operation *op, llvm::raw_ostream &os) {
+LogicalResult translateToTfheRustHL(Operation *op, llvm::raw_ostream &os,
+                                    bool parallel) {
   SelectVariableNames variableNames(op);
-  TfheRustHLEmitter emitter(os, &variableNames);
+  TfheRustHLEmitter emitter(os, &variableNames, parallel);
   LogicalResult result = emitter.translate(*op);
   return result;
 }
@@ -119,7 +157,11 @@ LogicalResult TfheRustHLEmitter::translate(Operation &op) {
 }
 
 LogicalResult TfheRustHLEmitter::printOperation(ModuleOp moduleOp) {
-  os << kModulePrelude << "\n";
+  os << kModulePrelude;
+  if (parallel) {
+    os << kParallelModulePrelude;
+  }
+  os << "\n";
 
   // Find default type of the module and use a Type alias
   moduleOp.getOperation()->walk([&](Operation *op) {
@@ -157,7 +199,13 @@ LogicalResult TfheRustHLEmitter::printOperation(func::FuncOp funcOp) {
   os << "pub fn " << funcOp.getName() << "(\n";
   os.indent();
   for (Value arg : funcOp.getArguments()) {
-    if (!isa<tfhe_rust::ServerKeyType>(arg.getType())) {
+    if (isa<tfhe_rust::ServerKeyType>(arg.getType())) {
+      // The high-level API uses a thread-local server key, which the rayon
+      // worker threads need to be given.
+      if (parallel) {
+        os << variableNames->getNameForValue(arg) << ": &ServerKey,\n";
+      }
+    } else {
       auto argName = variableNames->getNameForValue(arg);
       os << argName << ": &";
       if (failed(emitType(arg.getType()))) {
@@ -191,16 +239,144 @@ LogicalResult TfheRustHLEmitter::printOperation(func::FuncOp funcOp) {
   os << " {\n";
   os.indent();
 
+  if (parallel) {
+    for (Value arg : funcOp.getArguments()) {
+      if (isa<tfhe_rust::ServerKeyType>(arg.getType())) {
+        auto argName = variableNames->getNameForValue(arg);
+        os << "set_server_key(" << argName << ".clone());\n";
+        os << "rayon::broadcast(|_| set_server_key(" << argName
+           << ".clone()));\n";
+      }
+    }
+  }
+
   for (Block &block : funcOp.getBlocks()) {
+    if (failed(printBlock(block))) {
+      return failure();
+    }
+  }
+
+  os.unindent();
+  os << "}\n";
+  return success();
+}
+
+LogicalResult TfheRustHLEmitter::printBlock(Block &block) {
+  if (!parallel) {
     for (Operation &op : block.getOperations()) {
       if (failed(translate(op))) {
         return failure();
       }
     }
+    return success();
+  }
+
+  // Runs of levelled ops are scheduled together. Cheap ops in between that do
+  // not use the results of the run are printed ahead of it, and any other op
+  // ends the run.
+  SmallVector<Operation *> hoisted;
+  SetVector<Operation *> run;
+  auto printRun = [&]() -> LogicalResult {
+    for (Operation *op : hoisted) {
+      if (failed(translate(*op))) {
+        return failure();
+      }
+    }
+    LogicalResult result = printParallelOps(run.getArrayRef());
+    hoisted.clear();
+    run.clear();
+    return result;
+  };
+
+  for (Operation &op : block.getOperations()) {
+    if (isLevelledOp(&op)) {
+      run.insert(&op);
+      continue;
+    }
+    bool usesRun = llvm::any_of(op.getOperands(), [&](Value operand) {
+      return run.contains(operand.getDefiningOp());
+    });
+    if (isHoistableOp(&op) && !usesRun) {
+      hoisted.push_back(&op);
+      continue;
+    }
+    if (failed(printRun()) || failed(translate(op))) {
+      return failure();
+    }
+  }
+  return printRun();
+}
+
+LogicalResult TfheRustHLEmitter::printParallelOps(ArrayRef<Operation *> ops) {
+  // Level the ops such that the ops of one level only use results of lower
+  // levels, and can thus run concurrently.
+  DenseMap<Operation *, int> opLevels;
+  SmallVector<SmallVector<Operation *>> levels;
+  for (Operation *op : ops) {
+    int level = 0;
+    for (Value operand : op->getOperands()) {
+      auto it = opLevels.find(operand.getDefiningOp());
+      if (it != opLevels.end()) {
+        level = std::max(level, it->second + 1);
+      }
+    }
+    opLevels[op] = level;
+    if (static_cast<int>(levels.size()) <= level) {
+      levels.resize(level + 1);
+    }
+    levels[level].push_back(op);
+  }
+
+  for (const auto &level : levels) {
+    if (level.size() == 1) {
+      if (failed(translate(*level.front()))) {
+        return failure();
+      }
+      continue;
+    }
+    os << "let " << getJoinPattern(level, variableNames) << " = ";
+    if (failed(printJoin(level))) {
+      return failure();
+    }
+    os << ";\n";
   }
+  return success();
+}
 
+// Prints a balanced tree of rayon::join calls evaluating `ops`, which has the
+// shape of getJoinPattern(ops).
+LogicalResult TfheRustHLEmitter::printJoin(ArrayRef<Operation *> ops) {
+  size_t mid = ops.size() / 2;
+  os << "rayon::join(\n";
+  os.indent();
+  if (failed(printJoinClosure(ops.take_front(mid)))) {
+    return failure();
+  }
+  os << ",\n";
+  if (failed(printJoinClosure(ops.drop_front(mid)))) {
+    return failure();
+  }
+  os << ",\n";
   os.unindent();
-  os << "}\n";
+  os << ")";
+  return success();
+}
+
+LogicalResult TfheRustHLEmitter::printJoinClosure(ArrayRef<Operation *> ops) {
+  if (ops.size() > 1) {
+    os << "|| ";
+    return printJoin(ops);
+  }
+
+  Operation *op = ops.front();
+  os << "|| {\n";
+  os.indent();
+  if (failed(translate(*op))) {
+    return failure();
+  }
+  os << variableNames->getNameForValue(op->getResult(0)) << "\n";
+  os.unindent();
+  os << "}";
   return success();
 }
 
@@ -249,7 +425,7 @@ LogicalResult TfheRustHLEmitter::printOperation(func::CallOp op) {
 
   os << op.getCallee() << "(";
   for (Value arg : op->getOperands()) {
-    if (!isa<tfhe_rust::ServerKeyType>(arg.getType())) {
+    if (parallel || !isa<tfhe_rust::ServerKeyType>(arg.getType())) {
       auto argName = variableNames->getNameForValue(arg);
       if (op.getOperands().back() == arg) {
         os << "&" << argName;
@@ -380,7 +556,8 @@ LogicalResult TfheRustHLEmitter::printBinaryOp(::mlir::Value result,
                                                std::string_view op) {
   emitAssignPrefix(result);
 
-  if (auto cteOp = dyn_cast<mlir::arith::ConstantOp>(rhs.getDefiningOp())) {
+  if (auto cteOp =
+          dyn_cast_or_null<mlir::arith::ConstantOp>(rhs.getDefiningOp())) {
     auto intValue =
         cast<IntegerAttr>(cteOp.getValue()).getValue().getZExtValue();
     os << checkOrigin(lhs) << variableNames->getNameForValue(lhs) << " " << op
@@ -708,8 +885,9 @@ std::string TfheRustHLEmitter::checkOrigin(Value value) {
 }
 
 TfheRustHLEmitter::TfheRustHLEmitter(raw_ostream &os,
-                                     SelectVariableNames *variableNames)
-    : os(os), variableNames(variableNames) {}
+                                     SelectVariableNames *variableNames,
+                                     bool parallel)
+    : os(os), variableNames(variableNames), parallel(parallel) {}
 }  // namespace tfhe_rust
 }  // namespace heir
 }  // namespace mlir
@@ -29,11 +29,13 @@ void registerToTfheRustHLTranslation();
 
 /// Translates the given operation to TfheRustHL.
 ::mlir::LogicalResult translateToTfheRustHL(::mlir::Operation *op,
-                                            llvm::raw_ostream &os);
+                                            llvm::raw_ostream &os,
+                                            bool parallel);
 
 class TfheRustHLEmitter {
  public:
-  TfheRustHLEmitter(raw_ostream &os, SelectVariableNames *variableNames);
+  TfheRustHLEmitter(raw_ostream &os, SelectVariableNames *variableNames,
+                    bool parallel);
 
   LogicalResult translate(::mlir::Operation &operation);
   bool containsVectorOperands(Operation *op);
@@ -46,6 +48,9 @@ class TfheRustHLEmitter {
   /// values.
   SelectVariableNames *variableNames;
 
+  /// Whether to evaluate independent ops concurrently with rayon.
+  bool parallel;
+
   // Functions for printing individual ops
   LogicalResult printOperation(::mlir::ModuleOp op);
   LogicalResult printOperation(::mlir::func::FuncOp op);
@@ -77,6 +82,10 @@ class TfheRustHLEmitter {
   LogicalResult printOperation(BitAndOp op);
 
   // Helpers for above
+  LogicalResult printBlock(::mlir::Block &block);
+  LogicalResult printParallelOps(ArrayRef<::mlir::Operation *> ops);
+  LogicalResult printJoin(ArrayRef<::mlir::Operation *> ops);
+  LogicalResult printJoinClosure(ArrayRef<::mlir::Operation *> ops);
   LogicalResult printMethod(::mlir::Value result,
                             ::mlir::ValueRange nonSksOperands,
                             std::string_view op,
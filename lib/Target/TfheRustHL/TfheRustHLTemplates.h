@@ -13,6 +13,10 @@ use tfhe::{FheUint4, FheUint8, FheUint16, FheUint32, FheUint64};
 use tfhe::prelude::*;
 )rust";
 
+constexpr std::string_view kParallelModulePrelude = R"rust(
+use tfhe::{set_server_key, ServerKey};
+)rust";
+
 }  // namespace tfhe_rust
 }  // namespace heir
 }  // namespace mlir
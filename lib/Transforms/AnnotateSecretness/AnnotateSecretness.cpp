@@ -1,11 +1,8 @@
 #include "lib/Transforms/AnnotateSecretness/AnnotateSecretness.h"
 
 #include "lib/Analysis/SecretnessAnalysis/SecretnessAnalysis.h"
-#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
-#include "mlir/include/mlir/IR/MLIRContext.h"              // from @llvm-project
-#include "mlir/include/mlir/Support/LLVM.h"                // from @llvm-project
+#include "mlir/include/mlir/IR/MLIRContext.h"  // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"    // from @llvm-project
 
 namespace mlir {
 namespace heir {
@@ -17,20 +14,20 @@ struct AnnotateSecretness : impl::AnnotateSecretnessBase<AnnotateSecretness> {
   using AnnotateSecretnessBase::AnnotateSecretnessBase;
 
   void runOnOperation() override {
-    DataFlowSolver solver;
-    solver.load<dataflow::DeadCodeAnalysis>();
-    solver.load<dataflow::SparseConstantPropagation>();
-    solver.load<SecretnessAnalysis>();
+    // Reuse the secretness analysis of a previous pass (e.g., the
+    // data-oblivious passes) if it is still cached.
+    if (getCachedAnalysis<CachedSecretnessAnalysis>()) ++numReusedAnalyses;
+    auto &secretness = getAnalysis<CachedSecretnessAnalysis>();
 
-    auto result = solver.initializeAndRun(getOperation());
-
-    if (failed(result)) {
+    if (failed(secretness.getStatus())) {
       getOperation()->emitOpError() << "Failed to run the analysis.\n";
       signalPassFailure();
       return;
     }
 
-    annotateSecretness(getOperation(), &solver, verbose);
+    annotateSecretness(getOperation(), secretness.getSolver(), verbose);
+    // Only attributes were added, so the secretness is unchanged.
+    markAnalysesPreserved<CachedSecretnessAnalysis>();
   }
 };
 
@@ -6,8 +6,6 @@
 #include "llvm/include/llvm/ADT/STLExtras.h"    // from @llvm-project
 #include "llvm/include/llvm/Support/Casting.h"  // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"    // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"      // from @llvm-project
 #include "mlir/include/mlir/Dialect/SCF/IR/SCF.h"          // from @llvm-project
@@ -33,9 +31,8 @@ struct IfToSelectConversion : OpRewritePattern<scf::IfOp> {
   using OpRewritePattern<scf::IfOp>::OpRewritePattern;
 
  public:
-  IfToSelectConversion(Operation *top, DataFlowSolver *solver,
-                       MLIRContext *context)
-      : OpRewritePattern(context), top(top), solver(solver) {}
+  IfToSelectConversion(DataFlowSolver *solver, MLIRContext *context)
+      : OpRewritePattern(context), solver(solver) {}
 
   LogicalResult matchAndRewrite(scf::IfOp ifOp,
                                 PatternRewriter &rewriter) const override {
@@ -92,14 +89,12 @@ struct IfToSelectConversion : OpRewritePattern<scf::IfOp> {
       rewriter.replaceOp(ifOp, newResults);
     }
 
-    // re-run the analysis propagate secretness across
-    // newly created Values
-    return solver->initializeAndRun(top);
+    // The SecretnessUpdateListener of the pass has already updated the
+    // secretness of the new values.
+    return success();
   }
 
  private:
-  // root operation the pass is on, should never be altered hence never null
-  Operation *top;
   DataFlowSolver *solver;
 };
 
@@ -111,25 +106,25 @@ struct ConvertIfToSelect : impl::ConvertIfToSelectBase<ConvertIfToSelect> {
 
     RewritePatternSet patterns(context);
 
-    DataFlowSolver solver;
-    solver.load<dataflow::DeadCodeAnalysis>();
-    solver.load<dataflow::SparseConstantPropagation>();
-    solver.load<SecretnessAnalysis>();
+    auto &secretness = getAnalysis<CachedSecretnessAnalysis>();
+    DataFlowSolver *solver = secretness.getSolver();
 
-    auto result = solver.initializeAndRun(getOperation());
-
-    if (failed(result)) {
+    if (failed(secretness.getStatus())) {
       getOperation()->emitOpError() << "Failed to run the analysis.\n";
       signalPassFailure();
       return;
     }
 
-    patterns.add<IfToSelectConversion>(getOperation(), &solver, context);
+    patterns.add<IfToSelectConversion>(solver, context);
+    SecretnessUpdateListener listener(solver);
+    GreedyRewriteConfig config;
+    config.listener = &listener;
     // TODO (#1221): Investigate whether folding (default: on) can be skipped
     // here.
-    (void)applyPatternsGreedily(getOperation(), std::move(patterns));
+    (void)applyPatternsGreedily(getOperation(), std::move(patterns), config);
+    markAnalysesPreserved<CachedSecretnessAnalysis>();
 
-    LLVM_DEBUG({ annotateSecretness(getOperation(), &solver, true); });
+    LLVM_DEBUG({ annotateSecretness(getOperation(), solver, true); });
   }
 };
 
@@ -0,0 +1,311 @@
+#include "lib/Transforms/ConvertSecretForToMaskedTensor/ConvertSecretForToMaskedTensor.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include "lib/Analysis/SecretnessAnalysis/SecretnessAnalysis.h"
+#include "llvm/include/llvm/ADT/STLExtras.h"               // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"             // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"      // from @llvm-project
+#include "mlir/include/mlir/Dialect/SCF/IR/SCF.h"          // from @llvm-project
+#include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"    // from @llvm-project
+#include "mlir/include/mlir/Dialect/Utils/StaticValueUtils.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinAttributes.h"     // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"          // from @llvm-project
+#include "mlir/include/mlir/IR/IRMapping.h"             // from @llvm-project
+#include "mlir/include/mlir/IR/ImplicitLocOpBuilder.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/MLIRContext.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/OpDefinition.h"          // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"             // from @llvm-project
+#include "mlir/include/mlir/IR/OperationSupport.h"      // from @llvm-project
+#include "mlir/include/mlir/IR/PatternMatch.h"          // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                 // from @llvm-project
+#include "mlir/include/mlir/Interfaces/SideEffectInterfaces.h"  // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"           // from @llvm-project
+#include "mlir/include/mlir/Support/LogicalResult.h"  // from @llvm-project
+#include "mlir/include/mlir/Transforms/GreedyPatternRewriteDriver.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+
+#define GEN_PASS_DEF_CONVERTSECRETFORTOMASKEDTENSOR
+#include "lib/Transforms/ConvertSecretForToMaskedTensor/ConvertSecretForToMaskedTensor.h.inc"
+
+namespace {
+
+// Returns the static value of a loop bound: the `attrName` attribute of the
+// loop if the bound is secret, or the constant bound otherwise.
+std::optional<int64_t> getStaticBound(scf::ForOp forOp, Value bound,
+                                      bool isSecretBound, StringRef attrName) {
+  if (!isSecretBound) return getConstantIntValue(bound);
+  if (auto attr = forOp->getAttrOfType<IntegerAttr>(attrName))
+    return attr.getInt();
+  return std::nullopt;
+}
+
+bool isReductionCombiner(Operation *op) {
+  return isa<arith::AddIOp, arith::AddFOp, arith::MulIOp, arith::MulFOp>(op);
+}
+
+// The value leaving the other operand of `combiner` unchanged.
+TypedAttr getIdentityAttr(OpBuilder &b, Operation *combiner, Type type) {
+  if (isa<arith::AddIOp, arith::AddFOp>(combiner)) return b.getZeroAttr(type);
+  if (isa<FloatType>(type)) return b.getFloatAttr(type, 1.0);
+  return b.getIntegerAttr(type, 1);
+}
+
+}  // namespace
+
+struct SecretForToMaskedTensorConversion : OpRewritePattern<scf::ForOp> {
+  using OpRewritePattern<scf::ForOp>::OpRewritePattern;
+
+ public:
+  SecretForToMaskedTensorConversion(DataFlowSolver *solver,
+                                    MLIRContext *context,
+                                    int64_t &numReductions, int64_t &numMaps)
+      : OpRewritePattern(context),
+        solver(solver),
+        numReductions(numReductions),
+        numMaps(numMaps) {}
+
+  LogicalResult matchAndRewrite(scf::ForOp forOp,
+                                PatternRewriter &rewriter) const override {
+    bool isLowerBoundSecret = isSecret(forOp.getLowerBound(), solver);
+    bool isUpperBoundSecret = isSecret(forOp.getUpperBound(), solver);
+    if (!isLowerBoundSecret && !isUpperBoundSecret) return failure();
+
+    std::optional<int64_t> lower = getStaticBound(
+        forOp, forOp.getLowerBound(), isLowerBoundSecret, "lower");
+    std::optional<int64_t> upper = getStaticBound(
+        forOp, forOp.getUpperBound(), isUpperBoundSecret, "upper");
+    std::optional<int64_t> step = getConstantIntValue(forOp.getStep());
+    if (!lower || !upper || step != 1 || forOp.getNumRegionIterArgs() != 1)
+      return failure();
+
+    Block *body = forOp.getBody();
+    Value inductionVar = forOp.getInductionVar();
+    Value iterArg = forOp.getRegionIterArgs().front();
+    Value yielded = body->getTerminator()->getOperand(0);
+    Operation *combiner = yielded.getDefiningOp();
+    if (!combiner || combiner->getBlock() != body) return failure();
+
+    // A map inserts one element per iteration into the iteration argument,
+    // and a reduction combines it with one scalar per iteration.
+    Value combined;
+    auto insertOp = dyn_cast<tensor::InsertOp>(combiner);
+    bool isMap = insertOp && insertOp.getDest() == iterArg &&
+                 insertOp.getIndices().size() == 1 &&
+                 insertOp.getIndices().front() == inductionVar;
+    if (isMap) {
+      combined = insertOp.getScalar();
+    } else if (isReductionCombiner(combiner)) {
+      if (combiner->getOperand(0) == iterArg) {
+        combined = combiner->getOperand(1);
+      } else if (combiner->getOperand(1) == iterArg) {
+        combined = combiner->getOperand(0);
+      }
+    }
+    if (!combined || combined == iterArg ||
+        isa<ShapedType>(iterArg.getType()) != isMap)
+      return failure();
+
+    // The loop cannot access a tensor out of bounds, so its range is at most
+    // the size of the tensors it accesses.
+    int64_t rangeEnd = *upper;
+    auto clampToTensor = [&](Value tensor) {
+      auto tensorType = dyn_cast<RankedTensorType>(tensor.getType());
+      if (!tensorType || tensorType.getRank() != 1 ||
+          !tensorType.hasStaticShape())
+        return false;
+      rangeEnd = std::min(rangeEnd, tensorType.getDimSize(0));
+      return true;
+    };
+    if (isMap && !clampToTensor(iterArg)) return failure();
+
+    for (Operation &op : body->without_terminator()) {
+      if (&op == combiner) continue;
+      if (auto extractOp = dyn_cast<tensor::ExtractOp>(op)) {
+        Value tensor = extractOp.getTensor();
+        bool isInvariant = forOp.isDefinedOutsideOfLoop(tensor);
+        if (extractOp.getIndices().size() != 1 ||
+            extractOp.getIndices().front() != inductionVar ||
+            !(isInvariant || (isMap && tensor == iterArg)) ||
+            !clampToTensor(tensor))
+          return failure();
+        continue;
+      }
+      if (op.hasTrait<OpTrait::ConstantLike>()) continue;
+      if (!op.hasTrait<OpTrait::Elementwise>() || op.getNumRegions() != 0 ||
+          !isMemoryEffectFree(&op) ||
+          llvm::any_of(op.getResultTypes(), llvm::IsaPred<ShapedType>))
+        return failure();
+      if (llvm::is_contained(op.getOperands(), iterArg)) return failure();
+    }
+    if (!isMap && !iterArg.hasOneUse()) return failure();
+
+    int64_t size = rangeEnd - *lower;
+    if (*lower < 0 || size <= 0) return failure();
+
+    ImplicitLocOpBuilder b(forOp->getLoc(), rewriter);
+    auto getTensorType = [&](Type elementType) {
+      return RankedTensorType::get({size}, elementType);
+    };
+
+    // The mask is true for the iterated indices within the secret bounds.
+    SmallVector<int64_t> indices(size);
+    for (int64_t i = 0; i < size; ++i) indices[i] = *lower + i;
+    Value iota = b.create<arith::ConstantOp>(b.getIndexTensorAttr(indices));
+    Value mask;
+    if (isLowerBoundSecret) {
+      Value splat = b.create<tensor::SplatOp>(
+          forOp.getLowerBound(), getTensorType(b.getIndexType()));
+      mask = b.create<arith::CmpIOp>(arith::CmpIPredicate::sge, iota, splat);
+    }
+    if (isUpperBoundSecret) {
+      Value splat = b.create<tensor::SplatOp>(
+          forOp.getUpperBound(), getTensorType(b.getIndexType()));
+      Value upperMask =
+          b.create<arith::CmpIOp>(arith::CmpIPredicate::slt, iota, splat);
+      mask = mask ? b.create<arith::AndIOp>(mask, upperMask).getResult()
+                  : upperMask;
+    }
+
+    // Restricts a tensor to the iterated indices.
+    auto getSlice = [&](Value tensor) -> Value {
+      auto tensorType = cast<RankedTensorType>(tensor.getType());
+      if (*lower == 0 && size == tensorType.getDimSize(0)) return tensor;
+      return b.create<tensor::ExtractSliceOp>(
+          tensor, ArrayRef<OpFoldResult>{b.getIndexAttr(*lower)},
+          ArrayRef<OpFoldResult>{b.getIndexAttr(size)},
+          ArrayRef<OpFoldResult>{b.getIndexAttr(1)});
+    };
+
+    // Maps each scalar of the body to the tensor of its values over all
+    // iterations.
+    IRMapping vectorized;
+    vectorized.map(inductionVar, iota);
+    auto getVectorized = [&](Value scalar) -> Value {
+      if (Value vector = vectorized.lookupOrNull(scalar)) return vector;
+      Value splat =
+          b.create<tensor::SplatOp>(scalar, getTensorType(scalar.getType()));
+      vectorized.map(scalar, splat);
+      return splat;
+    };
+
+    IRMapping hoisted;
+    for (Operation &op : body->without_terminator()) {
+      if (&op == combiner) continue;
+      if (auto extractOp = dyn_cast<tensor::ExtractOp>(op)) {
+        // An iteration of a map reads its element before overwriting it, so
+        // the iteration argument holds the initial value there.
+        Value tensor = extractOp.getTensor() == iterArg
+                           ? forOp.getInitArgs().front()
+                           : extractOp.getTensor();
+        vectorized.map(extractOp.getResult(), getSlice(tensor));
+        continue;
+      }
+      if (op.hasTrait<OpTrait::ConstantLike>()) {
+        b.clone(op, hoisted);
+        continue;
+      }
+
+      OperationState state(op.getLoc(), op.getName());
+      for (Value operand : op.getOperands()) {
+        state.addOperands(getVectorized(hoisted.lookupOrDefault(operand)));
+      }
+      for (Type resultType : op.getResultTypes()) {
+        state.addTypes(getTensorType(resultType));
+      }
+      state.addAttributes(op.getAttrs());
+      Operation *vectorOp = b.create(state);
+      vectorized.map(op.getResults(), vectorOp->getResults());
+    }
+
+    Value values = getVectorized(hoisted.lookupOrDefault(combined));
+    Value init = forOp.getInitArgs().front();
+    if (isMap) {
+      Value selected = b.create<arith::SelectOp>(mask, values, getSlice(init));
+      Value result = selected;
+      if (selected.getType() != init.getType()) {
+        result = b.create<tensor::InsertSliceOp>(
+            selected, init, ArrayRef<OpFoldResult>{b.getIndexAttr(*lower)},
+            ArrayRef<OpFoldResult>{b.getIndexAttr(size)},
+            ArrayRef<OpFoldResult>{b.getIndexAttr(1)});
+      }
+      rewriter.replaceOp(forOp, result);
+      ++numMaps;
+      return success();
+    }
+
+    // Combine all elements of the masked tensor in a chain, which
+    // --rotate-and-reduce replaces with log(n) rotations, and then with the
+    // initial value.
+    Type elementType = combined.getType();
+    auto identity = b.create<arith::ConstantOp>(DenseElementsAttr::get(
+        getTensorType(elementType),
+        getIdentityAttr(b, combiner, elementType)));
+    Value masked = b.create<arith::SelectOp>(mask, values, identity);
+    auto combine = [&](Value lhs, Value rhs) {
+      OperationState state(combiner->getLoc(), combiner->getName());
+      state.addOperands({lhs, rhs});
+      state.addTypes(elementType);
+      state.addAttributes(combiner->getAttrs());
+      return b.create(state)->getResult(0);
+    };
+    auto extractAt = [&](int64_t i) -> Value {
+      return b.create<tensor::ExtractOp>(
+          masked, ValueRange{b.create<arith::ConstantIndexOp>(i)});
+    };
+    Value reduced = extractAt(0);
+    for (int64_t i = 1; i < size; ++i) {
+      reduced = combine(reduced, extractAt(i));
+    }
+    rewriter.replaceOp(forOp, combine(init, reduced));
+    ++numReductions;
+    return success();
+  }
+
+ private:
+  DataFlowSolver *solver;
+  int64_t &numReductions;
+  int64_t &numMaps;
+};
+
+struct ConvertSecretForToMaskedTensor
+    : impl::ConvertSecretForToMaskedTensorBase<ConvertSecretForToMaskedTensor> {
+  using ConvertSecretForToMaskedTensorBase::ConvertSecretForToMaskedTensorBase;
+
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+
+    RewritePatternSet patterns(context);
+
+    auto &secretness = getAnalysis<CachedSecretnessAnalysis>();
+    DataFlowSolver *solver = secretness.getSolver();
+
+    if (failed(secretness.getStatus())) {
+      getOperation()->emitOpError() << "Failed to run the analysis.\n";
+      signalPassFailure();
+      return;
+    }
+
+    int64_t reductions = 0;
+    int64_t maps = 0;
+    patterns.add<SecretForToMaskedTensorConversion>(solver, context,
+                                                    reductions, maps);
+    SecretnessUpdateListener listener(solver);
+    GreedyRewriteConfig config;
+    config.listener = &listener;
+    (void)applyPatternsGreedily(getOperation(), std::move(patterns), config);
+    markAnalysesPreserved<CachedSecretnessAnalysis>();
+
+    numReductions = reductions;
+    numMaps = maps;
+  }
+};
+
+}  // namespace heir
+}  // namespace mlir
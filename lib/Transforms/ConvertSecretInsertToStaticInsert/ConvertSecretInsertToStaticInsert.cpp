@@ -1,17 +1,21 @@
 #include "lib/Transforms/ConvertSecretInsertToStaticInsert/ConvertSecretInsertToStaticInsert.h"
 
+#include <cstdint>
+#include <iterator>
+#include <optional>
 #include <utility>
 
 #include "lib/Analysis/SecretnessAnalysis/SecretnessAnalysis.h"
+#include "lib/Utils/ObliviousAccess.h"
 #include "llvm/include/llvm/Support/Debug.h"  // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Affine/IR/AffineOps.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
 #include "mlir/include/mlir/Dialect/SCF/IR/SCF.h"        // from @llvm-project
 #include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Block.h"                  // from @llvm-project
 #include "mlir/include/mlir/IR/Builders.h"               // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"           // from @llvm-project
 #include "mlir/include/mlir/IR/Diagnostics.h"            // from @llvm-project
 #include "mlir/include/mlir/IR/ImplicitLocOpBuilder.h"   // from @llvm-project
 #include "mlir/include/mlir/IR/MLIRContext.h"            // from @llvm-project
@@ -35,9 +39,16 @@ struct SecretInsertToStaticInsertConversion
   using OpRewritePattern<tensor::InsertOp>::OpRewritePattern;
 
  public:
-  SecretInsertToStaticInsertConversion(Operation *top, DataFlowSolver *solver,
-                                       MLIRContext *context)
-      : OpRewritePattern(context), top(top), solver(solver) {}
+  SecretInsertToStaticInsertConversion(
+      DataFlowSolver *solver, MLIRContext *context,
+      std::optional<ObliviousAccessStrategy> strategy,
+      ObliviousAccessCostModel costModel,
+      ObliviousAccessStatistics &statistics)
+      : OpRewritePattern(context),
+        solver(solver),
+        strategy(strategy),
+        costModel(costModel),
+        statistics(statistics) {}
 
   LogicalResult matchAndRewrite(tensor::InsertOp insertOp,
                                 PatternRewriter &rewriter) const override {
@@ -71,7 +82,37 @@ struct SecretInsertToStaticInsertConversion
     if (indexSecretness.isInitialized() && !indexSecretness.getSecretness())
       return failure();
 
+    RankedTensorType tensorType = insertOp.getDest().getType();
+    int64_t numElements = tensorType.getDimSize(0);
+    bool isInsert = true;
+    ObliviousAccessStrategy chosen = chooseObliviousAccessStrategy(
+        strategy, isInsert, numElements, tensorType.getElementType(),
+        costModel);
+
+    // The new ops are inserted right before the insert, so that the
+    // statistics can be measured on them.
+    Operation *previous = insertOp->getPrevNode();
+    auto recordStatistics = [&]() {
+      Block::iterator begin = previous ? std::next(previous->getIterator())
+                                       : insertOp->getBlock()->begin();
+      statistics.record(
+          measureObliviousAccess(begin, insertOp->getIterator(), index));
+    };
+
     ImplicitLocOpBuilder builder(insertOp->getLoc(), rewriter);
+    if (chosen == ObliviousAccessStrategy::MuxTree) {
+      Value result = buildMuxTreeInsert(builder, insertedValue, tensor, index);
+      recordStatistics();
+      rewriter.replaceOp(insertOp, result);
+      return success();
+    }
+    if (chosen == ObliviousAccessStrategy::MaskReduce) {
+      Value result =
+          buildMaskReduceInsert(builder, insertedValue, tensor, index);
+      recordStatistics();
+      rewriter.replaceOp(insertOp, result);
+      return success();
+    }
 
     int size = insertOp.getDest().getType().getShape().front();
 
@@ -126,22 +167,19 @@ struct SecretInsertToStaticInsertConversion
     }
 
     // Replace the old tensor.insert op with forOp's result
+    recordStatistics();
     rewriter.replaceOp(insertOp, forOp);
 
-    return solver->initializeAndRun(top);
+    // The SecretnessUpdateListener of the pass has already updated the
+    // secretness of the new values.
+    return success();
   }
 
  private:
-  // root operation the pass is on, should never be altered hence never null
-  Operation *top;
   DataFlowSolver *solver;
-
-  static inline void setValueToSecretness(DataFlowSolver *solver, Value value,
-                                          Secretness secretness) {
-    auto *lattice = solver->getOrCreateState<SecretnessLattice>(value);
-    // solver->propagateIfChanged is bogus
-    (void)lattice->join(secretness);
-  }
+  std::optional<ObliviousAccessStrategy> strategy;
+  ObliviousAccessCostModel costModel;
+  ObliviousAccessStatistics &statistics;
 };
 
 struct ConvertSecretInsertToStaticInsert
@@ -155,26 +193,39 @@ struct ConvertSecretInsertToStaticInsert
 
     RewritePatternSet patterns(context);
 
-    DataFlowSolver solver;
-    solver.load<dataflow::DeadCodeAnalysis>();
-    solver.load<dataflow::SparseConstantPropagation>();
-    solver.load<SecretnessAnalysis>();
-
-    auto result = solver.initializeAndRun(getOperation());
+    auto &secretness = getAnalysis<CachedSecretnessAnalysis>();
+    DataFlowSolver *solver = secretness.getSolver();
 
-    if (failed(result)) {
+    if (failed(secretness.getStatus())) {
       getOperation()->emitOpError() << "Failed to run the analysis.\n";
       signalPassFailure();
       return;
     }
 
-    patterns.add<SecretInsertToStaticInsertConversion>(getOperation(), &solver,
-                                                       context);
+    std::optional<ObliviousAccessStrategy> parsedStrategy;
+    ObliviousAccessCostModel parsedCostModel;
+    if (failed(parseObliviousAccessOptions(getOperation(), strategy, costModel,
+                                           parsedStrategy, parsedCostModel))) {
+      signalPassFailure();
+      return;
+    }
+
+    ObliviousAccessStatistics statistics;
+    patterns.add<SecretInsertToStaticInsertConversion>(
+        solver, context, parsedStrategy, parsedCostModel, statistics);
+    SecretnessUpdateListener listener(solver);
+    GreedyRewriteConfig config;
+    config.listener = &listener;
     // TODO (#1221): Investigate whether folding (default: on) can be skipped
     // here.
-    (void)applyPatternsGreedily(getOperation(), std::move(patterns));
+    (void)applyPatternsGreedily(getOperation(), std::move(patterns), config);
+    markAnalysesPreserved<CachedSecretnessAnalysis>();
+
+    numSecretAccesses = statistics.numAccesses;
+    numAccessOps = statistics.numOps;
+    maxAccessDepth = statistics.maxDepth;
 
-    LLVM_DEBUG({ annotateSecretness(getOperation(), &solver, true); });
+    LLVM_DEBUG({ annotateSecretness(getOperation(), solver, true); });
   }
 };
 
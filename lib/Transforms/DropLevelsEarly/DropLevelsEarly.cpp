@@ -0,0 +1,212 @@
+#include "lib/Transforms/DropLevelsEarly/DropLevelsEarly.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "lib/Analysis/LevelAnalysis/LevelAnalysis.h"
+#include "lib/Analysis/SecretnessAnalysis/SecretnessAnalysis.h"
+#include "lib/Dialect/Mgmt/IR/MgmtOps.h"
+#include "lib/Dialect/Mgmt/Transforms/AnnotateMgmt.h"
+#include "lib/Dialect/ModuleAttributes.h"
+#include "lib/Dialect/Secret/IR/SecretOps.h"
+#include "lib/Dialect/TensorExt/IR/TensorExtOps.h"
+#include "llvm/include/llvm/ADT/STLExtras.h"    // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"  // from @llvm-project
+#include "llvm/include/llvm/Support/Debug.h"    // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"      // from @llvm-project
+#include "mlir/include/mlir/IR/Builders.h"                 // from @llvm-project
+#include "mlir/include/mlir/IR/IRMapping.h"                // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"                // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                    // from @llvm-project
+#include "mlir/include/mlir/IR/Visitors.h"                 // from @llvm-project
+#include "mlir/include/mlir/Pass/PassManager.h"            // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"                // from @llvm-project
+#include "mlir/include/mlir/Transforms/Passes.h"           // from @llvm-project
+
+#define DEBUG_TYPE "drop-levels-early"
+
+namespace mlir {
+namespace heir {
+
+#define GEN_PASS_DEF_DROPLEVELSEARLY
+#include "lib/Transforms/DropLevelsEarly/DropLevelsEarly.h.inc"
+
+namespace {
+
+// Ops whose result is at the level of their secret operands, so that a
+// modulus switch of the result can be applied to the operands instead. The
+// pass only runs on BGV, whose plaintexts are integers, and a negation is a
+// subtraction from zero.
+bool isLevelPreserving(Operation *op) {
+  return isa<arith::AddIOp, arith::SubIOp, tensor_ext::RotateOp>(op);
+}
+
+// The estimated cost of `op` on ciphertexts with `numLimbs` RNS limbs. Key
+// switching is quadratic in the number of limbs, other ops are linear.
+int64_t getOpCost(Operation *op, int64_t numLimbs) {
+  if (isa<mgmt::RelinearizeOp, tensor_ext::RotateOp>(op)) {
+    return numLimbs * numLimbs;
+  }
+  return numLimbs;
+}
+
+int64_t getLevel(Value value, DataFlowSolver *solver) {
+  const auto *lattice = solver->lookupState<LevelLattice>(value);
+  if (!lattice || !lattice->getValue().isInitialized()) return 0;
+  return lattice->getValue().getLevel();
+}
+
+// The levels computed by LevelAnalysis count the modulus switches from the
+// input, so a value at level l has maxLevel - l + 1 limbs left.
+int64_t getMaxLevel(Operation *top, DataFlowSolver *solver) {
+  int64_t maxLevel = 0;
+  top->walk([&](secret::GenericOp genericOp) {
+    genericOp.getBody()->walk([&](Operation *op) {
+      if (op->getNumResults() == 0 || !isSecret(op->getResult(0), solver)) {
+        return;
+      }
+      maxLevel = std::max(maxLevel, getLevel(op->getResult(0), solver));
+    });
+  });
+  return maxLevel;
+}
+
+int64_t estimateCost(Operation *top, DataFlowSolver *solver,
+                     int64_t maxLevel) {
+  int64_t cost = 0;
+  top->walk([&](secret::GenericOp genericOp) {
+    genericOp.getBody()->walk([&](Operation *op) {
+      if (op->getNumResults() == 0 || !isSecret(op->getResult(0), solver)) {
+        return;
+      }
+      // The result of a modulus switch has one less limb than its operand.
+      Value input = isa<mgmt::ModReduceOp>(op) ? op->getOperand(0)
+                                               : op->getResult(0);
+      cost += getOpCost(op, maxLevel - getLevel(input, solver) + 1);
+    });
+  });
+  return cost;
+}
+
+bool isModReduce(Operation *op) { return isa<mgmt::ModReduceOp>(op); }
+
+// Whether all uses of `value` other than by `op` are modulus switches, in
+// which case a modulus switch of `value` is merged with them.
+bool isOnlyModReducedOutside(Value value, Operation *op) {
+  return llvm::all_of(value.getUsers(), [&](Operation *user) {
+    return user == op || isModReduce(user);
+  });
+}
+
+}  // namespace
+
+struct DropLevelsEarly : impl::DropLevelsEarlyBase<DropLevelsEarly> {
+  using DropLevelsEarlyBase::DropLevelsEarlyBase;
+
+  // Applies the modulus switches of the result of `op` to its secret operands
+  // instead, if all the uses of its result are modulus switches and the
+  // estimated cost decreases.
+  bool moveAfterModReduce(Operation *op, DataFlowSolver *solver,
+                          int64_t maxLevel) {
+    if (!isLevelPreserving(op) || op->getNumResults() != 1) return false;
+    Value result = op->getResult(0);
+    if (result.use_empty() || !llvm::all_of(result.getUsers(), isModReduce)) {
+      return false;
+    }
+
+    SmallVector<Value> secretOperands;
+    for (Value operand : op->getOperands()) {
+      if (isSecret(operand, solver) &&
+          !llvm::is_contained(secretOperands, operand)) {
+        secretOperands.push_back(operand);
+      }
+    }
+    if (secretOperands.empty()) return false;
+
+    int64_t numLimbs = maxLevel - getLevel(result, solver) + 1;
+    if (numLimbs <= 1) return false;
+
+    // The modulus switches of the result are merged into one, and a modulus
+    // switch of an operand only adds to the cost if the operand has other
+    // uses at the current level.
+    int64_t costBefore = getOpCost(op, numLimbs) + numLimbs;
+    int64_t costAfter = getOpCost(op, numLimbs - 1);
+    for (Value operand : secretOperands) {
+      if (!isOnlyModReducedOutside(operand, op)) costAfter += numLimbs;
+    }
+    if (costAfter >= costBefore) return false;
+
+    LLVM_DEBUG(llvm::dbgs() << "Moving after modulus switch: " << *op << "\n");
+    OpBuilder b(op);
+    IRMapping mapping;
+    for (Value operand : secretOperands) {
+      mapping.map(operand, b.create<mgmt::ModReduceOp>(op->getLoc(), operand));
+    }
+    Operation *movedOp = b.clone(*op, mapping);
+    for (Operation *user : llvm::make_early_inc_range(result.getUsers())) {
+      user->replaceAllUsesWith(movedOp);
+      user->erase();
+    }
+    op->erase();
+    return true;
+  }
+
+  void runOnOperation() override {
+    if (!moduleIsBGV(getOperation())) return;
+
+    DataFlowSolver solver;
+    solver.load<dataflow::DeadCodeAnalysis>();
+    solver.load<dataflow::SparseConstantPropagation>();
+    solver.load<SecretnessAnalysis>();
+    solver.load<LevelAnalysis>();
+
+    auto runSolver = [&]() {
+      solver.eraseAllStates();
+      if (failed(solver.initializeAndRun(getOperation()))) {
+        getOperation()->emitOpError() << "Failed to run the analysis.\n";
+        signalPassFailure();
+        return false;
+      }
+      return true;
+    };
+    if (!runSolver()) return;
+
+    int64_t maxLevel = getMaxLevel(getOperation(), &solver);
+    costBefore = estimateCost(getOperation(), &solver, maxLevel);
+
+    // Visit the ops from the last one, so that a modulus switch moves up
+    // through a chain of ops in one sweep. The ops created by a sweep are
+    // visited by the next one, after the analysis is run on them.
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      SmallVector<Operation *> ops;
+      getOperation()->walk([&](secret::GenericOp genericOp) {
+        genericOp.getBody()->walk([&](Operation *op) { ops.push_back(op); });
+      });
+      for (Operation *op : llvm::reverse(ops)) {
+        if (moveAfterModReduce(op, &solver, maxLevel)) {
+          ++numMovedOps;
+          changed = true;
+        }
+      }
+      if (changed && !runSolver()) return;
+    }
+
+    // merge the modulus switches of the same value, and annotate the new
+    // levels for lowering
+    OpPassManager pipeline("builtin.module");
+    pipeline.addPass(createCSEPass());
+    pipeline.addPass(mgmt::createAnnotateMgmt());
+    (void)runPipeline(pipeline, getOperation());
+
+    if (!runSolver()) return;
+    costAfter = estimateCost(getOperation(), &solver, maxLevel);
+  }
+};
+
+}  // namespace heir
+}  // namespace mlir
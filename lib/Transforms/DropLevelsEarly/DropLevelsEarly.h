@@ -0,0 +1,18 @@
+#ifndef LIB_TRANSFORMS_DROPLEVELSEARLY_DROPLEVELSEARLY_H_
+#define LIB_TRANSFORMS_DROPLEVELSEARLY_DROPLEVELSEARLY_H_
+
+#include "mlir/include/mlir/Pass/Pass.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+
+#define GEN_PASS_DECL
+#include "lib/Transforms/DropLevelsEarly/DropLevelsEarly.h.inc"
+
+#define GEN_PASS_REGISTRATION
+#include "lib/Transforms/DropLevelsEarly/DropLevelsEarly.h.inc"
+
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_TRANSFORMS_DROPLEVELSEARLY_DROPLEVELSEARLY_H_
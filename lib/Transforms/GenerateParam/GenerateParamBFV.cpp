@@ -8,6 +8,7 @@
 #include "lib/Dialect/Secret/IR/SecretOps.h"
 #include "lib/Parameters/BGV/Params.h"
 #include "lib/Transforms/GenerateParam/GenerateParam.h"
+#include "lib/Transforms/GenerateParam/ParamSearch.h"
 #include "llvm/include/llvm/Support/Debug.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
@@ -118,6 +119,23 @@ struct GenerateParamBFV : impl::GenerateParamBFVBase<GenerateParamBFV> {
       llvm::dbgs() << "\n";
     });
 
+    if (minimizeRuntime) {
+      // B/FV does not modulus switch, so all operations happen on the full
+      // modulus chain.
+      auto candidates =
+          NoiseAnalysis::SchemeParamType::getConcreteSchemeParamCandidates(
+              qiSize, schemeParam.getPlaintextModulus(), slotNumber,
+              usePublicKey, encryptionTechniqueExtended,
+              countRLWEOps(getOperation(), qiSize.size() - 1));
+      for (const auto &candidate : candidates) {
+        if (isWithinNoiseBudget<NoiseAnalysis>(getOperation(), candidate)) {
+          return candidate;
+        }
+      }
+      // If no candidate fits, fall back to the default and leave the error
+      // to --validate-noise.
+    }
+
     auto concreteSchemeParam =
         NoiseAnalysis::SchemeParamType::getConcreteSchemeParam(
             qiSize, schemeParam.getPlaintextModulus(), slotNumber, usePublicKey,
@@ -182,6 +200,8 @@ struct GenerateParamBFV : impl::GenerateParamBFVBase<GenerateParamBFV> {
       return;
     }
 
+    ScopedPrimeTable scopedPrimeTable(getOperation(), primeTable);
+
     if (model == "bfv-noise-by-bound-coeff-worst-case") {
       run<NoiseAnalysis<bfv::NoiseByBoundCoeffWorstCaseModel>>();
     } else if (model == "bfv-noise-by-bound-coeff-average-case" ||
@@ -10,6 +10,7 @@
 #include "lib/Dialect/Mgmt/IR/MgmtOps.h"
 #include "lib/Dialect/Secret/IR/SecretOps.h"
 #include "lib/Transforms/GenerateParam/GenerateParam.h"
+#include "lib/Transforms/GenerateParam/ParamSearch.h"
 #include "llvm/include/llvm/Support/Debug.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
@@ -126,6 +127,21 @@ struct GenerateParamBGV : impl::GenerateParamBGVBase<GenerateParamBGV> {
       llvm::dbgs() << "\n";
     });
 
+    if (minimizeRuntime) {
+      auto candidates =
+          NoiseAnalysis::SchemeParamType::getConcreteSchemeParamCandidates(
+              qiSize, schemeParam.getPlaintextModulus(), slotNumber,
+              usePublicKey, encryptionTechniqueExtended,
+              countRLWEOps(getOperation()));
+      for (const auto &candidate : candidates) {
+        if (isWithinNoiseBudget<NoiseAnalysis>(getOperation(), candidate)) {
+          return candidate;
+        }
+      }
+      // If no candidate fits, fall back to the default and leave the error
+      // to --validate-noise.
+    }
+
     auto concreteSchemeParam =
         NoiseAnalysis::SchemeParamType::getConcreteSchemeParam(
             qiSize, schemeParam.getPlaintextModulus(), slotNumber, usePublicKey,
@@ -207,6 +223,8 @@ struct GenerateParamBGV : impl::GenerateParamBGVBase<GenerateParamBGV> {
       return;
     }
 
+    ScopedPrimeTable scopedPrimeTable(getOperation(), primeTable);
+
     if (model == "bgv-noise-by-bound-coeff-worst-case") {
       run<NoiseAnalysis<bgv::NoiseByBoundCoeffWorstCaseModel>>();
     } else if (model == "bgv-noise-by-bound-coeff-average-case" ||
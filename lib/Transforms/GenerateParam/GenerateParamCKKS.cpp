@@ -4,6 +4,7 @@
 #include "lib/Dialect/Secret/IR/SecretOps.h"
 #include "lib/Parameters/CKKS/Params.h"
 #include "lib/Transforms/GenerateParam/GenerateParam.h"
+#include "lib/Transforms/GenerateParam/ParamSearch.h"
 #include "llvm/include/llvm/Support/Debug.h"            // from @llvm-project
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
 #include "mlir/include/mlir/IR/Operation.h"             // from @llvm-project
@@ -62,8 +63,24 @@ struct GenerateParamCKKS : impl::GenerateParamCKKSBase<GenerateParamCKKS> {
     std::vector<double> logPrimes(maxLevel + 1, scalingModBits);
     logPrimes[0] = firstModBits;
 
+    ScopedPrimeTable scopedPrimeTable(getOperation(), primeTable);
     auto schemeParam = ckks::SchemeParam::getConcreteSchemeParam(
         logPrimes, scalingModBits, slotNumber, usePublicKey);
+    if (minimizeRuntime) {
+      // There is no CKKS noise model yet, so only keep candidates that have
+      // the levels of the program and whose special modulus bounds the key
+      // switching noise.
+      auto candidates = ckks::SchemeParam::getConcreteSchemeParamCandidates(
+          logPrimes, scalingModBits, slotNumber, usePublicKey,
+          countRLWEOps(getOperation()));
+      for (const auto &candidate : candidates) {
+        if (candidate.getLevel() >= maxLevel &&
+            isKeySwitchingModulusLargeEnough(candidate)) {
+          schemeParam = candidate;
+          break;
+        }
+      }
+    }
 
     LLVM_DEBUG(llvm::dbgs() << "Scheme Param:\n" << schemeParam << "\n");
 
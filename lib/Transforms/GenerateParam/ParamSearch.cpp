@@ -0,0 +1,90 @@
+#include "lib/Transforms/GenerateParam/ParamSearch.h"
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
+
+#include "lib/Dialect/Mgmt/IR/MgmtAttributes.h"
+#include "lib/Dialect/Mgmt/IR/MgmtDialect.h"
+#include "lib/Dialect/Mgmt/IR/MgmtOps.h"
+#include "lib/Dialect/Secret/IR/SecretOps.h"
+#include "lib/Dialect/TensorExt/IR/TensorExtOps.h"
+#include "lib/Parameters/RLWEParams.h"
+#include "llvm/include/llvm/ADT/TypeSwitch.h"          // from @llvm-project
+#include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Diagnostics.h"          // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"            // from @llvm-project
+#include "mlir/include/mlir/IR/Visitors.h"             // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"            // from @llvm-project
+
+namespace mlir {
+namespace heir {
+
+ScopedPrimeTable::ScopedPrimeTable(Operation *op, StringRef path)
+    : op(op), path(path.str()) {
+  if (!this->path.empty() && !loadPrimeTable(this->path)) {
+    op->emitWarning() << "Ignoring malformed prime table " << this->path;
+  }
+}
+
+ScopedPrimeTable::~ScopedPrimeTable() {
+  if (!path.empty() && !savePrimeTable(path)) {
+    op->emitWarning() << "Failed to write prime table " << path;
+  }
+}
+
+bool isKeySwitchingModulusLargeEnough(const RLWESchemeParam &param) {
+  const auto &logqi = param.getLogqi();
+  const auto &logpi = param.getLogpi();
+  if (logpi.empty()) return false;
+  double logP = std::accumulate(logpi.begin(), logpi.end(), 0.0);
+  int numQ = logqi.size();
+  int dnum = param.getDnum();
+  int digitSize = (numQ + dnum - 1) / dnum;
+  for (int start = 0; start < numQ; start += digitSize) {
+    int end = std::min(numQ, start + digitSize);
+    double logDigit =
+        std::accumulate(logqi.begin() + start, logqi.begin() + end, 0.0);
+    if (logDigit > logP) return false;
+  }
+  return true;
+}
+
+RLWEOpCounts countRLWEOps(Operation *top, std::optional<int> level) {
+  RLWEOpCounts counts;
+  top->walk([&](secret::GenericOp genericOp) {
+    genericOp.getBody()->walk([&](Operation *op) {
+      // only ops on ciphertexts are annotated
+      auto mgmtAttr = op->getAttrOfType<mgmt::MgmtAttr>(
+          mgmt::MgmtDialect::kArgMgmtAttrName);
+      if (!mgmtAttr) return;
+
+      std::optional<RLWEOpKind> kind =
+          llvm::TypeSwitch<Operation *, std::optional<RLWEOpKind>>(op)
+              .Case<mgmt::RelinearizeOp>(
+                  [](auto) { return RLWEOpKind::Relinearize; })
+              .Case<mgmt::ModReduceOp>(
+                  [](auto) { return RLWEOpKind::ModReduce; })
+              .Case<tensor_ext::RotateOp>(
+                  [](auto) { return RLWEOpKind::Rotate; })
+              .Case<arith::MulIOp, arith::MulFOp>([&](auto) {
+                // a ciphertext-ciphertext product has three polynomials
+                return mgmtAttr.getDimension() > 2 ? RLWEOpKind::Mul
+                                                   : RLWEOpKind::MulPlain;
+              })
+              .Case<arith::AddIOp, arith::SubIOp, arith::AddFOp,
+                    arith::SubFOp, arith::NegFOp>(
+                  [](auto) { return RLWEOpKind::Add; })
+              // bootstrapping is not modeled, and other ops (e.g., tensor
+              // extracts, level adjustments) are comparatively free
+              .Default([](auto) { return std::nullopt; });
+      if (kind.has_value()) {
+        counts.add(*kind, level.value_or(mgmtAttr.getLevel()));
+      }
+    });
+  });
+  return counts;
+}
+
+}  // namespace heir
+}  // namespace mlir
@@ -0,0 +1,101 @@
+#ifndef LIB_TRANSFORMS_GENERATEPARAM_PARAMSEARCH_H_
+#define LIB_TRANSFORMS_GENERATEPARAM_PARAMSEARCH_H_
+
+#include <optional>
+#include <string>
+
+#include "lib/Analysis/DimensionAnalysis/DimensionAnalysis.h"
+#include "lib/Analysis/LevelAnalysis/LevelAnalysis.h"
+#include "lib/Analysis/SecretnessAnalysis/SecretnessAnalysis.h"
+#include "lib/Dialect/Secret/IR/SecretOps.h"
+#include "lib/Parameters/RLWEParams.h"
+#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"                // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                    // from @llvm-project
+#include "mlir/include/mlir/IR/Visitors.h"                 // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"                // from @llvm-project
+
+namespace mlir {
+namespace heir {
+
+// Loads the prime table from `path` when constructed and saves it back when
+// destroyed, so that the primes generated in between are memoized across
+// compilations. Does nothing if `path` is empty.
+class ScopedPrimeTable {
+ public:
+  ScopedPrimeTable(Operation *op, StringRef path);
+  ~ScopedPrimeTable();
+
+ private:
+  Operation *op;
+  std::string path;
+};
+
+// Returns true if the special modulus P of `param` is at least as large as
+// each of the dnum digits of Q, so that HYBRID key switching divides the
+// noise of the digits away.
+bool isKeySwitchingModulusLargeEnough(const RLWESchemeParam &param);
+
+// Counts the homomorphic operations in the secret.generic ops under `top` at
+// the level given by their mgmt.mgmt attribute, or at `level` if given.
+RLWEOpCounts countRLWEOps(Operation *top,
+                          std::optional<int> level = std::nullopt);
+
+// Returns true if no secret value under `top` exceeds its noise budget under
+// `schemeParam`, as checked by --validate-noise.
+template <typename NoiseAnalysis>
+bool isWithinNoiseBudget(
+    Operation *top,
+    const typename NoiseAnalysis::SchemeParamType &schemeParam) {
+  using NoiseModel = typename NoiseAnalysis::NoiseModel;
+  using NoiseLatticeType = typename NoiseAnalysis::LatticeType;
+  using LocalParamType = typename NoiseAnalysis::LocalParamType;
+
+  DataFlowSolver solver;
+  solver.load<dataflow::DeadCodeAnalysis>();
+  solver.load<dataflow::SparseConstantPropagation>();
+  // NoiseAnalysis depends on SecretnessAnalysis
+  solver.load<SecretnessAnalysis>();
+  solver.load<NoiseAnalysis>(schemeParam);
+  if (failed(solver.initializeAndRun(top))) {
+    return false;
+  }
+
+  auto isWithinBudget = [&](Value value) {
+    if (!isSecret(value, &solver)) {
+      return true;
+    }
+    const auto *noiseLattice = solver.lookupState<NoiseLatticeType>(value);
+    if (!noiseLattice || !noiseLattice->getValue().isInitialized()) {
+      return false;
+    }
+    auto localParam =
+        LocalParamType(&schemeParam, getLevelFromMgmtAttr(value),
+                       getDimensionFromMgmtAttr(value));
+    return NoiseModel::toLogBudget(localParam, noiseLattice->getValue()) >= 0;
+  };
+
+  auto result = top->walk([&](secret::GenericOp genericOp) {
+    for (Value arg : genericOp.getBody()->getArguments()) {
+      if (!isWithinBudget(arg)) {
+        return WalkResult::interrupt();
+      }
+    }
+    return genericOp.getBody()->walk([&](Operation *op) {
+      for (Value result : op->getResults()) {
+        if (!isWithinBudget(result)) {
+          return WalkResult::interrupt();
+        }
+      }
+      return WalkResult::advance();
+    });
+  });
+  return !result.wasInterrupted();
+}
+
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_TRANSFORMS_GENERATEPARAM_PARAMSEARCH_H_
@@ -14,8 +14,6 @@
 #include "llvm/include/llvm/ADT/TypeSwitch.h"         // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"          // from @llvm-project
 #include "llvm/include/llvm/Support/raw_ostream.h"    // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"      // from @llvm-project
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"     // from @llvm-project
@@ -169,6 +167,7 @@ LogicalResult LayoutPropagation::visitOperation(Operation *op) {
             op->getLoc(), operand, AffineMapAttr::get(layout.value()));
         assignLayoutOp->setAttr(tensor_ext::TensorExtDialect::kLayoutAttrName,
                                 AffineMapAttr::get(layout.value()));
+        updateSecretness(assignLayoutOp, solver);
         Value toReplace = assignLayoutOp.getResult();
         // This may create duplicate layout assignment ops, and we expect CSE
         // to later clean them up. Otherwise we risk replacing a use of the
@@ -549,6 +548,7 @@ void LayoutPropagation::rectifyIncompatibleOperandLayouts(Operation *op) {
             ConvertLayoutOp convertOp = builder.create<ConvertLayoutOp>(
                 op->getLoc(), opOperand.get(), AffineMapAttr::get(sourceLayout),
                 AffineMapAttr::get(targetLayout));
+            updateSecretness(convertOp, solver);
 
             // Layout of the result is the same as the target layout of the
             // conversion. Mostly this is done for consistency: all ops have an
@@ -576,6 +576,7 @@ void LayoutPropagation::rectifyIncompatibleOperandLayouts(ReduceOp op) {
       ConvertLayoutOp convertOp = builder.create<ConvertLayoutOp>(
           op->getLoc(), init, AffineMapAttr::get(initLayout),
           AffineMapAttr::get(reducedInputLayout));
+      updateSecretness(convertOp, solver);
       Value toReplace = convertOp.getResult();
       builder.replaceUsesWithIf(init, toReplace, [&](OpOperand &operand) {
         return operand.getOwner() == op;
@@ -644,16 +645,13 @@ void LayoutPropagation::setResultLayoutAttr(Operation *op) {
 }
 
 void LayoutPropagation::runOnOperation() {
-  DataFlowSolver solver;
-  solver.load<dataflow::DeadCodeAnalysis>();
-  solver.load<dataflow::SparseConstantPropagation>();
-  solver.load<SecretnessAnalysis>();
-  if (failed(solver.initializeAndRun(getOperation()))) {
+  auto &secretness = getAnalysis<CachedSecretnessAnalysis>();
+  if (failed(secretness.getStatus())) {
     getOperation()->emitOpError() << "Failed to run secretness analysis.\n";
     signalPassFailure();
     return;
   }
-  this->solver = &solver;
+  this->solver = secretness.getSolver();
 
   LLVM_DEBUG(llvm::dbgs() << "Running layout propagation on operation: "
                           << getOperation()->getName() << "\n");
@@ -668,7 +666,9 @@ void LayoutPropagation::runOnOperation() {
 
   if (result.wasInterrupted()) {
     signalPassFailure();
+    return;
   }
+  markAnalysesPreserved<CachedSecretnessAnalysis>();
 };
 
 }  // namespace heir
@@ -126,7 +126,7 @@ struct SecretInsertMgmtCKKS
     }
 
     // re-run analysis as MulResultAnalysis is affected by slot_extract
-    solver.load<MulResultAnalysis>();
+    solver.load<MulResultAnalysis>(/*resetAfterModReduce=*/lazyRescale);
     solver.eraseAllStates();
     if (failed(solver.initializeAndRun(getOperation()))) {
       getOperation()->emitOpError() << "Failed to run the analysis.\n";
@@ -144,19 +144,19 @@ struct SecretInsertMgmtCKKS
     RewritePatternSet patternsMultModReduce(&getContext());
     patternsMultModReduce.add<ModReduceBefore<arith::MulIOp>>(
         &getContext(), /*isMul*/ true, includeFirstMul, getOperation(),
-        &solver);
+        &solver, lazyRescale);
     patternsMultModReduce.add<ModReduceBefore<arith::MulFOp>>(
         &getContext(), /*isMul*/ true, includeFirstMul, getOperation(),
-        &solver);
+        &solver, lazyRescale);
     // tensor::ExtractOp = mulConst + rotate
     patternsMultModReduce.add<ModReduceBefore<tensor::ExtractOp>>(
         &getContext(), /*isMul*/ true, includeFirstMul, getOperation(),
-        &solver);
+        &solver, lazyRescale);
     // isMul = true and includeFirstMul = false here
     // as before yield we want mulResult to be mod reduced
     patternsMultModReduce.add<ModReduceBefore<secret::YieldOp>>(
         &getContext(), /*isMul*/ true, /*includeFirstMul*/ false,
-        getOperation(), &solver);
+        getOperation(), &solver, lazyRescale);
     (void)walkAndApplyPatterns(getOperation(),
                                std::move(patternsMultModReduce));
 
@@ -199,6 +199,8 @@ struct SecretInsertMgmtCKKS
     pipeline.addPass(createCSEPass());
     pipeline.addPass(mgmt::createAnnotateMgmt());
     (void)runPipeline(pipeline, getOperation());
+
+    getOperation()->walk([&](mgmt::ModReduceOp) { ++numRescales; });
   }
 };
 
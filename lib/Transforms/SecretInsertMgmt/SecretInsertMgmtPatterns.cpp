@@ -75,6 +75,7 @@ LogicalResult ModReduceBefore<Op>::matchAndRewrite(
 
   auto maxLevel = 0;
   auto isMulResult = false;
+  auto lazyLevel = 0;
   // use map in case we have same operands
   DenseMap<Value, LevelState::LevelType> operandsInsertLevel;
   for (auto operand : op.getOperands()) {
@@ -96,6 +97,11 @@ LogicalResult ModReduceBefore<Op>::matchAndRewrite(
     operandsInsertLevel[operand] = level;
     maxLevel = std::max(maxLevel, level);
     isMulResult |= isMulResultLattice.getIsMulResult();
+    // an unrescaled product needs one more level before being multiplied
+    if (lazy && isMul &&
+        (includeFirstMul || isMulResultLattice.getIsMulResult())) {
+      lazyLevel = std::max(lazyLevel, level + 1);
+    }
 
     LLVM_DEBUG(llvm::dbgs() << "  ModReduceBefore: Operand: " << operand
                             << " Level: " << level << " isMulresult "
@@ -104,7 +110,9 @@ LogicalResult ModReduceBefore<Op>::matchAndRewrite(
 
   auto resultLevel = maxLevel;
   // for other op it is only mod reduce when operand mismatch level
-  if (isMul) {
+  if (lazy) {
+    resultLevel = std::max(maxLevel, lazyLevel);
+  } else if (isMul) {
     // if includeFirstMul, we always mod reduce before
     // else, check if it is a mul result
     if (includeFirstMul || (!includeFirstMul && isMulResult)) {
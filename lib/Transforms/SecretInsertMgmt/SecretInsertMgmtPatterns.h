@@ -27,15 +27,22 @@ struct MultRelinearize : public OpRewritePattern<MulOp> {
   DataFlowSolver *solver;
 };
 
+// Mod reduces the secret operands of `op` to the same level. If `isMul`, the
+// operands are first mod reduced once more when one of them is a mul result.
+//
+// If `lazy`, the mul result state is expected to be reset by mgmt.modreduce
+// (c.f. MulResultAnalysis), and each operand of a multiplication is only
+// mod reduced once more if it is itself an unrescaled mul result.
 template <typename Op>
 struct ModReduceBefore : public OpRewritePattern<Op> {
   using OpRewritePattern<Op>::OpRewritePattern;
 
   ModReduceBefore(MLIRContext *context, bool isMul, bool includeFirstMul,
-                  Operation *top, DataFlowSolver *solver)
+                  Operation *top, DataFlowSolver *solver, bool lazy = false)
       : OpRewritePattern<Op>(context, /*benefit=*/1),
         isMul(isMul),
         includeFirstMul(includeFirstMul),
+        lazy(lazy),
         top(top),
         solver(solver) {}
 
@@ -45,6 +52,7 @@ struct ModReduceBefore : public OpRewritePattern<Op> {
  private:
   bool isMul;
   bool includeFirstMul;
+  bool lazy;
   Operation *top;
   DataFlowSolver *solver;
 };
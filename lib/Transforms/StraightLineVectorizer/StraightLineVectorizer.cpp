@@ -3,6 +3,7 @@
 #include <cassert>
 #include <cstdint>
 
+#include "lib/Utils/Graph/CSRGraph.h"
 #include "lib/Utils/Graph/Graph.h"
 #include "llvm/include/llvm/Support/Debug.h"           // from @llvm-project
 #include "mlir/include/mlir/Analysis/SliceAnalysis.h"  // from @llvm-project
@@ -64,7 +65,7 @@ bool tryVectorizeBlock(Block *block, Dialect *dialect) {
     return false;
   }
 
-  auto result = graph.sortGraphByLevels();
+  auto result = graph::CSRGraph<Operation *>(graph).sortGraphByLevels();
   assert(succeeded(result) &&
          "Only possible failure is a cycle in the SSA graph!");
   auto levels = result.value();
@@ -1,5 +1,6 @@
 #include "lib/Transforms/YosysOptimizer/YosysOptimizer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cstdio>
@@ -20,10 +21,13 @@
 #include "lib/Transforms/YosysOptimizer/BooleanGateImporter.h"
 #include "lib/Transforms/YosysOptimizer/LUTImporter.h"
 #include "lib/Transforms/YosysOptimizer/RTLILImporter.h"
+#include "llvm/include/llvm/ADT/DenseMap.h"            // from @llvm-project
 #include "llvm/include/llvm/ADT/STLExtras.h"           // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallString.h"         // from @llvm-project
 #include "llvm/include/llvm/ADT/SmallVector.h"         // from @llvm-project
 #include "llvm/include/llvm/ADT/Statistic.h"           // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"           // from @llvm-project
+#include "llvm/include/llvm/Support/FileSystem.h"      // from @llvm-project
 #include "llvm/include/llvm/Support/FormatVariadic.h"  // from @llvm-project
 #include "llvm/include/llvm/Support/raw_ostream.h"     // from @llvm-project
 #include "mlir/include/mlir/Dialect/Affine/Analysis/LoopAnalysis.h"  // from @llvm-project
@@ -53,9 +57,9 @@
 
 // Block clang-format from reordering
 // clang-format off
-#include "kernel/log.h" // from @at_clifford_yosys
-#include "kernel/rtlil.h" // from @at_clifford_yosys
-#include "kernel/yosys.h" // from @at_clifford_yosys
+#include "kernel/log.h"    // from @at_clifford_yosys
+#include "kernel/rtlil.h"  // from @at_clifford_yosys
+#include "kernel/yosys.h"  // from @at_clifford_yosys
 // clang-format on
 
 #define DEBUG_TYPE "yosys-optimizer"
@@ -71,7 +75,7 @@ using std::string;
 // $1: function name
 // $2: yosys runfiles
 // $3: abc path
-// $4: abc fast option -fast
+// $4: abc options, i.e., -fast or a -script for depth-oriented mapping
 // This template uses LUTs to optimize logic. It handles Verilog modules that
 // may call submodules, utilizing splitnets to split output ports of the
 // submodule into individual bits. Note that the splitnets command uses %n to
@@ -114,8 +118,48 @@ clean;
 stat;
 )";
 
+// ABC scripts for the depth-oriented mapping to LUTs, run after Yosys has read
+// the LUT library. The circuit is rebalanced to reduce the number of logic
+// levels before mapping, and the mfs2 resynthesis ending the default script is
+// skipped, since it targets area and does not preserve depth. Without a delay
+// target, the `if` mapper minimizes the depth and only recovers area on the
+// non-critical paths.
+// $0: if mapper options, e.g. -D for a target depth
+constexpr std::string_view kAbcDepthScript = R"(
+strash; ifraig; scorr; dc2; dretime; strash;
+balance; dc2 -l; balance;
+dch -f; if {0};
+)";
+
+// $0: if mapper options, e.g. -D for a target depth
+constexpr std::string_view kAbcDepthFastScript = R"(
+strash; dretime; balance;
+if {0};
+)";
+
 namespace {
 
+// Returns the number of comb ops on the longest path through `func`, i.e., the
+// number of gate levels that must be evaluated sequentially.
+int64_t getCircuitDepth(func::FuncOp func) {
+  DenseMap<Value, int64_t> depth;
+  int64_t circuitDepth = 0;
+  func.walk([&](Operation *op) {
+    int64_t opDepth = 0;
+    for (Value operand : op->getOperands()) {
+      opDepth = std::max(opDepth, depth.lookup(operand));
+    }
+    if (isa<comb::CombDialect>(op->getDialect())) {
+      ++opDepth;
+    }
+    for (Value result : op->getResults()) {
+      depth[result] = opDepth;
+    }
+    circuitDepth = std::max(circuitDepth, opDepth);
+  });
+  return circuitDepth;
+}
+
 int64_t countArithOps(Operation *op, ModuleOp moduleOp) {
   int64_t numArithOps = 0;
   auto isArithOp = [](Operation *op) -> bool {
@@ -142,6 +186,7 @@ struct RelativeOptimizationStatistics {
   std::string originalOp;
   int64_t numArithOps;
   int64_t numCells;
+  int64_t depth;
 };
 
 struct YosysOptimizer : public impl::YosysOptimizerBase<YosysOptimizer> {
@@ -149,20 +194,28 @@ struct YosysOptimizer : public impl::YosysOptimizerBase<YosysOptimizer> {
 
   YosysOptimizer(std::string yosysFilesPath, std::string abcPath, bool abcFast,
                  int unrollFactor, bool useSubmodules, Mode mode,
-                 bool printStats)
+                 bool printStats, LutMapping lutMapping, int maxDepth)
       : yosysFilesPath(std::move(yosysFilesPath)),
         abcPath(std::move(abcPath)),
         abcFast(abcFast),
         printStats(printStats),
         unrollFactor(unrollFactor),
         useSubmodules(useSubmodules),
-        mode(mode) {}
+        mode(mode),
+        lutMapping(lutMapping),
+        maxDepth(maxDepth) {}
 
   void runOnOperation() override;
 
   LogicalResult runOnGenericOp(secret::GenericOp op);
 
  private:
+  // Returns the options passed to abc when mapping to LUTs. For the
+  // depth-oriented mapping, the abc script is written to a new temporary file
+  // whose path is stored in `scriptPath`.
+  FailureOr<std::string> getAbcLutOptions(
+      llvm::SmallVectorImpl<char> &scriptPath);
+
   // Path to a directory containing yosys techlibs.
   std::string yosysFilesPath;
   // Path to ABC binary.
@@ -173,6 +226,8 @@ struct YosysOptimizer : public impl::YosysOptimizerBase<YosysOptimizer> {
   int unrollFactor;
   bool useSubmodules;
   Mode mode;
+  LutMapping lutMapping;
+  int maxDepth;
   llvm::SmallVector<RelativeOptimizationStatistics> optStatistics;
 };
 
@@ -402,6 +457,32 @@ LogicalResult unrollAndMergeGenerics(Operation *op, int unrollFactor,
   return walkResult.wasInterrupted() ? failure() : success();
 }
 
+FailureOr<std::string> YosysOptimizer::getAbcLutOptions(
+    llvm::SmallVectorImpl<char> &scriptPath) {
+  if (lutMapping == LutMapping::Area) {
+    return std::string(abcFast ? "-fast" : "");
+  }
+
+  std::string ifOptions =
+      maxDepth > 0 ? llvm::formatv("-D {0}", maxDepth).str() : "";
+  int fd;
+  if (llvm::sys::fs::createTemporaryFile("heir_abc", "script", fd,
+                                         scriptPath)) {
+    return failure();
+  }
+  llvm::raw_fd_ostream of(fd, /*shouldClose=*/true);
+  of << llvm::formatv(
+      abcFast ? kAbcDepthFastScript.data() : kAbcDepthScript.data(),
+      ifOptions);
+  of.close();
+  if (of.has_error()) {
+    of.clear_error();
+    llvm::sys::fs::remove(scriptPath);
+    return failure();
+  }
+  return "-script " + std::string(scriptPath.begin(), scriptPath.end());
+}
+
 LogicalResult YosysOptimizer::runOnGenericOp(secret::GenericOp op) {
   std::string moduleName = "generic_body";
   MLIRContext *context = op->getContext();
@@ -460,18 +541,29 @@ LogicalResult YosysOptimizer::runOnGenericOp(secret::GenericOp op) {
   LLVM_DEBUG(
       llvm::dbgs() << "Using "
                    << (mode == Mode::LUT ? "LUT cells" : "boolean gates"));
-  auto yosysTemplate =
-      llvm::formatv(kYosysLutTemplate.data(), filename, moduleName,
-                    yosysFilesPath, abcPath, abcFast ? "-fast" : "")
-          .str();
+  std::string yosysTemplate;
+  llvm::SmallString<128> scriptPath;
   if (mode == Mode::Boolean) {
     yosysTemplate =
         llvm::formatv(kYosysBooleanTemplate.data(), filename, moduleName,
                       abcPath, yosysFilesPath, abcFast ? "-fast" : "")
             .str();
+  } else {
+    auto abcOptions = getAbcLutOptions(scriptPath);
+    if (failed(abcOptions)) {
+      op.emitError() << "Failed to write the abc script";
+      return failure();
+    }
+    yosysTemplate =
+        llvm::formatv(kYosysLutTemplate.data(), filename, moduleName,
+                      yosysFilesPath, abcPath, abcOptions.value())
+            .str();
   }
 
   Yosys::run_pass(yosysTemplate);
+  if (!scriptPath.empty()) {
+    llvm::sys::fs::remove(scriptPath);
+  }
 
   // Translate Yosys result back to MLIR and insert into the func
   LLVM_DEBUG(Yosys::run_pass("dump;"));
@@ -502,6 +594,13 @@ LogicalResult YosysOptimizer::runOnGenericOp(secret::GenericOp op) {
       })));
   Yosys::run_pass("delete;");
 
+  int64_t depth = getCircuitDepth(func);
+  totalCircuitDepth += depth;
+  maxCircuitDepth.updateMax(depth);
+  if (printStats) {
+    stats.depth = depth;
+  }
+
   LLVM_DEBUG(llvm::dbgs() << "Done importing RTLIL, now type-coverting ops\n");
 
   // The pass changes the yielded value types, e.g., from an i8 to a
@@ -679,7 +778,8 @@ void YosysOptimizer::runOnOperation() {
                    << stats.originalOp
                    << "\n\n  Starting arith op count: " << stats.numArithOps
                    << "\n  Ending cell count: " << stats.numCells
-                   << "\n  Ratio: " << ratio << "\n\n";
+                   << "\n  Ratio: " << ratio
+                   << "\n  Ending circuit depth: " << stats.depth << "\n\n";
     }
   }
 
@@ -690,10 +790,11 @@ void YosysOptimizer::runOnOperation() {
 
 std::unique_ptr<mlir::Pass> createYosysOptimizer(
     const std::string &yosysFilesPath, const std::string &abcPath, bool abcFast,
-    int unrollFactor, bool useSubmodules, Mode mode, bool printStats) {
+    int unrollFactor, bool useSubmodules, Mode mode, bool printStats,
+    LutMapping lutMapping, int maxDepth) {
   return std::make_unique<YosysOptimizer>(yosysFilesPath, abcPath, abcFast,
                                           unrollFactor, useSubmodules, mode,
-                                          printStats);
+                                          printStats, lutMapping, maxDepth);
 }
 
 void registerYosysOptimizerPipeline(const std::string &yosysFilesPath,
@@ -704,7 +805,8 @@ void registerYosysOptimizerPipeline(const std::string &yosysFilesPath,
                                 const YosysOptimizerPipelineOptions &options) {
         pm.addPass(createYosysOptimizer(
             yosysFilesPath, abcPath, options.abcFast, options.unrollFactor,
-            options.useSubmodules, options.mode, options.printStats));
+            options.useSubmodules, options.mode, options.printStats,
+            options.lutMapping, options.maxDepth));
         pm.addPass(mlir::createCSEPass());
       });
 }
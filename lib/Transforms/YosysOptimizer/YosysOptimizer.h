@@ -13,10 +13,20 @@ namespace heir {
 
 enum Mode { Boolean, LUT };
 
+// The objective of the ABC technology mapping to LUTs.
+enum class LutMapping {
+  // Minimize the number of LUTs.
+  Area,
+  // Minimize the circuit depth, i.e., the number of sequential LUT levels,
+  // after rebalancing the circuit.
+  Depth,
+};
+
 std::unique_ptr<mlir::Pass> createYosysOptimizer(
     const std::string &yosysFilesPath, const std::string &abcPath, bool abcFast,
     int unrollFactor = 0, bool useSubmodules = true, Mode mode = LUT,
-    bool printStats = false);
+    bool printStats = false, LutMapping lutMapping = LutMapping::Area,
+    int maxDepth = 0);
 
 #define GEN_PASS_DECL
 #include "lib/Transforms/YosysOptimizer/YosysOptimizer.h.inc"
@@ -50,6 +60,22 @@ struct YosysOptimizerPipelineOptions
       *this, "print-stats",
       llvm::cl::desc("Prints statistics about the optimized circuit"),
       llvm::cl::init(false)};
+
+  PassOptions::Option<LutMapping> lutMapping{
+      *this, "lut-mapping",
+      llvm::cl::desc("The objective of the mapping to lookup tables."),
+      llvm::cl::init(LutMapping::Area),
+      llvm::cl::values(
+          clEnumValN(LutMapping::Area, "area", "minimize the number of LUTs"),
+          clEnumValN(LutMapping::Depth, "depth",
+                     "minimize the number of sequential LUT levels"))};
+
+  PassOptions::Option<int> maxDepth{
+      *this, "max-depth",
+      llvm::cl::desc("With lut-mapping=depth, the target number of LUT levels "
+                     "under which the number of LUTs is minimized. A value of "
+                     "zero (default) targets the minimum depth."),
+      llvm::cl::init(0)};
 };
 
 // registerYosysOptimizerPipeline registers a Yosys pipeline pass using
@@ -1,6 +1,8 @@
 #include "lib/Utils/APIntUtils.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <utility>
 
 #include "llvm/include/llvm/ADT/APInt.h"     // from @llvm-project
@@ -59,5 +61,49 @@ APInt multiplicativeInverse(const APInt &x, const APInt &modulo) {
   return std::move(t[i]);
 }
 
+namespace {
+
+// Computes base^exponent mod modulo, where all three have the same bit width,
+// which is at least twice the active bits of the modulo.
+APInt powMod(APInt base, const APInt &exponent, const APInt &modulo) {
+  APInt result(modulo.getBitWidth(), 1);
+  for (unsigned i = 0, e = exponent.getActiveBits(); i < e; ++i) {
+    if (exponent[i]) result = (result * base).urem(modulo);
+    base = (base * base).urem(modulo);
+  }
+  return result;
+}
+
+}  // namespace
+
+bool isPrime(const APInt &n) {
+  static constexpr uint64_t kBases[] = {2,  3,  5,  7,  11, 13,
+                                        17, 19, 23, 29, 31, 37};
+  if (n.ult(2)) return false;
+  for (uint64_t base : kBases) {
+    if (n == base) return true;
+    if (n.urem(base) == 0) return false;
+  }
+
+  // Widen so that the product of two residues does not overflow.
+  unsigned bitWidth = std::max(2 * n.getActiveBits(), 64u);
+  APInt modulo = n.zextOrTrunc(bitWidth);
+  APInt nMinusOne = modulo - 1;
+  // n - 1 = d * 2^s with d odd.
+  unsigned s = nMinusOne.countr_zero();
+  APInt d = nMinusOne.lshr(s);
+  for (uint64_t base : kBases) {
+    APInt x = powMod(APInt(bitWidth, base), d, modulo);
+    if (x == 1 || x == nMinusOne) continue;
+    bool isWitness = true;
+    for (unsigned r = 1; r < s && isWitness; ++r) {
+      x = (x * x).urem(modulo);
+      isWitness = x != nMinusOne;
+    }
+    if (isWitness) return false;
+  }
+  return true;
+}
+
 }  // namespace heir
 }  // namespace mlir
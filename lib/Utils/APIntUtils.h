@@ -8,6 +8,11 @@ namespace heir {
 
 APInt multiplicativeInverse(const APInt &x, const APInt &modulo);
 
+/// Tests whether `n` is prime with the Miller-Rabin test on the first twelve
+/// primes as bases, which is exact for all n < 3.3 * 10^24 and so for every
+/// modulus of at most 64 bits.
+bool isPrime(const APInt &n);
+
 }  // namespace heir
 }  // namespace mlir
 
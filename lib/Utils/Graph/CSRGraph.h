@@ -0,0 +1,263 @@
+#ifndef LIB_UTILS_GRAPH_CSRGRAPH_H_
+#define LIB_UTILS_GRAPH_CSRGRAPH_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "lib/Utils/Graph/Graph.h"
+#include "llvm/include/llvm/ADT/ArrayRef.h"           // from @llvm-project
+#include "mlir/include/mlir/Support/LogicalResult.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace graph {
+
+// An immutable directed graph stored in compressed sparse row form.
+//
+// A CSRGraph is built once from a `Graph`, after which the vertices are
+// addressed by dense integer ids and the edges of each vertex are stored
+// contiguously. Traversals then run in O(V + E) time without allocating per
+// vertex, which matters for netlists with hundreds of thousands of gates.
+//
+// Vertex ids follow the order of `Graph::getVertices`, and the successors and
+// predecessors of each vertex are sorted by id, so the results of
+// `topologicalSort` and `sortGraphByLevels` are identical to those of the
+// corresponding `Graph` methods.
+template <typename V>
+class CSRGraph {
+ public:
+  using VertexId = uint32_t;
+
+  explicit CSRGraph(const Graph<V>& graph)
+      : vertices(graph.vertices.begin(), graph.vertices.end()) {
+    outOffsets.assign(vertices.size() + 1, 0);
+    inOffsets.assign(vertices.size() + 1, 0);
+    size_t numEdges = 0;
+    for (const auto& [source, targets] : graph.outEdges) {
+      numEdges += targets.size();
+    }
+    outTargets.reserve(numEdges);
+
+    // `Graph::outEdges` is ordered by source vertex and each target set is
+    // ordered, so the edges arrive in CSR order.
+    auto outEdgesIt = graph.outEdges.begin();
+    for (VertexId id = 0; id < vertices.size(); ++id) {
+      if (outEdgesIt != graph.outEdges.end() &&
+          outEdgesIt->first == vertices[id]) {
+        for (const V& target : outEdgesIt->second) {
+          VertexId targetId = getId(target);
+          outTargets.push_back(targetId);
+          ++inOffsets[targetId + 1];
+        }
+        ++outEdgesIt;
+      }
+      outOffsets[id + 1] = outTargets.size();
+    }
+
+    // Transpose the successor lists. Sources are visited in increasing id
+    // order, so each predecessor list comes out sorted.
+    for (VertexId id = 0; id < vertices.size(); ++id) {
+      inOffsets[id + 1] += inOffsets[id];
+    }
+    inSources.resize(numEdges);
+    std::vector<size_t> next(inOffsets.begin(), inOffsets.end() - 1);
+    for (VertexId source = 0; source < vertices.size(); ++source) {
+      for (VertexId target : successors(source)) {
+        inSources[next[target]++] = source;
+      }
+    }
+  }
+
+  size_t numVertices() const { return vertices.size(); }
+
+  size_t numEdges() const { return outTargets.size(); }
+
+  // Returns the vertex with the given id.
+  const V& getVertex(VertexId id) const { return vertices[id]; }
+
+  // Returns the id of the given vertex, which must be part of the graph.
+  VertexId getId(const V& vertex) const {
+    auto it = std::lower_bound(vertices.begin(), vertices.end(), vertex);
+    assert(it != vertices.end() && !(vertex < *it) &&
+           "vertex is not part of the graph");
+    return it - vertices.begin();
+  }
+
+  // Returns the ids of the vertices that the given vertex has edges to.
+  llvm::ArrayRef<VertexId> successors(VertexId id) const {
+    return llvm::ArrayRef<VertexId>(outTargets)
+        .slice(outOffsets[id], outOffsets[id + 1] - outOffsets[id]);
+  }
+
+  // Returns the ids of the vertices that have edges to the given vertex.
+  llvm::ArrayRef<VertexId> predecessors(VertexId id) const {
+    return llvm::ArrayRef<VertexId>(inSources)
+        .slice(inOffsets[id], inOffsets[id + 1] - inOffsets[id]);
+  }
+
+  // Returns a topological sort of the vertex ids if the graph is acyclic,
+  // otherwise returns failure().
+  FailureOr<std::vector<VertexId>> topologicalSort() const {
+    std::vector<VertexId> result;
+    result.reserve(vertices.size());
+
+    // Kahn's algorithm, visiting vertices in the same order as
+    // `Graph::topologicalSort`.
+    std::vector<VertexId> active;
+    std::vector<size_t> edgeCount(vertices.size());
+    for (VertexId id = 0; id < vertices.size(); ++id) {
+      edgeCount[id] = predecessors(id).size();
+      if (edgeCount[id] == 0) {
+        active.push_back(id);
+      }
+    }
+
+    while (!active.empty()) {
+      VertexId source = active.back();
+      active.pop_back();
+      result.push_back(source);
+      for (VertexId target : successors(source)) {
+        if (--edgeCount[target] == 0) {
+          active.push_back(target);
+        }
+      }
+    }
+
+    if (result.size() != vertices.size()) {
+      return failure();
+    }
+    return result;
+  }
+
+  // Returns, for each vertex id, the length of the longest path from any
+  // vertex without predecessors to that vertex, counted in edges. This is the
+  // earliest level at which the vertex can be scheduled.
+  FailureOr<std::vector<int64_t>> computeLevels() const {
+    auto result = longestPathLengths(/*weights=*/{});
+    if (failed(result)) {
+      return failure();
+    }
+    std::vector<int64_t> levels = std::move(result.value());
+    for (int64_t& level : levels) {
+      --level;
+    }
+    return levels;
+  }
+
+  // Returns, for each vertex id, the largest total weight of a path ending at
+  // that vertex, including the weight of the vertex itself. `weights` is
+  // indexed by vertex id; an empty `weights` gives every vertex weight 1.
+  FailureOr<std::vector<int64_t>> longestPathLengths(
+      llvm::ArrayRef<int64_t> weights) const {
+    assert((weights.empty() || weights.size() == vertices.size()) &&
+           "expected one weight per vertex");
+    auto result = topologicalSort();
+    if (failed(result)) {
+      return failure();
+    }
+
+    std::vector<int64_t> lengths(vertices.size(), 0);
+    for (VertexId id : result.value()) {
+      int64_t longestIn = 0;
+      for (VertexId source : predecessors(id)) {
+        longestIn = std::max(longestIn, lengths[source]);
+      }
+      lengths[id] = longestIn + (weights.empty() ? 1 : weights[id]);
+    }
+    return lengths;
+  }
+
+  // Returns the vertex ids along a path of largest total weight, from its
+  // source to its sink, using the same weights as `longestPathLengths`.
+  FailureOr<std::vector<VertexId>> criticalPath(
+      llvm::ArrayRef<int64_t> weights) const {
+    auto result = longestPathLengths(weights);
+    if (failed(result)) {
+      return failure();
+    }
+    const std::vector<int64_t>& lengths = result.value();
+    if (lengths.empty()) {
+      return std::vector<VertexId>();
+    }
+
+    VertexId current =
+        std::max_element(lengths.begin(), lengths.end()) - lengths.begin();
+    std::vector<VertexId> path = {current};
+    while (!predecessors(current).empty()) {
+      // Follow the predecessor that realizes the longest path, preferring the
+      // smallest id in a tie.
+      VertexId best = predecessors(current).front();
+      for (VertexId source : predecessors(current)) {
+        if (lengths[source] > lengths[best]) {
+          best = source;
+        }
+      }
+      current = best;
+      path.push_back(current);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+  }
+
+  // Groups the vertices into levels, such that every vertex is in a later
+  // level than all of its predecessors. Vertices are placed as late as
+  // possible, and the vertices within a level are ordered by id. This matches
+  // `Graph::sortGraphByLevels`.
+  FailureOr<std::vector<std::vector<V>>> sortGraphByLevels() const {
+    auto result = topologicalSort();
+    if (failed(result)) {
+      return failure();
+    }
+
+    // Walk backwards from the outputs, so that the distance to the furthest
+    // output is known for all successors of a vertex when it is visited.
+    const std::vector<VertexId>& topoOrder = result.value();
+    std::vector<int> levels(vertices.size(), 0);
+    int maxLevel = 0;
+    for (auto it = topoOrder.rbegin(); it != topoOrder.rend(); ++it) {
+      int maxSourceLevel = -1;
+      for (VertexId target : successors(*it)) {
+        maxSourceLevel = std::max(maxSourceLevel, levels[target]);
+      }
+      levels[*it] = 1 + maxSourceLevel;
+      maxLevel = std::max(levels[*it], maxLevel);
+    }
+
+    std::vector<std::vector<V>> output(vertices.empty() ? 0 : maxLevel + 1);
+    std::vector<size_t> levelSizes(output.size(), 0);
+    for (int level : levels) {
+      ++levelSizes[maxLevel - level];
+    }
+    for (size_t i = 0; i < output.size(); ++i) {
+      output[i].reserve(levelSizes[i]);
+    }
+    for (VertexId id = 0; id < vertices.size(); ++id) {
+      output[maxLevel - levels[id]].push_back(vertices[id]);
+    }
+    return output;
+  }
+
+ private:
+  // Vertices sorted in increasing order, indexed by id.
+  std::vector<V> vertices;
+
+  // The successors of vertex `i` are `outTargets[outOffsets[i]:
+  // outOffsets[i+1]]`.
+  std::vector<size_t> outOffsets;
+  std::vector<VertexId> outTargets;
+
+  // The predecessors of vertex `i` are `inSources[inOffsets[i]:
+  // inOffsets[i+1]]`.
+  std::vector<size_t> inOffsets;
+  std::vector<VertexId> inSources;
+};
+
+}  // namespace graph
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_UTILS_GRAPH_CSRGRAPH_H_
@@ -0,0 +1,141 @@
+#include <cstdint>
+#include <vector>
+
+#include "gmock/gmock.h"  // from @googletest
+#include "gtest/gtest.h"  // from @googletest
+#include "lib/Utils/Graph/CSRGraph.h"
+#include "lib/Utils/Graph/Graph.h"
+#include "mlir/include/mlir/Support/LogicalResult.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace graph {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+// Example graph:
+//       ↗ 2 ↘
+// 0 → 1 → 3 → 4
+//   ↘ → → → ↗
+Graph<int> diamondGraph() {
+  Graph<int> graph;
+  for (int i = 0; i < 5; ++i) graph.addVertex(i);
+  graph.addEdge(0, 1);
+  graph.addEdge(1, 2);
+  graph.addEdge(1, 3);
+  graph.addEdge(1, 4);
+  graph.addEdge(2, 4);
+  graph.addEdge(3, 4);
+  return graph;
+}
+
+TEST(CSRGraphTest, Adjacency) {
+  Graph<int> graph = diamondGraph();
+  CSRGraph<int> csr(graph);
+  EXPECT_EQ(csr.numVertices(), 5);
+  EXPECT_EQ(csr.numEdges(), 6);
+  EXPECT_THAT(csr.successors(csr.getId(1)), ElementsAre(2, 3, 4));
+  EXPECT_THAT(csr.predecessors(csr.getId(4)), ElementsAre(1, 2, 3));
+  EXPECT_THAT(csr.predecessors(csr.getId(0)), IsEmpty());
+}
+
+TEST(CSRGraphTest, SparseVertexIds) {
+  Graph<int> graph;
+  graph.addVertex(30);
+  graph.addVertex(10);
+  graph.addVertex(20);
+  graph.addEdge(30, 10);
+  graph.addEdge(10, 20);
+  CSRGraph<int> csr(graph);
+
+  EXPECT_EQ(csr.getId(10), 0);
+  EXPECT_EQ(csr.getId(30), 2);
+  EXPECT_EQ(csr.getVertex(1), 20);
+  auto sorted = csr.topologicalSort();
+  ASSERT_TRUE(succeeded(sorted));
+  EXPECT_THAT(sorted.value(), ElementsAre(2, 0, 1));
+}
+
+TEST(CSRGraphTest, MatchesGraphTopologicalSort) {
+  Graph<int> graph = diamondGraph();
+  auto expected = graph.topologicalSort();
+  ASSERT_TRUE(succeeded(expected));
+
+  CSRGraph<int> csr(graph);
+  auto actual = csr.topologicalSort();
+  ASSERT_TRUE(succeeded(actual));
+  std::vector<int> vertices;
+  for (auto id : actual.value()) vertices.push_back(csr.getVertex(id));
+  EXPECT_EQ(vertices, expected.value());
+}
+
+TEST(CSRGraphTest, MatchesGraphLevelSort) {
+  // Same graph as LevelSortTest.MultiOutputGraphLevelSort.
+  Graph<int> graph;
+  for (int i = 0; i < 10; ++i) graph.addVertex(i);
+  graph.addEdge(0, 1);
+  graph.addEdge(1, 2);
+  graph.addEdge(2, 3);
+  graph.addEdge(3, 4);
+  graph.addEdge(4, 5);
+  graph.addEdge(4, 6);
+  graph.addEdge(1, 9);
+  graph.addEdge(2, 8);
+  graph.addEdge(3, 7);
+
+  auto expected = graph.sortGraphByLevels();
+  ASSERT_TRUE(succeeded(expected));
+  auto actual = CSRGraph<int>(graph).sortGraphByLevels();
+  ASSERT_TRUE(succeeded(actual));
+  EXPECT_EQ(actual.value(), expected.value());
+}
+
+TEST(CSRGraphTest, CycleFails) {
+  Graph<int> graph;
+  graph.addVertex(0);
+  graph.addVertex(1);
+  graph.addEdge(0, 1);
+  graph.addEdge(1, 0);
+  CSRGraph<int> csr(graph);
+  EXPECT_TRUE(failed(csr.topologicalSort()));
+  EXPECT_TRUE(failed(csr.sortGraphByLevels()));
+  EXPECT_TRUE(failed(csr.computeLevels()));
+}
+
+TEST(CSRGraphTest, ComputeLevels) {
+  CSRGraph<int> csr(diamondGraph());
+  auto levels = csr.computeLevels();
+  ASSERT_TRUE(succeeded(levels));
+  EXPECT_THAT(levels.value(), ElementsAre(0, 1, 2, 2, 3));
+}
+
+TEST(CSRGraphTest, WeightedCriticalPath) {
+  CSRGraph<int> csr(diamondGraph());
+  std::vector<int64_t> weights = {1, 1, 5, 2, 1};
+
+  auto lengths = csr.longestPathLengths(weights);
+  ASSERT_TRUE(succeeded(lengths));
+  EXPECT_THAT(lengths.value(), ElementsAre(1, 2, 7, 4, 8));
+
+  auto path = csr.criticalPath(weights);
+  ASSERT_TRUE(succeeded(path));
+  EXPECT_THAT(path.value(), ElementsAre(0, 1, 2, 4));
+}
+
+TEST(CSRGraphTest, EmptyGraph) {
+  Graph<int> graph;
+  CSRGraph<int> csr(graph);
+  auto levels = csr.sortGraphByLevels();
+  ASSERT_TRUE(succeeded(levels));
+  EXPECT_THAT(levels.value(), IsEmpty());
+  auto path = csr.criticalPath({});
+  ASSERT_TRUE(succeeded(path));
+  EXPECT_THAT(path.value(), IsEmpty());
+}
+
+}  // namespace
+}  // namespace graph
+}  // namespace heir
+}  // namespace mlir
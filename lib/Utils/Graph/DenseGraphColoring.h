@@ -0,0 +1,226 @@
+#ifndef LIB_UTILS_GRAPH_DENSEGRAPHCOLORING_H_
+#define LIB_UTILS_GRAPH_DENSEGRAPHCOLORING_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "llvm/include/llvm/ADT/ArrayRef.h"   // from @llvm-project
+#include "llvm/include/llvm/ADT/BitVector.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace graph {
+
+// An undirected graph on the vertices 0..n-1, for graphs too large for
+// `UndirectedGraph`, such as conflict graphs over the slots of a ciphertext.
+//
+// Edges are collected with `addEdge` and deduplicated by `finalize`, which
+// must be called before querying neighbors.
+class DenseUndirectedGraph {
+ public:
+  explicit DenseUndirectedGraph(int64_t numVertices)
+      : adjacency(numVertices) {}
+
+  int64_t numVertices() const { return adjacency.size(); }
+
+  void addEdge(int64_t source, int64_t target) {
+    if (source == target) return;
+    adjacency[source].push_back(target);
+    adjacency[target].push_back(source);
+  }
+
+  // Sorts the neighbors of each vertex and removes duplicate edges.
+  void finalize() {
+    for (std::vector<int64_t>& neighbors : adjacency) {
+      std::sort(neighbors.begin(), neighbors.end());
+      neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                      neighbors.end());
+    }
+  }
+
+  llvm::ArrayRef<int64_t> neighbors(int64_t vertex) const {
+    return adjacency[vertex];
+  }
+
+ private:
+  std::vector<std::vector<int64_t>> adjacency;
+};
+
+// The DSatur graph coloring algorithm on a `DenseUndirectedGraph`, followed by
+// a bounded local search that tries to empty the highest color class.
+//
+// The DSatur phase visits vertices in the same order as `GreedyGraphColoring`
+// and so produces the same coloring. The local search only changes the
+// coloring when it removes a color.
+class DenseGraphColoring {
+ public:
+  // `maxLocalSearchRounds` bounds the number of color classes the local
+  // search tries to eliminate.
+  explicit DenseGraphColoring(int64_t maxLocalSearchRounds = 8)
+      : maxLocalSearchRounds(maxLocalSearchRounds) {}
+
+  // Returns the color of each vertex. Colors are numbered from zero with no
+  // gaps. If the caller knows that at least `lowerBound` colors are needed,
+  // e.g. from a clique in the graph, the local search stops once it is met.
+  std::vector<int> color(const DenseUndirectedGraph& graph,
+                         int lowerBound = 1) {
+    std::vector<int> colors = colorDSatur(graph);
+    for (int64_t round = 0; round < maxLocalSearchRounds; ++round) {
+      if (numColors(colors) <= lowerBound ||
+          !tryEliminateHighestColor(graph, colors)) {
+        break;
+      }
+    }
+    return colors;
+  }
+
+  static int numColors(llvm::ArrayRef<int> colors) {
+    if (colors.empty()) return 0;
+    return *std::max_element(colors.begin(), colors.end()) + 1;
+  }
+
+ private:
+  struct VertexInfo {
+    int64_t vertex;
+    // The number of different colors used by neighbors, primary sort key.
+    int saturationDegree;
+    // The number of uncolored neighbors, secondary sort key.
+    int uncoloredDegree;
+
+    bool operator<(const VertexInfo& other) const {
+      if (saturationDegree != other.saturationDegree)
+        return saturationDegree < other.saturationDegree;
+      if (uncoloredDegree != other.uncoloredDegree)
+        return uncoloredDegree < other.uncoloredDegree;
+      // Visit smaller index vertices first in a tiebreak
+      return vertex > other.vertex;
+    }
+  };
+
+  static std::vector<int> colorDSatur(const DenseUndirectedGraph& graph) {
+    int64_t numVertices = graph.numVertices();
+    std::vector<int> colors(numVertices, -1);
+    // The colors used by the neighbors of each vertex.
+    std::vector<llvm::BitVector> neighborColors(numVertices);
+    std::vector<VertexInfo> current(numVertices);
+    std::priority_queue<VertexInfo> queue;
+
+    for (int64_t vertex = 0; vertex < numVertices; ++vertex) {
+      current[vertex] = VertexInfo{
+          vertex, 0, static_cast<int>(graph.neighbors(vertex).size())};
+      queue.push(current[vertex]);
+    }
+
+    while (!queue.empty()) {
+      VertexInfo info = queue.top();
+      queue.pop();
+      // Skip entries for colored vertices and outdated entries.
+      if (colors[info.vertex] >= 0 ||
+          info.saturationDegree != current[info.vertex].saturationDegree ||
+          info.uncoloredDegree != current[info.vertex].uncoloredDegree) {
+        continue;
+      }
+
+      // Use the smallest unused color among neighbors.
+      const llvm::BitVector& used = neighborColors[info.vertex];
+      int color = used.find_first_unset();
+      if (color < 0) color = used.size();
+      colors[info.vertex] = color;
+
+      for (int64_t neighbor : graph.neighbors(info.vertex)) {
+        if (colors[neighbor] >= 0) continue;
+        llvm::BitVector& neighborUsed = neighborColors[neighbor];
+        if (neighborUsed.size() <= static_cast<unsigned>(color)) {
+          neighborUsed.resize(color + 1);
+        }
+        neighborUsed.set(color);
+        current[neighbor].saturationDegree = neighborUsed.count();
+        current[neighbor].uncoloredDegree -= 1;
+        queue.push(current[neighbor]);
+      }
+    }
+    return colors;
+  }
+
+  // Tries to move every vertex of the highest color class to a lower color,
+  // either directly or after moving the few neighbors that block a lower color
+  // to other lower colors. Returns true and updates `colors` if
+  // the class was emptied, and leaves `colors` unchanged otherwise.
+  static bool tryEliminateHighestColor(const DenseUndirectedGraph& graph,
+                                       std::vector<int>& colors) {
+    if (colors.empty()) return false;
+    int target = *std::max_element(colors.begin(), colors.end());
+    if (target == 0) return false;
+
+    std::vector<int> candidate = colors;
+    std::vector<int> conflicts(target);
+    for (int64_t vertex = 0; vertex < graph.numVertices(); ++vertex) {
+      if (candidate[vertex] != target) continue;
+
+      std::fill(conflicts.begin(), conflicts.end(), 0);
+      for (int64_t neighbor : graph.neighbors(vertex)) {
+        int neighborColor = candidate[neighbor];
+        if (neighborColor < target) {
+          ++conflicts[neighborColor];
+        }
+      }
+
+      auto free = std::find(conflicts.begin(), conflicts.end(), 0);
+      if (free != conflicts.end()) {
+        candidate[vertex] = free - conflicts.begin();
+        continue;
+      }
+
+      bool moved = false;
+      for (int color = 0; color < target && !moved; ++color) {
+        if (conflicts[color] > kMaxBlockers) continue;
+        moved = tryMoveBlockers(graph, candidate, vertex, color, target);
+      }
+      if (!moved) return false;
+    }
+
+    colors = std::move(candidate);
+    return true;
+  }
+
+  // Recolors the neighbors of `vertex` that have color `color` to other
+  // colors below `target`, then gives `vertex` color `color`. Returns false
+  // and leaves `colors` unchanged if some neighbor cannot be moved.
+  static bool tryMoveBlockers(const DenseUndirectedGraph& graph,
+                              std::vector<int>& colors, int64_t vertex,
+                              int color, int target) {
+    std::vector<std::pair<int64_t, int>> moves;
+    for (int64_t blocker : graph.neighbors(vertex)) {
+      if (colors[blocker] != color) continue;
+      llvm::BitVector blockerUsed(target);
+      for (int64_t neighbor : graph.neighbors(blocker)) {
+        if (colors[neighbor] < target) blockerUsed.set(colors[neighbor]);
+      }
+      blockerUsed.set(color);
+      int other = blockerUsed.find_first_unset();
+      if (other < 0) {
+        for (auto [moved, oldColor] : moves) colors[moved] = oldColor;
+        return false;
+      }
+      moves.emplace_back(blocker, color);
+      colors[blocker] = other;
+    }
+    colors[vertex] = color;
+    return true;
+  }
+
+  // The largest number of neighbors the local search moves out of the way to
+  // free a color for one vertex.
+  static constexpr int kMaxBlockers = 3;
+
+  int64_t maxLocalSearchRounds;
+};
+
+}  // namespace graph
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_UTILS_GRAPH_DENSEGRAPHCOLORING_H_
@@ -0,0 +1,89 @@
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"  // from @googletest
+#include "gtest/gtest.h"  // from @googletest
+#include "lib/Utils/Graph/DenseGraphColoring.h"
+#include "lib/Utils/Graph/Graph.h"
+
+namespace mlir {
+namespace heir {
+namespace graph {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(DenseGraphColoringTest, DuplicateEdgesAreMerged) {
+  DenseUndirectedGraph graph(3);
+  graph.addEdge(0, 1);
+  graph.addEdge(1, 0);
+  graph.addEdge(0, 2);
+  graph.addEdge(1, 1);
+  graph.finalize();
+  EXPECT_THAT(graph.neighbors(0), ElementsAre(1, 2));
+  EXPECT_THAT(graph.neighbors(1), ElementsAre(0));
+}
+
+TEST(DenseGraphColoringTest, MatchesGreedyGraphColoring) {
+  // Same graph as GraphColorTest.SimpleGraph.
+  //       / 2 \
+  // 0 - 1 - 3 - 4
+  //   \ - - - /
+  DenseUndirectedGraph dense(5);
+  UndirectedGraph<int> graph;
+  for (int i = 0; i < 5; ++i) graph.addVertex(i);
+  for (auto [source, target] : std::vector<std::pair<int, int>>{
+           {0, 1}, {1, 2}, {1, 3}, {2, 4}, {3, 4}}) {
+    dense.addEdge(source, target);
+    graph.addEdge(source, target);
+  }
+  dense.finalize();
+
+  std::vector<int> colors = DenseGraphColoring().color(dense);
+  GreedyGraphColoring<int> greedy;
+  auto expected = greedy.color(graph);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(colors[i], expected[i]);
+  }
+}
+
+TEST(DenseGraphColoringTest, LocalSearchRemovesColor) {
+  // DSatur needs four colors for this graph, but three suffice.
+  DenseUndirectedGraph graph(8);
+  for (auto [source, target] : std::vector<std::pair<int, int>>{
+           {0, 1}, {0, 5}, {0, 7}, {1, 2}, {2, 5}, {3, 4},
+           {3, 6}, {3, 7}, {4, 6}, {4, 7}, {5, 6}}) {
+    graph.addEdge(source, target);
+  }
+  graph.finalize();
+
+  std::vector<int> dsatur =
+      DenseGraphColoring(/*maxLocalSearchRounds=*/0).color(graph);
+  EXPECT_EQ(DenseGraphColoring::numColors(dsatur), 4);
+
+  std::vector<int> colors = DenseGraphColoring().color(graph);
+  EXPECT_EQ(DenseGraphColoring::numColors(colors), 3);
+  for (int vertex = 0; vertex < 8; ++vertex) {
+    for (int neighbor : graph.neighbors(vertex)) {
+      EXPECT_NE(colors[vertex], colors[neighbor]);
+    }
+  }
+}
+
+TEST(DenseGraphColoringTest, LowerBoundSkipsLocalSearch) {
+  DenseUndirectedGraph graph(8);
+  for (auto [source, target] : std::vector<std::pair<int, int>>{
+           {0, 1}, {0, 5}, {0, 7}, {1, 2}, {2, 5}, {3, 4},
+           {3, 6}, {3, 7}, {4, 6}, {4, 7}, {5, 6}}) {
+    graph.addEdge(source, target);
+  }
+  graph.finalize();
+
+  std::vector<int> colors = DenseGraphColoring().color(graph, /*lowerBound=*/4);
+  EXPECT_EQ(DenseGraphColoring::numColors(colors), 4);
+}
+
+}  // namespace
+}  // namespace graph
+}  // namespace heir
+}  // namespace mlir
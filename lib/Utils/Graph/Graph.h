@@ -16,8 +16,14 @@ namespace mlir {
 namespace heir {
 namespace graph {
 
+template <typename V>
+class CSRGraph;
+
 // A graph data structure.
 //
+// For large graphs, build a `CSRGraph` from the finished graph before running
+// traversals such as level sorting.
+//
 // Parameter `V` is the vertex type, which is expected to be cheap to copy.
 template <typename V>
 class Graph {
@@ -152,6 +158,8 @@ class Graph {
   }
 
  private:
+  friend class CSRGraph<V>;
+
   std::set<V> vertices;
   std::map<V, std::set<V>> outEdges;
   std::map<V, std::set<V>> inEdges;
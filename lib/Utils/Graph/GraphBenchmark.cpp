@@ -0,0 +1,99 @@
+// Microbenchmarks comparing level sorting on `Graph` and `CSRGraph` for large
+// synthetic DAGs shaped like gate netlists.
+//
+// Run with
+//
+//   bazel run -c opt //lib/Utils/Graph:GraphBenchmark
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"  // from @google_benchmark
+#include "lib/Utils/Graph/CSRGraph.h"
+#include "lib/Utils/Graph/Graph.h"
+
+namespace mlir {
+namespace heir {
+namespace graph {
+namespace {
+
+// Each vertex takes two inputs from the previous `kWindow` vertices, like a
+// netlist of two-input gates in topological order.
+constexpr int64_t kWindow = 1024;
+
+Graph<int64_t> makeRandomDag(int64_t numVertices) {
+  std::mt19937_64 rng(/*seed=*/42);
+  Graph<int64_t> graph;
+  for (int64_t i = 0; i < numVertices; ++i) {
+    graph.addVertex(i);
+  }
+  for (int64_t i = 1; i < numVertices; ++i) {
+    std::uniform_int_distribution<int64_t> dist(
+        std::max<int64_t>(0, i - kWindow), i - 1);
+    graph.addEdge(dist(rng), i);
+    graph.addEdge(dist(rng), i);
+  }
+  return graph;
+}
+
+void BM_GraphSortByLevels(benchmark::State& state) {
+  Graph<int64_t> graph = makeRandomDag(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(graph.sortGraphByLevels());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GraphSortByLevels)
+    ->RangeMultiplier(8)
+    ->Range(1 << 14, 1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_CSRGraphBuild(benchmark::State& state) {
+  Graph<int64_t> graph = makeRandomDag(state.range(0));
+  for (auto _ : state) {
+    CSRGraph<int64_t> csr(graph);
+    benchmark::DoNotOptimize(csr.numEdges());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CSRGraphBuild)
+    ->RangeMultiplier(8)
+    ->Range(1 << 14, 1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_CSRGraphSortByLevels(benchmark::State& state) {
+  CSRGraph<int64_t> csr(makeRandomDag(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(csr.sortGraphByLevels());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CSRGraphSortByLevels)
+    ->RangeMultiplier(8)
+    ->Range(1 << 14, 1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_CSRGraphCriticalPath(benchmark::State& state) {
+  CSRGraph<int64_t> csr(makeRandomDag(state.range(0)));
+  std::vector<int64_t> weights(csr.numVertices());
+  std::mt19937_64 rng(/*seed=*/7);
+  std::uniform_int_distribution<int64_t> dist(1, 100);
+  for (int64_t& weight : weights) {
+    weight = dist(rng);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(csr.criticalPath(weights));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CSRGraphCriticalPath)
+    ->RangeMultiplier(8)
+    ->Range(1 << 14, 1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace graph
+}  // namespace heir
+}  // namespace mlir
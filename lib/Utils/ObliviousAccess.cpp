@@ -0,0 +1,412 @@
+#include "lib/Utils/ObliviousAccess.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+#include "lib/Dialect/ModuleAttributes.h"
+#include "llvm/include/llvm/ADT/DenseMap.h"              // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"           // from @llvm-project
+#include "llvm/include/llvm/ADT/StringSwitch.h"          // from @llvm-project
+#include "llvm/include/llvm/Support/MathExtras.h"        // from @llvm-project
+#include "mlir/include/mlir/Dialect/Affine/Analysis/LoopAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Affine/IR/AffineOps.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
+#include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Block.h"                  // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinOps.h"             // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/ImplicitLocOpBuilder.h"   // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/Region.h"                 // from @llvm-project
+#include "mlir/include/mlir/IR/Types.h"                  // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                  // from @llvm-project
+#include "mlir/include/mlir/IR/ValueRange.h"             // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"              // from @llvm-project
+
+namespace mlir {
+namespace heir {
+
+namespace {
+
+// The number of bits of an index into a tensor of `size` elements.
+int64_t getNumIndexBits(int64_t size) {
+  return size <= 1 ? 0 : llvm::Log2_64_Ceil(size);
+}
+
+// The number of ands decoding a `size`-element one-hot vector from the bits
+// of an index, where the first bit alone gives a 2-element vector.
+int64_t getNumDecoderOps(int64_t size) {
+  int64_t numOps = 0;
+  for (int64_t width = 4; width < 2 * size; width *= 2) {
+    numOps += std::min(width, size);
+  }
+  return numOps;
+}
+
+// Returns the bits of `index` from least to most significant, as i1 values.
+SmallVector<Value> getIndexBits(ImplicitLocOpBuilder &b, Value index,
+                                int64_t numBits) {
+  SmallVector<Value> bits;
+  if (numBits == 0) return bits;
+  auto intType = b.getIntegerType(numBits);
+  Value intIndex = b.create<arith::IndexCastUIOp>(intType, index);
+  if (numBits == 1) {
+    bits.push_back(intIndex);
+    return bits;
+  }
+  for (int64_t i = 0; i < numBits; ++i) {
+    Value shifted = intIndex;
+    if (i > 0) {
+      auto shift = b.create<arith::ConstantIntOp>(i, intType);
+      shifted = b.create<arith::ShRUIOp>(intIndex, shift);
+    }
+    bits.push_back(b.create<arith::TruncIOp>(b.getI1Type(), shifted));
+  }
+  return bits;
+}
+
+// Returns the i1 tensor that is true at position `index` only.
+Value getOneHotMask(ImplicitLocOpBuilder &b, Value index, int64_t size) {
+  SmallVector<int64_t> positions(size);
+  for (int64_t i = 0; i < size; ++i) positions[i] = i;
+  auto iota = b.create<arith::ConstantOp>(b.getIndexTensorAttr(positions));
+  auto splatIndex = b.create<tensor::SplatOp>(
+      index, RankedTensorType::get({size}, b.getIndexType()));
+  return b.create<arith::CmpIOp>(arith::CmpIPredicate::eq, iota, splatIndex);
+}
+
+Value extractAt(ImplicitLocOpBuilder &b, Value tensor, int64_t position) {
+  Value index = b.create<arith::ConstantIndexOp>(position);
+  return b.create<tensor::ExtractOp>(tensor, index);
+}
+
+FailureOr<ObliviousAccessStrategy> parseObliviousAccessStrategy(
+    StringRef name) {
+  return llvm::StringSwitch<FailureOr<ObliviousAccessStrategy>>(name)
+      .Case("linear", ObliviousAccessStrategy::Linear)
+      .Case("mux-tree", ObliviousAccessStrategy::MuxTree)
+      .Case("mask-reduce", ObliviousAccessStrategy::MaskReduce)
+      .Default(failure());
+}
+
+FailureOr<ObliviousAccessCostModel> parseObliviousAccessCostModel(
+    StringRef name) {
+  return llvm::StringSwitch<FailureOr<ObliviousAccessCostModel>>(name)
+      .Case("simd", ObliviousAccessCostModel::Simd)
+      .Case("boolean", ObliviousAccessCostModel::Boolean)
+      .Default(failure());
+}
+
+ObliviousAccessCostModel getSchemeCostModel(Operation *moduleOp) {
+  if (!moduleOp) return ObliviousAccessCostModel::Boolean;
+  if (moduleIsBGVOrBFV(moduleOp) || moduleIsCKKS(moduleOp))
+    return ObliviousAccessCostModel::Simd;
+  return ObliviousAccessCostModel::Boolean;
+}
+
+// Tracks which values depend on the index of an access, and how deep.
+class AccessMeasure {
+ public:
+  explicit AccessMeasure(Value index) { depths[index] = 0; }
+
+  void visit(Operation *op);
+
+  ObliviousAccessCost getCost() const { return cost; }
+
+ private:
+  std::optional<int64_t> getDepth(ValueRange values) const;
+  void setDepth(Value value, std::optional<int64_t> depth);
+  // Visits the ops of `block` and returns the depths of the values yielded by
+  // its terminator.
+  SmallVector<std::optional<int64_t>> visitBlock(Block &block);
+
+  DenseMap<Value, int64_t> depths;
+  ObliviousAccessCost cost;
+};
+
+std::optional<int64_t> AccessMeasure::getDepth(ValueRange values) const {
+  std::optional<int64_t> depth;
+  for (Value value : values) {
+    auto it = depths.find(value);
+    if (it != depths.end()) depth = std::max(depth.value_or(0), it->second);
+  }
+  return depth;
+}
+
+void AccessMeasure::setDepth(Value value, std::optional<int64_t> depth) {
+  if (depth.has_value()) {
+    depths[value] = *depth;
+    cost.depth = std::max(cost.depth, *depth);
+  } else {
+    depths.erase(value);
+  }
+}
+
+SmallVector<std::optional<int64_t>> AccessMeasure::visitBlock(Block &block) {
+  for (Operation &op : block.without_terminator()) visit(&op);
+  SmallVector<std::optional<int64_t>> yielded;
+  if (block.mightHaveTerminator()) {
+    for (Value operand : block.getTerminator()->getOperands()) {
+      yielded.push_back(getDepth(operand));
+    }
+  }
+  return yielded;
+}
+
+void AccessMeasure::visit(Operation *op) {
+  if (auto forOp = dyn_cast<affine::AffineForOp>(op)) {
+    std::optional<uint64_t> tripCount = affine::getConstantTripCount(forOp);
+    if (tripCount.has_value()) {
+      SmallVector<std::optional<int64_t>> carried;
+      for (Value init : forOp.getInits()) carried.push_back(getDepth(init));
+      for (uint64_t i = 0; i < *tripCount; ++i) {
+        for (auto [arg, depth] :
+             llvm::zip(forOp.getRegionIterArgs(), carried)) {
+          setDepth(arg, depth);
+        }
+        carried = visitBlock(*forOp.getBody());
+      }
+      for (auto [result, depth] : llvm::zip(forOp.getResults(), carried)) {
+        setDepth(result, depth);
+      }
+      return;
+    }
+  }
+
+  // The results of other ops depend on their operands and on the values
+  // yielded by their regions, such as the branches of an scf.if.
+  std::optional<int64_t> depth = getDepth(op->getOperands());
+  for (Region &region : op->getRegions()) {
+    for (Block &block : region) {
+      for (std::optional<int64_t> yielded : visitBlock(block)) {
+        if (yielded.has_value()) depth = std::max(depth.value_or(0), *yielded);
+      }
+    }
+  }
+  if (!depth.has_value()) return;
+  ++cost.numOps;
+  for (Value result : op->getResults()) setDepth(result, *depth + 1);
+}
+
+}  // namespace
+
+void ObliviousAccessStatistics::record(const ObliviousAccessCost &cost) {
+  ++numAccesses;
+  numOps += cost.numOps;
+  maxDepth = std::max(maxDepth, cost.depth);
+}
+
+LogicalResult parseObliviousAccessOptions(
+    Operation *op, StringRef strategy, StringRef costModel,
+    std::optional<ObliviousAccessStrategy> &parsedStrategy,
+    ObliviousAccessCostModel &parsedCostModel) {
+  parsedStrategy = std::nullopt;
+  if (strategy != "auto") {
+    auto result = parseObliviousAccessStrategy(strategy);
+    if (failed(result)) {
+      return op->emitOpError()
+             << "unknown secret access strategy '" << strategy
+             << "', expected linear, mux-tree, mask-reduce or auto";
+    }
+    parsedStrategy = result.value();
+  }
+
+  if (costModel.empty()) {
+    Operation *moduleOp =
+        isa<ModuleOp>(op) ? op : op->getParentOfType<ModuleOp>();
+    parsedCostModel = getSchemeCostModel(moduleOp);
+  } else {
+    auto result = parseObliviousAccessCostModel(costModel);
+    if (failed(result)) {
+      return op->emitOpError() << "unknown secret access cost model '"
+                               << costModel << "', expected simd or boolean";
+    }
+    parsedCostModel = result.value();
+  }
+
+  if (parsedCostModel == ObliviousAccessCostModel::Simd &&
+      parsedStrategy.has_value() &&
+      *parsedStrategy != ObliviousAccessStrategy::Linear) {
+    return op->emitOpError()
+           << "secret access strategy '" << strategy
+           << "' requires the boolean cost model: it computes on the bits of "
+              "the secret index, which does not lower to BGV, BFV or CKKS";
+  }
+  return success();
+}
+
+bool supportsObliviousAccess(ObliviousAccessStrategy strategy, bool isInsert,
+                             Type elementType) {
+  if (strategy != ObliviousAccessStrategy::MaskReduce || isInsert) return true;
+  if (auto intType = dyn_cast<IntegerType>(elementType))
+    return intType.getWidth() > 1;
+  return isa<FloatType>(elementType);
+}
+
+ObliviousAccessCost estimateBooleanAccessCost(ObliviousAccessStrategy strategy,
+                                              bool isInsert, int64_t size) {
+  int64_t numBits = getNumIndexBits(size);
+  // Comparing the index with a constant is a tree of ands over its bits, and
+  // the bits of the index (and their negations) are free wires.
+  int64_t comparisonOps = std::max<int64_t>(numBits - 1, 1);
+
+  ObliviousAccessCost cost;
+  switch (strategy) {
+    case ObliviousAccessStrategy::Linear:
+      cost.depth = size;
+      cost.numOps = size * comparisonOps + size;
+      break;
+    case ObliviousAccessStrategy::MuxTree:
+      cost.depth = numBits;
+      cost.numOps = isInsert ? getNumDecoderOps(size) + size : size - 1;
+      break;
+    case ObliviousAccessStrategy::MaskReduce:
+      // The comparisons all run in parallel, followed by a select, or by a
+      // multiplication and a tree of additions.
+      cost.depth = isInsert ? 1 : 1 + numBits;
+      cost.numOps = size * comparisonOps + (isInsert ? size : 2 * size - 1);
+      break;
+  }
+  return cost;
+}
+
+ObliviousAccessStrategy chooseObliviousAccessStrategy(
+    std::optional<ObliviousAccessStrategy> strategy, bool isInsert,
+    int64_t size, Type elementType, ObliviousAccessCostModel costModel) {
+  if (costModel == ObliviousAccessCostModel::Simd) {
+    return ObliviousAccessStrategy::Linear;
+  }
+  if (strategy.has_value()) {
+    return supportsObliviousAccess(*strategy, isInsert, elementType)
+               ? *strategy
+               : ObliviousAccessStrategy::MuxTree;
+  }
+
+  auto key = [&](ObliviousAccessStrategy candidate) {
+    ObliviousAccessCost cost =
+        estimateBooleanAccessCost(candidate, isInsert, size);
+    return std::make_tuple(cost.numOps, cost.depth);
+  };
+
+  ObliviousAccessStrategy best = ObliviousAccessStrategy::Linear;
+  for (ObliviousAccessStrategy candidate :
+       {ObliviousAccessStrategy::MuxTree,
+        ObliviousAccessStrategy::MaskReduce}) {
+    if (supportsObliviousAccess(candidate, isInsert, elementType) &&
+        key(candidate) < key(best)) {
+      best = candidate;
+    }
+  }
+  return best;
+}
+
+ObliviousAccessCost measureObliviousAccess(Block::iterator begin,
+                                           Block::iterator end, Value index) {
+  AccessMeasure measure(index);
+  for (Operation &op : llvm::make_range(begin, end)) {
+    measure.visit(&op);
+  }
+  return measure.getCost();
+}
+
+Value buildMuxTreeExtract(ImplicitLocOpBuilder &b, Value tensor, Value index) {
+  int64_t size = cast<RankedTensorType>(tensor.getType()).getDimSize(0);
+  SmallVector<Value> bits = getIndexBits(b, index, getNumIndexBits(size));
+
+  // After selecting on the k low bits of the index, level[j] is the element
+  // at position j * 2^k + (index mod 2^k).
+  SmallVector<Value> level;
+  for (int64_t i = 0; i < size; ++i) {
+    level.push_back(extractAt(b, tensor, i));
+  }
+  for (Value bit : bits) {
+    SmallVector<Value> next;
+    for (size_t j = 0; j + 1 < level.size(); j += 2) {
+      next.push_back(b.create<arith::SelectOp>(bit, level[j + 1], level[j]));
+    }
+    // An index with this bit set is out of bounds for the last element.
+    if (level.size() % 2 == 1) next.push_back(level.back());
+    level = std::move(next);
+  }
+  return level.front();
+}
+
+Value buildMaskReduceExtract(ImplicitLocOpBuilder &b, Value tensor,
+                             Value index) {
+  auto tensorType = cast<RankedTensorType>(tensor.getType());
+  int64_t size = tensorType.getDimSize(0);
+  Type elementType = tensorType.getElementType();
+  Value mask = getOneHotMask(b, index, size);
+
+  Value masked;
+  if (isa<FloatType>(elementType)) {
+    Value floatMask = b.create<arith::UIToFPOp>(tensorType, mask);
+    masked = b.create<arith::MulFOp>(tensor, floatMask);
+  } else {
+    Value intMask = b.create<arith::ExtUIOp>(tensorType, mask);
+    masked = b.create<arith::MulIOp>(tensor, intMask);
+  }
+
+  // A chain of additions of all elements, which --rotate-and-reduce replaces
+  // with log(n) rotations.
+  Value sum = extractAt(b, masked, 0);
+  for (int64_t i = 1; i < size; ++i) {
+    Value element = extractAt(b, masked, i);
+    if (isa<FloatType>(elementType)) {
+      sum = b.create<arith::AddFOp>(sum, element);
+    } else {
+      sum = b.create<arith::AddIOp>(sum, element);
+    }
+  }
+  return sum;
+}
+
+Value buildMuxTreeInsert(ImplicitLocOpBuilder &b, Value scalar, Value tensor,
+                         Value index) {
+  auto tensorType = cast<RankedTensorType>(tensor.getType());
+  int64_t size = tensorType.getDimSize(0);
+  SmallVector<Value> bits = getIndexBits(b, index, getNumIndexBits(size));
+
+  // After decoding the k low bits of the index, oneHot[j] is whether they are
+  // equal to the k low bits of j.
+  SmallVector<Value> oneHot;
+  auto trueValue = b.create<arith::ConstantIntOp>(1, b.getI1Type());
+  for (auto [k, bit] : llvm::enumerate(bits)) {
+    Value notBit = b.create<arith::XOrIOp>(bit, trueValue);
+    int64_t width = std::min<int64_t>(int64_t{2} << k, size);
+    SmallVector<Value> next;
+    for (int64_t j = 0; j < width; ++j) {
+      Value bitMatches = (j >> k) & 1 ? bit : notBit;
+      if (oneHot.empty()) {
+        next.push_back(bitMatches);
+      } else {
+        Value lowBitsMatch = oneHot[j % oneHot.size()];
+        next.push_back(b.create<arith::AndIOp>(lowBitsMatch, bitMatches));
+      }
+    }
+    oneHot = std::move(next);
+  }
+
+  SmallVector<Value> elements;
+  for (int64_t i = 0; i < size; ++i) {
+    Value element = extractAt(b, tensor, i);
+    Value isIndex = oneHot.empty() ? Value(trueValue) : oneHot[i];
+    elements.push_back(b.create<arith::SelectOp>(isIndex, scalar, element));
+  }
+  return b.create<tensor::FromElementsOp>(tensorType, elements);
+}
+
+Value buildMaskReduceInsert(ImplicitLocOpBuilder &b, Value scalar,
+                            Value tensor, Value index) {
+  auto tensorType = cast<RankedTensorType>(tensor.getType());
+  Value mask = getOneHotMask(b, index, tensorType.getDimSize(0));
+  Value splat = b.create<tensor::SplatOp>(scalar, tensorType);
+  return b.create<arith::SelectOp>(mask, splat, tensor);
+}
+
+}  // namespace heir
+}  // namespace mlir
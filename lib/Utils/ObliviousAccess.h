@@ -0,0 +1,118 @@
+#ifndef LIB_UTILS_OBLIVIOUSACCESS_H_
+#define LIB_UTILS_OBLIVIOUSACCESS_H_
+
+#include <cstdint>
+#include <optional>
+
+#include "llvm/include/llvm/ADT/StringRef.h"            // from @llvm-project
+#include "mlir/include/mlir/IR/Block.h"                 // from @llvm-project
+#include "mlir/include/mlir/IR/ImplicitLocOpBuilder.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"             // from @llvm-project
+#include "mlir/include/mlir/IR/Types.h"                 // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                 // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"             // from @llvm-project
+
+namespace mlir {
+namespace heir {
+
+// Ways to read or write an element of a 1D tensor of size n at a secret index
+// without branching on the index.
+enum class ObliviousAccessStrategy {
+  // Compare the index with each position in a loop, and select the element
+  // (resp. the updated tensor) in a chain of n ops.
+  Linear,
+  // Select on the bits of the index. An extract is a binary tree of selects
+  // of depth log(n). An insert decodes the index into a one-hot vector with
+  // log(n) levels of ands, and then selects each element of the tensor.
+  MuxTree,
+  // Compare the index with all positions at once to build a one-hot mask. An
+  // extract multiplies the tensor by the mask and sums all of its elements,
+  // which --rotate-and-reduce turns into log(n) rotations. An insert selects
+  // between the tensor and a splat of the value with the mask.
+  MaskReduce,
+};
+
+enum class ObliviousAccessCostModel {
+  // A ciphertext packs a whole tensor (BGV, BFV, CKKS). Only Linear lowers:
+  // the other strategies compute on the bits of the secret index, or compare
+  // it with a vector, which these schemes cannot do on a ciphertext.
+  Simd,
+  // A ciphertext encrypts a single bit (CGGI): minimize the number of gates
+  // first, then the depth.
+  Boolean,
+};
+
+struct ObliviousAccessCost {
+  // The length of the longest chain of ops from the index to the result.
+  int64_t depth = 0;
+  // The number of ops that depend on the index.
+  int64_t numOps = 0;
+};
+
+// Totals over the accesses rewritten by a pass.
+struct ObliviousAccessStatistics {
+  int64_t numAccesses = 0;
+  int64_t numOps = 0;
+  int64_t maxDepth = 0;
+
+  void record(const ObliviousAccessCost &cost);
+};
+
+// Parses the `strategy` ("linear", "mux-tree", "mask-reduce" or "auto") and
+// `costModel` ("simd", "boolean" or empty) options of the passes rewriting
+// accesses at a secret index. The strategy is std::nullopt for "auto", and an
+// empty cost model defaults to the one of the scheme annotated on the module
+// containing `op`, or Boolean if there is none. Fails if the strategy is not
+// supported by the cost model.
+LogicalResult parseObliviousAccessOptions(
+    Operation *op, StringRef strategy, StringRef costModel,
+    std::optional<ObliviousAccessStrategy> &parsedStrategy,
+    ObliviousAccessCostModel &parsedCostModel);
+
+// Whether `strategy` can access tensors of `elementType`. Linear and MuxTree
+// support any type, while the extracts of MaskReduce need integer or
+// floating point elements to multiply them by the mask.
+bool supportsObliviousAccess(ObliviousAccessStrategy strategy, bool isInsert,
+                             Type elementType);
+
+// Estimates the number of gates and the depth of an access with `strategy`
+// in a boolean circuit, without building it.
+ObliviousAccessCost estimateBooleanAccessCost(ObliviousAccessStrategy strategy,
+                                              bool isInsert, int64_t size);
+
+// Returns `strategy`, or the cheapest strategy for `elementType` under
+// `costModel` if it is std::nullopt. Falls back to MuxTree if `strategy` does
+// not support `elementType`.
+ObliviousAccessStrategy chooseObliviousAccessStrategy(
+    std::optional<ObliviousAccessStrategy> strategy, bool isInsert,
+    int64_t size, Type elementType, ObliviousAccessCostModel costModel);
+
+// Measures an access at `index` that was rewritten to the ops in [begin, end):
+// the number of those ops that depend on the index, counting the body of an
+// affine.for with a constant trip count once per iteration, and the length of
+// the longest chain of such ops.
+ObliviousAccessCost measureObliviousAccess(Block::iterator begin,
+                                           Block::iterator end, Value index);
+
+// Builds the element of the 1D `tensor` at `index` with the MuxTree strategy.
+Value buildMuxTreeExtract(ImplicitLocOpBuilder &b, Value tensor, Value index);
+
+// Builds the element of the 1D `tensor` at `index` with the MaskReduce
+// strategy.
+Value buildMaskReduceExtract(ImplicitLocOpBuilder &b, Value tensor,
+                             Value index);
+
+// Builds the 1D `tensor` with `scalar` inserted at `index`, with the MuxTree
+// strategy.
+Value buildMuxTreeInsert(ImplicitLocOpBuilder &b, Value scalar, Value tensor,
+                         Value index);
+
+// Builds the 1D `tensor` with `scalar` inserted at `index`, with the
+// MaskReduce strategy.
+Value buildMaskReduceInsert(ImplicitLocOpBuilder &b, Value scalar,
+                            Value tensor, Value index);
+
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_UTILS_OBLIVIOUSACCESS_H_
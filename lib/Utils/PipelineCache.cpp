@@ -0,0 +1,372 @@
+#include "lib/Utils/PipelineCache.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "llvm/include/llvm/ADT/DenseMap.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/DenseSet.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"            // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallString.h"          // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"          // from @llvm-project
+#include "llvm/include/llvm/ADT/StringExtras.h"         // from @llvm-project
+#include "llvm/include/llvm/ADT/StringSet.h"            // from @llvm-project
+#include "llvm/include/llvm/ADT/Twine.h"                // from @llvm-project
+#include "llvm/include/llvm/Support/Debug.h"            // from @llvm-project
+#include "llvm/include/llvm/Support/FileSystem.h"       // from @llvm-project
+#include "llvm/include/llvm/Support/Path.h"             // from @llvm-project
+#include "llvm/include/llvm/Support/SHA256.h"           // from @llvm-project
+#include "llvm/include/llvm/Support/raw_ostream.h"      // from @llvm-project
+#include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/AttrTypeSubElements.h"   // from @llvm-project
+#include "mlir/include/mlir/IR/Builders.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinAttributes.h"     // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinOps.h"            // from @llvm-project
+#include "mlir/include/mlir/IR/Diagnostics.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/DialectRegistry.h"       // from @llvm-project
+#include "mlir/include/mlir/IR/Location.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"             // from @llvm-project
+#include "mlir/include/mlir/IR/OperationSupport.h"      // from @llvm-project
+#include "mlir/include/mlir/IR/OwningOpRef.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/SymbolTable.h"           // from @llvm-project
+#include "mlir/include/mlir/Parser/Parser.h"            // from @llvm-project
+#include "mlir/include/mlir/Pass/Pass.h"                // from @llvm-project
+#include "mlir/include/mlir/Pass/PassManager.h"         // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"             // from @llvm-project
+#include "mlir/include/mlir/Support/TypeID.h"           // from @llvm-project
+
+#define DEBUG_TYPE "pipeline-cache"
+
+namespace mlir {
+namespace heir {
+
+namespace {
+
+// Returns the top-level ops of `moduleOp` needed to compile `funcOp` on its
+// own: the functions it transitively calls, including itself, and all
+// function declarations and non-function ops, in module order. Declarations
+// are kept even if `funcOp` does not call them, so that they survive the merge
+// of the compiled units.
+SmallVector<Operation *> getCompilationUnit(ModuleOp moduleOp,
+                                            SymbolTable &symbolTable,
+                                            func::FuncOp funcOp) {
+  DenseSet<Operation *> functions;
+  SmallVector<Operation *> worklist;
+  functions.insert(funcOp);
+  worklist.push_back(funcOp);
+  while (!worklist.empty()) {
+    Operation *op = worklist.pop_back_val();
+    auto uses = SymbolTable::getSymbolUses(op);
+    if (!uses.has_value()) continue;
+    for (const SymbolTable::SymbolUse &use : *uses) {
+      Operation *symbol =
+          symbolTable.lookup(use.getSymbolRef().getRootReference());
+      if (isa_and_nonnull<func::FuncOp>(symbol) &&
+          functions.insert(symbol).second) {
+        worklist.push_back(symbol);
+      }
+    }
+  }
+
+  SmallVector<Operation *> unit;
+  for (Operation &op : moduleOp.getBody()->getOperations()) {
+    auto otherFuncOp = dyn_cast<func::FuncOp>(op);
+    if (!otherFuncOp || otherFuncOp.isDeclaration() ||
+        functions.contains(&op)) {
+      unit.push_back(&op);
+    }
+  }
+  return unit;
+}
+
+constexpr StringLiteral kLocationPlaceholderPrefix = "heir-pipeline-cache:";
+
+// Replaces each location in `unit` by a placeholder holding its index in the
+// returned list of original locations. The ops created by the pipeline derive
+// their locations from the placeholders, so a compiled unit can be reused for
+// an input that only differs in its locations once the placeholders are
+// replaced back by restoreLocations. The placeholders are name locations
+// wrapping the original location, which diagnostics still point to.
+SmallVector<Location> abstractLocations(ModuleOp unit) {
+  SmallVector<Location> locations;
+  DenseMap<Location, unsigned> indices;
+  auto getPlaceholder = [&](Location loc) -> Location {
+    auto [it, inserted] = indices.insert({loc, locations.size()});
+    if (inserted) locations.push_back(loc);
+    return NameLoc::get(
+        StringAttr::get(unit.getContext(), kLocationPlaceholderPrefix +
+                                               llvm::Twine(it->second)),
+        loc);
+  };
+  unit->walk([&](Operation *op) {
+    op->setLoc(getPlaceholder(op->getLoc()));
+    for (Region &region : op->getRegions()) {
+      for (Block &block : region) {
+        for (BlockArgument arg : block.getArguments()) {
+          arg.setLoc(getPlaceholder(arg.getLoc()));
+        }
+      }
+    }
+  });
+  return locations;
+}
+
+// Replaces the placeholders created by abstractLocations in `unit`, which may
+// have been compiled from an input with other locations, by `locations`.
+void restoreLocations(ModuleOp unit, ArrayRef<Location> locations) {
+  AttrTypeReplacer replacer;
+  replacer.addReplacement([&](NameLoc loc) -> std::optional<Attribute> {
+    StringRef name = loc.getName().getValue();
+    unsigned index;
+    if (!name.consume_front(kLocationPlaceholderPrefix) ||
+        name.getAsInteger(10, index) || index >= locations.size()) {
+      return std::nullopt;
+    }
+    return LocationAttr(locations[index]);
+  });
+  replacer.recursivelyReplaceElementsIn(unit, /*replaceAttrs=*/true,
+                                        /*replaceLocs=*/true,
+                                        /*replaceTypes=*/false);
+}
+
+// Returns the name of an attribute that does not have the same value in `lhs`
+// and `rhs`, including one that is missing from either, or null if there is
+// none.
+StringAttr getConflictingAttrName(DictionaryAttr lhs, DictionaryAttr rhs) {
+  if (lhs == rhs) return nullptr;
+  for (NamedAttribute attr : lhs) {
+    if (rhs.get(attr.getName()) != attr.getValue()) return attr.getName();
+  }
+  for (NamedAttribute attr : rhs) {
+    if (lhs.get(attr.getName()) != attr.getValue()) return attr.getName();
+  }
+  return nullptr;
+}
+
+std::string printWithoutLocations(Operation *op) {
+  std::string text;
+  llvm::raw_string_ostream os(text);
+  op->print(os, OpPrintingFlags().enableDebugInfo(false));
+  return text;
+}
+
+// Runs a pipeline on each function of a module separately, memoizing the
+// compiled modules in a cache directory.
+class PipelineCachePass
+    : public PassWrapper<PipelineCachePass, OperationPass<ModuleOp>> {
+ public:
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(PipelineCachePass)
+
+  PipelineCachePass(OpPassManager pipeline, StringRef cacheDir,
+                    std::string keyPrefix, PipelineCacheStatistics &statistics)
+      : pipeline(std::move(pipeline)),
+        cacheDir(cacheDir.str()),
+        keyPrefix(std::move(keyPrefix)),
+        statistics(statistics) {}
+
+  StringRef getArgument() const final { return "heir-pipeline-cache"; }
+
+  StringRef getDescription() const final {
+    return "Run a pipeline per function, reusing cached results";
+  }
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    pipeline.getDependentDialects(registry);
+  }
+
+  void runOnOperation() override;
+
+ private:
+  // Returns the compiled form of `unit`, from the cache if possible.
+  FailureOr<OwningOpRef<ModuleOp>> compile(OwningOpRef<ModuleOp> unit);
+
+  std::string getCacheKey(ModuleOp unit);
+  void writeCacheEntry(StringRef path, ModuleOp result);
+
+  OpPassManager pipeline;
+  std::string cacheDir;
+  std::string keyPrefix;
+  PipelineCacheStatistics &statistics;
+};
+
+std::string PipelineCachePass::getCacheKey(ModuleOp unit) {
+  // Locations are left out, so that edits to other functions do not
+  // invalidate the entry. The entries hold placeholder locations, which are
+  // replaced by those of the input after loading.
+  llvm::SHA256 hasher;
+  hasher.update(keyPrefix);
+  hasher.update(printWithoutLocations(unit));
+  return llvm::toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+void PipelineCachePass::writeCacheEntry(StringRef path, ModuleOp result) {
+  // Write to a temporary file first, so that concurrent compilations never
+  // read a partially written entry.
+  int fd;
+  SmallString<128> tempPath;
+  if (llvm::sys::fs::createUniqueFile(
+          llvm::Twine(cacheDir) + "/tmp-%%%%%%%%.mlir", fd, tempPath)) {
+    ++statistics.writeFailures;
+    return;
+  }
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    result->print(
+        os, OpPrintingFlags().enableDebugInfo().printGenericOpForm());
+  }
+  if (llvm::sys::fs::rename(tempPath, path)) {
+    llvm::sys::fs::remove(tempPath);
+    ++statistics.writeFailures;
+  }
+}
+
+FailureOr<OwningOpRef<ModuleOp>> PipelineCachePass::compile(
+    OwningOpRef<ModuleOp> unit) {
+  SmallString<128> path(cacheDir);
+  llvm::sys::path::append(path, getCacheKey(*unit) + ".mlir");
+
+  if (llvm::sys::fs::exists(path)) {
+    ParserConfig config(&getContext());
+    OwningOpRef<ModuleOp> cached = parseSourceFile<ModuleOp>(path, config);
+    if (cached) {
+      LLVM_DEBUG(llvm::dbgs() << "Pipeline cache hit: " << path << "\n");
+      ++statistics.hits;
+      return cached;
+    }
+    LLVM_DEBUG(llvm::dbgs() << "Ignoring malformed cache entry " << path
+                            << "\n");
+  }
+  ++statistics.misses;
+
+  // Dynamic pipelines may only run on ops nested under the current op, so the
+  // unit is compiled inside the module and taken out again afterwards.
+  ModuleOp unitOp = unit.release();
+  getOperation().getBody()->push_back(unitOp);
+  LogicalResult result = runPipeline(pipeline, unitOp);
+  unitOp->remove();
+  OwningOpRef<ModuleOp> compiled(unitOp);
+  if (failed(result)) {
+    return failure();
+  }
+
+  writeCacheEntry(path, *compiled);
+  return compiled;
+}
+
+void PipelineCachePass::runOnOperation() {
+  ModuleOp moduleOp = getOperation();
+  SmallVector<func::FuncOp> funcOps;
+  for (auto funcOp : moduleOp.getOps<func::FuncOp>()) {
+    if (!funcOp.isDeclaration()) funcOps.push_back(funcOp);
+  }
+  if (funcOps.empty()) {
+    if (failed(runPipeline(pipeline, moduleOp))) signalPassFailure();
+    return;
+  }
+
+  SymbolTable symbolTable(moduleOp);
+  SmallVector<OwningOpRef<ModuleOp>> results;
+  for (func::FuncOp funcOp : funcOps) {
+    OwningOpRef<ModuleOp> unit(
+        cast<ModuleOp>(moduleOp->cloneWithoutRegions()));
+    unit->getBodyRegion().emplaceBlock();
+    OpBuilder builder = OpBuilder::atBlockEnd(unit->getBody());
+    for (Operation *op : getCompilationUnit(moduleOp, symbolTable, funcOp)) {
+      builder.clone(*op);
+    }
+
+    SmallVector<Location> locations = abstractLocations(*unit);
+    auto result = compile(std::move(unit));
+    if (failed(result)) {
+      funcOp.emitError() << "failed to compile function with the pipeline";
+      signalPassFailure();
+      return;
+    }
+    restoreLocations(*result.value(), locations);
+    results.push_back(std::move(result.value()));
+  }
+
+  // The module attributes must be the same in all units. They replace those
+  // of the input, so that the attributes removed by the pipeline are dropped.
+  DictionaryAttr attributes = results.front().get()->getAttrDictionary();
+  for (const auto &[result, funcOp] : llvm::zip(results, funcOps)) {
+    StringAttr conflict =
+        getConflictingAttrName(attributes, result.get()->getAttrDictionary());
+    if (conflict) {
+      funcOp.emitError()
+          << "compiling functions separately sets conflicting values for "
+             "module attribute "
+          << conflict
+          << "; the pipeline cache only supports pipelines that compile "
+             "functions independently";
+      signalPassFailure();
+      return;
+    }
+  }
+
+  // Replace the body of the module with the compiled units. Functions shared
+  // between units are taken from the first unit containing them. The other
+  // top-level ops are kept once per distinct op, so that those a unit adds or
+  // rewrites differently are not lost.
+  moduleOp.getBody()->clear();
+  moduleOp->setAttrs(attributes);
+  llvm::StringSet<> symbols;
+  llvm::StringSet<> nonSymbolOps;
+  for (OwningOpRef<ModuleOp> &result : results) {
+    for (Operation &op : llvm::make_early_inc_range(
+             result.get().getBody()->getOperations())) {
+      StringAttr name = SymbolTable::getSymbolName(&op);
+      bool isNew =
+          name ? symbols.insert(name.getValue()).second
+               : nonSymbolOps.insert(printWithoutLocations(&op)).second;
+      if (!isNew) continue;
+      op.remove();
+      moduleOp.getBody()->push_back(&op);
+    }
+  }
+}
+
+}  // namespace
+
+void PipelineCacheStatistics::print(llvm::raw_ostream &os,
+                                    StringRef cacheDir) const {
+  os << "Pipeline cache " << cacheDir << ": " << hits << " hits, " << misses
+     << " misses";
+  if (writeFailures > 0) {
+    os << ", " << writeFailures << " failed writes";
+  }
+  os << "\n";
+}
+
+LogicalResult setupPipelineCache(PassManager &pm, StringRef cacheDir,
+                                 StringRef toolFingerprint,
+                                 PipelineCacheStatistics &statistics) {
+  if (std::error_code ec = llvm::sys::fs::create_directories(cacheDir)) {
+    return emitError(UnknownLoc::get(pm.getContext()))
+           << "failed to create pipeline cache directory " << cacheDir << ": "
+           << ec.message();
+  }
+  if (pm.getOpAnchorName() != ModuleOp::getOperationName() &&
+      pm.getOpAnchorName() != OpPassManager::getAnyOpAnchorName()) {
+    return emitError(UnknownLoc::get(pm.getContext()))
+           << "the pipeline cache requires a pipeline on builtin.module";
+  }
+
+  std::string keyPrefix;
+  llvm::raw_string_ostream os(keyPrefix);
+  os << toolFingerprint << "\n";
+  pm.printAsTextualPipeline(os);
+  os << "\n";
+
+  OpPassManager pipeline(pm);
+  pm.clear();
+  pm.addPass(std::make_unique<PipelineCachePass>(
+      std::move(pipeline), cacheDir, std::move(keyPrefix), statistics));
+  return success();
+}
+
+}  // namespace heir
+}  // namespace mlir
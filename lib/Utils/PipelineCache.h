@@ -0,0 +1,46 @@
+#ifndef LIB_UTILS_PIPELINECACHE_H_
+#define LIB_UTILS_PIPELINECACHE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "llvm/include/llvm/ADT/StringRef.h"        // from @llvm-project
+#include "llvm/include/llvm/Support/raw_ostream.h"  // from @llvm-project
+#include "mlir/include/mlir/Pass/PassManager.h"     // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"         // from @llvm-project
+
+namespace mlir {
+namespace heir {
+
+// Counters of the per-function pipeline cache, accumulated over all the
+// pipelines run by one invocation of heir-opt.
+struct PipelineCacheStatistics {
+  int64_t hits = 0;
+  int64_t misses = 0;
+  int64_t writeFailures = 0;
+
+  void print(llvm::raw_ostream &os, StringRef cacheDir) const;
+};
+
+// Replaces the passes of `pm` with a single pass that runs them separately on
+// each function of the module, reusing the output stored in `cacheDir` by a
+// previous run for every function whose IR is unchanged.
+//
+// Each function is compiled in a module of its own, alongside the functions it
+// (transitively) calls, the function declarations and the other non-function
+// ops of the module, and the resulting modules are merged back. The cache is
+// thus only sound for pipelines that compile functions independently, and the
+// merge fails unless all the compiled modules have the same attributes.
+//
+// The cache key is a hash of the function's module (without locations), the
+// textual pass pipeline and `toolFingerprint`, which identifies the heir-opt
+// build. The locations of a reused result are remapped to those of the
+// current input.
+LogicalResult setupPipelineCache(PassManager &pm, StringRef cacheDir,
+                                 StringRef toolFingerprint,
+                                 PipelineCacheStatistics &statistics);
+
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_UTILS_PIPELINECACHE_H_
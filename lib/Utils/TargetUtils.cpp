@@ -7,9 +7,12 @@
 #include <numeric>
 #include <string>
 
+#include "llvm/include/llvm/ADT/TypeSwitch.h"            // from @llvm-project
 #include "llvm/include/llvm/Support/FormatVariadic.h"    // from @llvm-project
+#include "llvm/include/llvm/Support/raw_ostream.h"       // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinTypeInterfaces.h"  // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinTypes.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/Location.h"               // from @llvm-project
 #include "mlir/include/mlir/IR/TypeRange.h"              // from @llvm-project
 #include "mlir/include/mlir/IR/Types.h"                  // from @llvm-project
 #include "mlir/include/mlir/IR/Value.h"                  // from @llvm-project
@@ -103,5 +106,41 @@ int64_t flattenedIndex(MemRefType memRefType, ValueRange indices,
   return index;
 }
 
+std::string locationToSourceString(Location loc) {
+  std::string result =
+      llvm::TypeSwitch<LocationAttr, std::string>(loc)
+          .Case<FileLineColLoc>([](FileLineColLoc fileLoc) {
+            return llvm::formatv("{0}:{1}:{2}",
+                                 fileLoc.getFilename().getValue(),
+                                 fileLoc.getLine(), fileLoc.getColumn())
+                .str();
+          })
+          .Case<NameLoc>([](NameLoc nameLoc) {
+            return locationToSourceString(nameLoc.getChildLoc());
+          })
+          .Case<CallSiteLoc>([](CallSiteLoc callSiteLoc) {
+            return locationToSourceString(callSiteLoc.getCallee());
+          })
+          .Case<FusedLoc>([](FusedLoc fusedLoc) -> std::string {
+            if (fusedLoc.getLocations().empty()) return "unknown";
+            return locationToSourceString(fusedLoc.getLocations().front());
+          })
+          .Case<UnknownLoc>([](UnknownLoc) { return std::string("unknown"); })
+          .Default([](LocationAttr locAttr) {
+            std::string str;
+            llvm::raw_string_ostream os(str);
+            locAttr.print(os);
+            return str;
+          });
+
+  for (char &c : result) {
+    if (c == '"' || c == '\\' || c == ';' || c == ' ' || c == '\t' ||
+        c == '\n') {
+      c = '_';
+    }
+  }
+  return result;
+}
+
 }  // namespace heir
 }  // namespace mlir
@@ -8,6 +8,7 @@
 
 #include "mlir/include/mlir/IR/BuiltinTypeInterfaces.h"  // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinTypes.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/Location.h"               // from @llvm-project
 #include "mlir/include/mlir/IR/TypeRange.h"              // from @llvm-project
 #include "mlir/include/mlir/IR/Types.h"                  // from @llvm-project
 #include "mlir/include/mlir/IR/Value.h"                  // from @llvm-project
@@ -63,6 +64,11 @@ int64_t flattenedIndex(ShapedType type, ValueRange indices,
 int64_t flattenedIndex(MemRefType memRefType, ValueRange indices,
                        std::function<int64_t(Value)> valueToInt);
 
+// Returns a short, single-token string describing a source location, e.g.,
+// "foo.mlir:12:5", suitable for embedding in a string literal of generated
+// code. Quotes, backslashes, whitespace and semicolons are replaced by '_'.
+std::string locationToSourceString(Location loc);
+
 }  // namespace heir
 }  // namespace mlir
 
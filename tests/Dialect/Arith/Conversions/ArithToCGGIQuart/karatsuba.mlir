@@ -0,0 +1,46 @@
+// RUN: heir-opt --arith-to-cggi-quart=limb-width=4 --mlir-pass-statistics %s 2>&1 | FileCheck %s --check-prefix=KARATSUBA
+// RUN: heir-opt --arith-to-cggi-quart --mlir-pass-statistics %s 2>&1 | FileCheck %s --check-prefix=SCHOOLBOOK
+
+// With 4 bit limbs, the sums of limb products fit in the 16 bit storage, so
+// the products use Karatsuba's algorithm: 9, 27 and 81 cggi.mul for 4, 8 and
+// 16 limbs, and one carry per limb.
+
+// KARATSUBA: func.func @mul16
+// KARATSUBA-SAME: -> tensor<4x!lwe.lwe_ciphertext
+// KARATSUBA: func.func @mul32
+// KARATSUBA-SAME: -> tensor<8x!lwe.lwe_ciphertext
+// KARATSUBA: func.func @mul64
+// KARATSUBA-SAME: -> tensor<16x!lwe.lwe_ciphertext
+
+// KARATSUBA: ArithToCGGIQuart
+// KARATSUBA-DAG: (S) 198 bootstrap ops
+// KARATSUBA-DAG: (S) 117 mul ops
+
+// With 8 bit limbs, a single limb product fills the storage, so the products
+// use schoolbook multiplication and extract carries early.
+
+// SCHOOLBOOK: func.func @mul16
+// SCHOOLBOOK-SAME: -> tensor<2x!lwe.lwe_ciphertext
+// SCHOOLBOOK: func.func @mul32
+// SCHOOLBOOK-SAME: -> tensor<4x!lwe.lwe_ciphertext
+// SCHOOLBOOK: func.func @mul64
+// SCHOOLBOOK-SAME: -> tensor<8x!lwe.lwe_ciphertext
+
+// SCHOOLBOOK: ArithToCGGIQuart
+// SCHOOLBOOK-DAG: (S) 204 bootstrap ops
+// SCHOOLBOOK-DAG: (S) 49 mul ops
+
+func.func @mul16(%arg0: i16, %arg1: i16) -> i16 {
+  %0 = arith.muli %arg0, %arg1 : i16
+  return %0 : i16
+}
+
+func.func @mul32(%arg0: i32, %arg1: i32) -> i32 {
+  %0 = arith.muli %arg0, %arg1 : i32
+  return %0 : i32
+}
+
+func.func @mul64(%arg0: i64, %arg1: i64) -> i64 {
+  %0 = arith.muli %arg0, %arg1 : i64
+  return %0 : i64
+}
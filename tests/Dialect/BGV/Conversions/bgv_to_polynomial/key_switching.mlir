@@ -0,0 +1,64 @@
+// RUN: heir-opt --mlir-print-local-scope --bgv-to-lwe --lwe-to-polynomial=key-switching-digit-bits=16 %s | FileCheck %s
+
+!Zq = !mod_arith.int<94391809 : i64>
+!Zq0 = !mod_arith.int<7681 : i64>
+!Zt = !mod_arith.int<17 : i64>
+
+#ring_t = #polynomial.ring<coefficientType = !Zt, polynomialModulus = <1 + x**8>>
+#ring_q = #polynomial.ring<coefficientType = !Zq, polynomialModulus = <1 + x**8>>
+#ring_q0 = #polynomial.ring<coefficientType = !Zq0, polynomialModulus = <1 + x**8>>
+
+#key = #lwe.key<>
+#chain_C0 = #lwe.modulus_chain<elements = <7681 : i64, 12289 : i64>, current = 0>
+#chain_C1 = #lwe.modulus_chain<elements = <7681 : i64, 12289 : i64>, current = 1>
+
+// Dropping 12289 = 15 mod 17 multiplies the message by 15^-1 = 8 mod 17.
+#pt_space = #lwe.plaintext_space<ring = #ring_t, encoding = #lwe.full_crt_packing_encoding<scaling_factor = 1>>
+#pt_space_switched = #lwe.plaintext_space<ring = #ring_t, encoding = #lwe.full_crt_packing_encoding<scaling_factor = 8>>
+
+#ct_space = #lwe.ciphertext_space<ring = #ring_q, encryption_type = lsb>
+#ct_space_D3 = #lwe.ciphertext_space<ring = #ring_q, encryption_type = lsb, size = 3>
+#ct_space_q0 = #lwe.ciphertext_space<ring = #ring_q0, encryption_type = lsb>
+
+!ct = !lwe.new_lwe_ciphertext<application_data = <message_type = i16>, plaintext_space = #pt_space, ciphertext_space = #ct_space, key = #key, modulus_chain = #chain_C1>
+!ct_D3 = !lwe.new_lwe_ciphertext<application_data = <message_type = i16>, plaintext_space = #pt_space, ciphertext_space = #ct_space_D3, key = #key, modulus_chain = #chain_C1>
+!ct_q0 = !lwe.new_lwe_ciphertext<application_data = <message_type = i16>, plaintext_space = #pt_space_switched, ciphertext_space = #ct_space_q0, key = #key, modulus_chain = #chain_C0>
+
+// CHECK-NOT: bgv.
+// CHECK: func.func @test_key_switching
+// CHECK-SAME: %[[X:[^:]*]]: tensor<2x!polynomial.polynomial<{{.*}}94391809
+// CHECK-SAME: %[[KEYS:[^:]*]]: tensor<2x2x2x!polynomial.polynomial<{{.*}}94391809{{.*}}>> {lwe.key_switching_keys = array<i64: 0, 5>}
+// CHECK-SAME: -> tensor<2x!polynomial.polynomial<{{.*}}7681
+func.func @test_key_switching(%x : !ct) -> !ct_q0 {
+  %mul = bgv.mul %x, %x : (!ct, !ct) -> !ct_D3
+
+  // The s^2 component is split into two 16-bit digits.
+  // CHECK: [[INTS:%.+]] = mod_arith.extract
+  // CHECK: [[MASK:%.+]] = arith.constant dense<65535> : tensor<8xi64>
+  // CHECK: arith.andi [[INTS]], [[MASK]]
+  // CHECK: [[SHIFT:%.+]] = arith.constant dense<16> : tensor<8xi64>
+  // CHECK: [[HIGH:%.+]] = arith.shrui [[INTS]], [[SHIFT]]
+  // CHECK: arith.andi [[HIGH]], [[MASK]]
+  // CHECK: tensor.extract %[[KEYS]][
+  // CHECK: polynomial.mul
+  // CHECK: polynomial.add
+  // CHECK: tensor.from_elements
+  %relin = bgv.relinearize %mul {from_basis = array<i32: 0, 1, 2>, to_basis = array<i32: 0, 1>} : !ct_D3 -> !ct
+
+  // A rotation by one slot maps X to X^5.
+  // CHECK: arith.constant dense<[0, 5, 2, 7, 4, 1, 6, 3]> : tensor<8xindex>
+  // CHECK: arith.constant dense<[false, true, true, false, false, false, true, true]> : tensor<8xi1>
+  // CHECK: tensor.generate
+  // CHECK: mod_arith.sub
+  // CHECK: arith.select
+  // CHECK: tensor.yield
+  // CHECK: tensor.extract %[[KEYS]][
+  %rotate = bgv.rotate_cols %relin { offset = 1 } : !ct
+
+  // CHECK: arith.constant dense<12289> : tensor<8xi64>
+  // CHECK: arith.divui
+  // CHECK: arith.remui
+  // CHECK: mod_arith.encapsulate {{.*}} -> tensor<8x!mod_arith.int<7681 : i64>>
+  %switched = bgv.modulus_switch %rotate {to_ring = #ring_q0} : !ct -> !ct_q0
+  return %switched : !ct_q0
+}
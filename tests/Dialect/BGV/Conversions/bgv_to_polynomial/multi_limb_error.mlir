@@ -0,0 +1,32 @@
+// RUN: heir-opt --bgv-to-lwe --lwe-to-polynomial --verify-diagnostics %s
+
+// Key switching and modulus switching only lower on single-modulus rings, so
+// a ring with two RNS limbs fails the pass.
+
+!Z1095233372161_i64_ = !mod_arith.int<1095233372161 : i64>
+!Z1032955396097_i64_ = !mod_arith.int<1032955396097 : i64>
+!Z65537_i64_ = !mod_arith.int<65537 : i64>
+
+!rns_L1_ = !rns.rns<!Z1095233372161_i64_, !Z1032955396097_i64_>
+
+#ring_Z65537_i64_1_x32_ = #polynomial.ring<coefficientType = !Z65537_i64_, polynomialModulus = <1 + x**32>>
+#ring_rns_L1_1_x32_ = #polynomial.ring<coefficientType = !rns_L1_, polynomialModulus = <1 + x**32>>
+
+#full_crt_packing_encoding = #lwe.full_crt_packing_encoding<scaling_factor = 0>
+#key = #lwe.key<>
+
+#modulus_chain_L1_C1_ = #lwe.modulus_chain<elements = <1095233372161 : i64, 1032955396097 : i64>, current = 1>
+
+#plaintext_space = #lwe.plaintext_space<ring = #ring_Z65537_i64_1_x32_, encoding = #full_crt_packing_encoding>
+
+#ciphertext_space_L1_ = #lwe.ciphertext_space<ring = #ring_rns_L1_1_x32_, encryption_type = lsb>
+
+!ct = !lwe.new_lwe_ciphertext<application_data = <message_type = tensor<32xi16>>, plaintext_space = #plaintext_space, ciphertext_space = #ciphertext_space_L1_, key = #key, modulus_chain = #modulus_chain_L1_C1_>
+
+module {
+  // expected-error@below {{requires single-modulus ciphertext rings}}
+  func.func @rotate(%arg0: !ct) -> !ct {
+    %0 = bgv.rotate_cols %arg0 { offset = 1 } : !ct
+    return %0 : !ct
+  }
+}
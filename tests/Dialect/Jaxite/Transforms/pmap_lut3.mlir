@@ -0,0 +1,65 @@
+// RUN: heir-opt --jaxite-pmap-lut3 %s | FileCheck %s
+// RUN: heir-opt --jaxite-pmap-lut3=parallelism=2 %s | FileCheck %s --check-prefix=PAR2
+
+!sks = !jaxite.server_key_set
+!params = !jaxite.params
+#encoding = #lwe.unspecified_bit_field_encoding<cleartext_bitwidth = 3>
+!ct = !lwe.lwe_ciphertext<encoding = #encoding>
+
+// CHECK-LABEL: func @two_levels
+// CHECK-SAME: (%[[a:.*]]: !lwe.lwe_ciphertext<{{.*}}>, %[[b:.*]]: !lwe.lwe_ciphertext<{{.*}}>, %[[c:.*]]: !lwe.lwe_ciphertext<{{.*}}>, %[[sks:.*]]: !jaxite.server_key_set, %[[params:.*]]: !jaxite.params)
+// CHECK-NOT: jaxite.lut3 %
+// CHECK: %[[args0:.*]] = jaxite.lut3_args %[[a]], %[[b]], %[[c]]
+// CHECK: %[[args1:.*]] = jaxite.lut3_args %[[c]], %[[b]], %[[a]]
+// CHECK: %[[args2:.*]] = jaxite.lut3_args %[[a]], %[[a]], %[[b]]
+// CHECK: %[[tuples:.*]] = tensor.from_elements %[[args0]], %[[args1]], %[[args2]]
+// CHECK: %[[level0:.*]] = jaxite.pmap_lut3 %[[tuples]], %[[sks]], %[[params]]
+// CHECK-SAME: -> tensor<3x!lwe.lwe_ciphertext
+// CHECK: %[[v0:.*]] = tensor.extract %[[level0]]
+// CHECK: %[[v1:.*]] = tensor.extract %[[level0]]
+// CHECK: %[[v2:.*]] = tensor.extract %[[level0]]
+// CHECK: jaxite.lut3_args %[[v0]], %[[v1]], %[[c]]
+// CHECK: jaxite.lut3_args %[[v1]], %[[v2]], %[[a]]
+// CHECK: %[[level1:.*]] = jaxite.pmap_lut3
+// CHECK-SAME: -> tensor<2x!lwe.lwe_ciphertext
+// CHECK-NOT: jaxite.lut3 %
+// CHECK: return
+
+// The third op of the first level is left alone with parallelism=2.
+// PAR2-LABEL: func @two_levels
+// PAR2: jaxite.pmap_lut3
+// PAR2-SAME: -> tensor<2x!lwe.lwe_ciphertext
+// PAR2: jaxite.lut3 %
+// PAR2: jaxite.pmap_lut3
+// PAR2-SAME: -> tensor<2x!lwe.lwe_ciphertext
+// PAR2-NOT: jaxite.pmap_lut3
+func.func @two_levels(%a: !ct, %b: !ct, %c: !ct, %sks: !sks, %params: !params) -> (!ct, !ct) {
+  %tt0 = arith.constant 8 : i8
+  %tt1 = arith.constant 6 : i8
+  %0 = jaxite.lut3 %a, %b, %c, %tt0, %sks, %params : (!ct, !ct, !ct, i8, !sks, !params) -> !ct
+  %1 = jaxite.lut3 %c, %b, %a, %tt1, %sks, %params : (!ct, !ct, !ct, i8, !sks, !params) -> !ct
+  %2 = jaxite.lut3 %a, %a, %b, %tt0, %sks, %params : (!ct, !ct, !ct, i8, !sks, !params) -> !ct
+  %3 = jaxite.lut3 %0, %1, %c, %tt1, %sks, %params : (!ct, !ct, !ct, i8, !sks, !params) -> !ct
+  %4 = jaxite.lut3 %1, %2, %a, %tt0, %sks, %params : (!ct, !ct, !ct, i8, !sks, !params) -> !ct
+  return %3, %4 : !ct, !ct
+}
+
+// The store of %0 comes before %1, so the two ops are not grouped even though
+// they are independent.
+
+// CHECK-LABEL: func @use_in_between
+// CHECK-NOT: jaxite.pmap_lut3
+// CHECK-COUNT-2: jaxite.lut3 %
+// CHECK-NOT: jaxite.pmap_lut3
+// CHECK: return
+func.func @use_in_between(%a: !ct, %b: !ct, %c: !ct, %sks: !sks, %params: !params) -> memref<2x!ct> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %tt = arith.constant 8 : i8
+  %alloc = memref.alloc() : memref<2x!ct>
+  %0 = jaxite.lut3 %a, %b, %c, %tt, %sks, %params : (!ct, !ct, !ct, i8, !sks, !params) -> !ct
+  memref.store %0, %alloc[%c0] : memref<2x!ct>
+  %1 = jaxite.lut3 %c, %b, %a, %tt, %sks, %params : (!ct, !ct, !ct, i8, !sks, !params) -> !ct
+  memref.store %1, %alloc[%c1] : memref<2x!ct>
+  return %alloc : memref<2x!ct>
+}
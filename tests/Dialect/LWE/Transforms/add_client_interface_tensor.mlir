@@ -0,0 +1,53 @@
+// RUN: heir-opt --lwe-add-client-interface="client-threads=4" %s | FileCheck %s
+
+!Z1095233372161_i64_ = !mod_arith.int<1095233372161 : i64>
+!Z65537_i64_ = !mod_arith.int<65537 : i64>
+
+!rns_L0_ = !rns.rns<!Z1095233372161_i64_>
+
+#ring_Z65537_i64_1_x32_ = #polynomial.ring<coefficientType = !Z65537_i64_, polynomialModulus = <1 + x**32>>
+#ring_rns_L0_1_x32_ = #polynomial.ring<coefficientType = !rns_L0_, polynomialModulus = <1 + x**32>>
+
+#full_crt_packing_encoding = #lwe.full_crt_packing_encoding<scaling_factor = 0>
+#key = #lwe.key<>
+
+#modulus_chain_L5_C0_ = #lwe.modulus_chain<elements = <1095233372161 : i64, 1032955396097 : i64, 1005037682689 : i64, 998595133441 : i64, 972824936449 : i64, 959939837953 : i64>, current = 0>
+
+#plaintext_space = #lwe.plaintext_space<ring = #ring_Z65537_i64_1_x32_, encoding = #full_crt_packing_encoding>
+
+#ciphertext_space_L0_ = #lwe.ciphertext_space<ring = #ring_rns_L0_1_x32_, encryption_type = lsb>
+
+!ct = !lwe.new_lwe_ciphertext<application_data = <message_type = tensor<32xi16>>, plaintext_space = #plaintext_space, ciphertext_space = #ciphertext_space_L0_, key = #key, modulus_chain = #modulus_chain_L5_C0_>
+
+module attributes {bgv.schemeParam = #bgv.scheme_param<logN = 13, Q = [], P = [], plaintextModulus = 65537, encryptionType = pk>, scheme.bgv} {
+  func.func @identity(%arg0: tensor<2x!ct>) -> tensor<2x!ct> {
+    return %arg0 : tensor<2x!ct>
+  }
+}
+
+// CHECK: func.func @identity__encrypt__arg0
+// CHECK-SAME: (%[[arg0:[^:]*]]: tensor<2x32xi16>,
+// CHECK-SAME: %[[sk:[^:]*]]: !lwe.new_lwe_secret_key
+// CHECK-SAME: -> tensor<2x!
+// CHECK:      %[[empty:.*]] = tensor.empty() : tensor<2x!
+// CHECK:      %[[res:.*]] = affine.for %[[i:.*]] = 0 to 2 iter_args(%[[acc:.*]] = %[[empty]])
+// CHECK:        %[[row:.*]] = tensor.extract_slice %[[arg0]][%[[i]], 0] [1, 32] [1, 1] : tensor<2x32xi16> to tensor<32xi16>
+// CHECK:        %[[pt:.*]] = lwe.rlwe_encode %[[row]]
+// CHECK:        %[[ct:.*]] = lwe.rlwe_encrypt %[[pt]], %[[sk]]
+// CHECK:        %[[ins:.*]] = tensor.insert %[[ct]] into %[[acc]][%[[i]]]
+// CHECK:        affine.yield %[[ins]]
+// CHECK:      } {lwe.client_threads = 4 : i64}
+// CHECK:      return %[[res]]
+
+// CHECK: func.func @identity__decrypt__result0
+// CHECK-SAME: (%[[arg0:[^:]*]]: tensor<2x!
+// CHECK-SAME: -> tensor<2x32xi16>
+// CHECK:      %[[empty:.*]] = tensor.empty() : tensor<2x32xi16>
+// CHECK:      %[[res:.*]] = affine.for %[[i:.*]] = 0 to 2 iter_args(%[[acc:.*]] = %[[empty]])
+// CHECK:        %[[ct:.*]] = tensor.extract %[[arg0]][%[[i]]]
+// CHECK:        %[[pt:.*]] = lwe.rlwe_decrypt %[[ct]]
+// CHECK:        %[[row:.*]] = lwe.rlwe_decode %[[pt]]
+// CHECK:        %[[ins:.*]] = tensor.insert_slice %[[row]] into %[[acc]][%[[i]], 0] [1, 32] [1, 1]
+// CHECK:        affine.yield %[[ins]]
+// CHECK:      } {lwe.client_threads = 4 : i64}
+// CHECK:      return %[[res]]
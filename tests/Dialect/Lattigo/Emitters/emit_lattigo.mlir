@@ -184,3 +184,21 @@ module attributes {scheme.bgv} {
     return %ct : !lattigo.rlwe.ciphertext
   }
 }
+
+// -----
+
+!ct = !lattigo.rlwe.ciphertext
+!pt = !lattigo.rlwe.plaintext
+!evaluator = !lattigo.bgv.evaluator
+
+// CHECK-LABEL: func test_weighted_sum_new
+// CHECK-SAME: ([[evaluator:.*]] *bgv.Evaluator, [[ct0:.*]] *rlwe.Ciphertext, [[ct1:.*]] *rlwe.Ciphertext, [[pt0:.*]] *rlwe.Plaintext, [[pt1:.*]] *rlwe.Plaintext) (*rlwe.Ciphertext)
+// CHECK: [[ct2:[^, ].*]], [[err:.*]] := [[evaluator]].MulNew([[ct0]], [[pt0]])
+// CHECK: [[err:.*]] := [[evaluator]].MulThenAdd([[ct1]], [[pt1]], [[ct2]])
+// CHECK: return [[ct2]]
+module attributes {scheme.bgv} {
+  func.func @test_weighted_sum_new(%evaluator: !evaluator, %ct0: !ct, %ct1: !ct, %pt0: !pt, %pt1: !pt) -> !ct {
+    %ct2 = lattigo.bgv.weighted_sum_new %evaluator, [%ct0, %ct1], [%pt0, %pt1] : (!evaluator, !ct, !ct, !pt, !pt) -> !ct
+    return %ct2 : !ct
+  }
+}
@@ -0,0 +1,47 @@
+// RUN: heir-translate %s --emit-lattigo --lattigo-parallel | FileCheck %s
+
+!ct = !lattigo.rlwe.ciphertext
+!evaluator = !lattigo.bgv.evaluator
+
+// CHECK: func heirShallowCopies
+// CHECK: func heirParallel(numWorkers, numTasks int, task func(worker, task int))
+
+module attributes {scheme.bgv} {
+  // CHECK-LABEL: func compute
+  // CHECK-SAME: ([[evaluator:.*]] *bgv.Evaluator, [[ct:.*]] *rlwe.Ciphertext, [[ct1:.*]] *rlwe.Ciphertext) (*rlwe.Ciphertext)
+  // CHECK-NEXT: var [[ct2:.*]] *rlwe.Ciphertext
+  // CHECK-NEXT: var [[ct3:.*]] *rlwe.Ciphertext
+  // CHECK-NEXT: [[workers:.*]] := heirShallowCopies([[evaluator]])
+  // CHECK-NEXT: heirParallel(len([[workers]]), 2, func(worker, task int) {
+  // CHECK-NEXT: switch task {
+  // CHECK-NEXT: case 0:
+  // CHECK-NEXT: var [[err0:.*]] error
+  // CHECK-NEXT: [[ct2]], [[err0]] = [[workers]][worker].RotateColumnsNew([[ct]], 1)
+  // CHECK: case 1:
+  // CHECK-NEXT: var [[err1:.*]] error
+  // CHECK-NEXT: [[ct3]], [[err1]] = [[workers]][worker].RotateColumnsNew([[ct]], 2)
+  // CHECK: })
+  // CHECK-NEXT: [[ct4:[^, ].*]], [[err2:.*]] := [[evaluator]].AddNew([[ct2]], [[ct3]])
+  // CHECK: return [[ct4]]
+  func.func @compute(%evaluator : !evaluator, %ct1 : !ct, %ct2 : !ct) -> (!ct) {
+    %rot1 = lattigo.bgv.rotate_columns_new %evaluator, %ct1 {offset = 1} : (!evaluator, !ct) -> !ct
+    %rot2 = lattigo.bgv.rotate_columns_new %evaluator, %ct1 {offset = 2} : (!evaluator, !ct) -> !ct
+    %added = lattigo.bgv.add_new %evaluator, %rot1, %rot2 : (!evaluator, !ct, !ct) -> !ct
+    return %added : !ct
+  }
+
+  // The add writes into the buffer of %ct1 while the mul reads it, so they
+  // can not run concurrently.
+
+  // CHECK-LABEL: func reuse_buffer
+  // CHECK-NOT: heirParallel
+  // CHECK: MulNew
+  // CHECK-NOT: heirParallel
+  // CHECK: .Add(
+  // CHECK: return
+  func.func @reuse_buffer(%evaluator : !evaluator, %ct1 : !ct, %ct2 : !ct) -> (!ct, !ct) {
+    %mul = lattigo.bgv.mul_new %evaluator, %ct1, %ct2 : (!evaluator, !ct, !ct) -> !ct
+    %added = lattigo.bgv.add %evaluator, %ct2, %ct2, %ct1 : (!evaluator, !ct, !ct, !ct) -> !ct
+    return %mul, %added : !ct, !ct
+  }
+}
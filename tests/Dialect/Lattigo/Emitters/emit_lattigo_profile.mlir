@@ -0,0 +1,25 @@
+// RUN: heir-translate %s --emit-lattigo --lattigo-profile-ops | FileCheck %s
+
+!ct = !lattigo.rlwe.ciphertext
+!evaluator = !lattigo.bgv.evaluator
+
+// CHECK: func heirProfileStart(
+// CHECK: func HeirProfileWriteTable(w io.Writer) {
+// CHECK: func HeirProfileWriteFolded(w io.Writer) {
+
+module attributes {scheme.bgv} {
+  // CHECK-LABEL: func compute
+  // CHECK-SAME: ([[evaluator:.*]] *bgv.Evaluator, [[ct:.*]] *rlwe.Ciphertext, [[ct1:.*]] *rlwe.Ciphertext) (*rlwe.Ciphertext)
+  // CHECK: [[T0:.*]] := heirProfileStart("compute", "lattigo.bgv.add_new", "{{.*}}emit_lattigo_profile.mlir:{{[0-9]+}}:{{[0-9]+}}", [[ct]].Level(), [[ct]].Value[0].N())
+  // CHECK-NEXT: [[ct2:[^, ].*]], [[err:.*]] := [[evaluator]].AddNew([[ct]], [[ct1]])
+  // CHECK: heirProfileStop([[T0]])
+  // CHECK-NEXT: [[T1:.*]] := heirProfileStart("compute", "lattigo.bgv.mul", "{{.*}}", [[ct2]].Level(), [[ct2]].Value[0].N())
+  // CHECK-NEXT: [[err:.*]] := [[evaluator]].Mul([[ct2]], [[ct1]], [[ct2]])
+  // CHECK: heirProfileStop([[T1]])
+  // CHECK: return [[ct2]]
+  func.func @compute(%evaluator : !evaluator, %ct1 : !ct, %ct2 : !ct) -> (!ct) {
+    %added = lattigo.bgv.add_new %evaluator, %ct1, %ct2 : (!evaluator, !ct, !ct) -> !ct
+    %mul = lattigo.bgv.mul %evaluator, %added, %ct2, %added : (!evaluator, !ct, !ct, !ct) -> !ct
+    return %mul : !ct
+  }
+}
@@ -0,0 +1,43 @@
+// RUN: heir-translate %s --emit-lattigo --lattigo-profile-ops --lattigo-parallel | FileCheck %s
+
+!ct = !lattigo.rlwe.ciphertext
+!evaluator = !lattigo.bgv.evaluator
+
+// Go requires every import to precede the other top-level declarations, so
+// the packages used by both preludes are merged into one import block.
+
+// CHECK: package
+// CHECK-NOT: import
+// CHECK: import (
+// CHECK-NEXT: "fmt"
+// CHECK-NEXT: "io"
+// CHECK-NEXT: "runtime"
+// CHECK-NEXT: "sort"
+// CHECK-NEXT: "sync"
+// CHECK-NEXT: "sync/atomic"
+// CHECK-NEXT: "time"
+// CHECK-EMPTY:
+// CHECK-NEXT: "github.com/tuneinsight/lattigo/v6/core/rlwe"
+// CHECK-NEXT: "github.com/tuneinsight/lattigo/v6/schemes/bgv"
+// CHECK-NEXT: )
+// CHECK-NOT: import
+// CHECK: func heirProfileStart(
+// CHECK-NOT: import
+// CHECK: func heirParallel(numWorkers, numTasks int, task func(worker, task int))
+// CHECK-NOT: import
+
+module attributes {scheme.bgv} {
+  // CHECK-LABEL: func compute
+  // CHECK: heirParallel(len({{.*}}), 2, func(worker, task int) {
+  // CHECK: case 0:
+  // CHECK-NEXT: heirProfileStart("compute", "lattigo.bgv.rotate_columns_new"
+  // CHECK: })
+  // CHECK: heirProfileStart("compute", "lattigo.bgv.add_new"
+  // CHECK: return
+  func.func @compute(%evaluator : !evaluator, %ct1 : !ct, %ct2 : !ct) -> (!ct) {
+    %rot1 = lattigo.bgv.rotate_columns_new %evaluator, %ct1 {offset = 1} : (!evaluator, !ct) -> !ct
+    %rot2 = lattigo.bgv.rotate_columns_new %evaluator, %ct1 {offset = 2} : (!evaluator, !ct) -> !ct
+    %added = lattigo.bgv.add_new %evaluator, %rot1, %rot2 : (!evaluator, !ct, !ct) -> !ct
+    return %added : !ct
+  }
+}
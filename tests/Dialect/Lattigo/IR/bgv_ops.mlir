@@ -101,6 +101,13 @@ module {
     return
   }
 
+  // CHECK-LABEL: func @test_bgv_weighted_sum_new
+  func.func @test_bgv_weighted_sum_new(%evaluator: !evaluator, %ct0: !ct, %ct1: !ct, %pt0: !pt, %pt1: !pt) {
+    // CHECK: %[[v1:.*]] = lattigo.bgv.weighted_sum_new
+    %output = lattigo.bgv.weighted_sum_new %evaluator, [%ct0, %ct1], [%pt0, %pt1] : (!evaluator, !ct, !ct, !pt, !pt) -> !ct
+    return
+  }
+
   // CHECK-LABEL: func @test_bgv_add
   func.func @test_bgv_add(%evaluator: !evaluator, %lhs: !ct, %rhs: !ct) {
     // CHECK: %[[v1:.*]] = lattigo.bgv.add
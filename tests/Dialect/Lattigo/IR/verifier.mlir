@@ -55,3 +55,15 @@ func.func @test_rlwe_new_encryptor_pk_input_sk(%params: !params, %pk: !pk) {
   %encryptor = lattigo.rlwe.new_encryptor %params, %pk : (!params, !pk) -> !encryptor_sk
   return
 }
+
+// -----
+
+!evaluator = !lattigo.ckks.evaluator
+!ct = !lattigo.rlwe.ciphertext
+!pt = !lattigo.rlwe.plaintext
+
+func.func @test_ckks_weighted_sum_new_mismatched_operands(%evaluator: !evaluator, %ct0: !ct, %ct1: !ct, %pt0: !pt) {
+  // expected-error@+1 {{expected as many plaintexts as ciphertexts}}
+  %output = lattigo.ckks.weighted_sum_new %evaluator, [%ct0, %ct1], [%pt0] : (!evaluator, !ct, !ct, !pt) -> !ct
+  return
+}
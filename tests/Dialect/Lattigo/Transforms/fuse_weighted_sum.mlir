@@ -0,0 +1,82 @@
+// RUN: heir-opt --lattigo-fuse-weighted-sum %s | FileCheck %s
+
+!ct = !lattigo.rlwe.ciphertext
+!encoder = !lattigo.ckks.encoder
+!evaluator = !lattigo.ckks.evaluator
+!pt = !lattigo.rlwe.plaintext
+
+// CHECK-LABEL: func.func @fuse_rescaled
+// CHECK-SAME: (%[[evaluator:.*]]: [[evaluator_ty:.*]], %[[encoder:.*]]: [[encoder_ty:.*]], %[[ct0:.*]]: [[ct_ty:.*]], %[[ct1:.*]]: [[ct_ty]], %[[ct2:.*]]: [[ct_ty]], %[[pt:.*]]: [[pt_ty:.*]], %[[v:.*]]: tensor<4xf32>)
+func.func @fuse_rescaled(%evaluator: !evaluator, %encoder: !encoder, %ct0: !ct, %ct1: !ct, %ct2: !ct, %pt: !pt, %v: tensor<4xf32>) -> !ct {
+  // CHECK: %[[pt0:.*]] = lattigo.ckks.encode
+  // CHECK: %[[pt1:.*]] = lattigo.ckks.encode
+  // CHECK: %[[pt2:.*]] = lattigo.ckks.encode
+  // CHECK: %[[sum:.*]] = lattigo.ckks.weighted_sum_new %[[evaluator]], [%[[ct0]], %[[ct1]], %[[ct2]]], [%[[pt0]], %[[pt1]], %[[pt2]]]
+  // CHECK-NEXT: %[[res:.*]] = lattigo.ckks.rescale_new %[[evaluator]], %[[sum]]
+  // CHECK-NOT: lattigo.ckks.mul_new
+  // CHECK-NOT: lattigo.ckks.add_new
+  // CHECK: return %[[res]]
+  %pt0 = lattigo.ckks.encode %encoder, %v, %pt {scale = 45 : i64} : (!encoder, tensor<4xf32>, !pt) -> !pt
+  %pt1 = lattigo.ckks.encode %encoder, %v, %pt {scale = 45 : i64} : (!encoder, tensor<4xf32>, !pt) -> !pt
+  %pt2 = lattigo.ckks.encode %encoder, %v, %pt {scale = 45 : i64} : (!encoder, tensor<4xf32>, !pt) -> !pt
+  %m0 = lattigo.ckks.mul_new %evaluator, %ct0, %pt0 : (!evaluator, !ct, !pt) -> !ct
+  %r0 = lattigo.ckks.rescale_new %evaluator, %m0 : (!evaluator, !ct) -> !ct
+  %m1 = lattigo.ckks.mul_new %evaluator, %ct1, %pt1 : (!evaluator, !ct, !pt) -> !ct
+  %r1 = lattigo.ckks.rescale_new %evaluator, %m1 : (!evaluator, !ct) -> !ct
+  %m2 = lattigo.ckks.mul_new %evaluator, %ct2, %pt2 : (!evaluator, !ct, !pt) -> !ct
+  %r2 = lattigo.ckks.rescale_new %evaluator, %m2 : (!evaluator, !ct) -> !ct
+  %s0 = lattigo.ckks.add_new %evaluator, %r0, %r1 : (!evaluator, !ct, !ct) -> !ct
+  %s1 = lattigo.ckks.add_new %evaluator, %s0, %r2 : (!evaluator, !ct, !ct) -> !ct
+  return %s1 : !ct
+}
+
+// CHECK-LABEL: func.func @fuse_with_other_addend
+// CHECK-SAME: (%[[evaluator:.*]]: [[evaluator_ty:.*]], %[[encoder:.*]]: [[encoder_ty:.*]], %[[ct0:.*]]: [[ct_ty:.*]], %[[ct1:.*]]: [[ct_ty]], %[[ct2:.*]]: [[ct_ty]], %[[pt:.*]]: [[pt_ty:.*]], %[[v:.*]]: tensor<4xf32>)
+func.func @fuse_with_other_addend(%evaluator: !evaluator, %encoder: !encoder, %ct0: !ct, %ct1: !ct, %ct2: !ct, %pt: !pt, %v: tensor<4xf32>) -> !ct {
+  // CHECK: %[[pt0:.*]] = lattigo.ckks.encode
+  // CHECK: %[[pt1:.*]] = lattigo.ckks.encode
+  // CHECK: %[[sum:.*]] = lattigo.ckks.weighted_sum_new %[[evaluator]], [%[[ct0]], %[[ct1]]], [%[[pt0]], %[[pt1]]]
+  // CHECK-NEXT: %[[res:.*]] = lattigo.ckks.add_new %[[evaluator]], %[[sum]], %[[ct2]]
+  // CHECK: return %[[res]]
+  %pt0 = lattigo.ckks.encode %encoder, %v, %pt {scale = 45 : i64} : (!encoder, tensor<4xf32>, !pt) -> !pt
+  %pt1 = lattigo.ckks.encode %encoder, %v, %pt {scale = 45 : i64} : (!encoder, tensor<4xf32>, !pt) -> !pt
+  %m0 = lattigo.ckks.mul_new %evaluator, %ct0, %pt0 : (!evaluator, !ct, !pt) -> !ct
+  %m1 = lattigo.ckks.mul_new %evaluator, %ct1, %pt1 : (!evaluator, !ct, !pt) -> !ct
+  %s0 = lattigo.ckks.add_new %evaluator, %m0, %ct2 : (!evaluator, !ct, !ct) -> !ct
+  %s1 = lattigo.ckks.add_new %evaluator, %s0, %m1 : (!evaluator, !ct, !ct) -> !ct
+  return %s1 : !ct
+}
+
+// A product used elsewhere is kept.
+// CHECK-LABEL: func.func @no_fuse_multi_use
+func.func @no_fuse_multi_use(%evaluator: !evaluator, %encoder: !encoder, %ct0: !ct, %ct1: !ct, %pt: !pt, %v: tensor<4xf32>) -> (!ct, !ct) {
+  // CHECK-NOT: lattigo.ckks.weighted_sum_new
+  %pt0 = lattigo.ckks.encode %encoder, %v, %pt {scale = 45 : i64} : (!encoder, tensor<4xf32>, !pt) -> !pt
+  %pt1 = lattigo.ckks.encode %encoder, %v, %pt {scale = 45 : i64} : (!encoder, tensor<4xf32>, !pt) -> !pt
+  %m0 = lattigo.ckks.mul_new %evaluator, %ct0, %pt0 : (!evaluator, !ct, !pt) -> !ct
+  %m1 = lattigo.ckks.mul_new %evaluator, %ct1, %pt1 : (!evaluator, !ct, !pt) -> !ct
+  %s0 = lattigo.ckks.add_new %evaluator, %m0, %m1 : (!evaluator, !ct, !ct) -> !ct
+  return %s0, %m1 : !ct, !ct
+}
+
+// Products of plaintexts encoded at different scales are kept.
+// CHECK-LABEL: func.func @no_fuse_different_scales
+func.func @no_fuse_different_scales(%evaluator: !evaluator, %encoder: !encoder, %ct0: !ct, %ct1: !ct, %pt: !pt, %v: tensor<4xf32>) -> !ct {
+  // CHECK-NOT: lattigo.ckks.weighted_sum_new
+  %pt0 = lattigo.ckks.encode %encoder, %v, %pt {scale = 45 : i64} : (!encoder, tensor<4xf32>, !pt) -> !pt
+  %pt1 = lattigo.ckks.encode %encoder, %v, %pt {scale = 90 : i64} : (!encoder, tensor<4xf32>, !pt) -> !pt
+  %m0 = lattigo.ckks.mul_new %evaluator, %ct0, %pt0 : (!evaluator, !ct, !pt) -> !ct
+  %m1 = lattigo.ckks.mul_new %evaluator, %ct1, %pt1 : (!evaluator, !ct, !pt) -> !ct
+  %s0 = lattigo.ckks.add_new %evaluator, %m0, %m1 : (!evaluator, !ct, !ct) -> !ct
+  return %s0 : !ct
+}
+
+// A plaintext whose scale is unknown is kept.
+// CHECK-LABEL: func.func @no_fuse_unknown_scale
+func.func @no_fuse_unknown_scale(%evaluator: !evaluator, %ct0: !ct, %ct1: !ct, %pt0: !pt, %pt1: !pt) -> !ct {
+  // CHECK-NOT: lattigo.ckks.weighted_sum_new
+  %m0 = lattigo.ckks.mul_new %evaluator, %ct0, %pt0 : (!evaluator, !ct, !pt) -> !ct
+  %m1 = lattigo.ckks.mul_new %evaluator, %ct1, %pt1 : (!evaluator, !ct, !pt) -> !ct
+  %s0 = lattigo.ckks.add_new %evaluator, %m0, %m1 : (!evaluator, !ct, !ct) -> !ct
+  return %s0 : !ct
+}
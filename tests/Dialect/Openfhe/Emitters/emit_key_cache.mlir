@@ -0,0 +1,58 @@
+// RUN: heir-translate %s --emit-openfhe-pke | FileCheck %s
+// RUN: heir-translate %s --emit-openfhe-pke-header | FileCheck %s --check-prefix=HEADER
+
+// HEADER: void test__save_key_pair(PublicKeyT {{.*}}, PrivateKeyT {{.*}});
+// HEADER: PrivateKeyT test__load_private_key(CryptoContextT {{.*}});
+
+// CHECK: #include "openfhe/pke/cryptocontext-ser.h"
+// CHECK: #include "openfhe/pke/key/key-ser.h"
+// CHECK: #include "openfhe/pke/scheme/ckksrns/ckksrns-ser.h"
+// CHECK: namespace heir_keys {
+// CHECK: inline void SaveCryptoContext(
+// CHECK: inline CryptoContextT LoadCryptoContext(
+// CHECK: inline void SaveKey(
+// CHECK: inline KeyT LoadKey(
+
+module attributes {scheme.ckks} {
+  // CHECK-LABEL: CryptoContextT test__configure_crypto_context(
+  // CHECK-SAME:    CryptoContextT [[CC:[^,]*]],
+  // CHECK-SAME:    PrivateKeyT [[SK:[^,]*]])
+  // CHECK:       [[CC]]->EvalMultKeyGen([[SK]]);
+  // CHECK-NEXT:  [[CC]]->EvalRotateKeyGen([[SK]], {1, 2});
+  // CHECK-NEXT:  heir_keys::SaveCryptoContext([[CC]], "/tmp/heir \"keys\"");
+  // CHECK-NEXT:  return [[CC]];
+  func.func @test__configure_crypto_context(%cc: !openfhe.crypto_context, %sk: !openfhe.private_key) -> !openfhe.crypto_context {
+    openfhe.gen_mulkey %cc, %sk : (!openfhe.crypto_context, !openfhe.private_key) -> ()
+    openfhe.gen_rotkey %cc, %sk {indices = array<i64: 1, 2>} : (!openfhe.crypto_context, !openfhe.private_key) -> ()
+    openfhe.save_crypto_context %cc {directory = "/tmp/heir \"keys\""} : (!openfhe.crypto_context) -> ()
+    return %cc : !openfhe.crypto_context
+  }
+
+  // CHECK-LABEL: CryptoContextT test__load_crypto_context()
+  // CHECK:       CryptoContextT [[LOADED:.*]] = heir_keys::LoadCryptoContext("/tmp/heir \"keys\"");
+  // CHECK-NEXT:  return [[LOADED]];
+  func.func @test__load_crypto_context() -> !openfhe.crypto_context {
+    %cc = openfhe.load_crypto_context {directory = "/tmp/heir \"keys\""} : () -> !openfhe.crypto_context
+    return %cc : !openfhe.crypto_context
+  }
+
+  // CHECK-LABEL: void test__save_key_pair(
+  // CHECK-SAME:    PublicKeyT [[PK:[^,]*]],
+  // CHECK-SAME:    PrivateKeyT [[SK:[^,)]*]])
+  // CHECK:       heir_keys::SaveKey([[PK]], "/tmp/heir_keys", heir_keys::kPublicKeyFile);
+  // CHECK-NEXT:  heir_keys::SaveKey([[SK]], "/tmp/heir_keys", heir_keys::kPrivateKeyFile);
+  // CHECK-NEXT:  return;
+  func.func @test__save_key_pair(%pk: !openfhe.public_key, %sk: !openfhe.private_key) {
+    openfhe.save_key %pk {directory = "/tmp/heir_keys"} : (!openfhe.public_key) -> ()
+    openfhe.save_key %sk {directory = "/tmp/heir_keys"} : (!openfhe.private_key) -> ()
+    return
+  }
+
+  // CHECK-LABEL: PrivateKeyT test__load_private_key(
+  // CHECK:       PrivateKeyT [[KEY:.*]] = heir_keys::LoadKey<PrivateKeyT>("/tmp/heir_keys", heir_keys::kPrivateKeyFile);
+  // CHECK-NEXT:  return [[KEY]];
+  func.func @test__load_private_key(%cc: !openfhe.crypto_context) -> !openfhe.private_key {
+    %sk = openfhe.load_key %cc {directory = "/tmp/heir_keys"} : (!openfhe.crypto_context) -> !openfhe.private_key
+    return %sk : !openfhe.private_key
+  }
+}
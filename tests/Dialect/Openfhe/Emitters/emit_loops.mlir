@@ -34,3 +34,59 @@ module attributes {scheme.ckks} {
     return %1 : !ct_L0_
   }
 }
+
+// -----
+
+!Z1095233372161_i64_ = !mod_arith.int<1095233372161 : i64>
+!Z65537_i64_ = !mod_arith.int<65537 : i64>
+
+!rns_L0_ = !rns.rns<!Z1095233372161_i64_>
+#ring_Z65537_i64_1_x32_ = #polynomial.ring<coefficientType = !Z65537_i64_, polynomialModulus = <1 + x**32>>
+#ring_rns_L0_1_x32_ = #polynomial.ring<coefficientType = !rns_L0_, polynomialModulus = <1 + x**32>>
+
+#full_crt_packing_encoding = #lwe.full_crt_packing_encoding<scaling_factor = 0>
+#key = #lwe.key<>
+
+#modulus_chain_L5_C0_ = #lwe.modulus_chain<elements = <1095233372161 : i64, 1032955396097 : i64, 1005037682689 : i64, 998595133441 : i64, 972824936449 : i64, 959939837953 : i64>, current = 0>
+
+#plaintext_space = #lwe.plaintext_space<ring = #ring_Z65537_i64_1_x32_, encoding = #full_crt_packing_encoding>
+
+#ciphertext_space_L0_ = #lwe.ciphertext_space<ring = #ring_rns_L0_1_x32_, encryption_type = lsb>
+
+!pt_L0_ = !lwe.new_lwe_plaintext<application_data = <message_type = tensor<32xi16>>, plaintext_space = #plaintext_space>
+!ct_L0_ = !lwe.new_lwe_ciphertext<application_data = <message_type = tensor<32xi16>>, plaintext_space = #plaintext_space, ciphertext_space = #ciphertext_space_L0_, key = #key, modulus_chain = #modulus_chain_L5_C0_>
+
+module attributes {scheme.bgv} {
+  // CHECK-LABEL: test_client_threads
+  // CHECK-SAME: CryptoContextT [[cc:[^,]*]], std::vector<int16_t> [[v0:[^,]*]], PublicKeyT [[pk:.*]]) {
+  // CHECK: std::vector<CiphertextT> [[empty:.*]](2);
+  // CHECK: std::vector<CiphertextT> [[res:.*]] = [[empty]];
+  // CHECK: #pragma omp parallel for num_threads(4)
+  // CHECK-NEXT: for (auto [[i:.*]] = 0; [[i]] < 2; ++[[i]]) {
+  // CHECK:   std::vector<int16_t> [[row:.*]](std::begin([[v0]]) + [[i]] * 32, std::begin([[v0]]) + [[i]] * 32 + 32);
+  // CHECK:   MakePackedPlaintext
+  // CHECK:   [[cc]]->Encrypt([[pk]]
+  // CHECK:   [[res]][[[i]]] =
+  // CHECK: }
+  // CHECK: return [[res]];
+  func.func @test_client_threads(%cc: !openfhe.crypto_context, %arg0: tensor<2x32xi16>, %pk: !openfhe.public_key) -> tensor<2x!ct_L0_> {
+    %0 = tensor.empty() : tensor<2x!ct_L0_>
+    %1 = affine.for %i = 0 to 2 iter_args(%acc = %0) -> (tensor<2x!ct_L0_>) {
+      %row = tensor.extract_slice %arg0[%i, 0] [1, 32] [1, 1] : tensor<2x32xi16> to tensor<32xi16>
+      %pt = openfhe.make_packed_plaintext %cc, %row : (!openfhe.crypto_context, tensor<32xi16>) -> !pt_L0_
+      %ct = openfhe.encrypt %cc, %pt, %pk : (!openfhe.crypto_context, !pt_L0_, !openfhe.public_key) -> !ct_L0_
+      %inserted = tensor.insert %ct into %acc[%i] : tensor<2x!ct_L0_>
+      affine.yield %inserted : tensor<2x!ct_L0_>
+    } {lwe.client_threads = 4 : i64}
+    return %1 : tensor<2x!ct_L0_>
+  }
+
+  // CHECK-LABEL: test_insert_slice
+  // CHECK-SAME: std::vector<int16_t> [[dest:[^,]*]], std::vector<int16_t> [[src:[^,]*]], size_t [[i:.*]]) {
+  // CHECK: std::copy(std::begin([[src]]), std::end([[src]]), std::begin([[dest]]) + [[i]] * 32);
+  // CHECK: return [[dest]];
+  func.func @test_insert_slice(%dest: tensor<2x32xi16>, %src: tensor<32xi16>, %i: index) -> tensor<2x32xi16> {
+    %0 = tensor.insert_slice %src into %dest[%i, 0] [1, 32] [1, 1] : tensor<32xi16> into tensor<2x32xi16>
+    return %0 : tensor<2x32xi16>
+  }
+}
@@ -182,6 +182,19 @@ module attributes {scheme.ckks} {
 
 // -----
 
+// CHECK-LABEL: test_num_large_digits
+// CHECK: SetKeySwitchTechnique(HYBRID);
+// CHECK-NEXT: SetNumLargeDigits(4);
+module attributes {scheme.ckks} {
+  func.func @test_num_large_digits() -> !openfhe.crypto_context {
+    %0 = openfhe.gen_params  {insecure = false, mulDepth = 3 : i64, plainMod = 0 : i64, evalAddCount = 0 : i64, keySwitchCount = 0 : i64, encryptionTechniqueExtended = false, numLargeDigits = 4 : i64} : () -> !openfhe.cc_params
+    %1 = openfhe.gen_context %0 {supportFHE = false} : (!openfhe.cc_params) -> !openfhe.crypto_context
+    return %1 : !openfhe.crypto_context
+  }
+}
+
+// -----
+
 !Z2147565569_i64_ = !mod_arith.int<2147565569 : i64>
 !Z65537_i64_ = !mod_arith.int<65537 : i64>
 #full_crt_packing_encoding = #lwe.full_crt_packing_encoding<scaling_factor = 0>
@@ -247,9 +260,53 @@ module attributes {scheme.ckks} {
 module attributes {scheme.ckks} {
   // CHECK-LABEL: test_extract_slice
   // CHECK-SAME: std::vector<float> [[v0:.*]], size_t [[v1:.*]]) {
-  // CHECK: std::vector<float> [[v2:.*]](std::begin([[v0]]) + [[v1]] * 1, std::end([[v0]]) + [[v1]] * 1 + 1024);
+  // CHECK: std::vector<float> [[v2:.*]](std::begin([[v0]]) + [[v1]] * 1024, std::begin([[v0]]) + [[v1]] * 1024 + 1024);
   func.func @test_extract_slice(%arg0: tensor<1x1024xf32>, %arg1: index) -> tensor<1024xf32> {
     %1 = tensor.extract_slice %arg0[%arg1, 0] [1, 1024] [1, 1] : tensor<1x1024xf32> to tensor<1024xf32>
     return %1 : tensor<1024xf32>
   }
 }
+
+// -----
+
+// 2D tensors are flattened in row-major order: a 3x4 tensor.empty is a single
+// vector of 12 elements, and row %i of a 3x4 tensor spans [%i * 4, %i * 4 + 4).
+
+module attributes {scheme.ckks} {
+  // CHECK-LABEL: test_flattened_2d_tensor
+  // CHECK-SAME: std::vector<float> [[v0:.*]], size_t [[v1:.*]]) {
+  // CHECK: std::vector<float> [[v2:.*]](12);
+  // CHECK: std::vector<float> [[v3:.*]](std::begin([[v0]]) + [[v1]] * 4, std::begin([[v0]]) + [[v1]] * 4 + 4);
+  func.func @test_flattened_2d_tensor(%arg0: tensor<3x4xf32>, %arg1: index) -> tensor<4xf32> {
+    %0 = tensor.empty() : tensor<3x4xf32>
+    %1 = tensor.extract_slice %arg0[%arg1, 0] [1, 4] [1, 1] : tensor<3x4xf32> to tensor<4xf32>
+    return %1 : tensor<4xf32>
+  }
+}
+
+// -----
+
+!Z2147565569_i64_ = !mod_arith.int<2147565569 : i64>
+!Z65537_i64_ = !mod_arith.int<65537 : i64>
+#inverse_canonical_encoding = #lwe.inverse_canonical_encoding<scaling_factor = 1024>
+#key = #lwe.key<>
+#modulus_chain_L0_C0_ = #lwe.modulus_chain<elements = <2147565569 : i64>, current = 0>
+!rns_L0_ = !rns.rns<!Z2147565569_i64_>
+#ring_Z65537_i64_1_x8_ = #polynomial.ring<coefficientType = !Z65537_i64_, polynomialModulus = <1 + x**8>>
+#plaintext_space = #lwe.plaintext_space<ring = #ring_Z65537_i64_1_x8_, encoding = #inverse_canonical_encoding>
+#ring_rns_L0_1_x8_ = #polynomial.ring<coefficientType = !rns_L0_, polynomialModulus = <1 + x**8>>
+#ciphertext_space_L0_ = #lwe.ciphertext_space<ring = #ring_rns_L0_1_x8_, encryption_type = lsb>
+!ct_L0_ = !lwe.new_lwe_ciphertext<application_data = <message_type = f32>, plaintext_space = #plaintext_space, ciphertext_space = #ciphertext_space_L0_, key = #key, modulus_chain = #modulus_chain_L0_C0_>
+
+module attributes {scheme.ckks} {
+  // CHECK-LABEL: test_linear_wsum
+  // CHECK-SAME: CryptoContextT [[CC:[^,]*]], CiphertextT [[ARG1:[^,]*]], CiphertextT [[ARG2:[^,]*]], double [[W0:[^,]*]], double [[W1:[^)]*]])
+  // CHECK-NEXT: std::vector<CiphertextT> [[v0:.*]]_cts = {[[ARG1]], [[ARG2]]};
+  // CHECK-NEXT: std::vector<double> [[v0]]_weights = {[[W0]], [[W1]]};
+  // CHECK-NEXT: const auto& [[v0]] = [[CC]]->EvalLinearWSum([[v0]]_cts, [[v0]]_weights);
+  // CHECK-NEXT: return [[v0]];
+  func.func @test_linear_wsum(%cc: !openfhe.crypto_context, %arg1: !ct_L0_, %arg2: !ct_L0_, %w0: f64, %w1: f64) -> !ct_L0_ {
+    %0 = openfhe.linear_wsum %cc, [%arg1, %arg2], [%w0, %w1] : (!openfhe.crypto_context, !ct_L0_, !ct_L0_) -> !ct_L0_
+    return %0 : !ct_L0_
+  }
+}
@@ -0,0 +1,60 @@
+// RUN: heir-translate %s --emit-openfhe-pke --openfhe-parallel-sections=2 | FileCheck %s
+
+!Z1095233372161_i64_ = !mod_arith.int<1095233372161 : i64>
+!Z65537_i64_ = !mod_arith.int<65537 : i64>
+
+!rns_L0_ = !rns.rns<!Z1095233372161_i64_>
+
+#ring_Z65537_i64_1_x32_ = #polynomial.ring<coefficientType = !Z65537_i64_, polynomialModulus = <1 + x**32>>
+#ring_rns_L0_1_x32_ = #polynomial.ring<coefficientType = !rns_L0_, polynomialModulus = <1 + x**32>>
+
+#full_crt_packing_encoding = #lwe.full_crt_packing_encoding<scaling_factor = 0>
+#key = #lwe.key<>
+
+#modulus_chain_L5_C0_ = #lwe.modulus_chain<elements = <1095233372161 : i64, 1032955396097 : i64, 1005037682689 : i64, 998595133441 : i64, 972824936449 : i64, 959939837953 : i64>, current = 0>
+
+#plaintext_space = #lwe.plaintext_space<ring = #ring_Z65537_i64_1_x32_, encoding = #full_crt_packing_encoding>
+
+#ciphertext_space_L0_ = #lwe.ciphertext_space<ring = #ring_rns_L0_1_x32_, encryption_type = lsb>
+
+!cc = !openfhe.crypto_context
+
+!ct = !lwe.new_lwe_ciphertext<application_data = <message_type = i3>, plaintext_space = #plaintext_space, ciphertext_space = #ciphertext_space_L0_, key = #key, modulus_chain = #modulus_chain_L5_C0_>
+
+// The multiplication and the two rotations are independent. The most
+// expensive op, the multiplication, gets a section of its own, and the two
+// rotations share the other section.
+
+// CHECK-LABEL: CiphertextT test_parallel_rotations(
+// CHECK-SAME:    CryptoContextT [[CC:[^,]*]],
+// CHECK-SAME:    CiphertextT [[ARG1:[^)]*]]
+// CHECK-SAME:  ) {
+// CHECK-NEXT:      CiphertextT [[v0:.*]];
+// CHECK-NEXT:      CiphertextT [[v1:.*]];
+// CHECK-NEXT:      CiphertextT [[v2:.*]];
+// CHECK-NEXT:      #pragma omp parallel sections
+// CHECK-NEXT:      {
+// CHECK-NEXT:        #pragma omp section
+// CHECK-NEXT:        {
+// CHECK-NEXT:          [[v0]] = [[CC]]->EvalMult([[ARG1]], [[ARG1]]);
+// CHECK-NEXT:        }
+// CHECK-NEXT:        #pragma omp section
+// CHECK-NEXT:        {
+// CHECK-NEXT:          [[v1]] = [[CC]]->EvalRotate([[ARG1]], 1);
+// CHECK-NEXT:          [[v2]] = [[CC]]->EvalRotate([[ARG1]], 2);
+// CHECK-NEXT:        }
+// CHECK-NEXT:      }
+// CHECK-NEXT:      const auto& [[v3:.*]] = [[CC]]->EvalAdd([[v0]], [[v1]]);
+// CHECK-NEXT:      const auto& [[v4:.*]] = [[CC]]->EvalAdd([[v3]], [[v2]]);
+// CHECK-NEXT:      return [[v4]];
+// CHECK-NEXT:  }
+module attributes {scheme.bgv} {
+  func.func @test_parallel_rotations(%cc : !cc, %input : !ct) -> !ct {
+    %0 = openfhe.mul %cc, %input, %input : (!cc, !ct, !ct) -> !ct
+    %1 = openfhe.rot %cc, %input { index = 1 } : (!cc, !ct) -> !ct
+    %2 = openfhe.rot %cc, %input { index = 2 } : (!cc, !ct) -> !ct
+    %3 = openfhe.add %cc, %0, %1 : (!cc, !ct, !ct) -> !ct
+    %4 = openfhe.add %cc, %3, %2 : (!cc, !ct, !ct) -> !ct
+    return %4 : !ct
+  }
+}
@@ -0,0 +1,57 @@
+// RUN: heir-translate %s --emit-openfhe-pke --openfhe-profile-ops | FileCheck %s
+// RUN: heir-translate %s --emit-openfhe-pke-header --openfhe-profile-ops | FileCheck %s --check-prefix=HEADER
+
+!Z1095233372161_i64_ = !mod_arith.int<1095233372161 : i64>
+!Z65537_i64_ = !mod_arith.int<65537 : i64>
+
+!rns_L0_ = !rns.rns<!Z1095233372161_i64_>
+
+#ring_Z65537_i64_1_x32_ = #polynomial.ring<coefficientType = !Z65537_i64_, polynomialModulus = <1 + x**32>>
+#ring_rns_L0_1_x32_ = #polynomial.ring<coefficientType = !rns_L0_, polynomialModulus = <1 + x**32>>
+
+#full_crt_packing_encoding = #lwe.full_crt_packing_encoding<scaling_factor = 0>
+#key = #lwe.key<>
+
+#modulus_chain_L5_C0_ = #lwe.modulus_chain<elements = <1095233372161 : i64, 1032955396097 : i64, 1005037682689 : i64, 998595133441 : i64, 972824936449 : i64, 959939837953 : i64>, current = 0>
+
+#plaintext_space = #lwe.plaintext_space<ring = #ring_Z65537_i64_1_x32_, encoding = #full_crt_packing_encoding>
+
+#ciphertext_space_L0_ = #lwe.ciphertext_space<ring = #ring_rns_L0_1_x32_, encryption_type = lsb>
+
+!cc = !openfhe.crypto_context
+
+!ct = !lwe.new_lwe_ciphertext<application_data = <message_type = i3>, plaintext_space = #plaintext_space, ciphertext_space = #ciphertext_space_L0_, key = #key, modulus_chain = #modulus_chain_L5_C0_>
+
+// CHECK: namespace heir_profile {
+// CHECK: void PrintTable(std::ostream& os) {
+// CHECK: void WriteFoldedStacks(std::ostream& os) {
+
+// CHECK-LABEL: CiphertextT test_profile(
+// CHECK-SAME:    CryptoContextT [[CC:[^,]*]],
+// CHECK-SAME:    CiphertextT [[ARG1:[^,]*]],
+// CHECK-SAME:    CiphertextT [[ARG2:[^)]*]]
+// CHECK-SAME:  ) {
+// CHECK-NEXT:      auto [[T0:.*]] = heir_profile::Start("test_profile", "openfhe.add", "{{.*}}emit_profile.mlir:{{[0-9]+}}:{{[0-9]+}}", [[ARG1]]->GetLevel(), [[CC]]->GetRingDimension());
+// CHECK-NEXT:      const auto& [[v0:.*]] = [[CC]]->EvalAdd([[ARG1]], [[ARG2]]);
+// CHECK-NEXT:      heir_profile::Stop([[T0]]);
+// CHECK-NEXT:      auto [[T1:.*]] = heir_profile::Start("test_profile", "openfhe.mul", "{{.*}}", [[v0]]->GetLevel(), [[CC]]->GetRingDimension());
+// CHECK-NEXT:      const auto& [[v1:.*]] = [[CC]]->EvalMult([[v0]], [[ARG2]]);
+// CHECK-NEXT:      heir_profile::Stop([[T1]]);
+// CHECK-NEXT:      auto [[T2:.*]] = heir_profile::Start("test_profile", "openfhe.rot", "{{.*}}", [[v1]]->GetLevel(), [[CC]]->GetRingDimension());
+// CHECK-NEXT:      const auto& [[v2:.*]] = [[CC]]->EvalRotate([[v1]], 4);
+// CHECK-NEXT:      heir_profile::Stop([[T2]]);
+// CHECK-NEXT:      return [[v2]];
+// CHECK-NEXT:  }
+
+// HEADER: namespace heir_profile {
+// HEADER: void PrintTable(std::ostream& os);
+// HEADER: void WriteFoldedStacks(std::ostream& os);
+// HEADER: CiphertextT test_profile(
+module attributes {scheme.bgv} {
+  func.func @test_profile(%cc : !cc, %input1 : !ct, %input2 : !ct) -> !ct {
+    %add_res = openfhe.add %cc, %input1, %input2 : (!cc, !ct, !ct) -> !ct
+    %mul_res = openfhe.mul %cc, %add_res, %input2 : (!cc, !ct, !ct) -> !ct
+    %rot_res = openfhe.rot %cc, %mul_res { index = 4 } : (!cc, !ct) -> !ct
+    return %rot_res : !ct
+  }
+}
@@ -2,6 +2,7 @@
 
 // CHECK: #include <pybind11/pybind11.h>
 // CHECK: #include <pybind11/stl.h>
+// CHECK: #include <pybind11/numpy.h>
 
 // A minor hack to avoid copybara mangling this transformation when it is synced
 // internally to Google.
@@ -26,11 +27,31 @@
 // CHECK:         .def("KeyGen", &CryptoContextImpl<DCRTPoly>::KeyGen);
 // CHECK: }
 
+// CHECK: std::vector<T> heir_vector_from_array(
+// CHECK: size_t heir_batch_size(std::initializer_list<size_t> sizes)
+// CHECK: auto heir_batch(size_t size, Func func)
+
 // CHECK: PYBIND11_MODULE(_heir_foo, m) {
 // CHECK:   bind_common(m);
-// CHECK:   m.def("simple_sum", &simple_sum);
-// CHECK:   m.def("simple_sum__encrypt", &simple_sum__encrypt);
-// CHECK:   m.def("simple_sum__decrypt", &simple_sum__decrypt);
+// CHECK:   m.def("simple_sum", &simple_sum, py::call_guard<py::gil_scoped_release>());
+// CHECK:   m.def("simple_sum__batch", [](CryptoContextT v0, const std::vector<CiphertextT>& v1) {
+// CHECK-NEXT:     size_t size = heir_batch_size({v1.size()});
+// CHECK-NEXT:     return heir_batch(size, [&](size_t i) { return simple_sum(v0, v1[i]); });
+// CHECK-NEXT:   }, py::call_guard<py::gil_scoped_release>());
+
+// CHECK:   m.def("simple_sum__encrypt", [](CryptoContextT v0, const py::array_t<int16_t, py::array::c_style | py::array::forcecast>& v1, PublicKeyT v2) {
+// CHECK-NEXT:     std::vector<int16_t> v1Vector = heir_vector_from_array(v1);
+// CHECK-NEXT:     py::gil_scoped_release release;
+// CHECK-NEXT:     return simple_sum__encrypt(v0, v1Vector, v2);
+// CHECK-NEXT:   });
+// CHECK:   m.def("simple_sum__encrypt", &simple_sum__encrypt, py::call_guard<py::gil_scoped_release>());
+// CHECK-NOT: simple_sum__encrypt__batch
+
+// CHECK:   m.def("simple_sum__decrypt", &simple_sum__decrypt, py::call_guard<py::gil_scoped_release>());
+// CHECK:   m.def("simple_sum__decrypt__batch", [](CryptoContextT v0, const std::vector<CiphertextT>& v1, PrivateKeyT v2) {
+// CHECK-NEXT:     size_t size = heir_batch_size({v1.size()});
+// CHECK-NEXT:     return heir_batch(size, [&](size_t i) { return simple_sum__decrypt(v0, v1[i], v2); });
+// CHECK-NEXT:   }, py::call_guard<py::gil_scoped_release>());
 // CHECK: }
 
 !Z1095233372161_i64_ = !mod_arith.int<1095233372161 : i64>
@@ -0,0 +1,49 @@
+// RUN: heir-translate %s --emit-openfhe-pke-pybind --pybind-header-include=foo.h --pybind-module-name=_heir_foo | FileCheck %s
+
+// A tensor of ciphertexts has no NumPy dtype, so it only gets the overload
+// taking a list, while the tensor of integers also gets a NumPy overload.
+
+// CHECK: PYBIND11_MODULE(_heir_foo, m) {
+// CHECK-NOT: py::array_t<CiphertextT
+// CHECK:   m.def("sum_all", &sum_all, py::call_guard<py::gil_scoped_release>());
+// CHECK-NOT: py::array_t
+// CHECK:   m.def("encrypt_all", [](CryptoContextT v0, const py::array_t<int16_t, py::array::c_style | py::array::forcecast>& v1, PublicKeyT v2) {
+// CHECK:   m.def("encrypt_all", &encrypt_all, py::call_guard<py::gil_scoped_release>());
+// CHECK: }
+
+!Z1095233372161_i64_ = !mod_arith.int<1095233372161 : i64>
+!Z65537_i64_ = !mod_arith.int<65537 : i64>
+
+!rns_L0_ = !rns.rns<!Z1095233372161_i64_>
+
+#ring_Z65537_i64_1_x32_ = #polynomial.ring<coefficientType = !Z65537_i64_, polynomialModulus = <1 + x**32>>
+#ring_rns_L0_1_x32_ = #polynomial.ring<coefficientType = !rns_L0_, polynomialModulus = <1 + x**32>>
+
+#full_crt_packing_encoding = #lwe.full_crt_packing_encoding<scaling_factor = 0>
+#key = #lwe.key<>
+
+#modulus_chain_L5_C0_ = #lwe.modulus_chain<elements = <1095233372161 : i64, 1032955396097 : i64, 1005037682689 : i64, 998595133441 : i64, 972824936449 : i64, 959939837953 : i64>, current = 0>
+
+#plaintext_space = #lwe.plaintext_space<ring = #ring_Z65537_i64_1_x32_, encoding = #full_crt_packing_encoding>
+
+#ciphertext_space_L0_ = #lwe.ciphertext_space<ring = #ring_rns_L0_1_x32_, encryption_type = lsb>
+
+!pt_ty = !lwe.new_lwe_plaintext<application_data = <message_type = tensor<32xi16>>, plaintext_space = #plaintext_space>
+!ct_ty = !lwe.new_lwe_ciphertext<application_data = <message_type = tensor<32xi16>>, plaintext_space = #plaintext_space, ciphertext_space = #ciphertext_space_L0_, key = #key, modulus_chain = #modulus_chain_L5_C0_>
+
+func.func @sum_all(%arg0: !openfhe.crypto_context, %arg1: tensor<2x!ct_ty>) -> !ct_ty {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %0 = tensor.extract %arg1[%c0] : tensor<2x!ct_ty>
+  %1 = tensor.extract %arg1[%c1] : tensor<2x!ct_ty>
+  %2 = openfhe.add %arg0, %0, %1 : (!openfhe.crypto_context, !ct_ty, !ct_ty) -> !ct_ty
+  return %2 : !ct_ty
+}
+
+func.func @encrypt_all(%arg0: !openfhe.crypto_context, %arg1: tensor<32xi16>, %arg2: !openfhe.public_key) -> tensor<2x!ct_ty> {
+  %0 = openfhe.make_packed_plaintext %arg0, %arg1 : (!openfhe.crypto_context, tensor<32xi16>) -> !pt_ty
+  %1 = openfhe.encrypt %arg0, %0, %arg2 : (!openfhe.crypto_context, !pt_ty, !openfhe.public_key) -> !ct_ty
+  %2 = openfhe.encrypt %arg0, %0, %arg2 : (!openfhe.crypto_context, !pt_ty, !openfhe.public_key) -> !ct_ty
+  %3 = tensor.from_elements %1, %2 : tensor<2x!ct_ty>
+  return %3 : tensor<2x!ct_ty>
+}
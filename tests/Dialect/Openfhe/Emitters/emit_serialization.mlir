@@ -0,0 +1,66 @@
+// RUN: heir-translate %s --emit-openfhe-pke | FileCheck %s
+// RUN: heir-translate %s --emit-openfhe-pke-header | FileCheck %s --check-prefix=HEADER
+
+!Z1095233372161_i64_ = !mod_arith.int<1095233372161 : i64>
+!Z65537_i64_ = !mod_arith.int<65537 : i64>
+
+!rns_L0_ = !rns.rns<!Z1095233372161_i64_>
+
+#ring_Z65537_i64_1_x32_ = #polynomial.ring<coefficientType = !Z65537_i64_, polynomialModulus = <1 + x**32>>
+#ring_rns_L0_1_x32_ = #polynomial.ring<coefficientType = !rns_L0_, polynomialModulus = <1 + x**32>>
+
+#full_crt_packing_encoding = #lwe.full_crt_packing_encoding<scaling_factor = 0>
+#key = #lwe.key<>
+
+#modulus_chain_L5_C0_ = #lwe.modulus_chain<elements = <1095233372161 : i64, 1032955396097 : i64, 1005037682689 : i64, 998595133441 : i64, 972824936449 : i64, 959939837953 : i64>, current = 0>
+
+#plaintext_space = #lwe.plaintext_space<ring = #ring_Z65537_i64_1_x32_, encoding = #full_crt_packing_encoding>
+
+#ciphertext_space_L0_ = #lwe.ciphertext_space<ring = #ring_rns_L0_1_x32_, encryption_type = lsb>
+
+!cc = !openfhe.crypto_context
+!pt = !lwe.new_lwe_plaintext<application_data = <message_type = tensor<32xi16>>, plaintext_space = #plaintext_space>
+!ct = !lwe.new_lwe_ciphertext<application_data = <message_type = tensor<32xi16>>, plaintext_space = #plaintext_space, ciphertext_space = #ciphertext_space_L0_, key = #key, modulus_chain = #modulus_chain_L5_C0_>
+
+// CHECK: namespace heir_wire {
+// CHECK: inline size_t Write(
+
+// CHECK-LABEL: CiphertextT simple_sum__encrypt__arg0(
+// CHECK:       size_t simple_sum__serialize__arg0(CryptoContextT cc, const CiphertextT& ciphertext, std::ostream& os) {
+// CHECK-NEXT:    return heir_wire::Write(cc, ciphertext, os, /*trimLevels=*/false);
+// CHECK-NEXT:  }
+// CHECK-NEXT:  CiphertextT simple_sum__deserialize__arg0(CryptoContextT cc, std::istream& is) {
+// CHECK-NEXT:    return heir_wire::Read<CiphertextT>(cc, is);
+// CHECK-NEXT:  }
+
+// CHECK-LABEL: std::vector<int16_t> simple_sum__decrypt__result0(
+// CHECK:       size_t simple_sum__serialize__result0(CryptoContextT cc, const std::vector<CiphertextT>& ciphertext, std::ostream& os) {
+// CHECK-NEXT:    return heir_wire::Write(cc, ciphertext, os, /*trimLevels=*/true);
+// CHECK-NEXT:  }
+// CHECK-NEXT:  std::vector<CiphertextT> simple_sum__deserialize__result0(CryptoContextT cc, std::istream& is) {
+// CHECK-NEXT:    return heir_wire::Read<std::vector<CiphertextT>>(cc, is);
+// CHECK-NEXT:  }
+
+// HEADER: #include <istream>
+// HEADER: #include <ostream>
+// HEADER: CiphertextT simple_sum__encrypt__arg0(
+// HEADER-NEXT: size_t simple_sum__serialize__arg0(CryptoContextT cc, const CiphertextT& ciphertext, std::ostream& os);
+// HEADER-NEXT: CiphertextT simple_sum__deserialize__arg0(CryptoContextT cc, std::istream& is);
+// HEADER: std::vector<int16_t> simple_sum__decrypt__result0(
+// HEADER-NEXT: size_t simple_sum__serialize__result0(CryptoContextT cc, const std::vector<CiphertextT>& ciphertext, std::ostream& os);
+// HEADER-NEXT: std::vector<CiphertextT> simple_sum__deserialize__result0(CryptoContextT cc, std::istream& is);
+
+module attributes {scheme.bgv} {
+  func.func @simple_sum__encrypt__arg0(%cc: !openfhe.crypto_context, %arg0: tensor<32xi16>, %pk: !openfhe.public_key) -> !ct attributes {lwe.client_serialization = {deserialize = "simple_sum__deserialize__arg0", serialize = "simple_sum__serialize__arg0"}} {
+    %0 = openfhe.make_packed_plaintext %cc, %arg0 : (!openfhe.crypto_context, tensor<32xi16>) -> !pt
+    %1 = openfhe.encrypt %cc, %0, %pk : (!openfhe.crypto_context, !pt, !openfhe.public_key) -> !ct
+    return %1 : !ct
+  }
+  func.func @simple_sum__decrypt__result0(%cc: !openfhe.crypto_context, %arg0: tensor<2x!ct>, %sk: !openfhe.private_key) -> tensor<32xi16> attributes {lwe.client_serialization = {deserialize = "simple_sum__deserialize__result0", serialize = "simple_sum__serialize__result0", trim_levels}} {
+    %c0 = arith.constant 0 : index
+    %ct = tensor.extract %arg0[%c0] : tensor<2x!ct>
+    %0 = openfhe.decrypt %cc, %ct, %sk : (!openfhe.crypto_context, !ct, !openfhe.private_key) -> !pt
+    %1 = lwe.rlwe_decode %0 {encoding = #full_crt_packing_encoding, ring = #ring_Z65537_i64_1_x32_} : !pt -> tensor<32xi16>
+    return %1 : tensor<32xi16>
+  }
+}
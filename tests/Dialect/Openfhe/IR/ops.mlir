@@ -123,6 +123,15 @@ module {
     return
   }
 
+  // CHECK-LABEL: func @test_linear_wsum
+  func.func @test_linear_wsum(%cc : !cc, %ct0 : !ct, %ct1 : !ct) -> !ct {
+    %w0 = arith.constant 0.5 : f64
+    %w1 = arith.constant -2.0 : f64
+    // CHECK: openfhe.linear_wsum
+    %out = openfhe.linear_wsum %cc, [%ct0, %ct1], [%w0, %w1] : (!cc, !ct, !ct) -> !ct
+    return %out : !ct
+  }
+
   // CHECK-LABEL: func @test_mul_no_relin
   func.func @test_mul_no_relin(%cc : !cc, %pt : !pt, %pk: !pk) {
     %c1 = openfhe.encrypt %cc, %pt, %pk : (!cc, !pt, !pk) -> !ct
@@ -0,0 +1,50 @@
+// RUN: heir-opt --openfhe-configure-crypto-context="entry-function=bootstrap key-cache-dir=/tmp/heir_keys" %s | FileCheck %s
+
+!Z1095233372161_i64_ = !mod_arith.int<1095233372161 : i64>
+!Z65537_i64_ = !mod_arith.int<65537 : i64>
+#full_crt_packing_encoding = #lwe.full_crt_packing_encoding<scaling_factor = 0>
+#key = #lwe.key<>
+#modulus_chain_L5_C0_ = #lwe.modulus_chain<elements = <1095233372161 : i64, 1032955396097 : i64, 1005037682689 : i64, 998595133441 : i64, 972824936449 : i64, 959939837953 : i64>, current = 0>
+!rns_L0_ = !rns.rns<!Z1095233372161_i64_>
+#ring_Z65537_i64_1_x32_ = #polynomial.ring<coefficientType = !Z65537_i64_, polynomialModulus = <1 + x**32>>
+#plaintext_space = #lwe.plaintext_space<ring = #ring_Z65537_i64_1_x32_, encoding = #full_crt_packing_encoding>
+#ring_rns_L0_1_x32_ = #polynomial.ring<coefficientType = !rns_L0_, polynomialModulus = <1 + x**32>>
+#ciphertext_space_L0_ = #lwe.ciphertext_space<ring = #ring_rns_L0_1_x32_, encryption_type = lsb>
+!ct_L0_ = !lwe.new_lwe_ciphertext<application_data = <message_type = i16>, plaintext_space = #plaintext_space, ciphertext_space = #ciphertext_space_L0_, key = #key, modulus_chain = #modulus_chain_L5_C0_>
+
+
+func.func @bootstrap(%arg0: !openfhe.crypto_context, %arg1: !ct_L0_) -> !ct_L0_ {
+  %0 = openfhe.rot %arg0, %arg1 {index = 4 : index} : (!openfhe.crypto_context, !ct_L0_) -> !ct_L0_
+  %1 = openfhe.bootstrap %arg0, %0 : (!openfhe.crypto_context, !ct_L0_) -> !ct_L0_
+  return %1 : !ct_L0_
+}
+
+// CHECK: @bootstrap__configure_crypto_context
+// CHECK-SAME: (%[[CC:.*]]: !openfhe.crypto_context, %[[SK:.*]]: !openfhe.private_key)
+// CHECK: openfhe.gen_mulkey
+// CHECK: openfhe.gen_rotkey %[[CC]], %[[SK]] {indices = array<i64: 4>}
+// CHECK: openfhe.gen_bootstrapkey
+// CHECK: openfhe.save_crypto_context %[[CC]] {directory = "/tmp/heir_keys"}
+// CHECK: return %[[CC]]
+
+// CHECK: @bootstrap__load_crypto_context() -> !openfhe.crypto_context
+// CHECK-NOT: openfhe.gen_
+// CHECK: %[[LOADED:.*]] = openfhe.load_crypto_context {directory = "/tmp/heir_keys"}
+// CHECK: openfhe.setup_bootstrap %[[LOADED]] {levelBudgetDecode = 3 : index, levelBudgetEncode = 3 : index}
+// CHECK: return %[[LOADED]]
+
+// CHECK: @bootstrap__save_key_pair
+// CHECK-SAME: (%[[PK:.*]]: !openfhe.public_key, %[[SK:.*]]: !openfhe.private_key)
+// CHECK: openfhe.save_key %[[PK]] {directory = "/tmp/heir_keys"}
+// CHECK: openfhe.save_key %[[SK]] {directory = "/tmp/heir_keys"}
+// CHECK: return
+
+// CHECK: @bootstrap__load_public_key
+// CHECK-SAME: (%[[CC:.*]]: !openfhe.crypto_context) -> !openfhe.public_key
+// CHECK: %[[KEY:.*]] = openfhe.load_key %[[CC]] {directory = "/tmp/heir_keys"} : (!openfhe.crypto_context) -> !openfhe.public_key
+// CHECK: return %[[KEY]]
+
+// CHECK: @bootstrap__load_private_key
+// CHECK-SAME: (%[[CC:.*]]: !openfhe.crypto_context) -> !openfhe.private_key
+// CHECK: %[[KEY:.*]] = openfhe.load_key %[[CC]] {directory = "/tmp/heir_keys"} : (!openfhe.crypto_context) -> !openfhe.private_key
+// CHECK: return %[[KEY]]
@@ -0,0 +1,39 @@
+// RUN: heir-opt --openfhe-configure-crypto-context=minimize-runtime=true %s | FileCheck %s
+// RUN: heir-opt --openfhe-configure-crypto-context %s | FileCheck %s --check-prefix=DEFAULT
+
+// With minimize-runtime, the number of digits of HYBRID key switching is
+// recovered from the scheme parameters: four primes in Q and one special prime
+// give four digits, which OpenFHE would not choose by itself. Without it, the
+// generated code keeps the default of OpenFHE.
+
+!Z1032955396097_i64_ = !mod_arith.int<1032955396097 : i64>
+!Z1095233372161_i64_ = !mod_arith.int<1095233372161 : i64>
+!Z65537_i64_ = !mod_arith.int<65537 : i64>
+#full_crt_packing_encoding = #lwe.full_crt_packing_encoding<scaling_factor = 0>
+#key = #lwe.key<>
+#modulus_chain_L5_C0_ = #lwe.modulus_chain<elements = <1095233372161 : i64, 1032955396097 : i64, 1005037682689 : i64, 998595133441 : i64, 972824936449 : i64, 959939837953 : i64>, current = 0>
+#modulus_chain_L5_C1_ = #lwe.modulus_chain<elements = <1095233372161 : i64, 1032955396097 : i64, 1005037682689 : i64, 998595133441 : i64, 972824936449 : i64, 959939837953 : i64>, current = 1>
+!rns_L0_ = !rns.rns<!Z1095233372161_i64_>
+!rns_L1_ = !rns.rns<!Z1095233372161_i64_, !Z1032955396097_i64_>
+#ring_Z65537_i64_1_x32_ = #polynomial.ring<coefficientType = !Z65537_i64_, polynomialModulus = <1 + x**32>>
+#plaintext_space = #lwe.plaintext_space<ring = #ring_Z65537_i64_1_x32_, encoding = #full_crt_packing_encoding>
+#ring_rns_L0_1_x32_ = #polynomial.ring<coefficientType = !rns_L0_, polynomialModulus = <1 + x**32>>
+#ring_rns_L1_1_x32_ = #polynomial.ring<coefficientType = !rns_L1_, polynomialModulus = <1 + x**32>>
+#ciphertext_space_L0_ = #lwe.ciphertext_space<ring = #ring_rns_L0_1_x32_, encryption_type = lsb>
+#ciphertext_space_L1_ = #lwe.ciphertext_space<ring = #ring_rns_L1_1_x32_, encryption_type = lsb>
+!ct_L0_ = !lwe.new_lwe_ciphertext<application_data = <message_type = i16>, plaintext_space = #plaintext_space, ciphertext_space = #ciphertext_space_L0_, key = #key, modulus_chain = #modulus_chain_L5_C0_>
+!ct_L1_ = !lwe.new_lwe_ciphertext<application_data = <message_type = tensor<32xi16>>, plaintext_space = #plaintext_space, ciphertext_space = #ciphertext_space_L1_, key = #key, modulus_chain = #modulus_chain_L5_C1_>
+
+// CHECK: @simple_sum__generate_crypto_context
+// CHECK: openfhe.gen_params
+// CHECK-SAME: numLargeDigits = 4
+
+// DEFAULT: @simple_sum__generate_crypto_context
+// DEFAULT: openfhe.gen_params
+// DEFAULT-NOT: numLargeDigits = {{[1-9]}}
+module attributes {bgv.schemeParam = #bgv.scheme_param<logN = 13, Q = [1095233372161, 1032955396097, 1005037682689, 998595133441], P = [972824936449], plaintextModulus = 65537>, scheme.bgv} {
+  func.func @simple_sum(%arg0: !openfhe.crypto_context, %arg1: !ct_L1_) -> !ct_L0_ {
+    %0 = openfhe.mod_reduce %arg0, %arg1 : (!openfhe.crypto_context, !ct_L1_) -> !ct_L0_
+    return %0 : !ct_L0_
+  }
+}
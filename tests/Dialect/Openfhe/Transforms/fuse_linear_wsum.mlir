@@ -0,0 +1,80 @@
+// RUN: heir-opt --openfhe-fuse-linear-wsum %s | FileCheck %s
+
+!Z1095233372161_i64_ = !mod_arith.int<1095233372161 : i64>
+!Z65537_i64_ = !mod_arith.int<65537 : i64>
+
+!rns_L0_ = !rns.rns<!Z1095233372161_i64_>
+
+#ring_Z65537_i64_1_x1024_ = #polynomial.ring<coefficientType = !Z65537_i64_, polynomialModulus = <1 + x**1024>>
+#ring_rns_L0_1_x1024_ = #polynomial.ring<coefficientType = !rns_L0_, polynomialModulus = <1 + x**1024>>
+
+#inverse_canonical_encoding = #lwe.inverse_canonical_encoding<scaling_factor = 1024>
+#key = #lwe.key<>
+
+#modulus_chain_L5_C0_ = #lwe.modulus_chain<elements = <1095233372161 : i64, 1032955396097 : i64, 1005037682689 : i64, 998595133441 : i64, 972824936449 : i64, 959939837953 : i64>, current = 0>
+
+#plaintext_space = #lwe.plaintext_space<ring = #ring_Z65537_i64_1_x1024_, encoding = #inverse_canonical_encoding>
+#ciphertext_space_L0_ = #lwe.ciphertext_space<ring = #ring_rns_L0_1_x1024_, encryption_type = lsb>
+
+!cc = !openfhe.crypto_context
+!pt = !lwe.new_lwe_plaintext<application_data = <message_type = f32>, plaintext_space = #plaintext_space>
+!ct = !lwe.new_lwe_ciphertext<application_data = <message_type = f32>, plaintext_space = #plaintext_space, ciphertext_space = #ciphertext_space_L0_, key = #key, modulus_chain = #modulus_chain_L5_C0_>
+
+module attributes {scheme.ckks} {
+  // CHECK-LABEL: func @fuse_constant_weights
+  // CHECK-SAME: (%[[cc:.*]]: [[cc_ty:.*]], %[[ct0:.*]]: [[ct_ty:.*]], %[[ct1:.*]]: [[ct_ty]], %[[ct2:.*]]: [[ct_ty]])
+  func.func @fuse_constant_weights(%cc: !cc, %ct0: !ct, %ct1: !ct, %ct2: !ct) -> !ct {
+    // CHECK-DAG: %[[w0:.*]] = arith.constant 5.000000e-01 : f64
+    // CHECK-DAG: %[[w1:.*]] = arith.constant 2.000000e+00 : f64
+    // CHECK-DAG: %[[w2:.*]] = arith.constant -1.000000e+00 : f64
+    // CHECK: %[[sum:.*]] = openfhe.linear_wsum %[[cc]], [%[[ct0]], %[[ct1]], %[[ct2]]], [%[[w0]], %[[w1]], %[[w2]]]
+    // CHECK-NOT: openfhe.mul_plain
+    // CHECK-NOT: openfhe.add
+    // CHECK: return %[[sum]]
+    %c0 = arith.constant dense<0.5> : tensor<1024xf32>
+    %c1 = arith.constant dense<2.0> : tensor<1024xf32>
+    %c2 = arith.constant dense<-1.0> : tensor<1024xf32>
+    %pt0 = openfhe.make_ckks_packed_plaintext %cc, %c0 : (!cc, tensor<1024xf32>) -> !pt
+    %pt1 = openfhe.make_ckks_packed_plaintext %cc, %c1 : (!cc, tensor<1024xf32>) -> !pt
+    %pt2 = openfhe.make_ckks_packed_plaintext %cc, %c2 : (!cc, tensor<1024xf32>) -> !pt
+    %m0 = openfhe.mul_plain %cc, %ct0, %pt0 : (!cc, !ct, !pt) -> !ct
+    %m1 = openfhe.mul_plain %cc, %ct1, %pt1 : (!cc, !ct, !pt) -> !ct
+    %m2 = openfhe.mul_plain %cc, %ct2, %pt2 : (!cc, !ct, !pt) -> !ct
+    %s0 = openfhe.add %cc, %m0, %m1 : (!cc, !ct, !ct) -> !ct
+    %s1 = openfhe.add %cc, %s0, %m2 : (!cc, !ct, !ct) -> !ct
+    return %s1 : !ct
+  }
+
+  // CHECK-LABEL: func @fuse_splat_weights
+  // CHECK-SAME: (%[[cc:.*]]: [[cc_ty:.*]], %[[ct0:.*]]: [[ct_ty:.*]], %[[ct1:.*]]: [[ct_ty]], %[[ct2:.*]]: [[ct_ty]], %[[x:.*]]: f32, %[[y:.*]]: f32)
+  func.func @fuse_splat_weights(%cc: !cc, %ct0: !ct, %ct1: !ct, %ct2: !ct, %x: f32, %y: f32) -> !ct {
+    // CHECK-DAG: %[[w0:.*]] = arith.extf %[[x]] : f32 to f64
+    // CHECK-DAG: %[[w1:.*]] = arith.extf %[[y]] : f32 to f64
+    // CHECK: %[[sum:.*]] = openfhe.linear_wsum %[[cc]], [%[[ct0]], %[[ct1]]], [%[[w0]], %[[w1]]]
+    // CHECK: %[[res:.*]] = openfhe.add %[[cc]], %[[sum]], %[[ct2]]
+    // CHECK: return %[[res]]
+    %s0 = tensor.splat %x : tensor<1024xf32>
+    %s1 = tensor.splat %y : tensor<1024xf32>
+    %pt0 = openfhe.make_ckks_packed_plaintext %cc, %s0 : (!cc, tensor<1024xf32>) -> !pt
+    %pt1 = openfhe.make_ckks_packed_plaintext %cc, %s1 : (!cc, tensor<1024xf32>) -> !pt
+    %m0 = openfhe.mul_plain %cc, %ct0, %pt0 : (!cc, !ct, !pt) -> !ct
+    %m1 = openfhe.mul_plain %cc, %ct1, %pt1 : (!cc, !ct, !pt) -> !ct
+    %a0 = openfhe.add %cc, %m0, %ct2 : (!cc, !ct, !ct) -> !ct
+    %a1 = openfhe.add %cc, %a0, %m1 : (!cc, !ct, !ct) -> !ct
+    return %a1 : !ct
+  }
+
+  // A plaintext with different values in its slots is not a scalar weight.
+  // CHECK-LABEL: func @no_fuse_non_splat
+  func.func @no_fuse_non_splat(%cc: !cc, %ct0: !ct, %ct1: !ct, %v: tensor<1024xf32>) -> !ct {
+    // CHECK-NOT: openfhe.linear_wsum
+    // CHECK: openfhe.add
+    %c0 = arith.constant dense<0.5> : tensor<1024xf32>
+    %pt0 = openfhe.make_ckks_packed_plaintext %cc, %c0 : (!cc, tensor<1024xf32>) -> !pt
+    %pt1 = openfhe.make_ckks_packed_plaintext %cc, %v : (!cc, tensor<1024xf32>) -> !pt
+    %m0 = openfhe.mul_plain %cc, %ct0, %pt0 : (!cc, !ct, !pt) -> !ct
+    %m1 = openfhe.mul_plain %cc, %ct1, %pt1 : (!cc, !ct, !pt) -> !ct
+    %s0 = openfhe.add %cc, %m0, %m1 : (!cc, !ct, !ct) -> !ct
+    return %s0 : !ct
+  }
+}
@@ -1,17 +1,13 @@
-// RUN: heir-opt --convert-polynomial-mul-to-ntt --mod-arith-to-arith %s | FileCheck --check-prefix=ARITH --check-prefix=CHECK %s
-// RUN: heir-opt --convert-polynomial-mul-to-ntt %s | FileCheck --check-prefix=EXT --check-prefix=CHECK %s
+// RUN: heir-opt --convert-polynomial-mul-to-ntt %s | FileCheck %s
 
 #ideal = #polynomial.int_polynomial<1 + x**4>
-#ring = #polynomial.ring<coefficientType=!modarith.modarith<17:i32:i32>, polynomialModulus=#ideal>
+#ring = #polynomial.ring<coefficientType=!mod_arith.int<17:i32>, polynomialModulus=#ideal>
 !poly_ty = !polynomial.polynomial<ring=#ring>
 
 // CHECK: func.func @rewrite_poly_mul(%[[poly0:.*]]: [[POLY_TY:.*]], %[[poly1:.*]]: [[POLY_TY]]) -> [[POLY_TY]] {
 // CHECK:      %[[NTT_POLY0:.*]] = polynomial.ntt %[[poly0]] : [[POLY_TY]] -> [[INPUT_TENSOR_TYPE:.*]]
 // CHECK:      %[[NTT_POLY1:.*]] = polynomial.ntt %[[poly1]] : [[POLY_TY]] -> [[INPUT_TENSOR_TYPE]]
-// EXT:        %[[NTT_RES:.*]] = mod_arith.mul %[[NTT_POLY0]], %[[NTT_POLY1]] {modulus = 17 : i32} : [[INPUT_TENSOR_TYPE]]
-// ARITH:      %[[NTT_MUL:.*]] = arith.muli %[[NTT_POLY0]], %[[NTT_POLY1]] : [[INPUT_TENSOR_TYPE]]
-// ARITH:      %[[CMOD:.*]] = arith.constant dense<17> : [[INPUT_TENSOR_TYPE:.*]]
-// ARITH:      %[[NTT_RES:.*]] = arith.remui %[[NTT_MUL]], %[[CMOD]] : [[INPUT_TENSOR_TYPE]]
+// CHECK:      %[[NTT_RES:.*]] = mod_arith.mul %[[NTT_POLY0]], %[[NTT_POLY1]] : [[INPUT_TENSOR_TYPE]]
 // CHECK:      %[[RES:.*]] = polynomial.intt %[[NTT_RES]] : [[INPUT_TENSOR_TYPE]] -> {{.*}}
 // CHECK:      return %[[RES]] : [[POLY_TY]]
 func.func @rewrite_poly_mul(%poly0: !poly_ty, %poly1: !poly_ty) -> !poly_ty {
@@ -20,7 +16,7 @@ func.func @rewrite_poly_mul(%poly0: !poly_ty, %poly1: !poly_ty) -> !poly_ty {
 }
 
 #bad_ideal = #polynomial.int_polynomial<1 + x**6>
-#bad_ring = #polynomial.ring<coefficientType=!modarith.modarith<17 : i32:i32>, polynomialModulus=#bad_ideal>
+#bad_ring = #polynomial.ring<coefficientType=!mod_arith.int<17:i32>, polynomialModulus=#bad_ideal>
 !bad_poly_ty = !polynomial.polynomial<ring=#bad_ring>
 
 // CHECK: func.func @rewrite_bad_poly_mul
@@ -30,3 +26,29 @@ func.func @rewrite_bad_poly_mul(%poly0: !bad_poly_ty, %poly1: !bad_poly_ty) -> !
   %poly = polynomial.mul %poly0, %poly1 : !bad_poly_ty
   return %poly : !bad_poly_ty
 }
+
+// 7917 = 5 mod 8, so there is no primitive 8th root of unity.
+#unfriendly_ring = #polynomial.ring<coefficientType=!mod_arith.int<7917:i32>, polynomialModulus=#ideal>
+!unfriendly_poly_ty = !polynomial.polynomial<ring=#unfriendly_ring>
+
+// CHECK: func.func @rewrite_unfriendly_poly_mul
+// CHECK-NOT: polynomial.ntt
+// CHECK:      %[[POLYMUL:.*]] = polynomial.mul
+// CHECK:      return %[[POLYMUL]]
+func.func @rewrite_unfriendly_poly_mul(%poly0: !unfriendly_poly_ty, %poly1: !unfriendly_poly_ty) -> !unfriendly_poly_ty {
+  %poly = polynomial.mul %poly0, %poly1 : !unfriendly_poly_ty
+  return %poly : !unfriendly_poly_ty
+}
+
+// 7921 = 89^2 is 1 mod 8 but not a prime, so the ring has no NTT.
+#composite_ring = #polynomial.ring<coefficientType=!mod_arith.int<7921:i32>, polynomialModulus=#ideal>
+!composite_poly_ty = !polynomial.polynomial<ring=#composite_ring>
+
+// CHECK: func.func @rewrite_composite_poly_mul
+// CHECK-NOT: polynomial.ntt
+// CHECK:      %[[POLYMUL:.*]] = polynomial.mul
+// CHECK:      return %[[POLYMUL]]
+func.func @rewrite_composite_poly_mul(%poly0: !composite_poly_ty, %poly1: !composite_poly_ty) -> !composite_poly_ty {
+  %poly = polynomial.mul %poly0, %poly1 : !composite_poly_ty
+  return %poly : !composite_poly_ty
+}
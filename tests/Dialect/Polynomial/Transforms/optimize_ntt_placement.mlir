@@ -0,0 +1,138 @@
+// RUN: heir-opt --optimize-ntt-placement %s | FileCheck %s
+// RUN: heir-opt --convert-polynomial-mul-to-ntt --optimize-ntt-placement %s | FileCheck %s
+// RUN: heir-opt --optimize-ntt-placement --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=STATS
+
+// Rewriting each of the 8 products separately needs 24 transforms, and 19
+// are left after the pass.
+
+// STATS: OptimizeNTTPlacement
+// STATS-DAG: (S) 14 ntt ops
+// STATS-DAG: (S) 5 intt ops
+// STATS-DAG: (S) 5 transforms removed
+
+#ideal = #polynomial.int_polynomial<1 + x**4>
+#ring = #polynomial.ring<coefficientType=!mod_arith.int<17:i32>, polynomialModulus=#ideal>
+!coeff_ty = !mod_arith.int<17:i32>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+// The sum is computed in evaluation form, and only the result is converted
+// back.
+
+// CHECK-LABEL: func.func @chain
+// CHECK-SAME: (%[[A:.*]]: [[POLY_TY:.*]], %[[B:.*]]: [[POLY_TY]], %[[C:.*]]: [[POLY_TY]], %[[D:.*]]: [[POLY_TY]])
+// CHECK-DAG: %[[A_NTT:.*]] = polynomial.ntt %[[A]]
+// CHECK-DAG: %[[B_NTT:.*]] = polynomial.ntt %[[B]]
+// CHECK: %[[AB:.*]] = mod_arith.mul %[[A_NTT]], %[[B_NTT]]
+// CHECK: %[[C_NTT:.*]] = polynomial.ntt %[[C]]
+// CHECK: %[[SUM:.*]] = mod_arith.add %[[AB]], %[[C_NTT]]
+// CHECK: %[[D_NTT:.*]] = polynomial.ntt %[[D]]
+// CHECK: %[[PROD:.*]] = mod_arith.mul %[[SUM]], %[[D_NTT]]
+// CHECK: %[[RES:.*]] = polynomial.intt %[[PROD]]
+// CHECK-NOT: polynomial.intt
+// CHECK: return %[[RES]]
+func.func @chain(%a: !poly_ty, %b: !poly_ty, %c: !poly_ty, %d: !poly_ty) -> !poly_ty {
+  %0 = polynomial.mul %a, %b : !poly_ty
+  %1 = polynomial.add %0, %c : !poly_ty
+  %2 = polynomial.mul %1, %d : !poly_ty
+  return %2 : !poly_ty
+}
+
+// CHECK-LABEL: func.func @sum_of_products
+// CHECK-COUNT-5: polynomial.ntt
+// CHECK-NOT: polynomial.ntt
+// CHECK: polynomial.intt
+// CHECK-NOT: polynomial.intt
+// CHECK: return
+func.func @sum_of_products(%a: !poly_ty, %b: !poly_ty, %c: !poly_ty, %d: !poly_ty, %e: !poly_ty) -> !poly_ty {
+  %0 = polynomial.mul %a, %b : !poly_ty
+  %1 = polynomial.mul %c, %d : !poly_ty
+  %2 = polynomial.sub %0, %1 : !poly_ty
+  %3 = polynomial.mul %2, %e : !poly_ty
+  return %3 : !poly_ty
+}
+
+// The product is also needed in coefficient form, but is only converted
+// once, and its evaluation form is reused by the second product.
+
+// CHECK-LABEL: func.func @coefficient_use
+// CHECK-SAME: (%[[A:.*]]: [[POLY_TY:.*]], %[[B:.*]]: [[POLY_TY]], %[[C:.*]]: [[POLY_TY]])
+// CHECK: %[[AB:.*]] = mod_arith.mul
+// CHECK: %[[AB_COEFF:.*]] = polynomial.intt %[[AB]]
+// CHECK: %[[C_NTT:.*]] = polynomial.ntt %[[C]]
+// CHECK: %[[ABC:.*]] = mod_arith.mul %[[AB]], %[[C_NTT]]
+// CHECK: %[[RES:.*]] = polynomial.intt %[[ABC]]
+// CHECK: %[[TENSOR:.*]] = polynomial.to_tensor %[[AB_COEFF]]
+// CHECK: return %[[RES]], %[[TENSOR]]
+func.func @coefficient_use(%a: !poly_ty, %b: !poly_ty, %c: !poly_ty) -> (!poly_ty, tensor<4x!coeff_ty>) {
+  %0 = polynomial.mul %a, %b : !poly_ty
+  %1 = polynomial.mul %0, %c : !poly_ty
+  %2 = polynomial.to_tensor %0 : !poly_ty -> tensor<4x!coeff_ty>
+  return %1, %2 : !poly_ty, tensor<4x!coeff_ty>
+}
+
+// CHECK-LABEL: func.func @mul_scalar
+// CHECK-SAME: (%[[A:.*]]: [[POLY_TY:.*]], %[[B:.*]]: [[POLY_TY]], %[[S:.*]]: [[COEFF_TY:.*]])
+// CHECK: %[[AB:.*]] = mod_arith.mul
+// CHECK: %[[SPLAT:.*]] = tensor.splat %[[S]]
+// CHECK: %[[SCALED:.*]] = mod_arith.mul %[[AB]], %[[SPLAT]]
+// CHECK: %[[RES:.*]] = polynomial.intt %[[SCALED]]
+// CHECK-NOT: polynomial.intt
+// CHECK: return %[[RES]]
+func.func @mul_scalar(%a: !poly_ty, %b: !poly_ty, %s: !coeff_ty) -> !poly_ty {
+  %0 = polynomial.mul %a, %b : !poly_ty
+  %1 = polynomial.mul_scalar %0, %s : !poly_ty, !coeff_ty
+  return %1 : !poly_ty
+}
+
+// Additions of values in coefficient form stay in coefficient form.
+
+// CHECK-LABEL: func.func @coefficient_add
+// CHECK-NOT: polynomial.ntt
+// CHECK: polynomial.add
+// CHECK-NOT: polynomial.intt
+// CHECK: return
+func.func @coefficient_add(%a: !poly_ty, %b: !poly_ty) -> !poly_ty {
+  %0 = polynomial.add %a, %b : !poly_ty
+  return %0 : !poly_ty
+}
+
+#bad_ideal = #polynomial.int_polynomial<1 + x**6>
+#bad_ring = #polynomial.ring<coefficientType=!mod_arith.int<17:i32>, polynomialModulus=#bad_ideal>
+!bad_poly_ty = !polynomial.polynomial<ring=#bad_ring>
+
+// CHECK-LABEL: func.func @bad_ring
+// CHECK-NOT: polynomial.ntt
+// CHECK: polynomial.mul
+// CHECK: polynomial.add
+// CHECK: return
+func.func @bad_ring(%a: !bad_poly_ty, %b: !bad_poly_ty) -> !bad_poly_ty {
+  %0 = polynomial.mul %a, %b : !bad_poly_ty
+  %1 = polynomial.add %0, %b : !bad_poly_ty
+  return %1 : !bad_poly_ty
+}
+
+// 7917 = 5 mod 8, so the ring has no NTT.
+#unfriendly_ring = #polynomial.ring<coefficientType=!mod_arith.int<7917:i32>, polynomialModulus=#ideal>
+!unfriendly_poly_ty = !polynomial.polynomial<ring=#unfriendly_ring>
+
+// CHECK-LABEL: func.func @unfriendly_modulus
+// CHECK-NOT: polynomial.ntt
+// CHECK: polynomial.mul
+// CHECK: return
+func.func @unfriendly_modulus(%a: !unfriendly_poly_ty, %b: !unfriendly_poly_ty) -> !unfriendly_poly_ty {
+  %0 = polynomial.mul %a, %b : !unfriendly_poly_ty
+  return %0 : !unfriendly_poly_ty
+}
+
+// 7921 = 89^2 is 1 mod 8 but not a prime, so the ring has no NTT.
+#composite_ring = #polynomial.ring<coefficientType=!mod_arith.int<7921:i32>, polynomialModulus=#ideal>
+!composite_poly_ty = !polynomial.polynomial<ring=#composite_ring>
+
+// CHECK-LABEL: func.func @composite_modulus
+// CHECK-NOT: polynomial.ntt
+// CHECK: polynomial.mul
+// CHECK: return
+func.func @composite_modulus(%a: !composite_poly_ty, %b: !composite_poly_ty) -> !composite_poly_ty {
+  %0 = polynomial.mul %a, %b : !composite_poly_ty
+  return %0 : !composite_poly_ty
+}
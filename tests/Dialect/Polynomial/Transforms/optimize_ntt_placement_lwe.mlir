@@ -0,0 +1,57 @@
+// RUN: heir-opt --bgv-to-lwe --lwe-to-polynomial --optimize-ntt-placement %s | FileCheck %s
+// RUN: heir-opt --bgv-to-lwe --lwe-to-polynomial --optimize-ntt-placement --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=STATS
+
+// The tensor product of two ciphertexts (x0, x1) and (y0, y1) lowers to four
+// polynomial products. Each of the four components is converted to evaluation
+// form once, the middle sum x0 * y1 + x1 * y0 is computed pointwise, and only
+// the three components of the result are converted back. The coefficient
+// modulus 786433 = 3 * 2^18 + 1 is a prime that is 1 mod 16, so the ring of
+// degree 8 supports the NTT.
+
+// CHECK: func.func @test_tensor_product
+// CHECK-COUNT-2: polynomial.ntt
+// CHECK: mod_arith.mul
+// CHECK: polynomial.intt
+// CHECK: polynomial.ntt
+// CHECK-NOT: polynomial.intt
+// CHECK: mod_arith.mul
+// CHECK-NOT: polynomial.intt
+// CHECK: polynomial.ntt
+// CHECK-NOT: polynomial.intt
+// CHECK: mod_arith.mul
+// CHECK-NOT: polynomial.intt
+// CHECK: mod_arith.add
+// CHECK: polynomial.intt
+// CHECK-NOT: polynomial.ntt
+// CHECK: mod_arith.mul
+// CHECK: polynomial.intt
+// CHECK: tensor.from_elements
+// CHECK: return
+
+// Converting each product separately needs 12 transforms, and 7 are left.
+
+// STATS: OptimizeNTTPlacement
+// STATS-DAG: (S) 4 ntt ops
+// STATS-DAG: (S) 3 intt ops
+// STATS-DAG: (S) 5 transforms removed
+
+!Zq = !mod_arith.int<786433 : i64>
+!Zt = !mod_arith.int<17 : i64>
+
+#ring_t = #polynomial.ring<coefficientType = !Zt, polynomialModulus = <1 + x**8>>
+#ring_q = #polynomial.ring<coefficientType = !Zq, polynomialModulus = <1 + x**8>>
+
+#key = #lwe.key<>
+#chain = #lwe.modulus_chain<elements = <786433 : i64>, current = 0>
+
+#pt_space = #lwe.plaintext_space<ring = #ring_t, encoding = #lwe.full_crt_packing_encoding<scaling_factor = 1>>
+#ct_space = #lwe.ciphertext_space<ring = #ring_q, encryption_type = lsb>
+#ct_space_D3 = #lwe.ciphertext_space<ring = #ring_q, encryption_type = lsb, size = 3>
+
+!ct = !lwe.new_lwe_ciphertext<application_data = <message_type = i16>, plaintext_space = #pt_space, ciphertext_space = #ct_space, key = #key, modulus_chain = #chain>
+!ct_D3 = !lwe.new_lwe_ciphertext<application_data = <message_type = i16>, plaintext_space = #pt_space, ciphertext_space = #ct_space_D3, key = #key, modulus_chain = #chain>
+
+func.func @test_tensor_product(%x : !ct, %y : !ct) -> !ct_D3 {
+  %mul = bgv.mul %x, %y : (!ct, !ct) -> !ct_D3
+  return %mul : !ct_D3
+}
@@ -0,0 +1,72 @@
+// RUN: heir-opt --batch-tensors=batch-size=4 --canonicalize --split-input-file --verify-diagnostics %s | FileCheck %s
+
+// Rotations stay within each input and the reduced value of input b ends up
+// in slot b.
+
+// CHECK: @simple_sum
+// CHECK-SAME: %[[arg0:[^:]*]]: !secret.secret<tensor<32xi16>> {tensor_ext.original_type = #tensor_ext.original_type<originalType = !secret.secret<tensor<4x8xi16>>, layout = (d0, d1) -> (d1 * 4 + d0)>}
+// CHECK-SAME: -> (!secret.secret<tensor<32xi16>> {tensor_ext.original_type = #tensor_ext.original_type<originalType = !secret.secret<tensor<4xi16>>, layout = (d0) -> (d0)>})
+// CHECK-DAG: %[[c4:.*]] = arith.constant 4 : index
+// CHECK-DAG: %[[c8:.*]] = arith.constant 8 : index
+// CHECK-DAG: %[[c16:.*]] = arith.constant 16 : index
+// CHECK: secret.generic
+// CHECK: ^body(%[[input0:.*]]: tensor<32xi16>):
+// CHECK: tensor_ext.rotate %[[input0]], %[[c16]]
+// CHECK: tensor_ext.rotate %{{.*}}, %[[c8]]
+// CHECK: tensor_ext.rotate %{{.*}}, %[[c4]]
+// CHECK-NOT: tensor.extract
+// CHECK: secret.yield %{{.*}} : tensor<32xi16>
+// CHECK: -> !secret.secret<tensor<32xi16>>
+func.func @simple_sum(%arg0: !secret.secret<tensor<8xi16>>) -> !secret.secret<i16> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c2 = arith.constant 2 : index
+  %c4 = arith.constant 4 : index
+  %0 = secret.generic ins(%arg0 : !secret.secret<tensor<8xi16>>) {
+  ^body(%input0: tensor<8xi16>):
+    %1 = tensor_ext.rotate %input0, %c4 : tensor<8xi16>, index
+    %2 = arith.addi %input0, %1 : tensor<8xi16>
+    %3 = tensor_ext.rotate %2, %c2 : tensor<8xi16>, index
+    %4 = arith.addi %2, %3 : tensor<8xi16>
+    %5 = tensor_ext.rotate %4, %c1 : tensor<8xi16>, index
+    %6 = arith.addi %4, %5 : tensor<8xi16>
+    %extracted = tensor.extract %6[%c0] : tensor<8xi16>
+    secret.yield %extracted : i16
+  } -> !secret.secret<i16>
+  return %0 : !secret.secret<i16>
+}
+
+// -----
+
+// Plaintext tensors are interleaved, plaintext scalars are splatted, and an
+// extraction rotates the extracted element of every input to the front.
+
+// CHECK: @plaintext_operands
+// CHECK-DAG: %[[weights:.*]] = arith.constant dense<[1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4]> : tensor<16xi16>
+// CHECK-DAG: %[[bias:.*]] = arith.constant dense<7> : tensor<16xi16>
+// CHECK-DAG: %[[c8:.*]] = arith.constant 8 : index
+// CHECK: ^body(%[[input0:.*]]: tensor<16xi16>):
+// CHECK: %[[v0:.*]] = arith.muli %[[input0]], %[[weights]] : tensor<16xi16>
+// CHECK: %[[v1:.*]] = tensor_ext.rotate %[[v0]], %[[c8]]
+// CHECK: %[[v2:.*]] = arith.addi %[[v1]], %[[bias]] : tensor<16xi16>
+// CHECK: secret.yield %[[v2]] : tensor<16xi16>
+func.func @plaintext_operands(%arg0: !secret.secret<tensor<4xi16>>) -> !secret.secret<i16> {
+  %c2 = arith.constant 2 : index
+  %bias = arith.constant 7 : i16
+  %weights = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi16>
+  %0 = secret.generic ins(%arg0 : !secret.secret<tensor<4xi16>>) {
+  ^body(%input0: tensor<4xi16>):
+    %1 = arith.muli %input0, %weights : tensor<4xi16>
+    %extracted = tensor.extract %1[%c2] : tensor<4xi16>
+    %2 = arith.addi %extracted, %bias : i16
+    secret.yield %2 : i16
+  } -> !secret.secret<i16>
+  return %0 : !secret.secret<i16>
+}
+
+// -----
+
+// expected-error@below {{cannot batch secret scalar argument 0}}
+func.func @scalar_argument(%arg0: !secret.secret<i16>, %arg1: !secret.secret<tensor<4xi16>>) -> !secret.secret<tensor<4xi16>> {
+  return %arg1 : !secret.secret<tensor<4xi16>>
+}
@@ -0,0 +1,28 @@
+// RUN: rm -rf %t
+// RUN: heir-opt --implement-shift-network="ciphertext-size=16 cache-dir=%t" --mlir-pass-statistics %s 2>&1 | FileCheck %s --check-prefix=COLD
+// RUN: heir-opt --implement-shift-network="ciphertext-size=16 cache-dir=%t" --mlir-pass-statistics %s 2>&1 | FileCheck %s --check-prefix=WARM
+
+// The second function reuses the network of the first one, and a second
+// compilation reuses both from the cache directory.
+
+// COLD: ImplementShiftNetwork
+// COLD-DAG: (S) 1 cache hits
+// COLD-DAG: (S) 2 permute ops
+// COLD-DAG: (S) 6 rotation groups
+// COLD-DAG: (S) 24 rotations
+
+// WARM: ImplementShiftNetwork
+// WARM-DAG: (S) 2 cache hits
+// WARM-DAG: (S) 6 rotation groups
+// WARM-DAG: (S) 24 rotations
+
+#map = dense<[13, 8, 4, 0, 11, 7, 14, 5, 15, 3, 12, 6, 10, 2, 9, 1]> : tensor<16xi64>
+func.func @figure3(%0: tensor<16xi32>) -> tensor<16xi32> {
+  %1 = tensor_ext.permute %0 {permutation = #map} : tensor<16xi32>
+  return %1 : tensor<16xi32>
+}
+
+func.func @figure3_again(%0: tensor<16xi32>) -> tensor<16xi32> {
+  %1 = tensor_ext.permute %0 {permutation = #map} : tensor<16xi32>
+  return %1 : tensor<16xi32>
+}
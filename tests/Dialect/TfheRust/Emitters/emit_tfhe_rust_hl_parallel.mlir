@@ -0,0 +1,76 @@
+// RUN: heir-translate %s --emit-tfhe-rust-hl --tfhe-rust-hl-parallel | FileCheck %s
+
+!sks = !tfhe_rust.server_key
+!eui32 = !tfhe_rust.eui32
+
+// CHECK: use tfhe::{set_server_key, ServerKey};
+
+// CHECK-LABEL: pub fn test_levels(
+// CHECK-NEXT:   [[sks:v[0-9]+]]: &ServerKey,
+// CHECK-NEXT:   [[x:v[0-9]+]]: &Ciphertext,
+// CHECK-NEXT:   [[y:v[0-9]+]]: &Ciphertext,
+// CHECK-NEXT: ) -> Ciphertext {
+// CHECK-NEXT:   set_server_key([[sks]].clone());
+// CHECK-NEXT:   rayon::broadcast(|_| set_server_key([[sks]].clone()));
+// CHECK-NEXT:   let ([[v0:v[0-9]+]], ([[v1:v[0-9]+]], [[v2:v[0-9]+]])) = rayon::join(
+// CHECK-NEXT:     || {
+// CHECK-NEXT:       let [[v0]] = [[x]] * [[y]];
+// CHECK-NEXT:       [[v0]]
+// CHECK-NEXT:     },
+// CHECK-NEXT:     || rayon::join(
+// CHECK-NEXT:       || {
+// CHECK-NEXT:         let [[v1]] = [[x]] + [[y]];
+// CHECK-NEXT:         [[v1]]
+// CHECK-NEXT:       },
+// CHECK-NEXT:       || {
+// CHECK-NEXT:         let [[v2]] = [[x]] - [[y]];
+// CHECK-NEXT:         [[v2]]
+// CHECK-NEXT:       },
+// CHECK-NEXT:     ),
+// CHECK-NEXT:   );
+// CHECK-NEXT:   let [[v3:v[0-9]+]] = &[[v0]] + &[[v1]];
+// CHECK-NEXT:   let [[v4:v[0-9]+]] = &[[v3]] * &[[v2]];
+// CHECK-NEXT:   [[v4]]
+// CHECK-NEXT: }
+func.func @test_levels(%sks : !sks, %x : !eui32, %y : !eui32) -> !eui32 {
+  %0 = tfhe_rust.mul %sks, %x, %y : (!sks, !eui32, !eui32) -> !eui32
+  %1 = tfhe_rust.add %sks, %x, %y : (!sks, !eui32, !eui32) -> !eui32
+  %2 = tfhe_rust.sub %sks, %x, %y : (!sks, !eui32, !eui32) -> !eui32
+  %3 = tfhe_rust.add %sks, %0, %1 : (!sks, !eui32, !eui32) -> !eui32
+  %4 = tfhe_rust.mul %sks, %3, %2 : (!sks, !eui32, !eui32) -> !eui32
+  return %4 : !eui32
+}
+
+// The trivial ciphertexts are created ahead of the ops that do not use them,
+// so that both multiplications run concurrently.
+
+// CHECK-LABEL: pub fn test_hoisting(
+// CHECK-NEXT:   [[sks:v[0-9]+]]: &ServerKey,
+// CHECK-NEXT:   [[x:v[0-9]+]]: &Ciphertext,
+// CHECK-NEXT: ) -> Ciphertext {
+// CHECK-NEXT:   set_server_key([[sks]].clone());
+// CHECK-NEXT:   rayon::broadcast(|_| set_server_key([[sks]].clone()));
+// CHECK-NEXT:   let [[c3:v[0-9]+]] = 3{{.*}};
+// CHECK-NEXT:   let [[t3:v[0-9]+]] = FheUint32::try_encrypt_trivial([[c3]]).unwrap();
+// CHECK-NEXT:   let [[c5:v[0-9]+]] = 5{{.*}};
+// CHECK-NEXT:   let [[t5:v[0-9]+]] = FheUint32::try_encrypt_trivial([[c5]]).unwrap();
+// CHECK-NEXT:   let ([[m3:v[0-9]+]], [[m5:v[0-9]+]]) = rayon::join(
+// CHECK-NEXT:     || {
+// CHECK-NEXT:       let [[m3]] = [[x]] * &[[t3]];
+// CHECK:            let [[m5]] = [[x]] * &[[t5]];
+// CHECK:          );
+// CHECK-NEXT:   let [[sum:v[0-9]+]] = &[[m3]] + &[[m5]];
+// CHECK-NEXT:   let [[res:v[0-9]+]] = test_levels(&[[sks]], &[[sum]], &[[x]]);
+// CHECK-NEXT:   [[res]]
+// CHECK-NEXT: }
+func.func @test_hoisting(%sks : !sks, %x : !eui32) -> !eui32 {
+  %c3 = arith.constant 3 : i32
+  %0 = tfhe_rust.create_trivial %sks, %c3 : (!sks, i32) -> !eui32
+  %1 = tfhe_rust.mul %sks, %x, %0 : (!sks, !eui32, !eui32) -> !eui32
+  %c5 = arith.constant 5 : i32
+  %2 = tfhe_rust.create_trivial %sks, %c5 : (!sks, i32) -> !eui32
+  %3 = tfhe_rust.mul %sks, %x, %2 : (!sks, !eui32, !eui32) -> !eui32
+  %4 = tfhe_rust.add %sks, %1, %3 : (!sks, !eui32, !eui32) -> !eui32
+  %5 = func.call @test_levels(%sks, %4, %x) : (!sks, !eui32, !eui32) -> !eui32
+  return %5 : !eui32
+}
@@ -0,0 +1,357 @@
+"""Measures the compile time and peak memory of heir-opt pipelines.
+
+Each benchmark generates an input program of a given size, runs one heir-opt
+pipeline on it with -mlir-timing, and records the total wall time, the wall
+time of each pass, and the peak resident set size of the heir-opt process.
+Results are written as JSON so they can be compared across commits:
+
+  bazel run //tests/Examples/benchmark:compile_time_benchmark -- \
+      --output=/tmp/after.json --baseline=/tmp/before.json
+
+When a baseline is given, passes that got slower by more than `threshold`
+(relative) and `min_seconds` (absolute) are reported and the script exits with
+a non-zero status.
+"""
+
+import argparse
+import dataclasses
+import json
+import os
+import pathlib
+import re
+import subprocess
+import sys
+import tempfile
+import time
+from typing import Callable, Optional
+
+
+def box_blur_bgv(n: int) -> str:
+  """An n x n box blur over a packed secret image, as in box_blur_64x64."""
+  size = n * n
+  return f"""
+func.func @box_blur(%arg0: tensor<{size}xi16> {{secret.secret}}) -> tensor<{size}xi16> {{
+  %c{size} = arith.constant {size} : index
+  %c{n} = arith.constant {n} : index
+  %0 = affine.for %x = 0 to {n} iter_args(%arg0_x = %arg0) -> (tensor<{size}xi16>) {{
+    %1 = affine.for %y = 0 to {n} iter_args(%arg0_y = %arg0_x) -> (tensor<{size}xi16>) {{
+      %c0_si16 = arith.constant 0 : i16
+      %2 = affine.for %j = -1 to 2 iter_args(%value_j = %c0_si16) -> (i16) {{
+        %6 = affine.for %i = -1 to 2 iter_args(%value_i = %value_j) -> (i16) {{
+          %7 = arith.addi %x, %i : index
+          %8 = arith.muli %7, %c{n} : index
+          %9 = arith.addi %y, %j : index
+          %10 = arith.addi %8, %9 : index
+          %11 = arith.remui %10, %c{size} : index
+          %12 = tensor.extract %arg0[%11] : tensor<{size}xi16>
+          %13 = arith.addi %value_i, %12 : i16
+          affine.yield %13 : i16
+        }}
+        affine.yield %6 : i16
+      }}
+      %3 = arith.muli %c{n}, %x : index
+      %4 = arith.addi %3, %y : index
+      %5 = arith.remui %4, %c{size} : index
+      %6 = tensor.insert %2 into %arg0_y[%5] : tensor<{size}xi16>
+      affine.yield %6 : tensor<{size}xi16>
+    }}
+    affine.yield %1 : tensor<{size}xi16>
+  }}
+  return %0 : tensor<{size}xi16>
+}}
+"""
+
+
+def dot_product_ckks(n: int) -> str:
+  """A dot product of two secret vectors of length n, as in dot_product_8f."""
+  return f"""
+func.func @dot_product(%arg0: tensor<{n}xf32> {{secret.secret}}, %arg1: tensor<{n}xf32> {{secret.secret}}) -> f32 {{
+  %c0_sf32 = arith.constant 0.1 : f32
+  %0 = affine.for %arg2 = 0 to {n} iter_args(%iter = %c0_sf32) -> (f32) {{
+    %1 = tensor.extract %arg0[%arg2] : tensor<{n}xf32>
+    %2 = tensor.extract %arg1[%arg2] : tensor<{n}xf32>
+    %3 = arith.mulf %1, %2 : f32
+    %4 = arith.addf %iter, %3 : f32
+    affine.yield %4 : f32
+  }}
+  return %0 : f32
+}}
+"""
+
+
+def fully_connected_tfhe(n: int) -> str:
+  """A quantized 1 x n by n x n matmul, as in tosa_to_boolean_tfhe tests."""
+  return f"""
+func.func @main(%arg0: tensor<1x{n}xi8> {{secret.secret}}) -> tensor<1x{n}xi32> {{
+  %cst = arith.constant dense<1> : tensor<{n}x{n}xi8>
+  %cst_0 = arith.constant dense<1> : tensor<1x{n}xi32>
+  %c-128_i32 = arith.constant -128 : i32
+  %c0_i32 = arith.constant 0 : i32
+  %1 = linalg.quantized_matmul ins(%arg0, %cst, %c-128_i32, %c0_i32 : tensor<1x{n}xi8>, tensor<{n}x{n}xi8>, i32, i32) outs(%cst_0 : tensor<1x{n}xi32>) -> tensor<1x{n}xi32>
+  return %1 : tensor<1x{n}xi32>
+}}
+"""
+
+
+@dataclasses.dataclass
+class Benchmark:
+  name: str
+  pipeline: list[str]
+  generator: Callable[[int], str]
+  sizes: list[int]
+
+
+BENCHMARKS = [
+    Benchmark(
+        name="box_blur_bgv",
+        pipeline=["--mlir-to-openfhe-bgv=ciphertext-degree=8192"],
+        generator=box_blur_bgv,
+        sizes=[8, 16, 32, 64],
+    ),
+    Benchmark(
+        name="dot_product_ckks",
+        pipeline=["--mlir-to-openfhe-ckks=ciphertext-degree=8192"],
+        generator=dot_product_ckks,
+        sizes=[8, 64, 512, 4096],
+    ),
+    Benchmark(
+        name="fully_connected_boolean_tfhe",
+        pipeline=["--tosa-to-boolean-tfhe=abc-fast=true"],
+        generator=fully_connected_tfhe,
+        sizes=[1, 2, 4],
+    ),
+]
+
+
+# A line of the text timing report, e.g. "  0.0123 (  4.5%)  InsertRotate".
+TEXT_TIMING_LINE = re.compile(r"^\s*([0-9.]+)\s+\(\s*[0-9.]+%\)\s+(.*\S)\s*$")
+
+
+def parse_timing(stderr: str) -> dict[str, float]:
+  """Returns the wall time in seconds of each entry in a -mlir-timing report.
+
+  Entries with the same name, e.g. a pass that runs more than once, are
+  summed.
+  """
+  timings = {}
+
+  # With --mlir-output-format=json the report is a JSON array of entries of
+  # the form {"name": ..., "wall": {"duration": ..., "percentage": ...}}.
+  start = stderr.find("[\n{")
+  if start >= 0:
+    try:
+      entries = json.loads(stderr[start : stderr.rindex("]") + 1])
+      for entry in entries:
+        name = entry["name"].strip()
+        timings[name] = timings.get(name, 0.0) + entry["wall"]["duration"]
+      return timings
+    except (ValueError, KeyError):
+      timings = {}
+
+  for line in stderr.splitlines():
+    match = TEXT_TIMING_LINE.match(line)
+    if match:
+      name = match.group(2)
+      timings[name] = timings.get(name, 0.0) + float(match.group(1))
+  return timings
+
+
+def yosys_env(heir_opt: str) -> dict[str, str]:
+  """Points the Yosys optimizer at the runfiles of a bazel-built heir-opt."""
+  env = dict(os.environ)
+  runfiles = pathlib.Path(heir_opt + ".runfiles")
+  if "HEIR_ABC_BINARY" not in env:
+    abc = runfiles / "edu_berkeley_abc" / "abc"
+    if abc.exists():
+      env["HEIR_ABC_BINARY"] = str(abc)
+  if "HEIR_YOSYS_SCRIPTS_DIR" not in env:
+    scripts = runfiles / "_main" / "lib" / "Transforms" / "YosysOptimizer"
+    scripts = scripts / "yosys"
+    if scripts.exists():
+      env["HEIR_YOSYS_SCRIPTS_DIR"] = str(scripts)
+  return env
+
+
+def run_one(heir_opt: str, pipeline: list[str], input_path: str,
+            env: dict[str, str]) -> dict:
+  """Runs heir-opt once and returns its timing and peak memory."""
+  cmd = [
+      heir_opt,
+      *pipeline,
+      "--mlir-timing",
+      "--mlir-timing-display=list",
+      "--mlir-output-format=json",
+      "-o",
+      os.devnull,
+      input_path,
+  ]
+  start = time.monotonic()
+  proc = subprocess.Popen(
+      cmd, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, env=env, text=True
+  )
+  # Read stderr before waiting, so a large report cannot fill the pipe.
+  stderr = proc.stderr.read()
+  proc.stderr.close()
+  # wait4 reports the resource usage of this child alone, unlike
+  # getrusage(RUSAGE_CHILDREN) which accumulates over all children.
+  _, status, rusage = os.wait4(proc.pid, 0)
+  proc.returncode = os.waitstatus_to_exitcode(status)
+  wall = time.monotonic() - start
+
+  result = {
+      "exit_code": proc.returncode,
+      "wall_seconds": wall,
+      # ru_maxrss is in KiB on Linux.
+      "peak_rss_kib": rusage.ru_maxrss,
+      "passes": {},
+  }
+  if proc.returncode != 0:
+    result["error"] = stderr[-2000:]
+    return result
+  result["passes"] = parse_timing(stderr)
+  return result
+
+
+def compare(results: list[dict], baseline_path: str, threshold: float,
+            min_seconds: float) -> list[str]:
+  """Returns a description of each regression relative to the baseline."""
+  with open(baseline_path) as f:
+    baseline = {(r["benchmark"], r["size"]): r for r in json.load(f)}
+
+  regressions = []
+  for result in results:
+    old = baseline.get((result["benchmark"], result["size"]))
+    if old is None:
+      continue
+    label = f"{result['benchmark']}[{result['size']}]"
+    for name, seconds in result["passes"].items():
+      old_seconds = old["passes"].get(name)
+      if old_seconds is None:
+        continue
+      if (seconds - old_seconds > min_seconds and
+          seconds > old_seconds * (1 + threshold)):
+        regressions.append(
+            f"{label} {name}: {old_seconds:.3f}s -> {seconds:.3f}s"
+        )
+    old_rss = old["peak_rss_kib"]
+    if result["peak_rss_kib"] > old_rss * (1 + threshold):
+      regressions.append(
+          f"{label} peak RSS: {old_rss} KiB -> {result['peak_rss_kib']} KiB"
+      )
+  return regressions
+
+
+def main():
+  parser = argparse.ArgumentParser(
+      description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter
+  )
+  parser.add_argument(
+      "--heir_opt", default="heir-opt", help="Path to the heir-opt binary."
+  )
+  parser.add_argument(
+      "--output",
+      default="",
+      help="File to write the JSON results to. Defaults to stdout.",
+  )
+  parser.add_argument(
+      "--benchmarks",
+      default="",
+      help="Comma-separated names of benchmarks to run. Defaults to all.",
+  )
+  parser.add_argument(
+      "--sizes",
+      default="",
+      help="Comma-separated input sizes, overriding each benchmark's defaults.",
+  )
+  parser.add_argument(
+      "--repetitions",
+      type=int,
+      default=1,
+      help="Number of runs per input; the fastest run is reported.",
+  )
+  parser.add_argument(
+      "--baseline",
+      default="",
+      help="A previous output of this script to compare against.",
+  )
+  parser.add_argument(
+      "--threshold",
+      type=float,
+      default=0.2,
+      help=(
+          "Relative slowdown of a pass, or growth of peak RSS, that counts as"
+          " a regression."
+      ),
+  )
+  parser.add_argument(
+      "--min_seconds",
+      type=float,
+      default=0.05,
+      help="Absolute slowdown of a pass below which it is ignored.",
+  )
+  args = parser.parse_args()
+  heir_opt = args.heir_opt
+  output = args.output
+  benchmarks = args.benchmarks
+  sizes = args.sizes
+  repetitions = args.repetitions
+  baseline = args.baseline
+  threshold = args.threshold
+  min_seconds = args.min_seconds
+
+  selected = set(benchmarks.split(",")) if benchmarks else None
+  size_override = [int(s) for s in sizes.split(",")] if sizes else None
+  env = yosys_env(heir_opt)
+
+  results = []
+  with tempfile.TemporaryDirectory() as tmpdir:
+    for benchmark in BENCHMARKS:
+      if selected is not None and benchmark.name not in selected:
+        continue
+      for size in size_override or benchmark.sizes:
+        input_path = os.path.join(tmpdir, f"{benchmark.name}_{size}.mlir")
+        with open(input_path, "w") as f:
+          f.write(benchmark.generator(size))
+
+        best: Optional[dict] = None
+        for _ in range(repetitions):
+          run = run_one(heir_opt, benchmark.pipeline, input_path, env)
+          if best is None or run["wall_seconds"] < best["wall_seconds"]:
+            best = run
+        result = {
+            "benchmark": benchmark.name,
+            "pipeline": " ".join(benchmark.pipeline),
+            "size": size,
+            **best,
+        }
+        results.append(result)
+        print(
+            f"{benchmark.name}[{size}]: {result['wall_seconds']:.3f}s, "
+            f"{result['peak_rss_kib']} KiB",
+            file=sys.stderr,
+        )
+
+  serialized = json.dumps(results, indent=2)
+  if output:
+    with open(output, "w") as f:
+      f.write(serialized + "\n")
+  else:
+    print(serialized)
+
+  failed = [r for r in results if r["exit_code"] != 0]
+  for r in failed:
+    print(f"{r['benchmark']}[{r['size']}] failed:\n{r['error']}",
+          file=sys.stderr)
+
+  regressions = []
+  if baseline:
+    regressions = compare(results, baseline, threshold, min_seconds)
+    for regression in regressions:
+      print(f"Regression: {regression}", file=sys.stderr)
+
+  if failed or regressions:
+    sys.exit(1)
+
+
+if __name__ == "__main__":
+  main()
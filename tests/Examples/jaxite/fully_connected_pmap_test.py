@@ -0,0 +1,50 @@
+"""Tests for fully_connected with jaxite.lut3 ops grouped into pmap_lut3."""
+
+import os
+
+# pmap_lut3 maps over devices, so emulate as many CPU devices as the
+# parallelism passed to --jaxite-pmap-lut3. This must be set before jax is
+# imported.
+os.environ["XLA_FLAGS"] = (
+    os.environ.get("XLA_FLAGS", "")
+    + " --xla_force_host_platform_device_count=4"
+)
+
+import time  # pylint: disable=g-import-not-at-top
+
+from absl import logging  # pylint: disable=g-import-not-at-top
+from absl.testing import absltest  # pylint: disable=g-import-not-at-top
+from tests.Examples.jaxite import fully_connected_lib  # pylint: disable=g-import-not-at-top
+from tests.Examples.jaxite import fully_connected_pmap_lib  # pylint: disable=g-import-not-at-top
+from tests.Examples.jaxite import test_utils  # pylint: disable=g-import-not-at-top
+
+
+class FullyConnectedPmapTest(absltest.TestCase):
+
+  def test_add_one(self):
+    x = 25
+    lwe_rng, boolean_params, cks, sks = test_utils.setup_test_params()
+    ciphertext_x = test_utils.encrypt_u8(x, cks, lwe_rng)
+
+    start = time.perf_counter()
+    result_ciphertext = fully_connected_pmap_lib.main(
+        ciphertext_x,
+        sks,
+        boolean_params,
+    )
+    pmap_time = time.perf_counter() - start
+
+    start = time.perf_counter()
+    fully_connected_lib.main(ciphertext_x, sks, boolean_params)
+    sequential_time = time.perf_counter() - start
+    logging.info(
+        "pmap_lut3: %.2fs, lut3: %.2fs", pmap_time, sequential_time
+    )
+
+    result = test_utils.decrypt_int(result_ciphertext, cks, num_bits=32)
+    # The result should be x + 1 + 128 (input_zp = -128)
+    self.assertEqual(x + 1 + 128, result)
+
+
+if __name__ == "__main__":
+  absltest.main()
@@ -0,0 +1,69 @@
+package boxblurparallel
+
+import (
+	"fmt"
+	"runtime"
+	"testing"
+)
+
+func expectedBoxBlur(input []int16) []int16 {
+	expected := make([]int16, 4096)
+	for row := 0; row < 64; row++ {
+		for col := 0; col < 64; col++ {
+			sum := int16(0)
+			for di := -1; di < 2; di++ {
+				for dj := -1; dj < 2; dj++ {
+					index := (row*64 + col + di*64 + dj) % 4096
+					if index < 0 {
+						index += 4096
+					}
+					sum += input[index]
+				}
+			}
+			expected[row*64+col] = sum
+		}
+	}
+	return expected
+}
+
+func TestBoxBlurParallel(t *testing.T) {
+	evaluator, params, ecd, enc, dec := box_blur__configure()
+
+	input := make([]int16, 4096)
+	for i := 0; i < 4096; i++ {
+		input[i] = int16(i)
+	}
+	expected := expectedBoxBlur(input)
+
+	ct0 := box_blur__encrypt__arg0(evaluator, params, ecd, enc, input)
+
+	resultCt := box_blur(evaluator, params, ecd, ct0)
+
+	result := box_blur__decrypt__result0(evaluator, params, ecd, dec, resultCt)
+
+	for i := 0; i < 4096; i++ {
+		if result[i] != expected[i] {
+			t.Errorf("Decryption error at %d: %d != %d", i, result[i], expected[i])
+		}
+	}
+}
+
+func BenchmarkBoxBlurParallel(b *testing.B) {
+	evaluator, params, ecd, enc, _ := box_blur__configure()
+
+	input := make([]int16, 4096)
+	for i := 0; i < 4096; i++ {
+		input[i] = int16(i)
+	}
+	ct0 := box_blur__encrypt__arg0(evaluator, params, ecd, enc, input)
+
+	defer runtime.GOMAXPROCS(runtime.GOMAXPROCS(0))
+	for _, procs := range []int{1, 2, 4, 8} {
+		b.Run(fmt.Sprintf("GOMAXPROCS=%d", procs), func(b *testing.B) {
+			runtime.GOMAXPROCS(procs)
+			for i := 0; i < b.N; i++ {
+				box_blur(evaluator, params, ecd, ct0)
+			}
+		})
+	}
+}
@@ -0,0 +1,41 @@
+// RUN: heir-translate %s --emit-tfhe-rust-hl --tfhe-rust-hl-parallel > %S/src/fn_under_test_parallel.rs
+// RUN: cargo run --release --manifest-path %S/Cargo.toml --bin main_parallel -- 27 | FileCheck %s
+
+// The six products are independent, as are the first three sums.
+// CHECK: 567
+module attributes {tf_saved_model.semantics} {
+  func.func @fn_under_test(%arg0: !tfhe_rust.server_key, %arg1: memref<2x3x!tfhe_rust.eui32>) -> memref<1x1x!tfhe_rust.eui32> {
+    %c1_i32 = arith.constant 1 : i32
+    %t1 = tfhe_rust.create_trivial %arg0, %c1_i32 : (!tfhe_rust.server_key, i32) -> !tfhe_rust.eui32
+    %x1 = affine.load %arg1[0, 0] : memref<2x3x!tfhe_rust.eui32>
+    %p1 = tfhe_rust.mul %arg0, %x1, %t1 : (!tfhe_rust.server_key, !tfhe_rust.eui32, !tfhe_rust.eui32) -> !tfhe_rust.eui32
+    %c2_i32 = arith.constant 2 : i32
+    %t2 = tfhe_rust.create_trivial %arg0, %c2_i32 : (!tfhe_rust.server_key, i32) -> !tfhe_rust.eui32
+    %x2 = affine.load %arg1[0, 1] : memref<2x3x!tfhe_rust.eui32>
+    %p2 = tfhe_rust.mul %arg0, %x2, %t2 : (!tfhe_rust.server_key, !tfhe_rust.eui32, !tfhe_rust.eui32) -> !tfhe_rust.eui32
+    %c3_i32 = arith.constant 3 : i32
+    %t3 = tfhe_rust.create_trivial %arg0, %c3_i32 : (!tfhe_rust.server_key, i32) -> !tfhe_rust.eui32
+    %x3 = affine.load %arg1[0, 2] : memref<2x3x!tfhe_rust.eui32>
+    %p3 = tfhe_rust.mul %arg0, %x3, %t3 : (!tfhe_rust.server_key, !tfhe_rust.eui32, !tfhe_rust.eui32) -> !tfhe_rust.eui32
+    %c4_i32 = arith.constant 4 : i32
+    %t4 = tfhe_rust.create_trivial %arg0, %c4_i32 : (!tfhe_rust.server_key, i32) -> !tfhe_rust.eui32
+    %x4 = affine.load %arg1[1, 0] : memref<2x3x!tfhe_rust.eui32>
+    %p4 = tfhe_rust.mul %arg0, %x4, %t4 : (!tfhe_rust.server_key, !tfhe_rust.eui32, !tfhe_rust.eui32) -> !tfhe_rust.eui32
+    %c5_i32 = arith.constant 5 : i32
+    %t5 = tfhe_rust.create_trivial %arg0, %c5_i32 : (!tfhe_rust.server_key, i32) -> !tfhe_rust.eui32
+    %x5 = affine.load %arg1[1, 1] : memref<2x3x!tfhe_rust.eui32>
+    %p5 = tfhe_rust.mul %arg0, %x5, %t5 : (!tfhe_rust.server_key, !tfhe_rust.eui32, !tfhe_rust.eui32) -> !tfhe_rust.eui32
+    %c6_i32 = arith.constant 6 : i32
+    %t6 = tfhe_rust.create_trivial %arg0, %c6_i32 : (!tfhe_rust.server_key, i32) -> !tfhe_rust.eui32
+    %x6 = affine.load %arg1[1, 2] : memref<2x3x!tfhe_rust.eui32>
+    %p6 = tfhe_rust.mul %arg0, %x6, %t6 : (!tfhe_rust.server_key, !tfhe_rust.eui32, !tfhe_rust.eui32) -> !tfhe_rust.eui32
+    %s0 = tfhe_rust.add %arg0, %p1, %p2 : (!tfhe_rust.server_key, !tfhe_rust.eui32, !tfhe_rust.eui32) -> !tfhe_rust.eui32
+    %s1 = tfhe_rust.add %arg0, %p3, %p4 : (!tfhe_rust.server_key, !tfhe_rust.eui32, !tfhe_rust.eui32) -> !tfhe_rust.eui32
+    %s2 = tfhe_rust.add %arg0, %p5, %p6 : (!tfhe_rust.server_key, !tfhe_rust.eui32, !tfhe_rust.eui32) -> !tfhe_rust.eui32
+    %s3 = tfhe_rust.add %arg0, %s0, %s1 : (!tfhe_rust.server_key, !tfhe_rust.eui32, !tfhe_rust.eui32) -> !tfhe_rust.eui32
+    %s4 = tfhe_rust.add %arg0, %s3, %s2 : (!tfhe_rust.server_key, !tfhe_rust.eui32, !tfhe_rust.eui32) -> !tfhe_rust.eui32
+    %alloc = memref.alloc() {alignment = 64 : i64} : memref<1x1x!tfhe_rust.eui32>
+    affine.store %s4, %alloc[0, 0] : memref<1x1x!tfhe_rust.eui32>
+    return %alloc : memref<1x1x!tfhe_rust.eui32>
+  }
+}
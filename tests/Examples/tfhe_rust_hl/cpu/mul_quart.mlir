@@ -0,0 +1,17 @@
+// RUN: heir-opt --arith-to-cggi-quart --cggi-to-tfhe-rust %s | heir-translate --emit-tfhe-rust-hl > %S/src/fn_under_test_quart.rs
+// RUN: cargo run --release --manifest-path %S/Cargo.toml --bin main_quart -- 4294967295 4294967295 | FileCheck %s --check-prefix=MAX
+// RUN: cargo run --release --manifest-path %S/Cargo.toml --bin main_quart -- 4042322160 252645135 | FileCheck %s --check-prefix=MIXED
+
+// An i32 multiplication split into four 8 bit limbs, each stored in 16 bits.
+// With all limbs at 255, the sum of the limb products at every position
+// overflows the 16 bit storage unless carries are extracted early, which the
+// previous lowering did not do.
+
+// 0xFFFFFFFF * 0xFFFFFFFF mod 2^32 = 1
+// MAX: 1
+// 0xF0F0F0F0 * 0x0F0F0F0F mod 2^32 = 1783377424
+// MIXED: 1783377424
+func.func @fn_under_test(%arg0: i32, %arg1: i32) -> i32 {
+  %0 = arith.muli %arg0, %arg1 : i32
+  return %0 : i32
+}
@@ -0,0 +1,46 @@
+use std::time::Instant;
+
+use clap::Parser;
+use tfhe::{ConfigBuilder, generate_keys, set_server_key, FheUint32};
+use tfhe::prelude::*;
+
+
+mod fn_under_test_parallel;
+
+#[derive(Parser, Debug)]
+struct Args {
+    /// arguments to forward to function under test
+    #[arg(id = "input_1", index = 1)]
+    input1: u8,
+}
+
+// Input = 27, output = (1 + 2 + 3 + 4 + 5 + 6) * 27 = 567
+fn main() {
+  let flags = Args::parse();
+
+  let config = ConfigBuilder::default().build();
+
+  // Client-side
+  let (client_key, server_key) = generate_keys(config);
+
+  let a: tfhe::FheUint<tfhe::FheUint32Id> = FheUint32::encrypt(flags.input1, &client_key);
+  let input_vec = core::array::from_fn(|_3| core::array::from_fn(|_2| a.clone()));
+
+  set_server_key(server_key.clone());
+
+  // Compare the runtime of the generated code on thread pools of growing size.
+  let mut output: u32 = 0;
+  for num_threads in [1, 2, 4, 8] {
+    let pool = rayon::ThreadPoolBuilder::new().num_threads(num_threads).build().unwrap();
+
+    let t = Instant::now();
+    let result = pool.install(|| fn_under_test_parallel::fn_under_test(&server_key, &input_vec));
+    let elapsed = t.elapsed();
+
+    println!("Time elapsed with {} threads: {:?}", num_threads, elapsed.as_secs_f32());
+
+    output = result[0][0].decrypt(&client_key);
+  }
+  println!("{:?}", output);
+
+}
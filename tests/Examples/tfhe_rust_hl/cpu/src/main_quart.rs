@@ -0,0 +1,53 @@
+use std::time::Instant;
+
+use clap::Parser;
+use tfhe::{ConfigBuilder, generate_keys, set_server_key, ClientKey, FheUint16};
+use tfhe::prelude::*;
+
+
+mod fn_under_test_quart;
+
+#[derive(Parser, Debug)]
+struct Args {
+    /// arguments to forward to function under test
+    #[arg(id = "input_1", index = 1)]
+    input1: u32,
+
+    #[arg(id = "input_2", index = 2)]
+    input2: u32,
+}
+
+// The i32 inputs and output are split into four 8 bit limbs, least
+// significant first, each encrypted in a 16 bit ciphertext.
+fn encrypt_limbs(value: u32, client_key: &ClientKey) -> Vec<FheUint16> {
+  (0..4)
+    .map(|i| FheUint16::encrypt(((value >> (8 * i)) & 0xFF) as u16, client_key))
+    .collect()
+}
+
+fn main() {
+  let flags = Args::parse();
+
+  let config = ConfigBuilder::default().build();
+
+  // Client-side
+  let (client_key, server_key) = generate_keys(config);
+
+  let a = encrypt_limbs(flags.input1, &client_key);
+  let b = encrypt_limbs(flags.input2, &client_key);
+
+  set_server_key(server_key);
+
+  let t = Instant::now();
+  let result = fn_under_test_quart::fn_under_test(&a, &b);
+  let elapsed = t.elapsed();
+
+  println!("Time elapsed: {:?}", elapsed.as_secs_f32());
+
+  let mut output: u32 = 0;
+  for (i, limb) in result.iter().enumerate() {
+    let limb: u16 = limb.decrypt(&client_key);
+    output |= ((limb & 0xFF) as u32) << (8 * i);
+  }
+  println!("{:?}", output);
+}
@@ -0,0 +1,47 @@
+// RUN: rm -rf %t.cache
+// RUN: heir-opt --heir-pipeline-cache-dir=%t.cache --canonicalize %s -o %t.out 2>&1 | FileCheck %s --check-prefix=COLD
+// RUN: FileCheck %s --input-file=%t.out
+// RUN: heir-opt --heir-pipeline-cache-dir=%t.cache --canonicalize %s -o %t.out 2>&1 | FileCheck %s --check-prefix=WARM
+// RUN: FileCheck %s --input-file=%t.out
+
+// Editing a function only recompiles it and its callers.
+// RUN: sed -e 's/arith.constant 7 : i32/arith.constant 8 : i32/' %s > %t.edited.mlir
+// RUN: heir-opt --heir-pipeline-cache-dir=%t.cache --canonicalize %t.edited.mlir -o %t.out 2>&1 | FileCheck %s --check-prefix=EDITED
+// RUN: FileCheck %s --check-prefix=EDITED-IR --input-file=%t.out
+
+// Changing the pipeline recompiles everything.
+// RUN: heir-opt --heir-pipeline-cache-dir=%t.cache --canonicalize --cse %s -o %t.out 2>&1 | FileCheck %s --check-prefix=COLD
+
+// COLD: Pipeline cache {{.*}}: 0 hits, 3 misses
+// WARM: Pipeline cache {{.*}}: 3 hits, 0 misses
+// EDITED: Pipeline cache {{.*}}: 1 hits, 2 misses
+
+// Declarations are kept even if no function calls them.
+// CHECK: func.func private @external(i32) -> i32
+// CHECK-LABEL: @add_seven
+// CHECK: arith.constant 7 : i32
+// CHECK-LABEL: @add_zero
+// CHECK-NOT: arith.addi
+// CHECK-LABEL: @call_add_seven
+// CHECK: call @add_seven
+
+// EDITED-IR-LABEL: @add_seven
+// EDITED-IR: arith.constant 8 : i32
+func.func private @external(i32) -> i32
+
+func.func @add_seven(%arg0: i32) -> i32 {
+  %c7 = arith.constant 7 : i32
+  %0 = arith.addi %arg0, %c7 : i32
+  return %0 : i32
+}
+
+func.func @add_zero(%arg0: i32) -> i32 {
+  %c0 = arith.constant 0 : i32
+  %0 = arith.addi %arg0, %c0 : i32
+  return %0 : i32
+}
+
+func.func @call_add_seven(%arg0: i32) -> i32 {
+  %0 = func.call @add_seven(%arg0) : (i32) -> i32
+  return %0 : i32
+}
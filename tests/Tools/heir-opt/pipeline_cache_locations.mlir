@@ -0,0 +1,28 @@
+// RUN: rm -rf %t.cache
+// RUN: heir-opt --heir-pipeline-cache-dir=%t.cache --canonicalize --mlir-print-debuginfo --mlir-print-local-scope %s -o %t.out 2>&1 | FileCheck %s --check-prefix=COLD
+// RUN: FileCheck %s --check-prefix=ORIG --input-file=%t.out
+
+// The cache key ignores locations, so moving every function one line down
+// reuses all entries. The reused results carry the locations of the new input.
+// RUN: sed -e '1p' %s > %t.shifted.mlir
+// RUN: heir-opt --heir-pipeline-cache-dir=%t.cache --canonicalize --mlir-print-debuginfo --mlir-print-local-scope %t.shifted.mlir -o %t.out 2>&1 | FileCheck %s --check-prefix=WARM
+// RUN: FileCheck %s --check-prefix=SHIFTED --input-file=%t.out
+
+// COLD: Pipeline cache {{.*}}: 0 hits, 2 misses
+// WARM: Pipeline cache {{.*}}: 2 hits, 0 misses
+
+// ORIG: arith.addi %arg0, %{{.*}} : i32 loc("{{.*}}pipeline_cache_locations.mlir":[[# @LINE + 5]]:{{[0-9]+}})
+// SHIFTED: arith.addi %arg0, %{{.*}} : i32 loc("{{.*}}shifted.mlir":[[# @LINE + 5]]:{{[0-9]+}})
+// SHIFTED-NOT: pipeline_cache_locations.mlir
+func.func @add_seven(%arg0: i32) -> i32 {
+  %c7 = arith.constant 7 : i32
+  %0 = arith.addi %arg0, %c7 : i32
+  return %0 : i32
+}
+
+// ORIG: func.call @add_seven(%arg0) : (i32) -> i32 loc("{{.*}}pipeline_cache_locations.mlir":[[# @LINE + 3]]:{{[0-9]+}})
+// SHIFTED: func.call @add_seven(%arg0) : (i32) -> i32 loc("{{.*}}shifted.mlir":[[# @LINE + 3]]:{{[0-9]+}})
+func.func @call_add_seven(%arg0: i32) -> i32 {
+  %0 = func.call @add_seven(%arg0) : (i32) -> i32
+  return %0 : i32
+}
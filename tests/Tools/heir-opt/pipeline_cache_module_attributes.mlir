@@ -0,0 +1,20 @@
+// RUN: rm -rf %t.cache
+// RUN: heir-opt --heir-pipeline-cache-dir=%t.cache --secret-insert-mgmt-bgv %s -o %t.out
+// RUN: FileCheck %s --input-file=%t.out
+
+// The module attributes of the output are those of the compiled functions, so
+// an attribute that the pipeline removes is not restored by the merge.
+
+// CHECK: module attributes {scheme.bgv}
+// CHECK-NOT: scheme.ckks
+module attributes {scheme.ckks} {
+  func.func @add(%arg0: i16, %arg1: i16) -> i16 {
+    %0 = arith.addi %arg0, %arg1 : i16
+    return %0 : i16
+  }
+
+  func.func @sub(%arg0: i16, %arg1: i16) -> i16 {
+    %0 = arith.subi %arg0, %arg1 : i16
+    return %0 : i16
+  }
+}
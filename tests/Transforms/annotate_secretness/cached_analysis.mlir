@@ -0,0 +1,27 @@
+// RUN: heir-opt --convert-if-to-select --annotate-secretness %s | FileCheck %s
+// RUN: heir-opt --convert-if-to-select --annotate-secretness --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=REUSED
+// RUN: heir-opt --annotate-secretness --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=FRESH
+
+// --convert-if-to-select keeps the secretness analysis up to date as it
+// rewrites and preserves it, so --annotate-secretness reads the cached state.
+// The new select and the existing multiplication, whose operand was replaced
+// by the select, must both be secret there.
+
+// REUSED: AnnotateSecretness
+// REUSED: (S) 1 reused analyses
+// FRESH: AnnotateSecretness
+// FRESH: (S) 0 reused analyses
+
+// CHECK-LABEL: @if_to_select
+// CHECK: %[[sel:.*]] = arith.select %{{.*}}, %{{.*}}, %{{.*}} {secret.secret} : i16
+// CHECK: arith.muli %[[sel]], %{{.*}} {secret.secret} : i16
+func.func @if_to_select(%cond: i1 {secret.secret}, %a: i16, %b: i16) -> i16 {
+  %0 = scf.if %cond -> (i16) {
+    %1 = arith.addi %a, %b : i16
+    scf.yield %1 : i16
+  } else {
+    scf.yield %a : i16
+  }
+  %2 = arith.muli %0, %b : i16
+  return %2 : i16
+}
@@ -0,0 +1,62 @@
+// RUN: heir-opt --convert-secret-extract-to-static-extract=strategy=mux-tree %s | FileCheck %s --check-prefix=MUX
+// RUN: heir-opt --convert-secret-extract-to-static-extract=strategy=mask-reduce %s | FileCheck %s --check-prefix=MASK
+// RUN: heir-opt --convert-secret-extract-to-static-extract --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=LINEAR-STATS
+// RUN: heir-opt --convert-secret-extract-to-static-extract=strategy=mux-tree --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=MUX-STATS
+// RUN: heir-opt --convert-secret-extract-to-static-extract="strategy=mask-reduce cost-model=boolean" --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=MASK-STATS
+// RUN: heir-opt --convert-secret-extract-to-static-extract="strategy=auto cost-model=simd" --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=LINEAR-STATS
+// RUN: heir-opt --convert-secret-extract-to-static-extract="strategy=auto cost-model=boolean" --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=MUX-STATS
+// RUN: not heir-opt --convert-secret-extract-to-static-extract="strategy=mux-tree cost-model=simd" %s 2>&1 | FileCheck %s --check-prefix=SIMD-ERROR
+
+// The statistics are measured on the rewritten IR. A tensor of 32 elements
+// has a 5-bit index.
+
+// The linear loop compares the index and selects once per iteration, and each
+// select depends on the previous one. Under the SIMD cost model, auto picks it
+// because the other strategies do not lower to RLWE schemes.
+// LINEAR-STATS: ConvertSecretExtractToStaticExtract
+// LINEAR-STATS-DAG: (S) 1 secret extracts
+// LINEAR-STATS-DAG: (S) 64 access ops
+// LINEAR-STATS-DAG: (S) 33 max access depth
+
+// The mux tree casts the index and extracts its 5 bits (10 ops), then selects
+// in 5 levels (31 ops). Under the boolean cost model, auto picks it as the
+// strategy with the fewest gates.
+// MUX-STATS: ConvertSecretExtractToStaticExtract
+// MUX-STATS-DAG: (S) 1 secret extracts
+// MUX-STATS-DAG: (S) 41 access ops
+// MUX-STATS-DAG: (S) 7 max access depth
+
+// The mask and the multiplication are vector ops, followed by the extraction
+// and the chain of additions of the 32 elements.
+// MASK-STATS: ConvertSecretExtractToStaticExtract
+// MASK-STATS-DAG: (S) 1 secret extracts
+// MASK-STATS-DAG: (S) 67 access ops
+// MASK-STATS-DAG: (S) 36 max access depth
+
+// SIMD-ERROR: secret access strategy 'mux-tree' requires the boolean cost model
+
+// MUX-LABEL: @extract_at_secret_index
+// MUX: %[[INDEX:.*]] = arith.index_castui %{{.*}} : index to i5
+// MUX-COUNT-5: arith.trunci
+// MUX-COUNT-31: arith.select
+// MUX-NOT: arith.select
+// MUX-NOT: scf.if
+// MUX: secret.yield
+
+// MASK-LABEL: @extract_at_secret_index
+// MASK: %[[IOTA:.*]] = arith.constant dense<[0, 1, 2
+// MASK: %[[SPLAT:.*]] = tensor.splat
+// MASK: %[[MASK:.*]] = arith.cmpi eq, %[[IOTA]], %[[SPLAT]] : tensor<32xindex>
+// MASK: %[[EXT:.*]] = arith.extui %[[MASK]] : tensor<32xi1> to tensor<32xi16>
+// MASK: %[[MASKED:.*]] = arith.muli %{{.*}}, %[[EXT]] : tensor<32xi16>
+// MASK-COUNT-31: arith.addi
+// MASK-NOT: scf.if
+// MASK: secret.yield
+func.func @extract_at_secret_index(%arg0: !secret.secret<tensor<32xi16>>, %arg1: !secret.secret<index>) -> !secret.secret<i16> {
+    %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<tensor<32xi16>>, !secret.secret<index>) {
+    ^bb0(%arg2: tensor<32xi16>, %arg3: index):
+      %extracted = tensor.extract %arg2[%arg3] : tensor<32xi16>
+      secret.yield %extracted : i16
+    } -> !secret.secret<i16>
+    return %0 : !secret.secret<i16>
+}
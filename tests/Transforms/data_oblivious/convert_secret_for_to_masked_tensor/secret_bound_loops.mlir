@@ -0,0 +1,175 @@
+// RUN: heir-opt --convert-secret-for-to-masked-tensor %s | FileCheck %s
+// RUN: heir-opt --convert-secret-for-to-masked-tensor --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=STATS
+
+// STATS: ConvertSecretForToMaskedTensor
+// STATS-DAG: (S) 3 masked reductions
+// STATS-DAG: (S) 2 masked maps
+
+// CHECK-LABEL: @sum_with_secret_upper_bound
+// CHECK-DAG:  %[[IOTA:.*]] = arith.constant dense<[0, 1, 2, {{.*}}]> : tensor<32xindex>
+// CHECK-DAG:  %[[ZERO:.*]] = arith.constant dense<0> : tensor<32xi16>
+// CHECK:      ^body(%[[TENSOR:.*]]: tensor<32xi16>, %[[UPPER:.*]]: index):
+// CHECK-NOT:    scf.for
+// CHECK:        %[[SPLAT:.*]] = tensor.splat %[[UPPER]] : tensor<32xindex>
+// CHECK:        %[[MASK:.*]] = arith.cmpi slt, %[[IOTA]], %[[SPLAT]] : tensor<32xindex>
+// CHECK:        %[[MASKED:.*]] = arith.select %[[MASK]], %[[TENSOR]], %[[ZERO]] : tensor<32xi1>, tensor<32xi16>
+// CHECK-COUNT-31: arith.addi
+// CHECK:        %[[RESULT:.*]] = arith.addi %{{.*}}, %{{.*}} : i16
+// CHECK:        secret.yield %[[RESULT]] : i16
+func.func @sum_with_secret_upper_bound(%arg0: !secret.secret<tensor<32xi16>>, %arg1: !secret.secret<index>) -> !secret.secret<i16> {
+    %c0 = arith.constant 0 : index
+    %c0_i16 = arith.constant 0 : i16
+    %c1 = arith.constant 1 : index
+    %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<tensor<32xi16>>, !secret.secret<index>) {
+    ^body(%arg2: tensor<32xi16>, %arg3: index):
+      %1 = scf.for %arg4 = %c0 to %arg3 step %c1 iter_args(%arg5 = %c0_i16) -> (i16) {
+        %extracted = tensor.extract %arg2[%arg4] : tensor<32xi16>
+        %2 = arith.addi %extracted, %arg5 : i16
+        scf.yield %2 : i16
+      } {lower = 0, upper = 42}
+      secret.yield %1 : i16
+    } -> !secret.secret<i16>
+    return %0 : !secret.secret<i16>
+}
+
+// The body is computed on slices of the tensors for the static range.
+
+// CHECK-LABEL: @dot_product_with_secret_bounds
+// CHECK:      %[[IOTA:.*]] = arith.constant dense<[4, 5, 6, {{.*}}, 15]> : tensor<12xindex>
+// CHECK:      ^body(%[[LHS:.*]]: tensor<32xi16>, %[[RHS:.*]]: tensor<32xi16>, %[[LOWER:.*]]: index, %[[UPPER:.*]]: index):
+// CHECK-NOT:    scf.for
+// CHECK:        %[[LOWER_MASK:.*]] = arith.cmpi sge, %[[IOTA]]
+// CHECK:        %[[UPPER_MASK:.*]] = arith.cmpi slt, %[[IOTA]]
+// CHECK:        %[[MASK:.*]] = arith.andi %[[LOWER_MASK]], %[[UPPER_MASK]] : tensor<12xi1>
+// CHECK-DAG:    %[[LHS_SLICE:.*]] = tensor.extract_slice %[[LHS]][4] [12] [1] : tensor<32xi16> to tensor<12xi16>
+// CHECK-DAG:    %[[RHS_SLICE:.*]] = tensor.extract_slice %[[RHS]][4] [12] [1] : tensor<32xi16> to tensor<12xi16>
+// CHECK:        %[[MUL:.*]] = arith.muli %[[LHS_SLICE]], %[[RHS_SLICE]] : tensor<12xi16>
+// CHECK:        arith.select %[[MASK]], %[[MUL]], %{{.*}} : tensor<12xi1>, tensor<12xi16>
+// CHECK-COUNT-11: arith.addi
+func.func @dot_product_with_secret_bounds(%arg0: !secret.secret<tensor<32xi16>>, %arg1: !secret.secret<tensor<32xi16>>, %arg2: !secret.secret<index>, %arg3: !secret.secret<index>) -> !secret.secret<i16> {
+    %c0_i16 = arith.constant 0 : i16
+    %c1 = arith.constant 1 : index
+    %0 = secret.generic ins(%arg0, %arg1, %arg2, %arg3 : !secret.secret<tensor<32xi16>>, !secret.secret<tensor<32xi16>>, !secret.secret<index>, !secret.secret<index>) {
+    ^body(%lhs: tensor<32xi16>, %rhs: tensor<32xi16>, %lower: index, %upper: index):
+      %1 = scf.for %i = %lower to %upper step %c1 iter_args(%acc = %c0_i16) -> (i16) {
+        %a = tensor.extract %lhs[%i] : tensor<32xi16>
+        %b = tensor.extract %rhs[%i] : tensor<32xi16>
+        %2 = arith.muli %a, %b : i16
+        %3 = arith.addi %acc, %2 : i16
+        scf.yield %3 : i16
+      } {lower = 4, upper = 16}
+      secret.yield %1 : i16
+    } -> !secret.secret<i16>
+    return %0 : !secret.secret<i16>
+}
+
+// CHECK-LABEL: @product_with_secret_upper_bound
+// CHECK:      %[[ONE:.*]] = arith.constant dense<1> : tensor<8xi16>
+// CHECK:      ^body
+// CHECK:        arith.select %{{.*}}, %{{.*}}, %[[ONE]] : tensor<8xi1>, tensor<8xi16>
+// CHECK-COUNT-7: arith.muli
+func.func @product_with_secret_upper_bound(%arg0: !secret.secret<tensor<8xi16>>, %arg1: !secret.secret<index>) -> !secret.secret<i16> {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c1_i16 = arith.constant 1 : i16
+    %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<tensor<8xi16>>, !secret.secret<index>) {
+    ^body(%arg2: tensor<8xi16>, %arg3: index):
+      %1 = scf.for %i = %c0 to %arg3 step %c1 iter_args(%acc = %c1_i16) -> (i16) {
+        %extracted = tensor.extract %arg2[%i] : tensor<8xi16>
+        %2 = arith.muli %acc, %extracted : i16
+        scf.yield %2 : i16
+      } {lower = 0, upper = 8}
+      secret.yield %1 : i16
+    } -> !secret.secret<i16>
+    return %0 : !secret.secret<i16>
+}
+
+// CHECK-LABEL: @map_with_secret_upper_bound
+// CHECK:      %[[C2:.*]] = arith.constant 2 : i16
+// CHECK:      ^body(%[[TENSOR:.*]]: tensor<32xi16>, %[[UPPER:.*]]: index):
+// CHECK-NOT:    scf.for
+// CHECK:        %[[MASK:.*]] = arith.cmpi slt
+// CHECK:        %[[SPLAT:.*]] = tensor.splat %[[C2]] : tensor<32xi16>
+// CHECK:        %[[MUL:.*]] = arith.muli %[[TENSOR]], %[[SPLAT]] : tensor<32xi16>
+// CHECK:        %[[RESULT:.*]] = arith.select %[[MASK]], %[[MUL]], %[[TENSOR]] : tensor<32xi1>, tensor<32xi16>
+// CHECK:        secret.yield %[[RESULT]] : tensor<32xi16>
+func.func @map_with_secret_upper_bound(%arg0: !secret.secret<tensor<32xi16>>, %arg1: !secret.secret<index>) -> !secret.secret<tensor<32xi16>> {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<tensor<32xi16>>, !secret.secret<index>) {
+    ^body(%arg2: tensor<32xi16>, %arg3: index):
+      %1 = scf.for %i = %c0 to %arg3 step %c1 iter_args(%acc = %arg2) -> (tensor<32xi16>) {
+        %extracted = tensor.extract %acc[%i] : tensor<32xi16>
+        %c2_i16 = arith.constant 2 : i16
+        %2 = arith.muli %extracted, %c2_i16 : i16
+        %inserted = tensor.insert %2 into %acc[%i] : tensor<32xi16>
+        scf.yield %inserted : tensor<32xi16>
+      } {lower = 0, upper = 32}
+      secret.yield %1 : tensor<32xi16>
+    } -> !secret.secret<tensor<32xi16>>
+    return %0 : !secret.secret<tensor<32xi16>>
+}
+
+// CHECK-LABEL: @map_on_subrange
+// CHECK:      ^body(%[[INPUT:.*]]: tensor<16xi16>, %[[OUTPUT:.*]]: tensor<16xi16>, %[[LOWER:.*]]: index):
+// CHECK:        %[[MASK:.*]] = arith.cmpi sge
+// CHECK-SAME:     tensor<8xindex>
+// CHECK-DAG:    %[[INPUT_SLICE:.*]] = tensor.extract_slice %[[INPUT]][8] [8] [1]
+// CHECK-DAG:    %[[OUTPUT_SLICE:.*]] = tensor.extract_slice %[[OUTPUT]][8] [8] [1]
+// CHECK:        %[[SELECTED:.*]] = arith.select %[[MASK]], %[[INPUT_SLICE]], %[[OUTPUT_SLICE]] : tensor<8xi1>, tensor<8xi16>
+// CHECK:        %[[RESULT:.*]] = tensor.insert_slice %[[SELECTED]] into %[[OUTPUT]][8] [8] [1] : tensor<8xi16> into tensor<16xi16>
+// CHECK:        secret.yield %[[RESULT]] : tensor<16xi16>
+func.func @map_on_subrange(%arg0: !secret.secret<tensor<16xi16>>, %arg1: !secret.secret<tensor<16xi16>>, %arg2: !secret.secret<index>) -> !secret.secret<tensor<16xi16>> {
+    %c1 = arith.constant 1 : index
+    %c16 = arith.constant 16 : index
+    %0 = secret.generic ins(%arg0, %arg1, %arg2 : !secret.secret<tensor<16xi16>>, !secret.secret<tensor<16xi16>>, !secret.secret<index>) {
+    ^body(%input: tensor<16xi16>, %output: tensor<16xi16>, %lower: index):
+      %1 = scf.for %i = %lower to %c16 step %c1 iter_args(%acc = %output) -> (tensor<16xi16>) {
+        %extracted = tensor.extract %input[%i] : tensor<16xi16>
+        %inserted = tensor.insert %extracted into %acc[%i] : tensor<16xi16>
+        scf.yield %inserted : tensor<16xi16>
+      } {lower = 8}
+      secret.yield %1 : tensor<16xi16>
+    } -> !secret.secret<tensor<16xi16>>
+    return %0 : !secret.secret<tensor<16xi16>>
+}
+
+// Loops with other bodies are left to --convert-secret-for-to-static-for.
+
+// CHECK-LABEL: @prefix_sum_is_not_a_map
+// CHECK: scf.for
+func.func @prefix_sum_is_not_a_map(%arg0: !secret.secret<tensor<16xi16>>, %arg1: !secret.secret<index>) -> !secret.secret<tensor<16xi16>> {
+    %c1 = arith.constant 1 : index
+    %c1_i16 = arith.constant 1 : i16
+    %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<tensor<16xi16>>, !secret.secret<index>) {
+    ^body(%arg2: tensor<16xi16>, %arg3: index):
+      %1 = scf.for %i = %c1 to %arg3 step %c1 iter_args(%acc = %arg2) -> (tensor<16xi16>) {
+        %prev = arith.subi %i, %c1 : index
+        %a = tensor.extract %acc[%prev] : tensor<16xi16>
+        %b = tensor.extract %acc[%i] : tensor<16xi16>
+        %2 = arith.addi %a, %b : i16
+        %inserted = tensor.insert %2 into %acc[%i] : tensor<16xi16>
+        scf.yield %inserted : tensor<16xi16>
+      } {lower = 1, upper = 16}
+      secret.yield %1 : tensor<16xi16>
+    } -> !secret.secret<tensor<16xi16>>
+    return %0 : !secret.secret<tensor<16xi16>>
+}
+
+// CHECK-LABEL: @missing_static_bound
+// CHECK: scf.for
+func.func @missing_static_bound(%arg0: !secret.secret<tensor<16xi16>>, %arg1: !secret.secret<index>) -> !secret.secret<i16> {
+    %c0 = arith.constant 0 : index
+    %c0_i16 = arith.constant 0 : i16
+    %c1 = arith.constant 1 : index
+    %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<tensor<16xi16>>, !secret.secret<index>) {
+    ^body(%arg2: tensor<16xi16>, %arg3: index):
+      %1 = scf.for %i = %c0 to %arg3 step %c1 iter_args(%acc = %c0_i16) -> (i16) {
+        %extracted = tensor.extract %arg2[%i] : tensor<16xi16>
+        %2 = arith.addi %extracted, %acc : i16
+        scf.yield %2 : i16
+      }
+      secret.yield %1 : i16
+    } -> !secret.secret<i16>
+    return %0 : !secret.secret<i16>
+}
@@ -0,0 +1,58 @@
+// RUN: heir-opt --convert-secret-insert-to-static-insert=strategy=mux-tree %s | FileCheck %s --check-prefix=MUX
+// RUN: heir-opt --convert-secret-insert-to-static-insert=strategy=mask-reduce %s | FileCheck %s --check-prefix=MASK
+// RUN: heir-opt --convert-secret-insert-to-static-insert --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=LINEAR-STATS
+// RUN: heir-opt --convert-secret-insert-to-static-insert=strategy=mux-tree --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=MUX-STATS
+// RUN: heir-opt --convert-secret-insert-to-static-insert="strategy=mask-reduce cost-model=boolean" --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=MASK-STATS
+// RUN: heir-opt --convert-secret-insert-to-static-insert="strategy=auto cost-model=simd" --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=LINEAR-STATS
+// RUN: heir-opt --convert-secret-insert-to-static-insert="strategy=auto cost-model=boolean" --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=MUX-STATS
+// RUN: not heir-opt --convert-secret-insert-to-static-insert="strategy=mask-reduce cost-model=simd" %s 2>&1 | FileCheck %s --check-prefix=SIMD-ERROR
+
+// The statistics are measured on the rewritten IR. A tensor of 32 elements
+// has a 5-bit index.
+
+// From the second iteration on, the linear loop inserts into the tensor of the
+// previous iteration and selects, so the depth grows by 2 per iteration.
+// LINEAR-STATS: ConvertSecretInsertToStaticInsert
+// LINEAR-STATS-DAG: (S) 1 secret inserts
+// LINEAR-STATS-DAG: (S) 95 access ops
+// LINEAR-STATS-DAG: (S) 64 max access depth
+
+// The mux tree decodes the index with 60 ands, selects each of the 32
+// elements, and rebuilds the tensor.
+// MUX-STATS: ConvertSecretInsertToStaticInsert
+// MUX-STATS-DAG: (S) 1 secret inserts
+// MUX-STATS-DAG: (S) 108 access ops
+// MUX-STATS-DAG: (S) 10 max access depth
+
+// MASK-STATS: ConvertSecretInsertToStaticInsert
+// MASK-STATS-DAG: (S) 1 secret inserts
+// MASK-STATS-DAG: (S) 3 access ops
+// MASK-STATS-DAG: (S) 3 max access depth
+
+// SIMD-ERROR: secret access strategy 'mask-reduce' requires the boolean cost model
+
+// MUX-LABEL: @insert_at_secret_index
+// MUX: arith.index_castui %{{.*}} : index to i5
+// MUX-COUNT-60: arith.andi
+// MUX-COUNT-32: arith.select
+// MUX: tensor.from_elements
+// MUX-NOT: scf.if
+// MUX: secret.yield
+
+// MASK-LABEL: @insert_at_secret_index
+// MASK: %[[IOTA:.*]] = arith.constant dense<[0, 1, 2
+// MASK: %[[SPLAT_INDEX:.*]] = tensor.splat
+// MASK: %[[MASK:.*]] = arith.cmpi eq, %[[IOTA]], %[[SPLAT_INDEX]] : tensor<32xindex>
+// MASK: %[[SPLAT:.*]] = tensor.splat %{{.*}} : tensor<32xi16>
+// MASK: %[[RESULT:.*]] = arith.select %[[MASK]], %[[SPLAT]], %{{.*}} : tensor<32xi1>, tensor<32xi16>
+// MASK-NOT: scf.if
+// MASK: secret.yield %[[RESULT]]
+func.func @insert_at_secret_index(%arg0: !secret.secret<tensor<32xi16>>, %arg1: !secret.secret<index>) -> !secret.secret<tensor<32xi16>> {
+    %c0_i16 = arith.constant 0 : i16
+    %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<tensor<32xi16>>, !secret.secret<index>) {
+    ^bb0(%arg2: tensor<32xi16>, %arg3: index):
+      %inserted = tensor.insert %c0_i16 into %arg2[%arg3] : tensor<32xi16>
+      secret.yield %inserted : tensor<32xi16>
+    } -> !secret.secret<tensor<32xi16>>
+    return %0 : !secret.secret<tensor<32xi16>>
+}
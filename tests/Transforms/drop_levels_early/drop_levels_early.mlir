@@ -0,0 +1,53 @@
+// RUN: heir-opt --secret-insert-mgmt-bgv --drop-levels-early %s | FileCheck %s
+// RUN: heir-opt --secret-insert-mgmt-bgv --drop-levels-early --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=STATS
+
+// STATS: DropLevelsEarly
+// STATS: (S) 2 moved ops
+
+module attributes {scheme.bgv} {
+  // The modulus switch before the yield is moved up through the add and the
+  // rotation, so that the rotation runs with one less limb.
+
+  // CHECK: func.func @rotate_before_yield
+  // CHECK: ^body(%[[input0:.*]]: tensor<8xi16>):
+  // CHECK:   %[[v0:.*]] = arith.muli %[[input0]], %[[input0]]
+  // CHECK:   %[[v1:.*]] = mgmt.relinearize %[[v0]]
+  // CHECK:   %[[v2:.*]] = mgmt.modreduce %[[v1]]
+  // CHECK:   %[[v3:.*]] = arith.muli %[[v2]], %[[v2]]
+  // CHECK:   %[[v4:.*]] = mgmt.relinearize %[[v3]]
+  // CHECK:   %[[v5:.*]] = mgmt.modreduce %[[v4]]
+  // CHECK-NOT: mgmt.modreduce
+  // CHECK:   %[[v6:.*]] = tensor_ext.rotate %[[v5]]
+  // CHECK:   %[[v7:.*]] = arith.addi %[[v6]], %[[v5]]
+  // CHECK:   secret.yield %[[v7]]
+  func.func @rotate_before_yield(%arg0: !secret.secret<tensor<8xi16>>) -> !secret.secret<tensor<8xi16>> {
+    %c1 = arith.constant 1 : i32
+    %0 = secret.generic ins(%arg0 : !secret.secret<tensor<8xi16>>) {
+    ^body(%input0: tensor<8xi16>):
+      %1 = arith.muli %input0, %input0 : tensor<8xi16>
+      %2 = arith.muli %1, %1 : tensor<8xi16>
+      %3 = tensor_ext.rotate %2, %c1 : tensor<8xi16>, i32
+      %4 = arith.addi %3, %2 : tensor<8xi16>
+      secret.yield %4 : tensor<8xi16>
+    } -> !secret.secret<tensor<8xi16>>
+    return %0 : !secret.secret<tensor<8xi16>>
+  }
+
+  // Both operands of the add are also multiplied at their current level, so
+  // switching them separately would cost more than switching the sum.
+
+  // CHECK: func.func @operands_used_at_level
+  // CHECK: ^body(%[[input0:.*]]: tensor<8xi16>, %[[input1:.*]]: tensor<8xi16>):
+  // CHECK:   %[[v0:.*]] = arith.addi %[[input0]], %[[input1]]
+  // CHECK:   mgmt.modreduce %[[v0]]
+  func.func @operands_used_at_level(%arg0: !secret.secret<tensor<8xi16>>, %arg1: !secret.secret<tensor<8xi16>>) -> !secret.secret<tensor<8xi16>> {
+    %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<tensor<8xi16>>, !secret.secret<tensor<8xi16>>) {
+    ^body(%input0: tensor<8xi16>, %input1: tensor<8xi16>):
+      %1 = arith.addi %input0, %input1 : tensor<8xi16>
+      %2 = arith.muli %input0, %input1 : tensor<8xi16>
+      %3 = arith.muli %1, %2 : tensor<8xi16>
+      secret.yield %3 : tensor<8xi16>
+    } -> !secret.secret<tensor<8xi16>>
+    return %0 : !secret.secret<tensor<8xi16>>
+  }
+}
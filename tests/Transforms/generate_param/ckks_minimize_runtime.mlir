@@ -0,0 +1,26 @@
+// RUN: heir-opt --generate-param-ckks="first-mod-bits=45 scaling-mod-bits=40 minimize-runtime=true" %s | FileCheck %s
+// RUN: heir-opt --generate-param-ckks="first-mod-bits=45 scaling-mod-bits=40" %s | FileCheck %s --check-prefix=DEFAULT
+// RUN: heir-opt --generate-param-ckks="first-mod-bits=45 scaling-mod-bits=40 minimize-runtime=true prime-table=%t" %s
+// RUN: FileCheck %s --check-prefix=TABLE --input-file=%t
+
+// With four 40-45 bit primes in Q, the default two special primes push logPQ
+// past the 214 bits allowed at N = 8192, while a single special prime does
+// not, so the cheaper parameters use one special prime.
+
+// CHECK: ckks.schemeParam = #ckks.scheme_param<logN = 13, Q = [{{[0-9]+}}, {{[0-9]+}}, {{[0-9]+}}, {{[0-9]+}}], P = [{{[0-9]+}}],
+// DEFAULT: ckks.schemeParam = #ckks.scheme_param<logN = 14, Q = [{{[0-9]+}}, {{[0-9]+}}, {{[0-9]+}}, {{[0-9]+}}], P = [{{[0-9]+}}, {{[0-9]+}}],
+
+// TABLE: heir-prime-table-v1
+// TABLE: 40 16384
+
+func.func @mul(%arg0: !secret.secret<f32>) -> !secret.secret<f32> {
+  %0 = secret.generic ins(%arg0 : !secret.secret<f32>) attrs = {__argattrs = [{mgmt.mgmt = #mgmt.mgmt<level = 3>}], __resattrs = [{mgmt.mgmt = #mgmt.mgmt<level = 2>}]} {
+  ^body(%input0: f32):
+    %1 = arith.mulf %input0, %input0 {mgmt.mgmt = #mgmt.mgmt<level = 3, dimension = 3>} : f32
+    %2 = mgmt.relinearize %1 {mgmt.mgmt = #mgmt.mgmt<level = 3>} : f32
+    %3 = arith.addf %2, %input0 {mgmt.mgmt = #mgmt.mgmt<level = 3>} : f32
+    %4 = mgmt.modreduce %3 {mgmt.mgmt = #mgmt.mgmt<level = 2>} : f32
+    secret.yield %4 : f32
+  } -> !secret.secret<f32>
+  return %0 : !secret.secret<f32>
+}
@@ -0,0 +1,23 @@
+// RUN: heir-opt --mlir-to-ckks='ciphertext-degree=8' --scheme-to-lattigo='entry-function=weighted_sum' %s | FileCheck %s
+
+// The products of the inputs with constant weights are encoded at the same
+// scale and summed with a single weighted_sum_new.
+
+// CHECK-LABEL: func.func @weighted_sum
+// CHECK-NOT: lattigo.ckks.mul
+// CHECK: lattigo.ckks.weighted_sum_new
+// CHECK-SAME: [%{{.*}}, %{{.*}}, %{{.*}}], [%{{.*}}, %{{.*}}, %{{.*}}]
+// CHECK-NOT: lattigo.ckks.mul
+// CHECK-NOT: lattigo.ckks.add
+// CHECK: return
+func.func @weighted_sum(%arg0: tensor<8xf32> {secret.secret}, %arg1: tensor<8xf32> {secret.secret}, %arg2: tensor<8xf32> {secret.secret}) -> tensor<8xf32> {
+  %c3 = arith.constant dense<3.0> : tensor<8xf32>
+  %c5 = arith.constant dense<5.0> : tensor<8xf32>
+  %c7 = arith.constant dense<7.0> : tensor<8xf32>
+  %0 = arith.mulf %arg0, %c3 : tensor<8xf32>
+  %1 = arith.mulf %arg1, %c5 : tensor<8xf32>
+  %2 = arith.mulf %arg2, %c7 : tensor<8xf32>
+  %3 = arith.addf %0, %1 : tensor<8xf32>
+  %4 = arith.addf %3, %2 : tensor<8xf32>
+  return %4 : tensor<8xf32>
+}
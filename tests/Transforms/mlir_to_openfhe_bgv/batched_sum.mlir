@@ -0,0 +1,18 @@
+// RUN: heir-opt --mlir-to-bgv='ciphertext-degree=32 batch-size=4' --scheme-to-openfhe='entry-function=simple_sum' %s | FileCheck %s
+
+// Four sums of eight elements share one ciphertext of 32 slots.
+
+// CHECK-LABEL: @simple_sum
+// CHECK-COUNT-3: openfhe.rot
+// CHECK-NOT: openfhe.rot
+// CHECK: return
+func.func @simple_sum(%arg0: tensor<8xi16> {secret.secret}) -> i16 {
+  %c0 = arith.constant 0 : index
+  %c0_si16 = arith.constant 0 : i16
+  %0 = affine.for %i = 0 to 8 iter_args(%sum_iter = %c0_si16) -> i16 {
+    %1 = tensor.extract %arg0[%i] : tensor<8xi16>
+    %2 = arith.addi %1, %sum_iter : i16
+    affine.yield %2 : i16
+  }
+  return %0 : i16
+}
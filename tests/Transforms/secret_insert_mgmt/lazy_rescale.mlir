@@ -0,0 +1,38 @@
+// RUN: heir-opt --secret-insert-mgmt-ckks=lazy-rescale=true %s | FileCheck %s
+// RUN: heir-opt --secret-insert-mgmt-ckks=lazy-rescale=true --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=LAZY
+// RUN: heir-opt --secret-insert-mgmt-ckks --mlir-pass-statistics %s 2>&1 >/dev/null | FileCheck %s --check-prefix=DEFAULT
+
+// The product is already rescaled before the second multiplication, so only
+// %arg1 is brought to its level, and the result is rescaled once before the
+// yield. Without lazy-rescale, the rescaled product is rescaled again and
+// %arg1 is mod reduced twice.
+
+// LAZY: SecretInsertMgmtCKKS
+// LAZY: (S) 3 rescales
+// DEFAULT: SecretInsertMgmtCKKS
+// DEFAULT: (S) 5 rescales
+
+// CHECK: func.func @rescaled_operand
+// CHECK-SAME: (%[[arg0:.*]]: !secret.secret<f32>, %[[arg1:.*]]: !secret.secret<f32>)
+// CHECK: attrs = {__argattrs = [{mgmt.mgmt = #mgmt.mgmt<level = 2>}, {mgmt.mgmt = #mgmt.mgmt<level = 2>}], __resattrs = [{mgmt.mgmt = #mgmt.mgmt<level = 0>}]}
+// CHECK: ^body(%[[input0:.*]]: f32, %[[input1:.*]]: f32)
+// CHECK:   %[[v0:.*]] = arith.mulf %[[input0]], %[[input1]]
+// CHECK:   %[[v1:.*]] = mgmt.relinearize %[[v0]]
+// CHECK:   %[[v2:.*]] = mgmt.modreduce %[[v1]]
+// CHECK:   %[[v3:.*]] = mgmt.modreduce %[[input1]]
+// CHECK:   %[[v4:.*]] = arith.mulf %[[v2]], %[[v3]]
+// CHECK:   %[[v5:.*]] = mgmt.relinearize %[[v4]]
+// CHECK:   %[[v6:.*]] = mgmt.modreduce %[[v5]]
+// CHECK:   secret.yield %[[v6]] : f32
+module {
+  func.func @rescaled_operand(%arg0: !secret.secret<f32>, %arg1: !secret.secret<f32>) -> !secret.secret<f32> {
+    %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<f32>, !secret.secret<f32>) {
+    ^body(%input0: f32, %input1: f32):
+      %1 = arith.mulf %input0, %input1 : f32
+      %2 = mgmt.modreduce %1 : f32
+      %3 = arith.mulf %2, %input1 : f32
+      secret.yield %3 : f32
+    } -> !secret.secret<f32>
+    return %0 : !secret.secret<f32>
+  }
+}
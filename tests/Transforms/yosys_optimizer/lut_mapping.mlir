@@ -0,0 +1,48 @@
+// RUN: heir-opt --yosys-optimizer="print-stats=true" %s 2>&1 | FileCheck %s
+// RUN: heir-opt --yosys-optimizer="lut-mapping=depth print-stats=true" %s 2>&1 | FileCheck %s
+// RUN: heir-opt --yosys-optimizer="lut-mapping=depth max-depth=12 print-stats=true" %s 2>&1 | FileCheck %s
+// RUN: heir-opt --yosys-optimizer="lut-mapping=depth abc-fast=true print-stats=true" %s 2>&1 | FileCheck %s
+// RUN: heir-opt --yosys-optimizer="lut-mapping=depth" --mlir-pass-statistics %s 2>&1 | FileCheck %s --check-prefix=STATS
+
+// Compare the circuit depth of both objectives on the same input.
+// RUN: heir-opt --yosys-optimizer="print-stats=true" -o /dev/null %s 2> %t.area
+// RUN: heir-opt --yosys-optimizer="lut-mapping=depth print-stats=true" --mlir-pass-statistics -o /dev/null %s 2> %t.depth
+// RUN: cat %t.area %t.depth | FileCheck %s --check-prefix=COMPARE
+
+// The multiply-accumulate is mapped to 3-input LUTs for both objectives, and
+// the depth-oriented mapping never uses more LUT levels.
+
+// CHECK: Starting arith op count: 2
+// CHECK-NEXT: Ending cell count: {{[0-9]+}}
+// CHECK-NEXT: Ratio:
+// CHECK-NEXT: Ending circuit depth: {{[0-9]+}}
+
+// CHECK-LABEL: @mac
+// CHECK: secret.generic
+// CHECK-NOT: arith.muli
+// CHECK-NOT: arith.addi
+// CHECK: comb.truth_table
+// CHECK: secret.yield
+
+// STATS: YosysOptimizer
+// STATS-DAG: (S) {{[0-9]+}} maxCircuitDepth
+// STATS-DAG: (S) {{[0-9]+}} totalCircuitDepth
+// STATS-DAG: (S) {{[0-9]+}} totalCircuitSize
+
+// The depth-oriented mapping is no deeper than the area-oriented one. The
+// depth is captured from the print-stats output of each run, and the statistic
+// of the second run, which equals DEPTH_DEPTH, must equal
+// min(AREA_DEPTH, DEPTH_DEPTH), i.e. DEPTH_DEPTH <= AREA_DEPTH.
+// COMPARE: Ending circuit depth: [[#AREA_DEPTH:]]
+// COMPARE: Ending circuit depth: [[#DEPTH_DEPTH:]]
+// COMPARE: (S) [[#min(AREA_DEPTH, DEPTH_DEPTH)]] maxCircuitDepth
+
+func.func @mac(%a: !secret.secret<i8>, %b: !secret.secret<i8>, %c: !secret.secret<i8>) -> (!secret.secret<i8>) {
+  %0 = secret.generic ins(%a, %b, %c : !secret.secret<i8>, !secret.secret<i8>, !secret.secret<i8>) {
+  ^bb0(%A: i8, %B: i8, %C: i8):
+    %1 = arith.muli %A, %B : i8
+    %2 = arith.addi %1, %C : i8
+    secret.yield %2 : i8
+  } -> (!secret.secret<i8>)
+  return %0 : !secret.secret<i8>
+}
@@ -38,3 +38,4 @@ func.func @cumulative_sums(%arg0: !in_ty) -> (!out_ty) {
 // CHECK: Starting arith op count: 4
 // CHECK-NEXT: Ending cell count: 60
 // CHECK-NEXT: Ratio: 1.500000e+01
+// CHECK-NEXT: Ending circuit depth: {{[0-9]+}}
@@ -18,6 +18,7 @@
 #include "lib/Dialect/Comb/IR/CombDialect.h"
 #include "lib/Dialect/HEIRInterfaces.h"
 #include "lib/Dialect/Jaxite/IR/JaxiteDialect.h"
+#include "lib/Dialect/Jaxite/Transforms/Passes.h"
 #include "lib/Dialect/LWE/Conversions/LWEToLattigo/LWEToLattigo.h"
 #include "lib/Dialect/LWE/Conversions/LWEToOpenfhe/LWEToOpenfhe.h"
 #include "lib/Dialect/LWE/Conversions/LWEToPolynomial/LWEToPolynomial.h"
@@ -57,10 +58,12 @@
 #include "lib/Transforms/ApplyFolders/ApplyFolders.h"
 #include "lib/Transforms/ConvertIfToSelect/ConvertIfToSelect.h"
 #include "lib/Transforms/ConvertSecretExtractToStaticExtract/ConvertSecretExtractToStaticExtract.h"
+#include "lib/Transforms/ConvertSecretForToMaskedTensor/ConvertSecretForToMaskedTensor.h"
 #include "lib/Transforms/ConvertSecretForToStaticFor/ConvertSecretForToStaticFor.h"
 #include "lib/Transforms/ConvertSecretInsertToStaticInsert/ConvertSecretInsertToStaticInsert.h"
 #include "lib/Transforms/ConvertSecretWhileToStaticFor/ConvertSecretWhileToStaticFor.h"
 #include "lib/Transforms/ConvertToCiphertextSemantics/ConvertToCiphertextSemantics.h"
+#include "lib/Transforms/DropLevelsEarly/DropLevelsEarly.h"
 #include "lib/Transforms/DropUnitDims/DropUnitDims.h"
 #include "lib/Transforms/ElementwiseToAffine/ElementwiseToAffine.h"
 #include "lib/Transforms/ForwardInsertToExtract/ForwardInsertToExtract.h"
@@ -78,6 +81,12 @@
 #include "lib/Transforms/TensorToScalars/TensorToScalars.h"
 #include "lib/Transforms/UnusedMemRef/UnusedMemRef.h"
 #include "lib/Transforms/ValidateNoise/ValidateNoise.h"
+#include "lib/Utils/PipelineCache.h"
+#include "llvm/include/llvm/Support/CommandLine.h"     // from @llvm-project
+#include "llvm/include/llvm/Support/FileSystem.h"      // from @llvm-project
+#include "llvm/include/llvm/Support/InitLLVM.h"        // from @llvm-project
+#include "llvm/include/llvm/Support/ToolOutputFile.h"  // from @llvm-project
+#include "llvm/include/llvm/Support/raw_ostream.h"     // from @llvm-project
 #include "mlir/include/mlir/Conversion/AffineToStandard/AffineToStandard.h"  // from @llvm-project
 #include "mlir/include/mlir/Conversion/ArithToLLVM/ArithToLLVM.h"  // from @llvm-project
 #include "mlir/include/mlir/Conversion/ComplexToLLVM/ComplexToLLVM.h"  // from @llvm-project
@@ -117,6 +126,7 @@
 #include "mlir/include/mlir/Dialect/Tosa/IR/TosaOps.h"     // from @llvm-project
 #include "mlir/include/mlir/Pass/PassManager.h"            // from @llvm-project
 #include "mlir/include/mlir/Pass/PassRegistry.h"           // from @llvm-project
+#include "mlir/include/mlir/Support/FileUtilities.h"       // from @llvm-project
 #include "mlir/include/mlir/Support/LLVM.h"                // from @llvm-project
 #include "mlir/include/mlir/Tools/mlir-opt/MlirOptMain.h"  // from @llvm-project
 #include "mlir/include/mlir/Transforms/Passes.h"           // from @llvm-project
@@ -134,7 +144,91 @@ using namespace mlir;
 using namespace tosa;
 using namespace heir;
 
+static llvm::cl::opt<std::string> pipelineCacheDir(
+    "heir-pipeline-cache-dir",
+    llvm::cl::desc("Directory in which the output of the pass pipeline is "
+                   "cached per function, so that recompiling a module only "
+                   "reruns the pipeline on the functions that changed. Only "
+                   "valid for pipelines that compile functions independently."),
+    llvm::cl::init(""));
+
+// Identifies the heir-opt build and its command line, apart from the input and
+// output files, so that cached pipeline results are not reused across builds
+// or pass options.
+static std::string getToolFingerprint(int argc, char **argv,
+                                      StringRef inputFilename,
+                                      StringRef outputFilename) {
+  std::string fingerprint;
+  llvm::raw_string_ostream os(fingerprint);
+  std::string executable =
+      llvm::sys::fs::getMainExecutable(argv[0], (void *)&getToolFingerprint);
+  llvm::sys::fs::file_status status;
+  if (!llvm::sys::fs::status(executable, status)) {
+    os << executable << " " << status.getSize() << " "
+       << status.getLastModificationTime().time_since_epoch().count();
+  }
+  for (int i = 1; i < argc; ++i) {
+    StringRef arg = argv[i];
+    if (arg == "-o" || arg == "--o") {
+      ++i;
+      continue;
+    }
+    if (arg == inputFilename || arg == outputFilename ||
+        arg.starts_with("-o=") || arg.starts_with("--o=")) {
+      continue;
+    }
+    os << " " << arg;
+  }
+  return fingerprint;
+}
+
+// Runs heir-opt like MlirOptMain, but with the pass pipeline wrapped by the
+// per-function pipeline cache if one is requested. Expects InitLLVM to have
+// been set up by the caller, before the command line was parsed.
+static LogicalResult runHeirOpt(int argc, char **argv, StringRef inputFilename,
+                                StringRef outputFilename,
+                                DialectRegistry &registry) {
+  MlirOptMainConfig config = MlirOptMainConfig::createFromCLOptions();
+  if (config.shouldShowDialects() || config.shouldListPasses()) {
+    return MlirOptMain(argc, argv, inputFilename, outputFilename, registry);
+  }
+
+  PipelineCacheStatistics statistics;
+  std::string toolFingerprint;
+  MlirOptMainConfig pipelineConfig = config;
+  if (!pipelineCacheDir.empty()) {
+    toolFingerprint =
+        getToolFingerprint(argc, argv, inputFilename, outputFilename);
+    config.setPassPipelineSetupFn([&](PassManager &pm) -> LogicalResult {
+      if (failed(pipelineConfig.setupPassPipeline(pm))) return failure();
+      return setupPipelineCache(pm, pipelineCacheDir, toolFingerprint,
+                                statistics);
+    });
+  }
+
+  std::string errorMessage;
+  auto file = openInputFile(inputFilename, &errorMessage);
+  if (!file) {
+    llvm::errs() << errorMessage << "\n";
+    return failure();
+  }
+  auto output = openOutputFile(outputFilename, &errorMessage);
+  if (!output) {
+    llvm::errs() << errorMessage << "\n";
+    return failure();
+  }
+  LogicalResult result =
+      MlirOptMain(output->os(), std::move(file), registry, config);
+  if (!pipelineCacheDir.empty()) {
+    statistics.print(llvm::errs(), pipelineCacheDir);
+  }
+  if (failed(result)) return failure();
+  output->keep();
+  return success();
+}
+
 int main(int argc, char **argv) {
+  llvm::InitLLVM y(argc, argv);
   mlir::DialectRegistry registry;
 
   // This comment inserts internal dialects
@@ -233,6 +327,7 @@ int main(int argc, char **argv) {
 
   // Custom passes in HEIR
   cggi::registerCGGIPasses();
+  jaxite::registerJaxitePasses();
   lattigo::registerLattigoPasses();
   lwe::registerLWEPasses();
   mgmt::registerMgmtPasses();
@@ -245,11 +340,13 @@ int main(int argc, char **argv) {
   registerSecretInsertMgmtPasses();
   registerFullLoopUnrollPasses();
   registerConvertIfToSelectPasses();
+  registerConvertSecretForToMaskedTensorPasses();
   registerConvertSecretForToStaticForPasses();
   registerConvertSecretWhileToStaticForPasses();
   registerConvertSecretExtractToStaticExtractPasses();
   registerConvertSecretInsertToStaticInsertPasses();
   registerConvertToCiphertextSemanticsPasses();
+  registerDropLevelsEarlyPasses();
   registerDropUnitDims();
   registerAnnotateSecretnessPasses();
   registerApplyFoldersPasses();
@@ -392,11 +489,16 @@ int main(int argc, char **argv) {
       "Convert code expressed at FHE scheme level to Lattigo Go code.",
       toLattigoPipelineBuilder());
 
-  PassPipelineRegistration<>(
+  PassPipelineRegistration<DataObliviousOptions>(
       "convert-to-data-oblivious",
       "Transforms a native program to data-oblivious program",
-      convertToDataObliviousPipelineBuilder);
+      [](OpPassManager &pm, const DataObliviousOptions &options) {
+        convertToDataObliviousPipelineBuilder(pm, options.accessStrategy,
+                                              options.accessCostModel);
+      });
 
+  auto [inputFilename, outputFilename] =
+      registerAndParseCLIOptions(argc, argv, "HEIR Pass Driver", registry);
   return asMainReturnCode(
-      MlirOptMain(argc, argv, "HEIR Pass Driver", registry));
+      runHeirOpt(argc, argv, inputFilename, outputFilename, registry));
 }